@@ -0,0 +1,172 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkConfig.h"
+#include "common/Type.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Helper.h"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// size of each chunk sent by the benchmarks
+    constexpr ChunkSize chunk_size = 1'048'576;  // 1 MB
+
+    /// number of (src, dest) pairs queried per benchmark iteration
+    constexpr size_t queries_count = 1'024;
+
+    void noop(void* const arg) {}
+
+    /// construct a 1D topology from in-memory values
+    [[nodiscard]] std::shared_ptr<Topology> make_topology(const TopologyBuildingBlock topology_type,
+                                                          const int npus_count) {
+        const auto network_config = NetworkConfig().add_dimension(topology_type, npus_count, 50, 500);
+        auto topology = construct_topology(network_config);
+        assert(topology != nullptr);
+        return topology;
+    }
+
+    /// random (src, dest) pairs of distinct NPUs
+    [[nodiscard]] std::vector<std::pair<DeviceId, DeviceId>> make_queries(const int npus_count) {
+        auto generator = std::mt19937(0);
+        auto npu = std::uniform_int_distribution<DeviceId>(0, npus_count - 1);
+        auto queries = std::vector<std::pair<DeviceId, DeviceId>>();
+        while (queries.size() < queries_count) {
+            const auto src = npu(generator);
+            const auto dest = npu(generator);
+            if (src != dest) {
+                queries.emplace_back(src, dest);
+            }
+        }
+        return queries;
+    }
+
+    /// schedule `depth` events at random times, then invoke them
+    void BM_EventQueueScheduleProceed(benchmark::State& state) {
+        const auto depth = static_cast<size_t>(state.range(0));
+        const auto backend = static_cast<EventQueueBackend>(state.range(1));
+
+        auto generator = std::mt19937(0);
+        auto event_time = std::uniform_int_distribution<EventTime>(1, depth * 10);
+        auto event_times = std::vector<EventTime>(depth);
+        for (auto& time : event_times) {
+            time = event_time(generator);
+        }
+
+        for (auto _ : state) {
+            auto event_queue = EventQueue(backend);
+            for (const auto time : event_times) {
+                event_queue.schedule_event(time, noop, nullptr);
+            }
+            while (!event_queue.finished()) {
+                event_queue.proceed();
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * depth));
+    }
+    BENCHMARK(BM_EventQueueScheduleProceed)
+        ->ArgNames({"depth", "backend"})
+        ->ArgsProduct({benchmark::CreateRange(16, 4'096, 4), {static_cast<int64_t>(EventQueueBackend::List)}})
+        ->ArgsProduct({benchmark::CreateRange(16, 65'536, 4), {static_cast<int64_t>(EventQueueBackend::Calendar)}});
+
+    /// construct routes between random NPU pairs
+    void BM_Route(benchmark::State& state) {
+        const auto topology_type = static_cast<TopologyBuildingBlock>(state.range(0));
+        const auto npus_count = static_cast<int>(state.range(1));
+        const auto topology = make_topology(topology_type, npus_count);
+        const auto queries = make_queries(npus_count);
+
+        for (auto _ : state) {
+            for (const auto& [src, dest] : queries) {
+                benchmark::DoNotOptimize(topology->route(src, dest));
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+    }
+    BENCHMARK(BM_Route)
+        ->ArgNames({"topology", "npus"})
+        ->ArgsProduct({{static_cast<int64_t>(TopologyBuildingBlock::Ring),
+                        static_cast<int64_t>(TopologyBuildingBlock::FullyConnected),
+                        static_cast<int64_t>(TopologyBuildingBlock::Switch)},
+                       benchmark::CreateRange(8, 512, 8)});
+
+    /// send a chunk over `hops` hops of a Ring, and simulate it to its destination
+    void BM_SendPerHop(benchmark::State& state) {
+        const auto hops_count = static_cast<int>(state.range(0));
+        const auto topology = make_topology(TopologyBuildingBlock::Ring, 2 * hops_count);
+
+        // every link is free again once the chunk arrives, so the topology and event queue are reused
+        const auto event_queue = std::make_shared<EventQueue>();
+        topology->set_event_queue(event_queue);
+
+        for (auto _ : state) {
+            topology->send(topology->make_chunk(chunk_size, 0, hops_count, noop, nullptr));
+            event_queue->run_to_completion();
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * hops_count));
+    }
+    BENCHMARK(BM_SendPerHop)->ArgName("hops")->RangeMultiplier(4)->Range(1, 256);
+
+    /// simulate a collective over every NPU, end to end
+    void BM_Collective(benchmark::State& state,
+                       const TopologyBuildingBlock topology_type,
+                       const CollectiveType collective_type,
+                       const CollectiveAlgorithm algorithm) {
+        const auto npus_count = static_cast<int>(state.range(0));
+
+        auto chunks_count = size_t(0);
+        for (auto _ : state) {
+            // every iteration starts from idle links and an empty event queue
+            state.PauseTiming();
+            const auto topology = make_topology(topology_type, npus_count);
+            const auto event_queue = std::make_shared<EventQueue>();
+            topology->set_event_queue(event_queue);
+            auto collective = Collective(topology.get(), collective_type, algorithm,
+                                         chunk_size * static_cast<ChunkSize>(npus_count), noop, nullptr);
+            state.ResumeTiming();
+
+            collective.start();
+            event_queue->run_to_completion();
+            chunks_count = collective.get_chunks_count();
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * chunks_count));
+        state.counters["chunks"] = static_cast<double>(chunks_count);
+    }
+    BENCHMARK_CAPTURE(BM_Collective,
+                      AllGatherRing,
+                      TopologyBuildingBlock::Ring,
+                      CollectiveType::AllGather,
+                      CollectiveAlgorithm::Ring)
+        ->ArgName("npus")
+        ->RangeMultiplier(8)
+        ->Range(8, 4'096)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
+    BENCHMARK_CAPTURE(BM_Collective,
+                      AllToAllSwitch,
+                      TopologyBuildingBlock::Switch,
+                      CollectiveType::AllToAll,
+                      CollectiveAlgorithm::Direct)
+        ->ArgName("npus")
+        ->RangeMultiplier(8)
+        ->Range(8, 4'096)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,166 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkConfig.h"
+#include "common/Type.h"
+#include "congestion_unaware/Helper.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+    /// size of each chunk sent by the benchmarks
+    constexpr ChunkSize chunk_size = 1'048'576;  // 1 MB
+
+    /// number of (src, dest) pairs queried per benchmark iteration
+    constexpr size_t queries_count = 1'024;
+
+    /// construct a topology with the given NPUs count per dimension, from in-memory values
+    [[nodiscard]] std::shared_ptr<Topology> make_topology(const TopologyBuildingBlock topology_type,
+                                                          const std::vector<int>& npus_count_per_dim) {
+        auto network_config = NetworkConfig();
+        for (const auto npus_count : npus_count_per_dim) {
+            network_config.add_dimension(topology_type, npus_count, 50, 500);
+        }
+        auto topology = construct_topology(network_config);
+        assert(topology != nullptr);
+        return topology;
+    }
+
+    /// random (src, dest) pairs of distinct NPUs
+    [[nodiscard]] std::vector<std::pair<DeviceId, DeviceId>> make_queries(const int npus_count) {
+        auto generator = std::mt19937(0);
+        auto npu = std::uniform_int_distribution<DeviceId>(0, npus_count - 1);
+        auto queries = std::vector<std::pair<DeviceId, DeviceId>>();
+        while (queries.size() < queries_count) {
+            const auto src = npu(generator);
+            const auto dest = npu(generator);
+            if (src != dest) {
+                queries.emplace_back(src, dest);
+            }
+        }
+        return queries;
+    }
+
+    /// send between random NPU pairs of a topology
+    void run_sends(benchmark::State& state, const Topology& topology) {
+        const auto queries = make_queries(topology.get_npus_count());
+
+        for (auto _ : state) {
+            for (const auto& [src, dest] : queries) {
+                benchmark::DoNotOptimize(topology.send(src, dest, chunk_size));
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+    }
+
+    /// send over a 1D topology
+    void BM_Send(benchmark::State& state) {
+        const auto topology_type = static_cast<TopologyBuildingBlock>(state.range(0));
+        const auto npus_count = static_cast<int>(state.range(1));
+        run_sends(state, *make_topology(topology_type, {npus_count}));
+    }
+    BENCHMARK(BM_Send)
+        ->ArgNames({"topology", "npus"})
+        ->ArgsProduct({{static_cast<int64_t>(TopologyBuildingBlock::Ring),
+                        static_cast<int64_t>(TopologyBuildingBlock::FullyConnected),
+                        static_cast<int64_t>(TopologyBuildingBlock::Switch)},
+                       benchmark::CreateRange(8, 4'096, 8)});
+
+    /// send over a multi-dimensional topology of 4096 NPUs, with `dims` dimensions of equal size
+    void BM_MultiDimSend(benchmark::State& state) {
+        const auto dims_count = static_cast<int>(state.range(0));
+        const auto npus_count_per_dim = [dims_count] {
+            switch (dims_count) {
+                case 2:
+                    return std::vector<int>{64, 64};
+                case 3:
+                    return std::vector<int>{16, 16, 16};
+                default:
+                    return std::vector<int>{8, 8, 8, 8};
+            }
+        }();
+        run_sends(state, *make_topology(TopologyBuildingBlock::Ring, npus_count_per_dim));
+    }
+    BENCHMARK(BM_MultiDimSend)->ArgName("dims")->DenseRange(2, 4);
+
+    /// all-to-all by sending between every pair of NPUs
+    void BM_AllToAll(benchmark::State& state) {
+        const auto topology_type = static_cast<TopologyBuildingBlock>(state.range(0));
+        const auto npus_count = static_cast<int>(state.range(1));
+        const auto topology = make_topology(topology_type, {npus_count});
+
+        for (auto _ : state) {
+            auto collective_time = EventTime(0);
+            for (auto src = 0; src < npus_count; src++) {
+                for (auto dest = 0; dest < npus_count; dest++) {
+                    if (src != dest) {
+                        collective_time = std::max(collective_time, topology->send(src, dest, chunk_size));
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(collective_time);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * npus_count * (npus_count - 1)));
+    }
+    BENCHMARK(BM_AllToAll)
+        ->ArgNames({"topology", "npus"})
+        ->ArgsProduct({{static_cast<int64_t>(TopologyBuildingBlock::FullyConnected),
+                        static_cast<int64_t>(TopologyBuildingBlock::Switch)},
+                       benchmark::CreateRange(8, 4'096, 8)})
+        ->Unit(benchmark::kMicrosecond);
+
+    /// ring all-gather, by summing the slowest send of each step
+    void BM_AllGatherRing(benchmark::State& state) {
+        const auto npus_count = static_cast<int>(state.range(0));
+        const auto topology = make_topology(TopologyBuildingBlock::Ring, {npus_count});
+
+        for (auto _ : state) {
+            auto collective_time = EventTime(0);
+            for (auto step = 1; step < npus_count; step++) {
+                auto step_time = EventTime(0);
+                for (auto npu = 0; npu < npus_count; npu++) {
+                    step_time = std::max(step_time, topology->send(npu, (npu + 1) % npus_count, chunk_size));
+                }
+                collective_time += step_time;
+            }
+            benchmark::DoNotOptimize(collective_time);
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * npus_count * (npus_count - 1)));
+    }
+    BENCHMARK(BM_AllGatherRing)->ArgName("npus")->RangeMultiplier(8)->Range(8, 4'096)->Unit(benchmark::kMicrosecond);
+
+    /// closed-form collective estimate, for reference against the send loops above
+    void BM_EstimateCollective(benchmark::State& state) {
+        const auto collective_type = static_cast<CollectiveType>(state.range(0));
+        const auto npus_count = static_cast<int>(state.range(1));
+        const auto topology_type = (collective_type == CollectiveType::AllToAll) ? TopologyBuildingBlock::Switch
+                                                                                 : TopologyBuildingBlock::Ring;
+        const auto algorithm =
+            (collective_type == CollectiveType::AllToAll) ? CollectiveAlgorithm::Direct : CollectiveAlgorithm::Ring;
+        const auto topology = make_topology(topology_type, {npus_count});
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(topology->estimate_collective(collective_type, algorithm,
+                                                                   chunk_size * static_cast<ChunkSize>(npus_count)));
+        }
+    }
+    BENCHMARK(BM_EstimateCollective)
+        ->ArgNames({"collective", "npus"})
+        ->ArgsProduct({{static_cast<int64_t>(CollectiveType::AllGather), static_cast<int64_t>(CollectiveType::AllToAll)},
+                       benchmark::CreateRange(8, 4'096, 8)});
+
+}  // namespace
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/NetworkFunction.h"
 #include <cassert>
+#include <cmath>
 
 using namespace NetworkAnalytical;
 
@@ -15,3 +16,20 @@ Bandwidth NetworkAnalytical::bw_GBps_to_Bpns(const Bandwidth bw_GBps) noexcept {
     // 1 s is 10^9 ns
     return bw_GBps * (1 << 30) / (1'000'000'000);  // GB/s to B/ns
 }
+
+ReciprocalBandwidth NetworkAnalytical::bw_Bpns_to_reciprocal(const Bandwidth bw_Bpns) noexcept {
+    assert(bw_Bpns > 0);
+
+    // ps/B, scaled by 2^reciprocal_bandwidth_fraction_bits
+    const auto scale = static_cast<double>(uint64_t(1) << reciprocal_bandwidth_fraction_bits);
+    const auto reciprocal = std::round(static_cast<double>(ps_per_ns) * scale / bw_Bpns);
+    assert(reciprocal < 18'446'744'073'709'551'616.0);  // fits 64 bits, i.e., bandwidth above ~0.24 KB/s
+
+    return static_cast<ReciprocalBandwidth>(reciprocal);
+}
+
+PicoTime NetworkAnalytical::latency_ns_to_ps(const Latency latency) noexcept {
+    assert(latency >= 0);
+
+    return static_cast<PicoTime>(std::llround(latency * static_cast<double>(ps_per_ns)));
+}
@@ -0,0 +1,218 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/CalendarQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+using namespace NetworkAnalytical;
+
+CalendarQueue::CalendarQueue() noexcept
+    : bucket_mask(min_buckets_count - 1),
+      bucket_width(1),
+      event_lists_count(0),
+      cursor_bucket(0),
+      cursor_bucket_top(1) {
+    // create empty buckets
+    buckets = std::vector<std::vector<EventList*>>(min_buckets_count);
+}
+
+bool CalendarQueue::empty() const noexcept {
+    return event_lists_count == 0;
+}
+
+size_t CalendarQueue::size() const noexcept {
+    return event_lists_count;
+}
+
+EventList* CalendarQueue::find_or_insert(const EventTime event_time, EventListPool& pool) noexcept {
+    // search the bucket backward, as new events are usually the latest ones
+    const auto& bucket = buckets[bucket_index(event_time)];
+    for (auto it = bucket.rbegin(); it != bucket.rend(); it++) {
+        if ((*it)->get_event_time() == event_time) {
+            // event list matching with event_time is found
+            return *it;
+        }
+
+        if ((*it)->get_event_time() < event_time) {
+            break;
+        }
+    }
+
+    // a new event list should be created
+    auto* const event_list = pool.acquire(event_time);
+    insert(event_list);
+
+    // grow the calendar if it became dense
+    if (event_lists_count > 2 * buckets.size()) {
+        resize(2 * buckets.size());
+    }
+
+    return event_list;
+}
+
+EventTime CalendarQueue::peek_min_time() noexcept {
+    // to peek, an event list should exist
+    assert(!empty());
+
+    // move the cursor to the earliest event list
+    // this is safe, as inserting an earlier event list rewinds the cursor
+    locate_min();
+
+    return buckets[cursor_bucket].front()->get_event_time();
+}
+
+EventList* CalendarQueue::pop_min() noexcept {
+    // to pop, an event list should exist
+    assert(!empty());
+
+    // move the cursor to the earliest event list
+    locate_min();
+
+    // take out the earliest event list
+    auto& bucket = buckets[cursor_bucket];
+    auto* const event_list = bucket.front();
+    bucket.erase(bucket.begin());
+    event_lists_count--;
+
+    // shrink the calendar if it became sparse
+    if (buckets.size() > min_buckets_count && event_lists_count < buckets.size() / 2) {
+        resize(buckets.size() / 2);
+    }
+
+    return event_list;
+}
+
+void CalendarQueue::erase(EventList* const event_list) noexcept {
+    assert(event_list != nullptr);
+
+    // the event list is in the bucket of its time
+    // the cursor stays valid, as no earlier event list is registered
+    auto& bucket = buckets[bucket_index(event_list->get_event_time())];
+    const auto it = std::find(bucket.begin(), bucket.end(), event_list);
+    assert(it != bucket.end());
+    bucket.erase(it);
+    event_lists_count--;
+}
+
+std::vector<const EventList*> CalendarQueue::get_event_lists() const noexcept {
+    auto event_lists = std::vector<const EventList*>();
+    event_lists.reserve(event_lists_count);
+    for (const auto& bucket : buckets) {
+        event_lists.insert(event_lists.end(), bucket.begin(), bucket.end());
+    }
+
+    // buckets are sorted individually, but hold event lists of different years
+    std::sort(event_lists.begin(), event_lists.end(), [](const EventList* const lhs, const EventList* const rhs) {
+        return lhs->get_event_time() < rhs->get_event_time();
+    });
+
+    return event_lists;
+}
+
+size_t CalendarQueue::bucket_index(const EventTime event_time) const noexcept {
+    return static_cast<size_t>(event_time / bucket_width) & bucket_mask;
+}
+
+void CalendarQueue::set_cursor(const EventTime event_time) noexcept {
+    cursor_bucket = bucket_index(event_time);
+    cursor_bucket_top = ((event_time / bucket_width) + 1) * bucket_width;
+}
+
+void CalendarQueue::locate_min() noexcept {
+    assert(!empty());
+
+    // scan one full year of days, starting from the cursor
+    auto bucket = cursor_bucket;
+    auto bucket_top = cursor_bucket_top;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        // the first event list of a bucket belongs to this day only if it's earlier than bucket_top
+        const auto& event_lists = buckets[bucket];
+        if (!event_lists.empty() && event_lists.front()->get_event_time() < bucket_top) {
+            cursor_bucket = bucket;
+            cursor_bucket_top = bucket_top;
+            return;
+        }
+
+        // proceed to the next day
+        bucket = (bucket + 1) & bucket_mask;
+        bucket_top += bucket_width;
+    }
+
+    // no event within a year: the bucket width is too small for the current event distribution.
+    // re-calibrate the calendar, which also moves the cursor to the earliest event list
+    resize(buckets.size());
+}
+
+void CalendarQueue::insert(EventList* const event_list) noexcept {
+    assert(event_list != nullptr);
+    const auto event_time = event_list->get_event_time();
+
+    // rewind the cursor if the new event list is earlier than the cursor's day
+    if (event_time + bucket_width < cursor_bucket_top) {
+        set_cursor(event_time);
+    }
+
+    // find the sorted position within the bucket
+    auto& bucket = buckets[bucket_index(event_time)];
+    auto it = bucket.end();
+    while (it != bucket.begin() && (*std::prev(it))->get_event_time() > event_time) {
+        it--;
+    }
+
+    // insert event list
+    event_lists_count++;
+    bucket.insert(it, event_list);
+}
+
+void CalendarQueue::resize(const size_t new_buckets_count) noexcept {
+    // buckets count should be a power of 2
+    assert(new_buckets_count >= min_buckets_count);
+    assert((new_buckets_count & (new_buckets_count - 1)) == 0);
+
+    // take out all registered event lists
+    auto event_lists = std::vector<EventList*>();
+    event_lists.reserve(event_lists_count);
+    for (const auto& bucket : buckets) {
+        event_lists.insert(event_lists.end(), bucket.begin(), bucket.end());
+    }
+
+    // estimate the bucket width as 3x the average separation of the earliest event lists
+    if (event_lists.size() >= 2) {
+        auto event_times = std::vector<EventTime>();
+        event_times.reserve(event_lists.size());
+        for (const auto* const event_list : event_lists) {
+            event_times.push_back(event_list->get_event_time());
+        }
+
+        const auto samples_count = std::min(event_times.size(), width_samples_count);
+        const auto samples_end = event_times.begin() + static_cast<std::ptrdiff_t>(samples_count);
+        std::nth_element(event_times.begin(), samples_end - 1, event_times.end());
+        std::sort(event_times.begin(), samples_end);
+
+        const auto average_separation = (event_times[samples_count - 1] - event_times[0]) / (samples_count - 1);
+        bucket_width = std::max<EventTime>(1, 3 * average_separation);
+    }
+
+    // rebuild buckets
+    buckets = std::vector<std::vector<EventList*>>(new_buckets_count);
+    bucket_mask = new_buckets_count - 1;
+    event_lists_count = 0;
+
+    if (event_lists.empty()) {
+        // keep the cursor at its current day
+        set_cursor(cursor_bucket_top - bucket_width);
+        return;
+    }
+
+    // re-insert event lists, and move the cursor to the earliest one
+    auto min_event_time = event_lists.front()->get_event_time();
+    for (auto* const event_list : event_lists) {
+        min_event_time = std::min(min_event_time, event_list->get_event_time());
+        insert(event_list);
+    }
+    set_cursor(min_event_time);
+}
@@ -27,3 +27,11 @@ std::pair<Callback, CallbackArg> Event::get_handler_arg() const noexcept {
 
     return {callback, callback_arg};
 }
+
+void Event::cancel() noexcept {
+    callback = nullptr;
+}
+
+bool Event::cancelled() const noexcept {
+    return callback == nullptr;
+}
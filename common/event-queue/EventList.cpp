@@ -4,32 +4,157 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventList.h"
+#ifdef ANALYTICAL_PROFILING
+#include "common/EventProfiler.h"
+#endif
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 
 using namespace NetworkAnalytical;
 
-EventList::EventList(const EventTime event_time) noexcept : event_time(event_time) {
+EventList::EventList(const EventTime event_time) noexcept
+    : event_time(event_time),
+      next(nullptr),
+      time_error(0),
+      generation(0),
+      invoked_count(0),
+      cancelled_count(0) {
     assert(event_time >= 0);
 
     // create an empty event list
-    events = std::list<Event>();
+    events = std::vector<Event>();
 }
 
 EventTime EventList::get_event_time() const noexcept {
     return event_time;
 }
 
-void EventList::add_event(const Callback callback, const CallbackArg callback_arg) noexcept {
+void EventList::reset(const EventTime event_time) noexcept {
+    // only an empty event list can be recycled
+    assert(events.empty());
+    assert(relayed_events.empty());
+
+    this->event_time = event_time;
+    next = nullptr;
+    time_error = 0;
+    generation++;
+}
+
+EventTime EventList::get_time_error() const noexcept {
+    return time_error;
+}
+
+void EventList::raise_time_error(const EventTime time_error) noexcept {
+    this->time_error = std::max(this->time_error, time_error);
+}
+
+bool EventList::empty() const noexcept {
+    return events.empty() && relayed_events.empty();
+}
+
+const std::vector<Event>& EventList::get_events() const noexcept {
+    return events;
+}
+
+EventList* EventList::get_next() const noexcept {
+    return next;
+}
+
+void EventList::set_next(EventList* const next_event_list) noexcept {
+    next = next_event_list;
+}
+
+EventHandle EventList::add_event(const Callback callback, const CallbackArg callback_arg) noexcept {
     assert(callback != nullptr);
 
     // add the event to the event list
     events.emplace_back(callback, callback_arg);
+    return {this, static_cast<uint32_t>(events.size() - 1), generation};
+}
+
+EventHandle EventList::add_event(const Callback callback,
+                                 const CallbackArg callback_arg,
+                                 const uint64_t sequence) noexcept {
+    // sequence numbers grow in the order of registration
+    assert(sequence >= events.size());
+    assert(sequences.empty() || sequences.back() < sequence);
+
+    sequences.push_back(sequence);
+    return add_event(callback, callback_arg);
 }
 
-void EventList::invoke_events() noexcept {
+uint64_t EventList::get_sequence(const size_t index) const noexcept {
+    assert(index < events.size());
+
+    // the first events may be registered before the numbering started
+    const auto unnumbered_count = events.size() - sequences.size();
+    return index < unnumbered_count ? index : sequences[index - unnumbered_count];
+}
+
+bool EventList::pending(const uint32_t index, const uint32_t generation) const noexcept {
+    // an event of a recycled list, or already invoked
+    if (generation != this->generation || index < invoked_count || index >= events.size()) {
+        return false;
+    }
+    return !events[index].cancelled();
+}
+
+void EventList::cancel_event(const uint32_t index) noexcept {
+    assert(invoked_count <= index && index < events.size());
+    assert(!events[index].cancelled());
+
+    events[index].cancel();
+    cancelled_count++;
+}
+
+bool EventList::all_events_cancelled() const noexcept {
+    assert(invoked_count == 0);
+
+    return cancelled_count == events.size() && relayed_events.empty();
+}
+
+void EventList::discard_events() noexcept {
+    assert(relayed_events.empty());
+
+    events.clear();
+    sequences.clear();
+    cancelled_count = 0;
+}
+
+size_t EventList::invoke_events() noexcept {
     // invoke all events in the event list
-    while (!events.empty()) {
-        events.front().invoke_event();
-        events.pop_front();
+    // an event may register new events to this list, which are invoked in the same pass.
+    // the event is copied out, as registration may reallocate the buffer
+#ifdef ANALYTICAL_PROFILING
+    // attribute the ticks of each invocation to its callback
+    auto& profiler = EventProfiler::get_thread_profiler();
+    while (invoked_count < events.size()) {
+        auto event = events[invoked_count++];
+        if (event.cancelled()) {
+            continue;
+        }
+        const auto start = EventProfiler::read_ticks();
+        event.invoke_event();
+        profiler.record_callback(event.get_handler_arg().first, EventProfiler::read_ticks() - start);
+    }
+    profiler.record_batch(events.size() - cancelled_count);
+#else
+    // the cursor is a member, so that an event can cancel the later ones of the same list
+    while (invoked_count < events.size()) {
+        auto event = events[invoked_count++];
+        if (!event.cancelled()) {
+            event.invoke_event();
+        }
     }
+#endif
+
+    // drop invoked events, keeping the buffer
+    const auto invoked_events_count = events.size() - cancelled_count;
+    events.clear();
+    sequences.clear();
+    invoked_count = 0;
+    cancelled_count = 0;
+
+    return invoked_events_count;
 }
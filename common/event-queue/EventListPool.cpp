@@ -0,0 +1,64 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventListPool.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+EventListPool::EventListPool() noexcept : in_use_count(0), peak_usage(0) {
+    // create an empty pool
+    event_lists = std::deque<EventList>();
+    free_event_lists = std::vector<EventList*>();
+}
+
+EventList* EventListPool::acquire(const EventTime event_time) noexcept {
+    // grow the pool if there's no free event list
+    if (free_event_lists.empty()) {
+        event_lists.emplace_back(event_time);
+        free_event_lists.push_back(&event_lists.back());
+    }
+
+    // take out a free event list
+    auto* const event_list = free_event_lists.back();
+    free_event_lists.pop_back();
+    event_list->reset(event_time);
+
+    // update usage
+    in_use_count++;
+    peak_usage = std::max(peak_usage, in_use_count);
+
+    return event_list;
+}
+
+void EventListPool::release(EventList* const event_list) noexcept {
+    assert(event_list != nullptr);
+    assert(event_list->empty());
+    assert(in_use_count > 0);
+
+    // return the event list, its event buffer is kept for reuse
+    free_event_lists.push_back(event_list);
+    in_use_count--;
+}
+
+void EventListPool::reserve(const size_t event_lists_count) noexcept {
+    while (event_lists.size() < event_lists_count) {
+        event_lists.emplace_back(0);
+        free_event_lists.push_back(&event_lists.back());
+    }
+}
+
+size_t EventListPool::get_in_use_count() const noexcept {
+    return in_use_count;
+}
+
+size_t EventListPool::get_peak_usage() const noexcept {
+    return peak_usage;
+}
+
+size_t EventListPool::get_capacity() const noexcept {
+    return event_lists.size();
+}
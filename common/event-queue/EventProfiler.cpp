@@ -0,0 +1,223 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+#if defined(ANALYTICAL_PROFILING) && __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#define ANALYTICAL_PROFILING_SYMBOLS
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+    /**
+     * Profile of the whole process, which the thread profilers are merged into.
+     * It's printed when destructed at exit, after the profiler of the main thread is merged.
+     */
+    struct ProcessProfile {
+        std::mutex mutex;
+        EventProfiler profiler;
+
+        ~ProcessProfile() {
+            if (profiler.get_batches_count() > 0) {
+                profiler.print_summary(std::cerr);
+            }
+        }
+    };
+
+    [[nodiscard]] ProcessProfile& get_process_profile() noexcept {
+        static auto process_profile = ProcessProfile();
+        return process_profile;
+    }
+
+    /// profiler of a thread, merged into the process profile when the thread exits
+    struct ThreadProfile {
+        EventProfiler profiler;
+
+        ThreadProfile() noexcept {
+            // construct the process profile first, so that it outlives every thread profile
+            static_cast<void>(get_process_profile());
+        }
+
+        ~ThreadProfile() {
+            auto& process_profile = get_process_profile();
+            const auto lock = std::lock_guard<std::mutex>(process_profile.mutex);
+            process_profile.profiler.merge(profiler);
+        }
+    };
+
+}  // namespace
+
+EventProfiler::EventProfiler() noexcept : batches_count(0), max_batch_size(0) {
+    callback_profiles = {};
+    batch_sizes_histogram = {};
+}
+
+EventProfiler& EventProfiler::get_thread_profiler() noexcept {
+    thread_local auto thread_profile = ThreadProfile();
+    return thread_profile.profiler;
+}
+
+uint64_t EventProfiler::read_ticks() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+const char* EventProfiler::get_ticks_unit() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+void EventProfiler::record_callback(const Callback callback, const uint64_t ticks) noexcept {
+    auto& callback_profile = callback_profiles[callback];
+    callback_profile.invocations_count++;
+    callback_profile.ticks += ticks;
+}
+
+void EventProfiler::record_batch(const size_t events_count) noexcept {
+    if (events_count == 0) {
+        return;
+    }
+
+    // bucket of floor(log2(events_count))
+    auto bucket = size_t(0);
+    while ((events_count >> (bucket + 1)) > 0) {
+        bucket++;
+    }
+    if (bucket >= batch_sizes_histogram.size()) {
+        batch_sizes_histogram.resize(bucket + 1, 0);
+    }
+
+    batch_sizes_histogram[bucket]++;
+    batches_count++;
+    max_batch_size = std::max(max_batch_size, events_count);
+}
+
+const std::unordered_map<Callback, EventProfiler::CallbackProfile>& EventProfiler::get_callback_profiles()
+    const noexcept {
+    return callback_profiles;
+}
+
+const std::vector<uint64_t>& EventProfiler::get_batch_sizes_histogram() const noexcept {
+    return batch_sizes_histogram;
+}
+
+uint64_t EventProfiler::get_batches_count() const noexcept {
+    return batches_count;
+}
+
+size_t EventProfiler::get_max_batch_size() const noexcept {
+    return max_batch_size;
+}
+
+void EventProfiler::merge(const EventProfiler& other) noexcept {
+    for (const auto& [callback, other_profile] : other.callback_profiles) {
+        auto& callback_profile = callback_profiles[callback];
+        callback_profile.invocations_count += other_profile.invocations_count;
+        callback_profile.ticks += other_profile.ticks;
+    }
+
+    if (other.batch_sizes_histogram.size() > batch_sizes_histogram.size()) {
+        batch_sizes_histogram.resize(other.batch_sizes_histogram.size(), 0);
+    }
+    for (auto bucket = size_t(0); bucket < other.batch_sizes_histogram.size(); bucket++) {
+        batch_sizes_histogram[bucket] += other.batch_sizes_histogram[bucket];
+    }
+
+    batches_count += other.batches_count;
+    max_batch_size = std::max(max_batch_size, other.max_batch_size);
+}
+
+void EventProfiler::reset() noexcept {
+    callback_profiles.clear();
+    batch_sizes_histogram.clear();
+    batches_count = 0;
+    max_batch_size = 0;
+}
+
+void EventProfiler::print_summary(std::ostream& out) const noexcept {
+    // sort the callbacks by their ticks, the most expensive first
+    auto profiles =
+        std::vector<std::pair<Callback, CallbackProfile>>(callback_profiles.begin(), callback_profiles.end());
+    std::sort(profiles.begin(), profiles.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.second.ticks > rhs.second.ticks; });
+
+    auto total_ticks = uint64_t(0);
+    for (const auto& [callback, profile] : profiles) {
+        total_ticks += profile.ticks;
+    }
+
+    const auto* const unit = get_ticks_unit();
+    out << "[Profiling] (network/analytical) Event callbacks" << std::endl;
+    out << std::setw(16) << "invocations" << std::setw(20) << (std::string(unit) + " total") << std::setw(16)
+        << (std::string(unit) + "/call") << std::setw(10) << "share"
+        << "  callback" << std::endl;
+    for (const auto& [callback, profile] : profiles) {
+        const auto share = (total_ticks > 0) ? 100.0 * static_cast<double>(profile.ticks) / total_ticks : 0;
+        out << std::setw(16) << profile.invocations_count << std::setw(20) << profile.ticks << std::setw(16)
+            << profile.ticks / profile.invocations_count << std::setw(9) << std::fixed << std::setprecision(1)
+            << share << "%"
+            << "  " << get_callback_name(callback) << std::endl;
+    }
+    out << std::defaultfloat;
+
+    out << "[Profiling] (network/analytical) Events per event time (" << batches_count << " event times, max "
+        << max_batch_size << ")" << std::endl;
+    out << std::setw(24) << "events" << std::setw(16) << "event times" << std::endl;
+    for (auto bucket = size_t(0); bucket < batch_sizes_histogram.size(); bucket++) {
+        if (batch_sizes_histogram[bucket] == 0) {
+            continue;
+        }
+        auto range = std::ostringstream();
+        range << (size_t(1) << bucket);
+        if (bucket > 0) {
+            range << " - " << ((size_t(2) << bucket) - 1);
+        }
+        out << std::setw(24) << range.str() << std::setw(16) << batch_sizes_histogram[bucket] << std::endl;
+    }
+}
+
+std::string EventProfiler::get_callback_name(const Callback callback) noexcept {
+#ifdef ANALYTICAL_PROFILING_SYMBOLS
+    // resolve the symbol, which requires the executable to export its symbols (e.g., -rdynamic)
+    auto info = Dl_info();
+    if (dladdr(reinterpret_cast<void*>(callback), &info) != 0 && info.dli_sname != nullptr) {
+        auto status = 0;
+        auto* const demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+            auto name = std::string(demangled);
+            std::free(demangled);
+            return name;
+        }
+        return info.dli_sname;
+    }
+#endif
+
+    // not resolved, print the address
+    auto address = std::ostringstream();
+    address << reinterpret_cast<void*>(callback);
+    return address.str();
+}
@@ -4,13 +4,30 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventQueue.h"
+#ifdef ANALYTICAL_PROFILING
+#include "common/EventProfiler.h"
+#endif
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 
 using namespace NetworkAnalytical;
 
-EventQueue::EventQueue() noexcept : current_time(0) {
-    // create empty event queue
-    event_queue = std::list<EventList>();
+EventQueue::EventQueue(const EventQueueBackend backend) noexcept
+    : current_time(0),
+      backend(backend),
+      event_queue(nullptr),
+      current_event_list(nullptr),
+      time_quantum(0),
+      current_time_error(0),
+      time_error_bound(0),
+      schedule_hook(nullptr),
+      schedule_hook_context(nullptr),
+      relays_enabled(false),
+      next_sequence(0) {}
+
+EventQueueBackend EventQueue::get_backend() const noexcept {
+    return backend;
 }
 
 EventTime EventQueue::get_current_time() const noexcept {
@@ -19,41 +36,340 @@ EventTime EventQueue::get_current_time() const noexcept {
 
 bool EventQueue::finished() const noexcept {
     // check whether event queue is empty
-    return event_queue.empty();
+    // i.e., all event lists returned to the pool
+    return event_list_pool.get_in_use_count() == 0;
 }
 
 
 int EventQueue::counter() const noexcept{
-  return event_queue.size();
+  return static_cast<int>(event_list_pool.get_in_use_count());
 }
 
 void EventQueue::proceed() noexcept {
     // to proceed, next event should exist
     assert(!finished());
 
-    // proceed to the next event time
-    auto& current_event_list = event_queue.front();
+    proceed_event_list();
+}
+
+RunSummary EventQueue::run_until(const EventTime end_time) noexcept {
+    auto summary = RunSummary();
+    const auto start = std::chrono::steady_clock::now();
+
+    // invoke event lists until the horizon
+    while (!finished() && peek_next_event_time() <= end_time) {
+        summary.events_count += proceed_event_list();
+        summary.event_times_count++;
+    }
+
+    // the relays until the horizon are due as well
+    if (relays_enabled) {
+        pass_relays(end_time, true);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    summary.wall_time = std::chrono::duration<double>(end - start).count();
+    summary.time_error_bound = time_error_bound;
+
+    return summary;
+}
+
+RunSummary EventQueue::advance_to(const EventTime time) noexcept {
+    assert(time >= current_time);
+
+    // invoke the events up to the bound
+    auto summary = run_until(time);
+
+    // no event is pending until the bound, so the queue can jump to it
+    assert(finished() || peek_next_event_time() > time);
+    current_time = time;
+
+    return summary;
+}
+
+RunSummary EventQueue::run_to_completion() noexcept {
+    auto summary = RunSummary();
+    const auto start = std::chrono::steady_clock::now();
+
+    // invoke event lists until the queue is drained
+    while (!finished()) {
+        summary.events_count += proceed_event_list();
+        summary.event_times_count++;
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    summary.wall_time = std::chrono::duration<double>(end - start).count();
+    summary.time_error_bound = time_error_bound;
+
+    return summary;
+}
+
+EventTime EventQueue::peek_next_event_time() noexcept {
+    // next event should exist
+    assert(!finished());
+
+    if (backend == EventQueueBackend::Calendar) {
+        return calendar_queue.peek_min_time();
+    }
+
+    return event_queue->get_event_time();
+}
+
+size_t EventQueue::proceed_event_list() noexcept {
+    // take out the earliest event list
+    EventList* next_event_list;
+    if (backend == EventQueueBackend::Calendar) {
+        next_event_list = calendar_queue.pop_min();
+    } else {
+        next_event_list = event_queue;
+        event_queue = event_queue->get_next();
+    }
+
+    // the relays before are passed first, as they would have been invoked first
+    if (relays_enabled) {
+        pass_relays(next_event_list->get_event_time(), false);
+    }
 
     // check the validity and update current time
-    assert(current_event_list.get_event_time() > current_time);
-    current_time = current_event_list.get_event_time();
+    // scheduled between two proceeds, an event can be due at the current time (e.g., after advance_to())
+    assert(next_event_list->get_event_time() >= current_time);
+    current_time = next_event_list->get_event_time();
+
+    // the events scheduled meanwhile are as late as the invoked ones, at least
+    current_time_error = next_event_list->get_time_error();
+    time_error_bound = std::max(time_error_bound, current_time_error);
 
     // invoke events
-    current_event_list.invoke_events();
+    // events scheduled at current_time meanwhile are appended to this list
+    current_event_list = next_event_list;
+    const auto invoked_events_count =
+        relays_enabled ? invoke_relayed_event_list(next_event_list) : next_event_list->invoke_events();
+    current_event_list = nullptr;
+
+    // recycle processed event list
+    event_list_pool.release(next_event_list);
 
-    // drop processed event list
-    event_queue.pop_front();
+    return invoked_events_count;
 }
 
-void EventQueue::schedule_event(const EventTime event_time, const Callback callback,
-                                const CallbackArg callback_arg) noexcept {
+EventHandle EventQueue::schedule_event(const EventTime event_time,
+                                       Callback callback,
+                                       CallbackArg callback_arg) noexcept {
     // time should be at least larger than current time
     assert(event_time >= current_time);
 
+    // the hook may wrap the event, or take it over
+    if (schedule_hook != nullptr && (*schedule_hook)(schedule_hook_context, event_time, callback, callback_arg)) {
+        return {};
+    }
+
+    // exact event time
+    // events are numbered if relayed events are interleaved with them
+    if (time_quantum <= 1) {
+        auto* const event_list = find_or_insert_event_list(event_time);
+        if (relays_enabled) {
+            return event_list->add_event(callback, callback_arg, next_sequence++);
+        }
+        return event_list->add_event(callback, callback_arg);
+    }
+
+    // otherwise, round the event time up to the quantum
+    // the event is late by the rounding, on top of the lateness of the event scheduling it
+    const auto quantized_time = ((event_time + time_quantum - 1) / time_quantum) * time_quantum;
+    auto* const event_list = find_or_insert_event_list(quantized_time);
+    const auto handle = relays_enabled ? event_list->add_event(callback, callback_arg, next_sequence++)
+                                       : event_list->add_event(callback, callback_arg);
+    event_list->raise_time_error(current_time_error + (quantized_time - event_time));
+    return handle;
+}
+
+void EventQueue::set_schedule_hook(const ScheduleHook hook, void* const context) noexcept {
+    schedule_hook = hook;
+    schedule_hook_context = context;
+}
+
+bool EventQueue::is_pending(const EventHandle& handle) const noexcept {
+    if (handle.relayed) {
+        assert(handle.index < relayed_events.size());
+        const auto& relayed_event = relayed_events[handle.index];
+        return handle.generation == relayed_event.generation && relayed_event.event_list != nullptr;
+    }
+
+    return handle.event_list != nullptr && handle.event_list->pending(handle.index, handle.generation);
+}
+
+bool EventQueue::cancel(const EventHandle& handle) noexcept {
+    if (!is_pending(handle)) {
+        return false;
+    }
+
+    if (handle.relayed) {
+        unlink_relayed_event(handle.index);
+        release_relayed_event(handle.index);
+        return true;
+    }
+
+    auto* const event_list = handle.event_list;
+    event_list->cancel_event(handle.index);
+
+    // drop the time once nothing is left to invoke, unless it's being invoked
+    if (event_list != current_event_list && event_list->all_events_cancelled()) {
+        drop_event_list(event_list);
+    }
+    return true;
+}
+
+EventHandle EventQueue::reschedule(const EventHandle& handle, const EventTime event_time) noexcept {
+    if (!is_pending(handle)) {
+        return {};
+    }
+
+    // the callback survives the cancellation, which may recycle its EventList
+    // a relayed event is moved as an ordinary one
+    auto handler_arg = std::pair<Callback, CallbackArg>();
+    if (handle.relayed) {
+        const auto& relayed_event = relayed_events[handle.index];
+        handler_arg = {relayed_event.callback, relayed_event.callback_arg};
+    } else {
+        handler_arg = handle.event_list->get_events()[handle.index].get_handler_arg();
+    }
+    const auto [callback, callback_arg] = handler_arg;
+    cancel(handle);
+    return schedule_event(event_time, callback, callback_arg);
+}
+
+void EventQueue::enable_relayed_events() noexcept {
+    if (relays_enabled) {
+        return;
+    }
+
+    // the pending events can't be renumbered while they're invoked
+    assert(current_event_list == nullptr);
+
+    // the pending events are numbered by their index in their EventLists,
+    // so the events registered from now on are numbered after them
+    const auto skip_events = [this](const EventList* const event_list) {
+        next_sequence = std::max<uint64_t>(next_sequence, event_list->get_events().size());
+    };
+    if (backend == EventQueueBackend::Calendar) {
+        for (const auto* const event_list : calendar_queue.get_event_lists()) {
+            skip_events(event_list);
+        }
+    } else {
+        for (const auto* event_list = event_queue; event_list != nullptr; event_list = event_list->get_next()) {
+            skip_events(event_list);
+        }
+    }
+
+    relays_enabled = true;
+}
+
+bool EventQueue::relayed_events_enabled() const noexcept {
+    return relays_enabled;
+}
+
+EventHandle EventQueue::schedule_relayed_event(const std::vector<EventTime>& relay_times,
+                                               const EventTime event_time,
+                                               const Callback callback,
+                                               const CallbackArg callback_arg) noexcept {
+    assert(relays_enabled);
+    assert(time_quantum <= 1);
+    assert(schedule_hook == nullptr);
+    assert(callback != nullptr);
+    assert(!relay_times.empty());
+    assert(relay_times.front() >= current_time);
+    assert(std::is_sorted(relay_times.begin(), relay_times.end()));
+    assert(event_time >= relay_times.back());
+
+    // take a free entry of the relay table
+    auto id = static_cast<uint32_t>(relayed_events.size());
+    if (free_relayed_events.empty()) {
+        relayed_events.push_back({{}, {}, nullptr, nullptr, nullptr, 0});
+    } else {
+        id = free_relayed_events.back();
+        free_relayed_events.pop_back();
+    }
+
+    auto& relayed_event = relayed_events[id];
+    relayed_event.times.assign(relay_times.begin(), relay_times.end());
+    relayed_event.times.push_back(event_time);
+    relayed_event.callback = callback;
+    relayed_event.callback_arg = callback_arg;
+
+    // the first relay is registered now, as an event would be
+    relayed_event.positions.assign(1, 2 * next_sequence++);
+    relay_passes.push_back({relay_times.front(), {id, 0, relayed_event.positions.front()}, relayed_event.generation});
+    std::push_heap(relay_passes.begin(), relay_passes.end(),
+                   [this](const RelayPass& lhs, const RelayPass& rhs) { return later_relay_pass(lhs, rhs); });
+
+    return link_relayed_event(id);
+}
+
+bool EventQueue::relay_passed(const EventHandle& handle, const size_t relay) const noexcept {
+    assert(is_pending(handle));
+
+    const auto& relayed_event = relayed_events[handle.index];
+    assert(relay + 1 < relayed_event.times.size());
+
+    // once a relay is passed, the position of the next one is resolved
+    return relayed_event.positions.size() > relay + 1;
+}
+
+EventHandle EventQueue::cut_relays(const EventHandle& handle, const size_t relay) noexcept {
+    assert(is_pending(handle));
+    assert(!relay_passed(handle, relay));
+
+    // the event takes the place of the relay
+    // the passes of the cut relays become stale
+    unlink_relayed_event(handle.index);
+    auto& relayed_event = relayed_events[handle.index];
+    relayed_event.times.resize(relay + 1);
+    assert(relayed_event.positions.size() <= relayed_event.times.size());
+
+    return link_relayed_event(handle.index);
+}
+
+void EventQueue::drop_event_list(EventList* const event_list) noexcept {
+    assert(event_list != current_event_list);
+
+    if (backend == EventQueueBackend::Calendar) {
+        calendar_queue.erase(event_list);
+    } else {
+        // unlink from the sorted list
+        if (event_queue == event_list) {
+            event_queue = event_list->get_next();
+        } else {
+            auto* prev_event_list = event_queue;
+            while (prev_event_list->get_next() != event_list) {
+                prev_event_list = prev_event_list->get_next();
+                assert(prev_event_list != nullptr);
+            }
+            prev_event_list->set_next(event_list->get_next());
+        }
+    }
+
+    event_list->discard_events();
+    event_list_pool.release(event_list);
+}
+
+EventList* EventQueue::find_or_insert_event_list(const EventTime event_time) noexcept {
+    assert(event_time >= current_time);
+
+    // event at the current time while proceeding: invoke within the current event list
+    if (current_event_list != nullptr && event_time == current_time) {
+        return current_event_list;
+    }
+
+    if (backend == EventQueueBackend::Calendar) {
+        return calendar_queue.find_or_insert(event_time, event_list_pool);
+    }
+
     // find the entry to insert event
-    auto event_list_it = event_queue.begin();
-    while (event_list_it != event_queue.end() && event_list_it->get_event_time() < event_time) {
-        event_list_it++;
+    EventList* prev_event_list = nullptr;
+    auto* event_list = event_queue;
+    while (event_list != nullptr && event_list->get_event_time() < event_time) {
+        prev_event_list = event_list;
+        event_list = event_list->get_next();
     }
 
     // There can be three scenarios:
@@ -64,12 +380,334 @@ void EventQueue::schedule_event(const EventTime event_time, const Callback callb
     //   (2-2) the event_time requested is
     //   smaller than the largest event time scheduled
     // for both (2-1) or (2-2), a new event should be created
-    if (event_list_it == event_queue.end() || event_time < event_list_it->get_event_time()) {
+    if (event_list == nullptr || event_time < event_list->get_event_time()) {
         // insert new event_list
-        event_list_it = event_queue.insert(event_list_it, EventList(event_time));
+        auto* const new_event_list = event_list_pool.acquire(event_time);
+        new_event_list->set_next(event_list);
+        if (prev_event_list == nullptr) {
+            event_queue = new_event_list;
+        } else {
+            prev_event_list->set_next(new_event_list);
+        }
+        event_list = new_event_list;
     }
 
     // now, whether (1) or (2), the entry to insert the event is found
-    // add event to event_list
-    event_list_it->add_event(callback, callback_arg);
+    return event_list;
+}
+
+void EventQueue::for_each_event(const std::function<void(EventTime, Callback, CallbackArg)>& visitor) const noexcept {
+    // events can't be visited in order while an event list is being invoked
+    assert(current_event_list == nullptr);
+
+    const auto visit = [this, &visitor](const EventList* const event_list) {
+        // the relayed events are interleaved by their positions, followed by the unresolved ones (if any)
+        auto relayed_ids = event_list->relayed_events;
+        const auto resolved = [this](const uint32_t id) {
+            return relayed_events[id].positions.size() == relayed_events[id].times.size();
+        };
+        const auto unresolved_begin = std::stable_partition(relayed_ids.begin(), relayed_ids.end(), resolved);
+        std::sort(relayed_ids.begin(), unresolved_begin, [this](const uint32_t lhs, const uint32_t rhs) {
+            return precedes(relayed_event_order(lhs), relayed_event_order(rhs));
+        });
+
+        const auto& events = event_list->get_events();
+        auto relayed_id = relayed_ids.begin();
+        const auto visit_relayed_event = [&]() {
+            const auto& relayed_event = relayed_events[*relayed_id++];
+            visitor(event_list->get_event_time(), relayed_event.callback, relayed_event.callback_arg);
+        };
+        for (auto i = size_t(0); i < events.size(); i++) {
+            const auto order = EventOrder{no_relayed_event, 0, 2 * event_list->get_sequence(i)};
+            while (relayed_id != unresolved_begin && precedes(relayed_event_order(*relayed_id), order)) {
+                visit_relayed_event();
+            }
+            if (events[i].cancelled()) {
+                continue;
+            }
+            const auto [callback, callback_arg] = events[i].get_handler_arg();
+            visitor(event_list->get_event_time(), callback, callback_arg);
+        }
+        while (relayed_id != relayed_ids.end()) {
+            visit_relayed_event();
+        }
+    };
+
+    if (backend == EventQueueBackend::Calendar) {
+        for (const auto* const event_list : calendar_queue.get_event_lists()) {
+            visit(event_list);
+        }
+        return;
+    }
+
+    for (const auto* event_list = event_queue; event_list != nullptr; event_list = event_list->get_next()) {
+        visit(event_list);
+    }
+}
+
+void EventQueue::set_current_time(const EventTime time) noexcept {
+    // only an empty event queue can jump in time
+    assert(finished());
+    assert(time >= current_time);
+
+    current_time = time;
+}
+
+void EventQueue::set_time_quantum(const EventTime time_quantum) noexcept {
+    this->time_quantum = time_quantum;
+}
+
+EventTime EventQueue::get_time_quantum() const noexcept {
+    return time_quantum;
+}
+
+EventTime EventQueue::get_time_error_bound() const noexcept {
+    return time_error_bound;
+}
+
+void EventQueue::reserve(const size_t event_lists_count) noexcept {
+    event_list_pool.reserve(event_lists_count);
+}
+
+size_t EventQueue::get_peak_pool_usage() const noexcept {
+    return event_list_pool.get_peak_usage();
+}
+
+size_t EventQueue::invoke_relayed_event_list(EventList* const event_list) noexcept {
+    assert(event_list == current_event_list);
+
+    const auto event_time = event_list->get_event_time();
+    const auto later = [this](const RelayPass& lhs, const RelayPass& rhs) { return later_relay_pass(lhs, rhs); };
+    const auto relayed_event_due = [this](const RelayPass& relayed_event_pass) {
+        const auto& relayed_event = relayed_events[relayed_event_pass.order.relayed_event];
+        return relayed_event_pass.generation == relayed_event.generation &&
+               relayed_event.event_list == current_event_list;
+    };
+
+    // the relayed events resolved so far, the others are resolved once their last relays are passed
+    current_relayed_events.clear();
+    for (const auto id : event_list->relayed_events) {
+        const auto& relayed_event = relayed_events[id];
+        if (relayed_event.positions.size() == relayed_event.times.size()) {
+            current_relayed_events.push_back({event_time, relayed_event_order(id), relayed_event.generation});
+        }
+    }
+    std::make_heap(current_relayed_events.begin(), current_relayed_events.end(), later);
+
+#ifdef ANALYTICAL_PROFILING
+    // attribute the ticks of each invocation to its callback
+    auto& profiler = EventProfiler::get_thread_profiler();
+#endif
+    const auto invoke = [&](const Callback callback, const CallbackArg callback_arg) {
+#ifdef ANALYTICAL_PROFILING
+        const auto start = EventProfiler::read_ticks();
+        (*callback)(callback_arg);
+        profiler.record_callback(callback, EventProfiler::read_ticks() - start);
+#else
+        (*callback)(callback_arg);
+#endif
+    };
+
+    // invoke the events, the relayed events, and pass the relays of the time, in the order of their positions
+    // any of them may register new ones at this time, which are positioned after it
+    auto& events = event_list->events;
+    auto invoked_events_count = size_t(0);
+    while (true) {
+        while (event_list->invoked_count < events.size() && events[event_list->invoked_count].cancelled()) {
+            event_list->invoked_count++;
+        }
+        while (!current_relayed_events.empty() && !relayed_event_due(current_relayed_events.front())) {
+            std::pop_heap(current_relayed_events.begin(), current_relayed_events.end(), later);
+            current_relayed_events.pop_back();
+        }
+        while (!relay_passes.empty() && !relay_pass_due(relay_passes.front())) {
+            std::pop_heap(relay_passes.begin(), relay_passes.end(), later);
+            relay_passes.pop_back();
+        }
+
+        // find the earliest
+        const auto has_event = event_list->invoked_count < events.size();
+        const auto has_relayed_event = !current_relayed_events.empty();
+        const auto has_relay = !relay_passes.empty() && relay_passes.front().time == event_time;
+        if (!has_event && !has_relayed_event && !has_relay) {
+            break;
+        }
+        auto next_order = EventOrder{no_relayed_event, 0, std::numeric_limits<uint64_t>::max()};
+        if (has_event) {
+            next_order.position = 2 * event_list->get_sequence(event_list->invoked_count);
+        }
+        if (has_relayed_event && (!has_event || precedes(current_relayed_events.front().order, next_order))) {
+            next_order = current_relayed_events.front().order;
+        }
+        if (has_relay && ((!has_event && !has_relayed_event) || precedes(relay_passes.front().order, next_order))) {
+            const auto relay_pass = relay_passes.front();
+            std::pop_heap(relay_passes.begin(), relay_passes.end(), later);
+            relay_passes.pop_back();
+            pass_relay(relay_pass);
+            continue;
+        }
+
+        if (next_order.relayed_event == no_relayed_event) {
+            // copied out, as registration may reallocate the buffer
+            const auto [callback, callback_arg] = events[event_list->invoked_count++].get_handler_arg();
+            invoke(callback, callback_arg);
+        } else {
+            // the relayed event is no longer pending once invoked, and its entry is recycled afterwards
+            const auto id = next_order.relayed_event;
+            std::pop_heap(current_relayed_events.begin(), current_relayed_events.end(), later);
+            current_relayed_events.pop_back();
+            relayed_events[id].event_list = nullptr;
+            invoke(relayed_events[id].callback, relayed_events[id].callback_arg);
+            release_relayed_event(id);
+        }
+        invoked_events_count++;
+    }
+
+#ifdef ANALYTICAL_PROFILING
+    profiler.record_batch(invoked_events_count);
+#endif
+
+    // drop invoked events, keeping the buffers
+    events.clear();
+    event_list->sequences.clear();
+    event_list->relayed_events.clear();
+    event_list->invoked_count = 0;
+    event_list->cancelled_count = 0;
+
+    return invoked_events_count;
+}
+
+void EventQueue::pass_relays(const EventTime time, const bool inclusive) noexcept {
+    const auto later = [this](const RelayPass& lhs, const RelayPass& rhs) { return later_relay_pass(lhs, rhs); };
+    while (!relay_passes.empty()) {
+        const auto relay_pass = relay_passes.front();
+        if (relay_pass.time > time || (!inclusive && relay_pass.time == time)) {
+            break;
+        }
+        std::pop_heap(relay_passes.begin(), relay_passes.end(), later);
+        relay_passes.pop_back();
+        if (!relay_pass_due(relay_pass)) {
+            continue;
+        }
+
+        // the relay would have been invoked at its time
+        current_time = std::max(current_time, relay_pass.time);
+        pass_relay(relay_pass);
+    }
+}
+
+void EventQueue::pass_relay(const RelayPass& relay_pass) noexcept {
+    assert(relay_pass_due(relay_pass));
+
+    // the relay registers the next one (or the relayed event) at this point
+    const auto id = relay_pass.order.relayed_event;
+    auto& relayed_event = relayed_events[id];
+    relayed_event.positions.push_back(2 * next_sequence - 1);
+
+    const auto later = [this](const RelayPass& lhs, const RelayPass& rhs) { return later_relay_pass(lhs, rhs); };
+    const auto next_relay = relay_pass.order.relay + 1;
+    if (next_relay + 1 < relayed_event.times.size()) {
+        relay_passes.push_back({relayed_event.times[next_relay],
+                                {id, next_relay, relayed_event.positions[next_relay]},
+                                relayed_event.generation});
+        std::push_heap(relay_passes.begin(), relay_passes.end(), later);
+    } else if (relayed_event.event_list == current_event_list) {
+        // the relayed event is due at the time being invoked
+        current_relayed_events.push_back(
+            {relayed_event.times.back(), relayed_event_order(id), relayed_event.generation});
+        std::push_heap(current_relayed_events.begin(), current_relayed_events.end(), later);
+    }
+}
+
+bool EventQueue::relay_pass_due(const RelayPass& relay_pass) const noexcept {
+    const auto& relayed_event = relayed_events[relay_pass.order.relayed_event];
+    return relay_pass.generation == relayed_event.generation && relayed_event.event_list != nullptr &&
+           relay_pass.order.relay + 1 < relayed_event.times.size() &&
+           relayed_event.positions.size() == relay_pass.order.relay + 1;
+}
+
+bool EventQueue::precedes(EventOrder lhs, EventOrder rhs) const noexcept {
+    while (lhs.position == rhs.position) {
+        if (lhs.relayed_event == rhs.relayed_event && lhs.relay == rhs.relay) {
+            return false;
+        }
+
+        // relays registered at the same point (between the same events) are registered
+        // in the order of the relays registering them: the earlier first, or the one passed first
+        assert(lhs.relay > 0 && rhs.relay > 0);
+        const auto& lhs_relayed_event = relayed_events[lhs.relayed_event];
+        const auto& rhs_relayed_event = relayed_events[rhs.relayed_event];
+        const auto lhs_time = lhs_relayed_event.times[lhs.relay - 1];
+        const auto rhs_time = rhs_relayed_event.times[rhs.relay - 1];
+        if (lhs_time != rhs_time) {
+            return lhs_time < rhs_time;
+        }
+        lhs = {lhs.relayed_event, lhs.relay - 1, lhs_relayed_event.positions[lhs.relay - 1]};
+        rhs = {rhs.relayed_event, rhs.relay - 1, rhs_relayed_event.positions[rhs.relay - 1]};
+    }
+
+    return lhs.position < rhs.position;
+}
+
+bool EventQueue::later_relay_pass(const RelayPass& lhs, const RelayPass& rhs) const noexcept {
+    if (lhs.time != rhs.time) {
+        return lhs.time > rhs.time;
+    }
+    return precedes(rhs.order, lhs.order);
+}
+
+EventQueue::EventOrder EventQueue::relayed_event_order(const uint32_t id) const noexcept {
+    const auto& relayed_event = relayed_events[id];
+    assert(relayed_event.positions.size() == relayed_event.times.size());
+
+    const auto relay = static_cast<uint32_t>(relayed_event.times.size() - 1);
+    return {id, relay, relayed_event.positions.back()};
+}
+
+void EventQueue::unlink_relayed_event(const uint32_t id) noexcept {
+    auto& relayed_event = relayed_events[id];
+    auto* const event_list = relayed_event.event_list;
+    assert(event_list != nullptr);
+
+    auto& relayed_ids = event_list->relayed_events;
+    const auto position = std::find(relayed_ids.begin(), relayed_ids.end(), id);
+    assert(position != relayed_ids.end());
+    *position = relayed_ids.back();
+    relayed_ids.pop_back();
+    relayed_event.event_list = nullptr;
+
+    // drop the time once nothing is left to invoke, unless it's being invoked
+    if (event_list != current_event_list && event_list->all_events_cancelled()) {
+        drop_event_list(event_list);
+    }
+}
+
+EventHandle EventQueue::link_relayed_event(const uint32_t id) noexcept {
+    auto& relayed_event = relayed_events[id];
+    assert(relayed_event.event_list == nullptr);
+
+    auto* const event_list = find_or_insert_event_list(relayed_event.times.back());
+    event_list->relayed_events.push_back(id);
+    relayed_event.event_list = event_list;
+
+    // a resolved event due at the time being invoked is interleaved right away
+    if (event_list == current_event_list && relayed_event.positions.size() == relayed_event.times.size()) {
+        current_relayed_events.push_back(
+            {relayed_event.times.back(), relayed_event_order(id), relayed_event.generation});
+        std::push_heap(current_relayed_events.begin(), current_relayed_events.end(),
+                       [this](const RelayPass& lhs, const RelayPass& rhs) { return later_relay_pass(lhs, rhs); });
+    }
+
+    return {event_list, id, relayed_event.generation, true};
+}
+
+void EventQueue::release_relayed_event(const uint32_t id) noexcept {
+    auto& relayed_event = relayed_events[id];
+    assert(relayed_event.event_list == nullptr);
+
+    // stale handles and passes are told apart by the generation
+    relayed_event.generation++;
+    relayed_event.times.clear();
+    relayed_event.positions.clear();
+    free_relayed_events.push_back(id);
 }
@@ -0,0 +1,479 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkConfig.h"
+#include "common/Hash.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+    /**
+     * Given a yaml node whose type is list of type T,
+     * Read the value from the node and create a std::vector<T>.
+     *
+     * @tparam T type of the element to be read
+     * @param network_config parsed YAML node of the network configuration
+     * @param key key of the list to read
+     * @param parsed_vector set to the read elements
+     * @param error set to the error message if reading fails
+     * @return true if the list is read, false otherwise
+     */
+    template <typename T>
+    [[nodiscard]] bool parse_vector(const YAML::Node& network_config,
+                                    const std::string& key,
+                                    std::vector<T>& parsed_vector,
+                                    std::string& error) noexcept {
+        const auto node = network_config[key];
+        if (!node.IsSequence()) {
+            error = "\"" + key + "\" should be a list";
+            return false;
+        }
+
+        // try to read each element
+        parsed_vector.clear();
+        for (const auto& element : node) {
+            try {
+                // read an element in type T
+                parsed_vector.push_back(element.as<T>());
+            } catch (const YAML::BadConversion& e) {
+                // error reading an element as type T
+                error = "\"" + key + "\": " + e.what();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Parse the given YAML node and retrieve network configuration values.
+     *
+     * @param network_config opened and parsed YAML node
+     * @param config set to the retrieved values
+     * @param error set to the error message if parsing fails
+     * @return true if the values are retrieved, false otherwise
+     */
+    [[nodiscard]] bool parse_network_config_yml(const YAML::Node& network_config,
+                                                NetworkConfig& config,
+                                                std::string& error) noexcept {
+        // parse the list of each key
+        auto topology_names = std::vector<std::string>();
+        auto npus_count_per_dim = std::vector<int>();
+        auto bandwidth_per_dim = std::vector<Bandwidth>();
+        auto latency_per_dim = std::vector<Latency>();
+        if (!parse_vector(network_config, "topology", topology_names, error) ||
+            !parse_vector(network_config, "npus_count", npus_count_per_dim, error) ||
+            !parse_vector(network_config, "bandwidth", bandwidth_per_dim, error) ||
+            !parse_vector(network_config, "latency", latency_per_dim, error)) {
+            return false;
+        }
+
+        // dims_count should match
+        const auto dims_count = topology_names.size();
+        if (dims_count != npus_count_per_dim.size()) {
+            error = "length of npus_count (" + std::to_string(npus_count_per_dim.size()) +
+                    ") doesn't match with dimensions (" + std::to_string(dims_count) + ")";
+            return false;
+        }
+        if (dims_count != bandwidth_per_dim.size()) {
+            error = "length of bandwidth (" + std::to_string(bandwidth_per_dim.size()) +
+                    ") doesn't match with dims_count (" + std::to_string(dims_count) + ")";
+            return false;
+        }
+        if (dims_count != latency_per_dim.size()) {
+            error = "length of latency (" + std::to_string(latency_per_dim.size()) +
+                    ") doesn't match with dims_count (" + std::to_string(dims_count) + ")";
+            return false;
+        }
+
+        // append every dimension
+        for (auto dim = size_t(0); dim < dims_count; dim++) {
+            const auto topology = NetworkConfig::parse_topology_name(topology_names[dim]);
+            if (topology == TopologyBuildingBlock::Undefined) {
+                error = "Topology name " + topology_names[dim] + " not supported";
+                return false;
+            }
+            config.add_dimension(topology, npus_count_per_dim[dim], bandwidth_per_dim[dim], latency_per_dim[dim]);
+        }
+
+        // FatTree shapes are optional
+        for (const auto& key : {std::string("radix"), std::string("oversubscription")}) {
+            if (!network_config[key]) {
+                continue;
+            }
+
+            auto values_per_dim = std::vector<int>();
+            if (!parse_vector(network_config, key, values_per_dim, error)) {
+                return false;
+            }
+            if (dims_count != values_per_dim.size()) {
+                error = "length of " + key + " (" + std::to_string(values_per_dim.size()) +
+                        ") doesn't match with dims_count (" + std::to_string(dims_count) + ")";
+                return false;
+            }
+
+            for (auto dim = 0; dim < static_cast<int>(dims_count); dim++) {
+                const auto radix = (key == "radix") ? values_per_dim[dim] : config.get_radixes_per_dim()[dim];
+                const auto oversubscription =
+                    (key == "oversubscription") ? values_per_dim[dim] : config.get_oversubscriptions_per_dim()[dim];
+                config.set_fat_tree(dim, radix, oversubscription);
+            }
+        }
+
+        // Torus and Mesh shapes are optional
+        if (network_config["shape"]) {
+            auto shape_per_dim = std::vector<std::vector<int>>();
+            if (!parse_vector(network_config, "shape", shape_per_dim, error)) {
+                return false;
+            }
+            if (dims_count != shape_per_dim.size()) {
+                error = "length of shape (" + std::to_string(shape_per_dim.size()) +
+                        ") doesn't match with dims_count (" + std::to_string(dims_count) + ")";
+                return false;
+            }
+
+            for (auto dim = 0; dim < static_cast<int>(dims_count); dim++) {
+                config.set_shape(dim, shape_per_dim[dim]);
+            }
+        }
+
+        // fidelities are optional
+        if (network_config["fidelity"]) {
+            auto fidelity_names = std::vector<std::string>();
+            if (!parse_vector(network_config, "fidelity", fidelity_names, error)) {
+                return false;
+            }
+            if (dims_count != fidelity_names.size()) {
+                error = "length of fidelity (" + std::to_string(fidelity_names.size()) +
+                        ") doesn't match with dims_count (" + std::to_string(dims_count) + ")";
+                return false;
+            }
+
+            for (auto dim = 0; dim < static_cast<int>(dims_count); dim++) {
+                if (fidelity_names[dim] == "aware") {
+                    config.set_fidelity(dim, DimensionFidelity::CongestionAware);
+                } else if (fidelity_names[dim] == "unaware") {
+                    config.set_fidelity(dim, DimensionFidelity::CongestionUnaware);
+                } else {
+                    error = "Fidelity name " + fidelity_names[dim] + " not supported";
+                    return false;
+                }
+            }
+        }
+
+        // check the validity of the parsed network config
+        error = config.validate();
+        return error.empty();
+    }
+
+}  // namespace
+
+NetworkConfig::NetworkConfig() noexcept {
+    // initialize values
+    npus_count_per_dim = {};
+    bandwidth_per_dim = {};
+    latency_per_dim = {};
+    topology_per_dim = {};
+    radix_per_dim = {};
+    oversubscription_per_dim = {};
+    shape_per_dim = {};
+    fidelity_per_dim = {};
+}
+
+std::optional<NetworkConfig> NetworkConfig::parse_yaml(const std::string& yaml, std::string& error) noexcept {
+    auto config = NetworkConfig();
+
+    try {
+        // parse the network config
+        const auto network_config = YAML::Load(yaml);
+        if (!parse_network_config_yml(network_config, config, error)) {
+            return std::nullopt;
+        }
+    } catch (const YAML::Exception& e) {
+        // ill-formed YAML
+        error = e.what();
+        return std::nullopt;
+    }
+
+    return config;
+}
+
+std::optional<NetworkConfig> NetworkConfig::load_yaml_file(const std::string& path, std::string& error) noexcept {
+    auto config = NetworkConfig();
+
+    try {
+        // load network config file
+        const auto network_config = YAML::LoadFile(path);
+        if (!parse_network_config_yml(network_config, config, error)) {
+            return std::nullopt;
+        }
+    } catch (const YAML::Exception& e) {
+        // loading network config file failed
+        error = e.what();
+        return std::nullopt;
+    }
+
+    return config;
+}
+
+TopologyBuildingBlock NetworkConfig::parse_topology_name(const std::string& topology_name) noexcept {
+    if (topology_name == "Ring") {
+        return TopologyBuildingBlock::Ring;
+    }
+
+    if (topology_name == "FullyConnected") {
+        return TopologyBuildingBlock::FullyConnected;
+    }
+
+    if (topology_name == "Switch") {
+        return TopologyBuildingBlock::Switch;
+    }
+
+    if (topology_name == "FatTree") {
+        return TopologyBuildingBlock::FatTree;
+    }
+
+    if (topology_name == "Torus") {
+        return TopologyBuildingBlock::Torus;
+    }
+
+    if (topology_name == "Mesh") {
+        return TopologyBuildingBlock::Mesh;
+    }
+
+    // not supported
+    return TopologyBuildingBlock::Undefined;
+}
+
+NetworkConfig& NetworkConfig::add_dimension(const TopologyBuildingBlock topology,
+                                            const int npus_count,
+                                            const Bandwidth bandwidth,
+                                            const Latency latency) noexcept {
+    topology_per_dim.push_back(topology);
+    npus_count_per_dim.push_back(npus_count);
+    bandwidth_per_dim.push_back(bandwidth);
+    latency_per_dim.push_back(latency);
+    radix_per_dim.push_back(0);
+    oversubscription_per_dim.push_back(1);
+    shape_per_dim.emplace_back();
+    fidelity_per_dim.push_back(DimensionFidelity::CongestionAware);
+
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_npus_count(const int dim, const int npus_count) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    npus_count_per_dim[dim] = npus_count;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_bandwidth(const int dim, const Bandwidth bandwidth) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    bandwidth_per_dim[dim] = bandwidth;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_latency(const int dim, const Latency latency) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    latency_per_dim[dim] = latency;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_fat_tree(const int dim, const int radix, const int oversubscription) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    radix_per_dim[dim] = radix;
+    oversubscription_per_dim[dim] = oversubscription;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_shape(const int dim, const std::vector<int>& shape) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    shape_per_dim[dim] = shape;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_fidelity(const int dim, const DimensionFidelity fidelity) noexcept {
+    assert(0 <= dim && dim < get_dims_count());
+
+    fidelity_per_dim[dim] = fidelity;
+    return *this;
+}
+
+std::string NetworkConfig::validate() const noexcept {
+    // there should be at least one dimension
+    if (topology_per_dim.empty()) {
+        return "network should have at least one dimension";
+    }
+
+    for (auto dim = 0; dim < get_dims_count(); dim++) {
+        // topology should be a supported building block
+        if (topology_per_dim[dim] == TopologyBuildingBlock::Undefined) {
+            return "topology of dimension " + std::to_string(dim) + " is undefined";
+        }
+
+        // npus_count should be all positive
+        if (npus_count_per_dim[dim] <= 1) {
+            return "npus_count (" + std::to_string(npus_count_per_dim[dim]) + ") should be larger than 1";
+        }
+
+        // bandwidths should be all positive
+        if (!(bandwidth_per_dim[dim] > 0)) {
+            auto message = std::ostringstream();
+            message << "bandwidth (" << bandwidth_per_dim[dim] << ") should be larger than 0";
+            return message.str();
+        }
+
+        // latency should be non-negative
+        if (!(latency_per_dim[dim] >= 0)) {
+            auto message = std::ostringstream();
+            message << "latency (" << latency_per_dim[dim] << ") should be non-negative";
+            return message.str();
+        }
+
+        // FatTree should be shaped by its radix
+        if (topology_per_dim[dim] == TopologyBuildingBlock::FatTree) {
+            const auto radix = radix_per_dim[dim];
+            if (radix < 2) {
+                return "radix (" + std::to_string(radix) + ") of FatTree dimension " + std::to_string(dim) +
+                       " should be larger than 1";
+            }
+
+            auto leaves_count = npus_count_per_dim[dim];
+            while (leaves_count % radix == 0) {
+                leaves_count /= radix;
+            }
+            if (leaves_count != 1) {
+                return "npus_count (" + std::to_string(npus_count_per_dim[dim]) + ") of FatTree dimension " +
+                       std::to_string(dim) + " should be a power of radix (" + std::to_string(radix) + ")";
+            }
+
+            const auto oversubscription = oversubscription_per_dim[dim];
+            if (oversubscription < 1 || radix % oversubscription != 0) {
+                return "oversubscription (" + std::to_string(oversubscription) + ") of FatTree dimension " +
+                       std::to_string(dim) + " should divide radix (" + std::to_string(radix) + ")";
+            }
+        }
+
+        // sides of Torus and Mesh should multiply up to npus_count
+        if (topology_per_dim[dim] == TopologyBuildingBlock::Torus ||
+            topology_per_dim[dim] == TopologyBuildingBlock::Mesh) {
+            if (shape_per_dim[dim].empty()) {
+                continue;
+            }
+
+            auto shape_npus_count = int64_t(1);
+            for (const auto side : shape_per_dim[dim]) {
+                if (side <= 1) {
+                    return "side (" + std::to_string(side) + ") of dimension " + std::to_string(dim) +
+                           " should be larger than 1";
+                }
+                shape_npus_count *= side;
+            }
+            if (shape_npus_count != npus_count_per_dim[dim]) {
+                return "sides of dimension " + std::to_string(dim) + " multiply to " +
+                       std::to_string(shape_npus_count) + ", not npus_count (" +
+                       std::to_string(npus_count_per_dim[dim]) + ")";
+            }
+        }
+    }
+
+    // valid
+    return "";
+}
+
+std::string NetworkConfig::validate(const std::vector<TopologyBuildingBlock>& supported_topologies,
+                                    const int max_dims_count) const noexcept {
+    if (auto error = validate(); !error.empty()) {
+        return error;
+    }
+
+    // the backend should support the number of dimensions
+    if (max_dims_count > 0 && get_dims_count() > max_dims_count) {
+        return "dims_count (" + std::to_string(get_dims_count()) + ") should be at most " +
+               std::to_string(max_dims_count) + " for this backend";
+    }
+
+    // the backend should support the building block of every dimension
+    for (auto dim = 0; dim < get_dims_count(); dim++) {
+        if (std::find(supported_topologies.begin(), supported_topologies.end(), topology_per_dim[dim]) ==
+            supported_topologies.end()) {
+            return "topology of dimension " + std::to_string(dim) + " is not supported by this backend";
+        }
+    }
+
+    // valid
+    return "";
+}
+
+uint64_t NetworkConfig::hash() const noexcept {
+    auto hash = fnv1a_offset_basis;
+
+    // every value of each dimension, in order
+    const auto dims_count = get_dims_count();
+    hash_value(hash, dims_count);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        hash_value(hash, topology_per_dim[dim]);
+        hash_value(hash, npus_count_per_dim[dim]);
+        hash_value(hash, bandwidth_per_dim[dim]);
+        hash_value(hash, latency_per_dim[dim]);
+        hash_value(hash, radix_per_dim[dim]);
+        hash_value(hash, oversubscription_per_dim[dim]);
+        hash_value(hash, fidelity_per_dim[dim]);
+
+        // the shape is variable-length, so its length is hashed as well
+        hash_value(hash, shape_per_dim[dim].size());
+        for (const auto side : shape_per_dim[dim]) {
+            hash_value(hash, side);
+        }
+    }
+    return hash;
+}
+
+int NetworkConfig::get_dims_count() const noexcept {
+    return static_cast<int>(topology_per_dim.size());
+}
+
+const std::vector<int>& NetworkConfig::get_npus_counts_per_dim() const noexcept {
+    return npus_count_per_dim;
+}
+
+const std::vector<Bandwidth>& NetworkConfig::get_bandwidths_per_dim() const noexcept {
+    return bandwidth_per_dim;
+}
+
+const std::vector<Latency>& NetworkConfig::get_latencies_per_dim() const noexcept {
+    return latency_per_dim;
+}
+
+const std::vector<TopologyBuildingBlock>& NetworkConfig::get_topologies_per_dim() const noexcept {
+    return topology_per_dim;
+}
+
+const std::vector<int>& NetworkConfig::get_radixes_per_dim() const noexcept {
+    return radix_per_dim;
+}
+
+const std::vector<int>& NetworkConfig::get_oversubscriptions_per_dim() const noexcept {
+    return oversubscription_per_dim;
+}
+
+const std::vector<std::vector<int>>& NetworkConfig::get_shapes_per_dim() const noexcept {
+    return shape_per_dim;
+}
+
+const std::vector<DimensionFidelity>& NetworkConfig::get_fidelities_per_dim() const noexcept {
+    return fidelity_per_dim;
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FatTree.h"
+#include <cassert>
+#include <cstdint>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /**
+     * Compute the number of parallel switches per subtree of each level, indexed by level (index 0 unused).
+     *
+     * @param npus_count number of NPUs, a power of radix
+     * @param radix number of down ports of each switch
+     * @param oversubscription ratio of the down ports to the up ports of each leaf switch
+     * @return widths per level
+     */
+    [[nodiscard]] std::vector<int> compute_widths(const int npus_count,
+                                                  const int radix,
+                                                  const int oversubscription) noexcept {
+        assert(radix >= 2);
+        assert(oversubscription >= 1 && radix % oversubscription == 0);
+
+        // the leaf level is a single switch per subtree, and each leaf has radix / oversubscription up ports
+        auto widths = std::vector<int>{0};
+        auto width = 1;
+        for (auto subtree_size = int64_t(radix); subtree_size <= npus_count; subtree_size *= radix) {
+            widths.push_back(width);
+            width *= (widths.size() == 2) ? (radix / oversubscription) : radix;
+        }
+
+        // npus_count should be a power of radix
+        assert(widths.size() >= 2);
+        return widths;
+    }
+
+    /**
+     * Compute the number of switches.
+     *
+     * @param npus_count number of NPUs, a power of radix
+     * @param radix number of down ports of each switch
+     * @param oversubscription ratio of the down ports to the up ports of each leaf switch
+     * @return number of switches
+     */
+    [[nodiscard]] int compute_switches_count(const int npus_count,
+                                             const int radix,
+                                             const int oversubscription) noexcept {
+        const auto widths = compute_widths(npus_count, radix, oversubscription);
+
+        // each level has (npus_count / radix^level) subtrees
+        auto switches_count = 0;
+        auto subtrees_count = npus_count;
+        for (auto level = 1; level < static_cast<int>(widths.size()); level++) {
+            subtrees_count /= radix;
+            switches_count += subtrees_count * widths[level];
+        }
+        return switches_count;
+    }
+
+    /**
+     * Hash a (src, dest) pair to choose among the equal-cost paths, so that every flow keeps its path.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return hash of the pair
+     */
+    [[nodiscard]] uint64_t hash_flow(const DeviceId src, const DeviceId dest) noexcept {
+        // splitmix64 finalizer
+        auto hash = (static_cast<uint64_t>(src) << 32) ^ static_cast<uint64_t>(dest);
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        return hash ^ (hash >> 31);
+    }
+
+}  // namespace
+
+FatTree::FatTree(const int npus_count,
+                 const Bandwidth bandwidth,
+                 const Latency latency,
+                 const int radix,
+                 const int oversubscription) noexcept
+    : BasicTopology(npus_count, npus_count + compute_switches_count(npus_count, radix, oversubscription), bandwidth,
+                    latency),
+      radix(radix) {
+    assert(npus_count >= radix);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set topology type
+    basic_topology_type = TopologyBuildingBlock::FatTree;
+
+    // lay out the levels
+    widths_per_level = compute_widths(npus_count, radix, oversubscription);
+    levels_count = static_cast<int>(widths_per_level.size()) - 1;
+    offsets_per_level = std::vector<int>(levels_count + 1, 0);
+    for (auto level = 1, subtrees_count = npus_count / radix; level < levels_count; level++, subtrees_count /= radix) {
+        offsets_per_level[level + 1] = offsets_per_level[level] + subtrees_count * widths_per_level[level];
+    }
+
+    // connect each npu to its leaf switch, the link should be bidirectional
+    for (auto npu = 0; npu < npus_count; npu++) {
+        connect(npu, get_switch_id(1, npu / radix, 0), bandwidth, latency, true);
+    }
+
+    // connect each switch to the switches of the parent subtree:
+    // switch y connects to the switches y + W_level * j of the upper level
+    for (auto level = 1, subtrees_count = npus_count / radix; level < levels_count; level++, subtrees_count /= radix) {
+        const auto width = widths_per_level[level];
+        const auto uplinks_count = widths_per_level[level + 1] / width;
+
+        for (auto subtree = 0; subtree < subtrees_count; subtree++) {
+            for (auto index = 0; index < width; index++) {
+                const auto switch_id = get_switch_id(level, subtree, index);
+                for (auto j = 0; j < uplinks_count; j++) {
+                    const auto parent_id = get_switch_id(level + 1, subtree / radix, index + width * j);
+                    connect(switch_id, parent_id, bandwidth, latency, true);
+                }
+            }
+        }
+    }
+}
+
+int FatTree::get_levels_count() const noexcept {
+    return levels_count;
+}
+
+DeviceId FatTree::get_switch_id(const int level, const int subtree, const int index) const noexcept {
+    assert(1 <= level && level <= levels_count);
+    assert(0 <= index && index < widths_per_level[level]);
+
+    return npus_count + offsets_per_level[level] + subtree * widths_per_level[level] + index;
+}
+
+Route FatTree::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // find the lowest common level
+    auto top_level = 1;
+    for (auto src_subtree = src / radix, dest_subtree = dest / radix; src_subtree != dest_subtree; top_level++) {
+        src_subtree /= radix;
+        dest_subtree /= radix;
+    }
+
+    // choose the top switch by the flow hash
+    const auto path_index = static_cast<int>(hash_flow(src, dest) % widths_per_level[top_level]);
+
+    // construct route
+    // go up from src to the top switch, then go down to dest
+    auto route = Route(*this);
+    route.push_back(src);
+
+    auto subtree = src;
+    for (auto level = 1; level <= top_level; level++) {
+        subtree /= radix;
+        route.push_back(get_switch_id(level, subtree, path_index % widths_per_level[level]));
+    }
+
+    // the subtree of dest at a level is dest / radix^level
+    auto subtree_size = 1;
+    for (auto level = 1; level < top_level; level++) {
+        subtree_size *= radix;
+    }
+    for (auto level = top_level - 1; level >= 1; level--) {
+        route.push_back(get_switch_id(level, dest / subtree_size, path_index % widths_per_level[level]));
+        subtree_size /= radix;
+    }
+
+    route.push_back(dest);
+    return route;
+}
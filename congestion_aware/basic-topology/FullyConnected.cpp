@@ -8,7 +8,10 @@ LICENSE file in the root directory of this source tree.
 
 using namespace NetworkAnalyticalCongestionAware;
 
-FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
+FullyConnected::FullyConnected(const int npus_count,
+                               const Bandwidth bandwidth,
+                               const Latency latency,
+                               const bool lazy) noexcept
     : BasicTopology(npus_count, npus_count, bandwidth, latency) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
@@ -17,6 +20,12 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
     // set topology type
     basic_topology_type = TopologyBuildingBlock::FullyConnected;
 
+    // create the links on first use
+    if (lazy) {
+        enable_lazy_links(npus_count * (npus_count - 1), bandwidth, latency);
+        return;
+    }
+
     // fully-connect every src-dest pairs
     for (auto src = 0; src < npus_count; src++) {
         for (auto dest = 0; dest < npus_count; dest++) {
@@ -27,16 +36,33 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
     }
 }
 
-Route FullyConnected::route(const DeviceId src, const DeviceId dest) const noexcept {
+Route FullyConnected::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
     // construct route
     // directly connected
-    auto route = Route();
-    route.push_back(devices[src]);
-    route.push_back(devices[dest]);
+    auto route = Route(*this);
+    route.push_back(src);
+    route.push_back(dest);
 
     return route;
 }
+
+LinkId FullyConnected::compute_lazy_link_id(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // same order as the links connected upfront
+    return (src * (npus_count - 1)) + ((dest < src) ? dest : (dest - 1));
+}
+
+std::pair<DeviceId, DeviceId> FullyConnected::compute_lazy_link_devices(const LinkId id) const noexcept {
+    assert(0 <= id && id < npus_count * (npus_count - 1));
+
+    const auto src = id / (npus_count - 1);
+    const auto offset = id % (npus_count - 1);
+    return {src, (offset < src) ? offset : (offset + 1)};
+}
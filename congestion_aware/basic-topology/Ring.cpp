@@ -14,20 +14,27 @@ Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latenc
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // set topology type
+    basic_topology_type = TopologyBuildingBlock::Ring;
+
     // connect npus in a ring
     for (auto i = 0; i < npus_count - 1; i++) {
         connect(i, i + 1, bandwidth, latency, bidirectional);
     }
-    connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+
+    // close the ring, unless a bidirectional 2-NPU ring is already closed
+    if (!(bidirectional && npus_count == 2)) {
+        connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+    }
 }
 
-Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
+Route Ring::compute_route(DeviceId src, DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
     // construct empty route
-    auto route = Route();
+    auto route = Route(*this);
 
     auto step = 1;  // default direction: clockwise
     if (bidirectional) {
@@ -48,7 +55,7 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
     auto current = src;
     while (current != dest) {
         // traverse the ring until reaches dest
-        route.push_back(devices[current]);
+        route.push_back(current);
         current = (current + step);
 
         // wrap around
@@ -60,7 +67,7 @@ Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
     }
 
     // arrives at dest
-    route.push_back(devices[dest]);
+    route.push_back(dest);
 
     // return the constructed route
     return route;
@@ -16,6 +16,9 @@ Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency la
     assert(bandwidth > 0);
     assert(latency >= 0);
 
+    // set topology type
+    basic_topology_type = TopologyBuildingBlock::Switch;
+
     // set switch id
     switch_id = npus_count;
 
@@ -25,17 +28,17 @@ Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency la
     }
 }
 
-Route Switch::route(DeviceId src, DeviceId dest) const noexcept {
+Route Switch::compute_route(DeviceId src, DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
     // construct route
     // start at source, and go to switch, then go to destination
-    auto route = Route();
-    route.push_back(devices[src]);
-    route.push_back(devices[switch_id]);
-    route.push_back(devices[dest]);
+    auto route = Route(*this);
+    route.push_back(src);
+    route.push_back(switch_id);
+    route.push_back(dest);
 
     return route;
 }
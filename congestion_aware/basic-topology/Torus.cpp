@@ -0,0 +1,164 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Torus.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Torus::Torus(const int npus_count,
+             const Bandwidth bandwidth,
+             const Latency latency,
+             const std::vector<int>& shape,
+             const bool wraparound) noexcept
+    : BasicTopology(npus_count, npus_count, bandwidth, latency),
+      shape(shape.empty() ? std::vector<int>{npus_count} : shape),
+      wraparound(wraparound) {
+    assert(npus_count > 1);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set topology type
+    basic_topology_type = wraparound ? TopologyBuildingBlock::Torus : TopologyBuildingBlock::Mesh;
+
+    // side i is strided by the product of the lower sides
+    const auto sides_count = static_cast<int>(this->shape.size());
+    auto stride = 1;
+    for (const auto side : this->shape) {
+        assert(side > 1);
+        strides.push_back(stride);
+        stride *= side;
+    }
+    assert(stride == npus_count);
+
+    // links of each (side, direction) take a contiguous range of ids:
+    // every NPU has the link if the side wraps around, otherwise every NPU but the last of the side
+    link_offsets.push_back(0);
+    for (auto side = 0; side < sides_count; side++) {
+        const auto length = this->shape[side];
+        const auto links_count = wraps_around(side) ? npus_count : (npus_count / length) * (length - 1);
+        link_offsets.push_back(link_offsets.back() + links_count);
+        link_offsets.push_back(link_offsets.back() + links_count);
+    }
+
+    // create the links on first use
+    enable_lazy_links(link_offsets.back(), bandwidth, latency);
+}
+
+const std::vector<int>& Torus::get_shape() const noexcept {
+    return shape;
+}
+
+bool Torus::wraps_around(const int side) const noexcept {
+    // a side of 2 is a single link, either way
+    return wraparound && shape[side] > 2;
+}
+
+Route Torus::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // construct route
+    auto route = Route(*this);
+    route.push_back(src);
+
+    // align the sides in order
+    auto current = src;
+    for (auto side = 0; side < static_cast<int>(shape.size()); side++) {
+        const auto length = shape[side];
+        const auto stride = strides[side];
+        auto coordinate = (current / stride) % length;
+        const auto dest_coordinate = (dest / stride) % length;
+        if (coordinate == dest_coordinate) {
+            continue;
+        }
+
+        // forward if it's the shorter way around (or the only way, on a Mesh)
+        auto forward = (dest_coordinate > coordinate);
+        if (wraps_around(side)) {
+            const auto forward_distance = (dest_coordinate - coordinate + length) % length;
+            forward = (forward_distance <= length - forward_distance);
+        }
+
+        // hop along the side
+        while (coordinate != dest_coordinate) {
+            const auto next_coordinate = forward ? (coordinate + 1) % length : (coordinate - 1 + length) % length;
+            current += (next_coordinate - coordinate) * stride;
+            coordinate = next_coordinate;
+            route.push_back(current);
+        }
+    }
+
+    assert(current == dest);
+    return route;
+}
+
+LinkId Torus::compute_lazy_link_id(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // find the side the neighbors differ in
+    for (auto side = 0; side < static_cast<int>(shape.size()); side++) {
+        const auto length = shape[side];
+        const auto stride = strides[side];
+        const auto coordinate = (src / stride) % length;
+        const auto dest_coordinate = (dest / stride) % length;
+        if (coordinate == dest_coordinate) {
+            continue;
+        }
+
+        // without the wraparound, a side of 2 steps forward from 0 to 1 only
+        const auto forward =
+            wraps_around(side) ? (dest_coordinate == (coordinate + 1) % length) : (dest_coordinate > coordinate);
+        assert(forward ? (dest_coordinate == (coordinate + 1) % length)
+                       : (dest_coordinate == (coordinate - 1 + length) % length));
+        const auto offset = link_offsets[(2 * side) + (forward ? 0 : 1)];
+
+        // wraparound: every NPU has the link
+        if (wraps_around(side)) {
+            return offset + src;
+        }
+
+        // otherwise, index by the forward link of the side, skipping the last NPU of each line
+        const auto forward_src = forward ? src : dest;
+        const auto line_size = stride * length;
+        return offset + ((forward_src / line_size) * (line_size - stride)) + (forward_src % line_size);
+    }
+
+    // shouldn't reach here: src and dest should be neighbors
+    assert(false);
+    return -1;
+}
+
+std::pair<DeviceId, DeviceId> Torus::compute_lazy_link_devices(const LinkId id) const noexcept {
+    assert(0 <= id && id < link_offsets.back());
+
+    // find the (side, direction) the link belongs to
+    auto block = 0;
+    while (id >= link_offsets[block + 1]) {
+        block++;
+    }
+    const auto side = block / 2;
+    const auto forward = (block % 2 == 0);
+    const auto length = shape[side];
+    const auto stride = strides[side];
+    const auto index = id - link_offsets[block];
+
+    // wraparound: indexed by the src NPU
+    if (wraps_around(side)) {
+        const auto coordinate = (index / stride) % length;
+        const auto next_coordinate = forward ? (coordinate + 1) % length : (coordinate - 1 + length) % length;
+        return {index, index + ((next_coordinate - coordinate) * stride)};
+    }
+
+    // otherwise, indexed by the forward link of the side
+    const auto line_size = stride * length;
+    const auto forward_src = ((index / (line_size - stride)) * line_size) + (index % (line_size - stride));
+    if (forward) {
+        return {forward_src, forward_src + stride};
+    }
+    return {forward_src + stride, forward_src};
+}
@@ -0,0 +1,374 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Collective.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+void Collective::chunk_arrived(void* const step_arrival) noexcept {
+    assert(step_arrival != nullptr);
+
+    // typecast step_arrival
+    const auto* const arrival = static_cast<const StepArrival*>(step_arrival);
+    auto* const collective = arrival->collective;
+    const auto steps_count = collective->get_steps_count();
+
+    // count the arrival, which stands for the arrival at every NPU if reduced
+    const auto reduced = (collective->orbit_topology != nullptr);
+    collective->received_chunks[arrival->npu * steps_count + arrival->step]++;
+    collective->arrived_chunks_count += reduced ? collective->npus_count : 1;
+
+    // the NPU has received every chunk
+    if (--collective->pending_chunks[arrival->npu] == 0) {
+        const auto finish_time = collective->event_queue->get_current_time();
+        if (reduced) {
+            std::fill(collective->npu_finish_times.begin(), collective->npu_finish_times.end(), finish_time);
+        } else {
+            collective->npu_finish_times[arrival->npu] = finish_time;
+        }
+    }
+
+    // invoke the callback if the collective is finished
+    if (collective->finished()) {
+        collective->finish();
+        return;
+    }
+
+    // the NPU may start its next step
+    collective->proceed(arrival->npu);
+}
+
+void Collective::cached_result_arrived(void* const collective) noexcept {
+    assert(collective != nullptr);
+
+    // every chunk has arrived, as cached
+    auto* const cached_collective = static_cast<Collective*>(collective);
+    cached_collective->arrived_chunks_count = cached_collective->chunks_count;
+    cached_collective->finish();
+}
+
+Collective::Collective(Topology* const topology,
+                       const CollectiveType type,
+                       const CollectiveAlgorithm algorithm,
+                       const ChunkSize size,
+                       const Callback callback,
+                       const CallbackArg callback_arg) noexcept
+    : topology(topology),
+      type(type),
+      algorithm(algorithm),
+      size(size),
+      event_queue(nullptr),
+      symmetry_reduction(false),
+      result_cache(nullptr),
+      result_key(0),
+      result_cached(false),
+      local_npus_begin(0),
+      local_npus_end(0),
+      start_time(0),
+      chunks_count(0),
+      arrived_chunks_count(0),
+      callback(callback),
+      callback_arg(callback_arg) {
+    assert(topology != nullptr);
+    assert(callback != nullptr);
+
+    npus_count = topology->get_npus_count();
+    assert(npus_count > 0);
+    local_npus_end = npus_count;
+
+    // the buffer should be large enough to be split into shards
+    const auto shard_size = size / npus_count;
+    if (shard_size == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "collective size should be at least the number of NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    // halving-doubling pairs NPUs by their id bits
+    if (algorithm == CollectiveAlgorithm::HalvingDoubling && (npus_count & (npus_count - 1)) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "halving-doubling collective requires a power-of-2 number of NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    // expand the collective into steps
+    if (type == CollectiveType::AllReduce) {
+        append_steps(CollectiveType::ReduceScatter, algorithm, shard_size);
+        append_steps(CollectiveType::AllGather, algorithm, shard_size);
+    } else {
+        append_steps(type, algorithm, shard_size);
+    }
+
+    // count the chunks each NPU receives at each step
+    const auto steps_count = get_steps_count();
+    expected_chunks.resize(npus_count * steps_count, 0);
+    received_chunks.resize(npus_count * steps_count, 0);
+    pending_chunks.resize(npus_count, 0);
+    for (auto step = 0; step < steps_count; step++) {
+        for (auto npu = 0; npu < npus_count; npu++) {
+            for (const auto dest : steps[step].peers[npu]) {
+                expected_chunks[dest * steps_count + step]++;
+                pending_chunks[dest]++;
+                chunks_count++;
+            }
+        }
+    }
+    npu_finish_times.resize(npus_count, 0);
+
+    // callback arguments of every (npu, step) pair
+    step_arrivals.reserve(npus_count * steps_count);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        for (auto step = 0; step < steps_count; step++) {
+            step_arrivals.push_back({this, npu, step});
+        }
+    }
+
+    next_steps.resize(npus_count, 0);
+}
+
+void Collective::start() noexcept {
+    // nothing to communicate
+    if (finished()) {
+        (*callback)(callback_arg);
+        return;
+    }
+
+    event_queue = topology->get_event_queue().get();
+    assert(event_queue != nullptr);
+    start_time = event_queue->get_current_time();
+
+    // replay the cached result instead of simulating
+    if (result_cache != nullptr && all_npus_local()) {
+        const auto result = result_cache->find(result_key);
+        if (result.has_value() && result->npu_durations.size() == static_cast<size_t>(npus_count)) {
+            for (auto npu = 0; npu < npus_count; npu++) {
+                npu_finish_times[npu] = start_time + result->npu_durations[npu];
+            }
+            result_cached = true;
+            event_queue->schedule_event(start_time + result->duration, cached_result_arrived, this);
+            return;
+        }
+    }
+
+    // simulate NPU 0 alone over the quotient, on the same event queue
+    if (symmetry_reduction && all_npus_local() && OrbitTopology::reducible(*topology) && rotation_invariant()) {
+        orbit_topology = std::make_unique<OrbitTopology>(*static_cast<const BasicTopology*>(topology));
+        orbit_topology->set_event_queue(topology->get_event_queue());
+        proceed(0);
+        return;
+    }
+
+    for (auto npu = local_npus_begin; npu < local_npus_end; npu++) {
+        proceed(npu);
+    }
+}
+
+void Collective::set_symmetry_reduction(const bool symmetry_reduction) noexcept {
+    this->symmetry_reduction = symmetry_reduction;
+}
+
+bool Collective::is_symmetry_reduced() const noexcept {
+    return orbit_topology != nullptr;
+}
+
+void Collective::set_result_cache(CollectiveCache* const result_cache, const uint64_t config_hash) noexcept {
+    this->result_cache = result_cache;
+    result_key = CollectiveCache::hash_key(config_hash, type, algorithm, size);
+}
+
+bool Collective::is_result_cached() const noexcept {
+    return result_cached;
+}
+
+void Collective::set_local_npus(const DeviceId begin, const DeviceId end) noexcept {
+    assert(0 <= begin && begin <= end && end <= npus_count);
+    assert(event_queue == nullptr);
+
+    local_npus_begin = begin;
+    local_npus_end = end;
+
+    // only the chunks destined to the local NPUs arrive here
+    chunks_count = 0;
+    for (auto npu = begin; npu < end; npu++) {
+        chunks_count += pending_chunks[npu];
+    }
+}
+
+CallbackHandle Collective::encode_callback([[maybe_unused]] const Callback callback,
+                                          const CallbackArg callback_arg) const noexcept {
+    assert(callback == chunk_arrived);
+
+    // the index of the (npu, step) pair is the same on every rank
+    const auto* const arrival = static_cast<const StepArrival*>(callback_arg);
+    assert(step_arrivals.data() <= arrival && arrival < step_arrivals.data() + step_arrivals.size());
+    return static_cast<CallbackHandle>(arrival - step_arrivals.data());
+}
+
+std::pair<Callback, CallbackArg> Collective::decode_callback(const CallbackHandle handle) noexcept {
+    assert(handle < step_arrivals.size());
+
+    return {chunk_arrived, &step_arrivals[handle]};
+}
+
+bool Collective::finished() const noexcept {
+    return arrived_chunks_count == chunks_count;
+}
+
+int Collective::get_steps_count() const noexcept {
+    return static_cast<int>(steps.size());
+}
+
+size_t Collective::get_chunks_count() const noexcept {
+    return chunks_count;
+}
+
+EventTime Collective::get_npu_finish_time(const DeviceId npu) const noexcept {
+    assert(local_npus_begin <= npu && npu < local_npus_end);
+    assert(finished());
+
+    return npu_finish_times[npu];
+}
+
+void Collective::append_steps(const CollectiveType type,
+                              const CollectiveAlgorithm algorithm,
+                              const ChunkSize shard_size) noexcept {
+    assert(type != CollectiveType::AllReduce);
+
+    const auto npus_count = this->npus_count;
+
+    if (algorithm == CollectiveAlgorithm::Direct) {
+        // a single step: send a shard to every other NPU, starting from the next NPU
+        // so that no NPU is the first dest of every other NPU
+        auto step = Step{shard_size, std::vector<std::vector<DeviceId>>(npus_count)};
+        for (auto npu = 0; npu < npus_count; npu++) {
+            for (auto i = 1; i < npus_count; i++) {
+                step.peers[npu].push_back((npu + i) % npus_count);
+            }
+        }
+        steps.push_back(std::move(step));
+        return;
+    }
+
+    if (type == CollectiveType::AllToAll) {
+        // pairwise exchange: a shard per step
+        for (auto i = 1; i < npus_count; i++) {
+            if (algorithm == CollectiveAlgorithm::Ring) {
+                append_pairwise_step(shard_size, [=](const DeviceId npu) { return (npu + i) % npus_count; });
+            } else {
+                append_pairwise_step(shard_size, [=](const DeviceId npu) { return npu ^ i; });
+            }
+        }
+        return;
+    }
+
+    if (algorithm == CollectiveAlgorithm::Ring) {
+        // forward a shard to the next NPU per step
+        for (auto i = 1; i < npus_count; i++) {
+            append_pairwise_step(shard_size, [=](const DeviceId npu) { return (npu + 1) % npus_count; });
+        }
+        return;
+    }
+
+    // halving-doubling
+    assert(algorithm == CollectiveAlgorithm::HalvingDoubling);
+    if (type == CollectiveType::AllGather) {
+        // recursive doubling: exchange with the nearest peer first, doubling the data per step
+        for (auto distance = 1; distance < npus_count; distance *= 2) {
+            append_pairwise_step(shard_size * distance, [=](const DeviceId npu) { return npu ^ distance; });
+        }
+    } else {
+        // recursive halving: exchange with the farthest peer first, halving the data per step
+        for (auto distance = npus_count / 2; distance >= 1; distance /= 2) {
+            append_pairwise_step(shard_size * distance, [=](const DeviceId npu) { return npu ^ distance; });
+        }
+    }
+}
+
+template <typename PeerFunction>
+void Collective::append_pairwise_step(const ChunkSize chunk_size, PeerFunction peer) noexcept {
+    auto step = Step{chunk_size, std::vector<std::vector<DeviceId>>(npus_count)};
+    for (auto npu = 0; npu < npus_count; npu++) {
+        step.peers[npu].push_back(peer(npu));
+    }
+    steps.push_back(std::move(step));
+}
+
+void Collective::finish() noexcept {
+    assert(finished());
+
+    // cache the simulated result, relative to the start
+    if (result_cache != nullptr && !result_cached && all_npus_local()) {
+        auto result = CollectiveCache::CollectiveResult{event_queue->get_current_time() - start_time, {}};
+        result.npu_durations.reserve(npus_count);
+        for (const auto finish_time : npu_finish_times) {
+            result.npu_durations.push_back(finish_time - start_time);
+        }
+        result_cache->insert(result_key, result);
+    }
+
+    (*callback)(callback_arg);
+}
+
+bool Collective::all_npus_local() const noexcept {
+    return local_npus_begin == 0 && local_npus_end == npus_count;
+}
+
+bool Collective::rotation_invariant() const noexcept {
+    auto rotated = std::vector<DeviceId>();
+    auto peers = std::vector<DeviceId>();
+    for (const auto& step : steps) {
+        for (auto npu = 1; npu < npus_count; npu++) {
+            // compare the peers as sets: the order within a step doesn't change the traffic
+            rotated.clear();
+            for (const auto peer : step.peers[0]) {
+                rotated.push_back((peer + npu) % npus_count);
+            }
+            peers = step.peers[npu];
+            std::sort(rotated.begin(), rotated.end());
+            std::sort(peers.begin(), peers.end());
+            if (rotated != peers) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void Collective::proceed(const DeviceId npu) noexcept {
+    assert(0 <= npu && npu < npus_count);
+
+    const auto steps_count = get_steps_count();
+    auto& next_step = next_steps[npu];
+    while (next_step < steps_count) {
+        // the previous step should have completed
+        if (next_step > 0) {
+            const auto previous = npu * steps_count + (next_step - 1);
+            if (received_chunks[previous] < expected_chunks[previous]) {
+                return;
+            }
+        }
+
+        // send the chunks of the step
+        const auto step = next_step++;
+        const auto& current_step = steps[step];
+        for (const auto dest : current_step.peers[npu]) {
+            // if reduced, the chunk 0 -> dest stands for the chunk (-dest) -> 0 of the step, arriving at NPU 0
+            if (orbit_topology != nullptr) {
+                auto* const arrival = &step_arrivals[step];
+                orbit_topology->send(
+                    orbit_topology->make_orbit_chunk(current_step.chunk_size, dest, chunk_arrived, arrival));
+                continue;
+            }
+
+            auto* const arrival = &step_arrivals[dest * steps_count + step];
+            topology->send(topology->make_chunk(current_step.chunk_size, npu, dest, chunk_arrived, arrival));
+        }
+    }
+}
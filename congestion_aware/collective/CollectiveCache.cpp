@@ -0,0 +1,238 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectiveCache.h"
+#include "common/Hash.h"
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// the library version is defined by the build
+#ifndef ANALYTICAL_VERSION
+#define ANALYTICAL_VERSION "unversioned"
+#endif
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// magic number at the beginning of a cached result file
+    constexpr char collective_result_magic[8] = {'A', 'N', 'C', 'O', 'L', 'R', 'E', 'S'};
+
+    /// header of a cached result file, followed by the duration of each NPU
+    struct ResultHeader {
+        /// magic number
+        char magic[8];
+
+        /// key of the collective
+        uint64_t key;
+
+        /// hash of the library version
+        uint64_t version_hash;
+
+        /// time from the start until every NPU finishes
+        uint64_t duration;
+
+        /// number of NPUs
+        uint64_t npus_count;
+    };
+
+    /**
+     * Compute the hash of the library version.
+     *
+     * @return hash of the library version
+     */
+    [[nodiscard]] uint64_t hash_library_version() noexcept {
+        auto hash = fnv1a_offset_basis;
+        hash_bytes(hash, ANALYTICAL_VERSION, std::strlen(ANALYTICAL_VERSION));
+        return hash;
+    }
+
+}  // namespace
+
+CollectiveCache::CollectiveCache(const size_t capacity, std::string directory) noexcept
+    : capacity(capacity),
+      directory(std::move(directory)),
+      memory_hits_count(0),
+      disk_hits_count(0),
+      misses_count(0) {
+    assert(capacity > 0);
+
+    // create the store, unless another process already did
+    if (!this->directory.empty() && mkdir(this->directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot create the collective cache directory: " << this->directory << std::endl;
+        std::exit(-1);
+    }
+}
+
+const char* CollectiveCache::get_library_version() noexcept {
+    return ANALYTICAL_VERSION;
+}
+
+uint64_t CollectiveCache::hash_key(const uint64_t config_hash,
+                                   const CollectiveType type,
+                                   const CollectiveAlgorithm algorithm,
+                                   const ChunkSize size) noexcept {
+    // salted by the library version, so that the results of another version are never hit
+    auto hash = hash_library_version();
+    hash_bytes(hash, &config_hash, sizeof(config_hash));
+    hash_bytes(hash, &type, sizeof(type));
+    hash_bytes(hash, &algorithm, sizeof(algorithm));
+    hash_bytes(hash, &size, sizeof(size));
+    return hash;
+}
+
+std::optional<CollectiveCache::CollectiveResult> CollectiveCache::find(const uint64_t key) noexcept {
+    {
+        const auto lock = std::lock_guard<std::mutex>(mutex);
+        const auto entry = result_table.find(key);
+        if (entry != result_table.end()) {
+            // move to the front, as the most recently used
+            results.splice(results.begin(), results, entry->second);
+            memory_hits_count++;
+            return entry->second->second;
+        }
+    }
+
+    // read the store without the lock, as it may be slow
+    auto result = directory.empty() ? std::nullopt : read_result(key);
+
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    if (!result.has_value()) {
+        misses_count++;
+        return std::nullopt;
+    }
+    disk_hits_count++;
+    remember(key, *result);
+    return result;
+}
+
+void CollectiveCache::insert(const uint64_t key, const CollectiveResult& result) noexcept {
+    {
+        const auto lock = std::lock_guard<std::mutex>(mutex);
+        remember(key, result);
+    }
+
+    if (!directory.empty()) {
+        write_result(key, result);
+    }
+}
+
+size_t CollectiveCache::get_entries_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    return results.size();
+}
+
+uint64_t CollectiveCache::get_memory_hits_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    return memory_hits_count;
+}
+
+uint64_t CollectiveCache::get_disk_hits_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    return disk_hits_count;
+}
+
+uint64_t CollectiveCache::get_misses_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    return misses_count;
+}
+
+double CollectiveCache::get_hit_rate() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    const auto hits_count = memory_hits_count + disk_hits_count;
+    const auto lookups_count = hits_count + misses_count;
+    return (lookups_count > 0) ? static_cast<double>(hits_count) / static_cast<double>(lookups_count) : 0;
+}
+
+void CollectiveCache::remember(const uint64_t key, CollectiveResult result) noexcept {
+    // overwrite a result already in memory
+    const auto entry = result_table.find(key);
+    if (entry != result_table.end()) {
+        entry->second->second = std::move(result);
+        results.splice(results.begin(), results, entry->second);
+        return;
+    }
+
+    // evict the least recently used result
+    if (results.size() >= capacity) {
+        result_table.erase(results.back().first);
+        results.pop_back();
+    }
+
+    results.emplace_front(key, std::move(result));
+    result_table.emplace(key, results.begin());
+}
+
+std::string CollectiveCache::get_path(const uint64_t key) const noexcept {
+    auto path = std::ostringstream();
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".collective";
+    return path.str();
+}
+
+std::optional<CollectiveCache::CollectiveResult> CollectiveCache::read_result(const uint64_t key) const noexcept {
+    // a missing file is a miss
+    auto in = std::ifstream(get_path(key), std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+    const auto file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    // reject a file of another format or version, a colliding key, or a truncated file
+    auto header = ResultHeader();
+    if (file_size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, collective_result_magic, sizeof(collective_result_magic)) != 0 ||
+        header.key != key || header.version_hash != hash_library_version() ||
+        file_size != sizeof(header) + (header.npus_count * sizeof(EventTime))) {
+        return std::nullopt;
+    }
+
+    auto result = CollectiveResult{header.duration, std::vector<EventTime>(header.npus_count)};
+    const auto durations_size = static_cast<std::streamsize>(header.npus_count * sizeof(EventTime));
+    if (!in.read(reinterpret_cast<char*>(result.npu_durations.data()), durations_size)) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+void CollectiveCache::write_result(const uint64_t key, const CollectiveResult& result) const noexcept {
+    // write to a temporary file first, so that processes reading the file concurrently never see a partial one
+    const auto path = get_path(key);
+    const auto temporary_path = path + ".tmp." + std::to_string(getpid()) + "." +
+                                std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    auto out = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return;
+    }
+
+    auto header = ResultHeader();
+    std::memcpy(header.magic, collective_result_magic, sizeof(collective_result_magic));
+    header.key = key;
+    header.version_hash = hash_library_version();
+    header.duration = result.duration;
+    header.npus_count = result.npu_durations.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(result.npu_durations.data()),
+              static_cast<std::streamsize>(result.npu_durations.size() * sizeof(EventTime)));
+    out.close();
+
+    if (!out || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+    }
+}
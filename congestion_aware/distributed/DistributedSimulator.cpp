@@ -0,0 +1,315 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/DistributedSimulator.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Link.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// header of a chunk handed over to another rank, followed by the device ids of its route
+    struct HandoffHeader {
+        /// time the chunk arrives the next device
+        EventTime arrival_time;
+
+        /// time the chunk started its transmission
+        EventTime send_time;
+
+        /// size of the chunk
+        ChunkSize chunk_size;
+
+        /// handle of the chunk callback
+        CallbackHandle callback;
+
+        /// number of devices of the rest of the route, starting from the current device
+        uint64_t route_size;
+    };
+
+    /**
+     * Abort every rank if an MPI call failed.
+     *
+     * @param result result of the MPI call
+     */
+    void check_mpi(const int result) noexcept {
+        if (result != MPI_SUCCESS) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "MPI call failed with error code " << result << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, result);
+        }
+    }
+
+}  // namespace
+
+DistributedSimulator::DistributedSimulator(std::shared_ptr<Topology> topology,
+                                           const MPI_Comm communicator,
+                                           CallbackEncoder encoder,
+                                           CallbackDecoder decoder) noexcept
+    : topology(std::move(topology)),
+      communicator(communicator),
+      rank(0),
+      ranks_count(1),
+      encoder(std::move(encoder)),
+      decoder(std::move(decoder)),
+      lookahead(std::numeric_limits<EventTime>::max()),
+      current_time(0) {
+    assert(this->topology != nullptr);
+    assert(this->topology->get_event_queue() != nullptr);
+    assert(this->encoder != nullptr);
+    assert(this->decoder != nullptr);
+
+    check_mpi(MPI_Comm_rank(communicator, &rank));
+    check_mpi(MPI_Comm_size(communicator, &ranks_count));
+
+    const auto devices_count = this->topology->get_devices_count();
+    if (ranks_count > devices_count) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "distributed simulation requires at most as many ranks as devices" << std::endl;
+        std::exit(-1);
+    }
+
+    // shard devices into contiguous id ranges, as ParallelSimulator partitions them
+    for (auto shard = 0; shard <= ranks_count; shard++) {
+        const auto offset = (static_cast<long>(shard) * devices_count + ranks_count - 1) / ranks_count;
+        rank_offsets.push_back(static_cast<DeviceId>(offset));
+    }
+    mailboxes = std::vector<ChunkMailbox>(ranks_count);
+
+    // the lookahead is the smallest latency of the links crossing ranks
+    // lazy links share a single latency, which spares creating them
+    if (this->topology->has_lazy_links()) {
+        lookahead = static_cast<EventTime>(this->topology->get_min_link_latency());
+    } else {
+        for (auto link_id = 0; link_id < this->topology->get_links_count(); link_id++) {
+            const auto* const link = this->topology->get_link(link_id);
+            if (get_device_rank(link->get_src()) != get_device_rank(link->get_dest())) {
+                lookahead = std::min(lookahead, static_cast<EventTime>(link->get_latency()));
+            }
+        }
+    }
+
+    // a chunk arrival should never be scheduled within the window it's sent
+    if (lookahead == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "distributed simulation requires links crossing ranks to have latency of at least 1 ns"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // every arrival that can't happen within the window it's sent goes through a mailbox,
+    // so that arrivals at the same time are ordered by a single rule (see exchange_mailboxes)
+    this->topology->set_link_outboxes([this](const Link& link) -> ChunkMailbox* {
+        if (static_cast<EventTime>(link.get_latency()) < lookahead) {
+            return nullptr;
+        }
+        return &mailboxes[get_device_rank(link.get_dest())];
+    });
+}
+
+DistributedSimulator::~DistributedSimulator() noexcept {
+    topology->set_link_outboxes(nullptr);
+}
+
+int DistributedSimulator::get_rank() const noexcept {
+    return rank;
+}
+
+int DistributedSimulator::get_ranks_count() const noexcept {
+    return ranks_count;
+}
+
+int DistributedSimulator::get_device_rank(const DeviceId device) const noexcept {
+    assert(0 <= device && device < topology->get_devices_count());
+
+    return static_cast<int>(static_cast<long>(device) * ranks_count / topology->get_devices_count());
+}
+
+std::pair<DeviceId, DeviceId> DistributedSimulator::get_local_npus() const noexcept {
+    // NPUs take the lowest device ids
+    const auto npus_count = topology->get_npus_count();
+    return {std::min(rank_offsets[rank], npus_count), std::min(rank_offsets[rank + 1], npus_count)};
+}
+
+EventTime DistributedSimulator::get_lookahead() const noexcept {
+    return lookahead;
+}
+
+EventTime DistributedSimulator::get_current_time() const noexcept {
+    return current_time;
+}
+
+RunSummary DistributedSimulator::run() noexcept {
+    constexpr auto no_event = std::numeric_limits<EventTime>::max();
+    const auto start = std::chrono::steady_clock::now();
+    auto& event_queue = *topology->get_event_queue();
+
+    // chunks sent before the run may already be in the mailboxes
+    exchange_mailboxes();
+
+    auto local_summary = RunSummary();
+    while (true) {
+        // every rank computes the same window
+        const auto next_event_time = event_queue.finished() ? no_event : event_queue.peek_next_event_time();
+        auto window_start = no_event;
+        check_mpi(MPI_Allreduce(&next_event_time, &window_start, 1, MPI_UINT64_T, MPI_MIN, communicator));
+        if (window_start == no_event) {
+            // every rank is finished, and no chunk is in flight
+            break;
+        }
+        const auto window_end = (window_start > no_event - lookahead) ? no_event : window_start + lookahead - 1;
+
+        // run the window independently
+        const auto summary = event_queue.run_until(window_end);
+        local_summary.events_count += summary.events_count;
+        local_summary.event_times_count += summary.event_times_count;
+
+        // hand over the chunks sent within the window
+        exchange_mailboxes();
+    }
+
+    // accumulate summaries
+    const uint64_t local_counts[2] = {local_summary.events_count, local_summary.event_times_count};
+    uint64_t counts[2] = {0, 0};
+    check_mpi(MPI_Allreduce(local_counts, counts, 2, MPI_UINT64_T, MPI_SUM, communicator));
+    const auto local_time = event_queue.get_current_time();
+    check_mpi(MPI_Allreduce(&local_time, &current_time, 1, MPI_UINT64_T, MPI_MAX, communicator));
+
+    auto summary = RunSummary();
+    summary.events_count = counts[0];
+    summary.event_times_count = counts[1];
+    const auto end = std::chrono::steady_clock::now();
+    summary.wall_time = std::chrono::duration<double>(end - start).count();
+
+    return summary;
+}
+
+void DistributedSimulator::exchange_mailboxes() noexcept {
+    // serialize the chunks handed over to each rank, in the order sent
+    // the chunks leave this rank, so they're destroyed here and recreated by their rank
+    auto send_buffer = std::vector<char>();
+    auto send_counts = std::vector<int>(ranks_count, 0);
+    for (auto dest_rank = 0; dest_rank < ranks_count; dest_rank++) {
+        if (dest_rank == rank) {
+            continue;
+        }
+
+        const auto begin = send_buffer.size();
+        for (const auto& delivery : mailboxes[dest_rank]) {
+            auto chunk = std::unique_ptr<Chunk>(delivery.chunk);
+            const auto& route = chunk->get_route();
+            const auto header = HandoffHeader{delivery.arrival_time, delivery.send_time, chunk->get_size(),
+                                              encoder(chunk->callback, chunk->callback_arg), route.size()};
+            const auto* const header_bytes = reinterpret_cast<const char*>(&header);
+            send_buffer.insert(send_buffer.end(), header_bytes, header_bytes + sizeof(header));
+            for (auto i = size_t(0); i < route.size(); i++) {
+                const auto device = route.at(i);
+                const auto* const device_bytes = reinterpret_cast<const char*>(&device);
+                send_buffer.insert(send_buffer.end(), device_bytes, device_bytes + sizeof(device));
+            }
+        }
+        mailboxes[dest_rank].clear();
+        send_counts[dest_rank] = static_cast<int>(send_buffer.size() - begin);
+    }
+
+    // exchange the sizes, then the chunks, in a single all-to-all each
+    auto recv_counts = std::vector<int>(ranks_count, 0);
+    check_mpi(MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, communicator));
+    auto send_displacements = std::vector<int>(ranks_count, 0);
+    auto recv_displacements = std::vector<int>(ranks_count, 0);
+    for (auto i = 1; i < ranks_count; i++) {
+        send_displacements[i] = send_displacements[i - 1] + send_counts[i - 1];
+        recv_displacements[i] = recv_displacements[i - 1] + recv_counts[i - 1];
+    }
+    auto recv_buffer = std::vector<char>(recv_displacements.back() + recv_counts.back());
+    check_mpi(MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displacements.data(), MPI_BYTE,
+                            recv_buffer.data(), recv_counts.data(), recv_displacements.data(), MPI_BYTE,
+                            communicator));
+
+    // gather arrivals in the order of src ranks, then in the order sent
+    auto deliveries = ChunkMailbox();
+    for (auto src_rank = 0; src_rank < ranks_count; src_rank++) {
+        if (src_rank == rank) {
+            deliveries.insert(deliveries.end(), mailboxes[rank].begin(), mailboxes[rank].end());
+            mailboxes[rank].clear();
+            continue;
+        }
+
+        // recreate the chunks handed over from the rank
+        const auto* cursor = recv_buffer.data() + recv_displacements[src_rank];
+        const auto* const end = cursor + recv_counts[src_rank];
+        while (cursor < end) {
+            auto header = HandoffHeader();
+            std::memcpy(&header, cursor, sizeof(header));
+            cursor += sizeof(header);
+
+            auto route = Route(*topology);
+            for (auto i = uint64_t(0); i < header.route_size; i++) {
+                auto device = DeviceId(0);
+                std::memcpy(&device, cursor, sizeof(device));
+                cursor += sizeof(device);
+                route.push_back(device);
+            }
+
+            const auto [callback, callback_arg] = decoder(header.callback);
+            auto* const chunk = new (topology->get_chunk_pool())
+                Chunk(header.chunk_size, std::move(route), callback, callback_arg);
+            deliveries.push_back({header.arrival_time, header.send_time, chunk});
+        }
+        assert(cursor == end);
+    }
+
+    // the sequential event queue invokes arrivals at the same time in the order they were scheduled,
+    // so the earlier sent chunk arrives first
+    std::stable_sort(deliveries.begin(), deliveries.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.arrival_time != rhs.arrival_time) {
+            return lhs.arrival_time < rhs.arrival_time;
+        }
+        return lhs.send_time < rhs.send_time;
+    });
+
+    auto* const event_queue = topology->get_event_queue().get();
+    for (const auto& delivery : deliveries) {
+        delivery.chunk->schedule_arrival(event_queue, delivery.arrival_time);
+    }
+}
+
+#ifdef ANALYTICAL_TELEMETRY
+Telemetry DistributedSimulator::gather_telemetry(const int root) const noexcept {
+    assert(0 <= root && root < ranks_count);
+
+    // gather the sizes, then the counters of every rank
+    auto send_buffer = std::vector<char>();
+    topology->get_telemetry().serialize(send_buffer);
+    const auto send_count = static_cast<int>(send_buffer.size());
+    auto recv_counts = std::vector<int>(ranks_count, 0);
+    check_mpi(MPI_Gather(&send_count, 1, MPI_INT, recv_counts.data(), 1, MPI_INT, root, communicator));
+    auto recv_displacements = std::vector<int>(ranks_count, 0);
+    for (auto i = 1; i < ranks_count; i++) {
+        recv_displacements[i] = recv_displacements[i - 1] + recv_counts[i - 1];
+    }
+    auto recv_buffer = std::vector<char>((rank == root) ? recv_displacements.back() + recv_counts.back() : 0);
+    check_mpi(MPI_Gatherv(send_buffer.data(), send_count, MPI_BYTE, recv_buffer.data(), recv_counts.data(),
+                          recv_displacements.data(), MPI_BYTE, root, communicator));
+
+    // each rank records the links starting from its devices, so the merge is exact
+    auto telemetry = Telemetry();
+    if (rank == root) {
+        for (auto src_rank = 0; src_rank < ranks_count; src_rank++) {
+            const auto* const data = recv_buffer.data() + recv_displacements[src_rank];
+            telemetry.merge(Telemetry::deserialize(data, recv_counts[src_rank]));
+        }
+    }
+    return telemetry;
+}
+#endif
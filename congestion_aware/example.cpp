@@ -7,7 +7,12 @@ LICENSE file in the root directory of this source tree.
 #include "common/NetworkParser.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Helper.h"
+#include <cstring>
 #include <iostream>
+#include <memory>
+#ifdef ANALYTICAL_MPI
+#include "congestion_aware/DistributedSimulator.h"
+#endif
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
@@ -21,22 +26,50 @@ void chunk_arrived_callback(void* const event_queue_ptr) {
     std::cout << "A chunk arrived at destination at time: " << current_time << " ns" << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // --distributed shards the simulation across the MPI ranks (e.g., mpirun -np 4 ./Analytical_Congestion_Aware)
+    const auto distributed = (argc > 1 && std::strcmp(argv[1], "--distributed") == 0);
+#ifdef ANALYTICAL_MPI
+    if (distributed) {
+        MPI_Init(&argc, &argv);
+    }
+#else
+    if (distributed) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "--distributed requires the backend compiled with NETWORK_BACKEND_MPI" << std::endl;
+        return -1;
+    }
+#endif
+
     // Instantiate shared resources
     const auto event_queue = std::make_shared<EventQueue>();
-    Topology::set_event_queue(event_queue);
 
     // Parse network config and create topology
     const auto network_parser = NetworkParser("../input/Ring.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
     const auto npus_count = topology->get_npus_count();
     const auto devices_count = topology->get_devices_count();
 
     // message settings
     const auto chunk_size = 1'048'576;  // 1 MB
 
+    // every rank sends the chunks of its own NPUs, all NPUs if not distributed
+    auto local_npus = std::make_pair(0, npus_count);
+    auto* event_queue_ptr = static_cast<void*>(event_queue.get());
+#ifdef ANALYTICAL_MPI
+    // a chunk handed over to another rank is called back with the event queue of that rank
+    auto simulator = std::unique_ptr<DistributedSimulator>();
+    if (distributed) {
+        const auto encoder = [](Callback, CallbackArg) { return CallbackHandle(0); };
+        const auto decoder = [=](CallbackHandle) { return std::make_pair(chunk_arrived_callback, event_queue_ptr); };
+        simulator = std::make_unique<DistributedSimulator>(topology, MPI_COMM_WORLD, encoder, decoder);
+        local_npus = simulator->get_local_npus();
+    }
+#endif
+
     // Run All-Gather
-    for (int i = 0; i < npus_count; i++) {
+    for (int i = local_npus.first; i < local_npus.second; i++) {
         for (int j = 0; j < npus_count; j++) {
             if (i == j) {
                 continue;
@@ -44,7 +77,6 @@ int main() {
 
             // crate a chunk
             auto route = topology->route(i, j);
-            auto* event_queue_ptr = static_cast<void*>(event_queue.get());
             auto chunk = std::make_unique<Chunk>(chunk_size, route, chunk_arrived_callback, event_queue_ptr);
 
             // send a chunk
@@ -53,15 +85,37 @@ int main() {
     }
 
     // Run simulation
-    while (!event_queue->finished()) {
-        event_queue->proceed();
+    auto summary = RunSummary();
+    auto finish_time = EventTime(0);
+    auto print_result = true;
+#ifdef ANALYTICAL_MPI
+    if (simulator != nullptr) {
+        summary = simulator->run();
+        finish_time = simulator->get_current_time();
+        print_result = (simulator->get_rank() == 0);
+    }
+#endif
+    if (!distributed) {
+        summary = event_queue->run_to_completion();
+        finish_time = event_queue->get_current_time();
     }
 
     // Print simulation result
-    const auto finish_time = event_queue->get_current_time();
-    std::cout << "Total NPUs Count: " << npus_count << std::endl;
-    std::cout << "Total devices Count: " << devices_count << std::endl;
-    std::cout << "Simulation finished at time: " << finish_time << " ns" << std::endl;
+    if (print_result) {
+        std::cout << "Total NPUs Count: " << npus_count << std::endl;
+        std::cout << "Total devices Count: " << devices_count << std::endl;
+        std::cout << "Simulation finished at time: " << finish_time << " ns" << std::endl;
+        std::cout << "Events executed: " << summary.events_count << " (" << summary.event_times_count
+                  << " event times, " << summary.wall_time << " s)" << std::endl;
+    }
+
+#ifdef ANALYTICAL_MPI
+    // the simulator unbinds the topology before MPI shuts down
+    if (distributed) {
+        simulator.reset();
+        MPI_Finalize();
+    }
+#endif
 
     return 0;
 }
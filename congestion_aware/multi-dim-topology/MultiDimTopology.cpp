@@ -0,0 +1,228 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MultiDimTopology.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+MultiDimTopology::MultiDimTopology() noexcept : Topology() {
+    // initialize values
+    topology_per_dim.clear();
+    npus_count_per_dim = {};
+
+    // initialize topology shape
+    npus_count = 1;
+    devices_count = 1;
+    dims_count = 0;
+}
+
+void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> basic_topology,
+                                        const DimensionFidelity fidelity) noexcept {
+    assert(basic_topology != nullptr);
+
+    // routes and event queue bindings would be invalidated by the rebuild
+    assert(route_cache == nullptr);
+    assert(event_queue == nullptr);
+
+    // increment dims_count
+    dims_count++;
+
+    // NPUs of the new dimension are strided by the NPUs of the existing dimensions
+    const auto topology_size = basic_topology->get_npus_count();
+    stride_per_dim.push_back(npus_count);
+    npus_count *= topology_size;
+
+    // append bandwidth
+    const auto bandwidth = basic_topology->get_bandwidth_per_dim()[0];
+    bandwidth_per_dim.push_back(bandwidth);
+
+    // push back topology and npus_count
+    topology_per_dim.push_back(std::move(basic_topology));
+    fidelity_per_dim.push_back(fidelity);
+    npus_count_per_dim.push_back(topology_size);
+
+    // rebuild the devices and links
+    build_dimensions();
+}
+
+const BasicTopology* MultiDimTopology::get_topology_of_dim(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return topology_per_dim[dim].get();
+}
+
+DimensionFidelity MultiDimTopology::get_fidelity_of_dim(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return fidelity_per_dim[dim];
+}
+
+Route MultiDimTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // construct route
+    auto route = Route(*this);
+    route.push_back(src);
+
+    // traverse the dimensions in order
+    auto current = src;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto current_local_id = local_address(dim, current);
+        const auto dest_local_id = local_address(dim, dest);
+        if (current_local_id == dest_local_id) {
+            // already aligned in this dimension
+            continue;
+        }
+
+        // an unaware dimension is crossed by a single analytical link
+        if (fidelity_per_dim[dim] == DimensionFidelity::CongestionUnaware) {
+            current += (dest_local_id - current_local_id) * stride_per_dim[dim];
+            route.push_back(current);
+            continue;
+        }
+
+        // follow the route of the dimension, skipping its src (already in the route)
+        const auto local_route = topology_per_dim[dim]->route(current_local_id, dest_local_id);
+        for (auto i = size_t(1); i < local_route.size(); i++) {
+            route.push_back(global_id(dim, current, local_route.at(i)));
+        }
+
+        // move to the dest address of this dimension
+        current += (dest_local_id - current_local_id) * stride_per_dim[dim];
+    }
+
+    assert(current == dest);
+    return route;
+}
+
+void MultiDimTopology::build_dimensions() noexcept {
+    // non-NPU devices of each dimension follow the NPUs
+    extra_devices_offset_per_dim.clear();
+    devices_count = npus_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto& topology = topology_per_dim[dim];
+        const auto instances_count = npus_count / npus_count_per_dim[dim];
+        auto extra_devices_count = topology->get_devices_count() - topology->get_npus_count();
+        if (fidelity_per_dim[dim] == DimensionFidelity::CongestionUnaware) {
+            // the switches of an unaware dimension are never traversed
+            extra_devices_count = 0;
+        }
+
+        extra_devices_offset_per_dim.push_back(devices_count);
+        devices_count += instances_count * extra_devices_count;
+    }
+
+    // instantiate devices from scratch
+    devices.clear();
+    links.clear();
+    link_states.clear();
+    instantiate_devices();
+
+    // replicate the links of each dimension to its every instance
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto& topology = topology_per_dim[dim];
+        const auto bandwidth = bandwidth_per_dim[dim];
+
+        if (fidelity_per_dim[dim] == DimensionFidelity::CongestionUnaware) {
+            connect_analytical_dimension(dim);
+            continue;
+        }
+
+        for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+            // visit each dim-instance once, by its first NPU
+            if (local_address(dim, npu_id) != 0) {
+                continue;
+            }
+
+            for (auto link_id = 0; link_id < topology->get_links_count(); link_id++) {
+                const auto* const link = topology->get_link(link_id);
+                const auto src = global_id(dim, npu_id, link->get_src());
+                const auto dest = global_id(dim, npu_id, link->get_dest());
+                connect(src, dest, bandwidth, link->get_latency(), false);
+            }
+        }
+    }
+}
+
+void MultiDimTopology::connect_analytical_dimension(const int dim) noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(fidelity_per_dim[dim] == DimensionFidelity::CongestionUnaware);
+
+    const auto& topology = topology_per_dim[dim];
+    const auto bandwidth = bandwidth_per_dim[dim];
+    const auto topology_size = npus_count_per_dim[dim];
+
+    // latency of the route between each NPU pair of the dimension, computed once for all instances
+    auto route_latencies = std::vector<Latency>(topology_size * topology_size, 0);
+    for (auto src = 0; src < topology_size; src++) {
+        for (auto dest = 0; dest < topology_size; dest++) {
+            if (src == dest) {
+                continue;
+            }
+
+            auto route = topology->route(src, dest);
+            auto& route_latency = route_latencies[(src * topology_size) + dest];
+            while (route.size() > 1) {
+                route_latency += route.link(0)->get_latency();
+                route.pop_front();
+            }
+        }
+    }
+
+    // connect each NPU pair of every dim-instance by an analytical link
+    for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+        // visit each dim-instance once, by its first NPU
+        if (local_address(dim, npu_id) != 0) {
+            continue;
+        }
+
+        for (auto src = 0; src < topology_size; src++) {
+            for (auto dest = 0; dest < topology_size; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+
+                const auto latency = route_latencies[(src * topology_size) + dest];
+                connect(global_id(dim, npu_id, src), global_id(dim, npu_id, dest), bandwidth, latency, false);
+                links.back()->set_analytical(true);
+            }
+        }
+    }
+}
+
+DeviceId MultiDimTopology::local_address(const int dim, const DeviceId npu_id) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    return (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
+}
+
+DeviceId MultiDimTopology::global_id(const int dim, const DeviceId npu_id, const DeviceId local_id) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    const auto stride = stride_per_dim[dim];
+    const auto topology_size = npus_count_per_dim[dim];
+
+    // an NPU of the dim-instance: replace the address of this dimension
+    if (local_id < topology_size) {
+        return npu_id + ((local_id - local_address(dim, npu_id)) * stride);
+    }
+
+    // a non-NPU device: index the dim-instance by the address of the other dimensions
+    const auto lower_address = npu_id % stride;
+    const auto upper_address = npu_id / (stride * topology_size);
+    const auto instance_id = (upper_address * stride) + lower_address;
+
+    const auto& topology = topology_per_dim[dim];
+    const auto extra_devices_count = topology->get_devices_count() - topology->get_npus_count();
+    assert(local_id - topology_size < extra_devices_count);
+
+    return extra_devices_offset_per_dim[dim] + (instance_id * extra_devices_count) + (local_id - topology_size);
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CallbackBatcher.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+CallbackBatcher::CallbackBatcher() noexcept
+    : event_queue(nullptr),
+      flush_scheduled(false),
+      batches_count(0),
+      deferred_count(0) {
+    batches = {};
+    flushed_args = {};
+}
+
+void CallbackBatcher::set_event_queue(EventQueue* const event_queue) noexcept {
+    // pending batches would never be flushed
+    assert(!flush_scheduled);
+
+    this->event_queue = event_queue;
+}
+
+void CallbackBatcher::register_callback(const Callback callback, const BatchCallback batch_callback) noexcept {
+    assert(callback != nullptr);
+    assert(batch_callback != nullptr);
+
+    for (auto& batch : batches) {
+        if (batch.callback == callback) {
+            batch.batch_callback = batch_callback;
+            return;
+        }
+    }
+    batches.push_back({callback, batch_callback, {}});
+}
+
+bool CallbackBatcher::defer(const Callback callback, const CallbackArg callback_arg) noexcept {
+    for (auto& batch : batches) {
+        if (batch.callback != callback) {
+            continue;
+        }
+
+        batch.callback_args.push_back(callback_arg);
+        deferred_count++;
+
+        // flush after every arrival already scheduled at this time
+        if (!flush_scheduled) {
+            assert(event_queue != nullptr);
+            flush_scheduled = true;
+            event_queue->schedule_event<CallbackBatcher, flush>(event_queue->get_current_time(), this);
+        }
+        return true;
+    }
+
+    // not registered
+    return false;
+}
+
+uint64_t CallbackBatcher::get_batches_count() const noexcept {
+    return batches_count;
+}
+
+uint64_t CallbackBatcher::get_deferred_count() const noexcept {
+    return deferred_count;
+}
+
+void CallbackBatcher::flush(CallbackBatcher* const batcher) noexcept {
+    assert(batcher != nullptr);
+    assert(batcher->flush_scheduled);
+
+    // chunks arriving from the batched callbacks start the next batch
+    batcher->flush_scheduled = false;
+
+    for (auto i = size_t(0); i < batcher->batches.size(); i++) {
+        auto& batch = batcher->batches[i];
+        if (batch.callback_args.empty()) {
+            continue;
+        }
+
+        // hand the arguments over before invoking, so that the callback may defer again
+        batcher->flushed_args.swap(batch.callback_args);
+        batch.callback_args.clear();
+        batcher->batches_count++;
+        (*batch.batch_callback)(batcher->flushed_args.data(), batcher->flushed_args.size());
+        batcher->flushed_args.clear();
+    }
+}
@@ -6,23 +6,41 @@ LICENSE file in the root directory of this source tree.
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Device.h"
 #include "congestion_aware/Link.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
 
-void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
+void Chunk::chunk_arrived_next_device(Chunk* const chunk_ptr) noexcept {
     assert(chunk_ptr != nullptr);
 
-    // cast to unique_ptr<Chunk>
-    auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    // take back the ownership from the event queue
+    auto chunk = std::unique_ptr<Chunk>(chunk_ptr);
+    chunk->arrival_event = EventHandle();
 
-    // mark chunk arrived next node
+    // trace the arrival at the dest of the last link traversed
+    const auto* const last_link = chunk->route.link(chunk->express_hops);
+    if (auto* const tracer = last_link->get_tracer(); tracer != nullptr) {
+        tracer->record(TraceRecordType::Arrival, chunk->arrival_time, chunk->arrival_time, last_link->get_src(),
+                       last_link->get_dest(), chunk->chunk_size);
+    }
+
+    // mark chunk arrived next node, passing through the express hops
+    // whose reservations are all in effect by now
     chunk->mark_arrived_next_device();
+    for (auto i = size_t(0); i < chunk->express_hops; i++) {
+        chunk->route.link(0)->release_reservation(chunk.get());
+        chunk->mark_arrived_next_device();
+    }
+    chunk->express_hops = 0;
 
     if (chunk->arrived_dest()) {
-        // chunk arrived dest, invoke callback
+        // chunk arrived dest, invoke callback unless it's batched
         // as chunk is unique_ptr, will be destroyed automatically
-        chunk->invoke_callback();
+        auto* const callback_batcher = last_link->get_callback_batcher();
+        if (callback_batcher == nullptr || !callback_batcher->defer(chunk->callback, chunk->callback_arg)) {
+            chunk->invoke_callback();
+        }
     } else {
         // send this chunk to next dest
         const auto current_node = chunk->current_device();
@@ -30,28 +48,108 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     }
 }
 
+void Chunk::packet_arrived(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    // wait for the other packets
+    auto* const packed_chunk = static_cast<Chunk*>(chunk_ptr);
+    assert(packed_chunk->packets_count > 0);
+    if (--packed_chunk->packets_count > 0) {
+        return;
+    }
+
+    // the last packet arrived, so does the chunk
+    auto chunk = std::unique_ptr<Chunk>(packed_chunk);
+    const auto* const last_link = chunk->route.link(chunk->route.size() - 2);
+    while (!chunk->arrived_dest()) {
+        chunk->mark_arrived_next_device();
+    }
+    auto* const callback_batcher = last_link->get_callback_batcher();
+    if (callback_batcher == nullptr || !callback_batcher->defer(chunk->callback, chunk->callback_arg)) {
+        chunk->invoke_callback();
+    }
+}
+
+std::vector<std::unique_ptr<Chunk>> Chunk::split_into_packets(std::unique_ptr<Chunk> chunk,
+                                                              const ChunkSize packet_size,
+                                                              ChunkPool& pool) noexcept {
+    assert(chunk != nullptr);
+    assert(!chunk->arrived_dest());
+    assert(packet_size > 0);
+
+    // every packet follows the rest of the route of the chunk,
+    // which outlives the packets as the chunk is held until the last one arrives
+    auto packets = std::vector<std::unique_ptr<Chunk>>();
+    for (auto offset = ChunkSize(0); offset < chunk->chunk_size; offset += packet_size) {
+        const auto size = std::min(packet_size, chunk->chunk_size - offset);
+        packets.push_back(
+            std::unique_ptr<Chunk>(new (pool) Chunk(size, chunk->route.share(), packet_arrived, chunk.get())));
+    }
+
+    // the packets hold the chunk until the last one arrives
+    chunk->packets_count = packets.size();
+    chunk.release();
+    return packets;
+}
+
 Chunk::Chunk(const ChunkSize chunk_size, Route route, const Callback callback, const CallbackArg callback_arg) noexcept
-    : chunk_size(chunk_size), route(std::move(route)), callback(callback), callback_arg(callback_arg) {
+    : chunk_size(chunk_size),
+      route(std::move(route)),
+      callback(callback),
+      callback_arg(callback_arg),
+      arrival_time(0),
+      express_hops(0),
+      packets_count(0) {
     assert(chunk_size > 0);
     assert(!this->route.empty());
     assert(callback != nullptr);
 }
 
-std::shared_ptr<Device> Chunk::current_device() const noexcept {
+void* Chunk::operator new(const size_t size) {
+    return ChunkPool::allocate_unpooled(size);
+}
+
+void* Chunk::operator new([[maybe_unused]] const size_t size, ChunkPool& pool) {
+    // pooled slots only fit a Chunk
+    assert(size == sizeof(Chunk));
+
+    return pool.allocate();
+}
+
+void Chunk::operator delete(void* const storage) noexcept {
+    ChunkPool::deallocate(storage);
+}
+
+void Chunk::operator delete(void* const storage, ChunkPool& pool) noexcept {
+    pool.release(storage);
+}
+
+Device* Chunk::current_device() const noexcept {
     // assert the route is not empty
     assert(!route.empty());
 
     // return the first npu in route
-    return route.front();
+    return route.device(0);
 }
 
-std::shared_ptr<Device> Chunk::next_device() const noexcept {
+Device* Chunk::next_device() const noexcept {
     // assert the chunk has next dest
     assert(!arrived_dest());
 
     // return next dest
-    const auto next_dest = std::next(route.begin(), 1);
-    return *next_dest;
+    return route.device(1);
+}
+
+Link* Chunk::next_link() const noexcept {
+    // assert the chunk has next dest
+    assert(!arrived_dest());
+
+    // return the link to next dest
+    return route.link(0);
+}
+
+const Route& Chunk::get_route() const noexcept {
+    return route;
 }
 
 void Chunk::mark_arrived_next_device() noexcept {
@@ -64,6 +162,49 @@ void Chunk::mark_arrived_next_device() noexcept {
     route.pop_front();
 }
 
+void Chunk::schedule_arrival(EventQueue* const event_queue, const EventTime arrival_time) noexcept {
+    assert(event_queue != nullptr);
+
+    this->arrival_time = arrival_time;
+    arrival_event = event_queue->schedule_event<Chunk, chunk_arrived_next_device>(arrival_time, this);
+}
+
+void Chunk::schedule_express_arrival(EventQueue* const event_queue,
+                                     const std::vector<EventTime>& hop_arrival_times,
+                                     const EventTime arrival_time) noexcept {
+    assert(event_queue != nullptr);
+    assert(!hop_arrival_times.empty());
+
+    // the arrivals at the devices in between are relays of the final arrival
+    this->arrival_time = arrival_time;
+    express_hops = hop_arrival_times.size();
+    arrival_event = event_queue->schedule_relayed_event(hop_arrival_times, arrival_time,
+                                                        invoke_typed_event<Chunk, chunk_arrived_next_device>, this);
+}
+
+size_t Chunk::get_express_hops() const noexcept {
+    return express_hops;
+}
+
+bool Chunk::passed_express_hop(const EventQueue* const event_queue, const size_t hop) const noexcept {
+    assert(event_queue != nullptr);
+    assert(1 <= hop && hop <= express_hops);
+
+    // relay hop - 1 is the arrival at the src device of the hop
+    return event_queue->relay_passed(arrival_event, hop - 1);
+}
+
+void Chunk::cut_express_hops(EventQueue* const event_queue, const size_t hop, const EventTime arrival_time) noexcept {
+    assert(event_queue != nullptr);
+    assert(1 <= hop && hop <= express_hops);
+    assert(!passed_express_hop(event_queue, hop));
+
+    // the arrival at the src device of the hop becomes the arrival of the chunk
+    this->arrival_time = arrival_time;
+    arrival_event = event_queue->cut_relays(arrival_event, hop - 1);
+    express_hops = hop - 1;
+}
+
 bool Chunk::arrived_dest() const noexcept {
     // if a chunk arrived dest, route length should be 1
     // i.e., only containing the dest node
@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/Chunk.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// header prefixing every Chunk storage
+    struct alignas(std::max_align_t) SlotHeader {
+        /// pool owning the storage, nullptr if the storage is not pooled
+        ChunkPool* pool;
+    };
+
+    static_assert(alignof(Chunk) <= alignof(SlotHeader));
+
+    /// size of a pooled slot: header followed by the Chunk storage
+    constexpr auto slot_size = sizeof(SlotHeader) + (sizeof(Chunk) + alignof(SlotHeader) - 1) / alignof(SlotHeader) * alignof(SlotHeader);
+
+    SlotHeader* header_of(void* const storage) noexcept {
+        return reinterpret_cast<SlotHeader*>(static_cast<unsigned char*>(storage) - sizeof(SlotHeader));
+    }
+
+}  // namespace
+
+ChunkPool::ChunkPool() noexcept : in_use_count(0), peak_usage(0), concurrent(false) {}
+
+void* ChunkPool::allocate() noexcept {
+    if (!concurrent) {
+        return allocate_slot();
+    }
+
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    return allocate_slot();
+}
+
+void ChunkPool::release(void* const storage) noexcept {
+    if (!concurrent) {
+        release_slot(storage);
+        return;
+    }
+
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    release_slot(storage);
+}
+
+void ChunkPool::reserve(const size_t chunks_count) noexcept {
+    while (get_capacity() < chunks_count) {
+        allocate_slab();
+    }
+}
+
+void ChunkPool::set_concurrent(const bool concurrent) noexcept {
+    this->concurrent = concurrent;
+}
+
+size_t ChunkPool::get_in_use_count() const noexcept {
+    return in_use_count;
+}
+
+size_t ChunkPool::get_peak_usage() const noexcept {
+    return peak_usage;
+}
+
+size_t ChunkPool::get_capacity() const noexcept {
+    return slabs.size() * slab_slots_count;
+}
+
+void* ChunkPool::allocate_unpooled(const size_t size) noexcept {
+    // allocate the header together with the chunk
+    auto* const header = static_cast<SlotHeader*>(::operator new(sizeof(SlotHeader) + size));
+    header->pool = nullptr;
+
+    return reinterpret_cast<unsigned char*>(header) + sizeof(SlotHeader);
+}
+
+void ChunkPool::deallocate(void* const storage) noexcept {
+    if (storage == nullptr) {
+        return;
+    }
+
+    // return the storage to where it came from
+    auto* const header = header_of(storage);
+    if (header->pool != nullptr) {
+        header->pool->release(storage);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+void ChunkPool::allocate_slab() noexcept {
+    // the slab is aligned as new[] returns storage aligned to max_align_t
+    auto slab = std::make_unique<unsigned char[]>(slab_slots_count * slot_size);
+
+    // register the slots, in reverse so that they're allocated in address order
+    for (auto i = slab_slots_count; i > 0; i--) {
+        auto* const header = reinterpret_cast<SlotHeader*>(slab.get() + (i - 1) * slot_size);
+        header->pool = this;
+        free_slots.push_back(reinterpret_cast<unsigned char*>(header) + sizeof(SlotHeader));
+    }
+
+    slabs.push_back(std::move(slab));
+}
+
+void* ChunkPool::allocate_slot() noexcept {
+    // grow the pool if every slot is in use
+    if (free_slots.empty()) {
+        allocate_slab();
+    }
+
+    auto* const storage = free_slots.back();
+    free_slots.pop_back();
+
+    in_use_count++;
+    peak_usage = std::max(peak_usage, in_use_count);
+
+    return storage;
+}
+
+void ChunkPool::release_slot(void* const storage) noexcept {
+    assert(header_of(storage)->pool == this);
+    assert(in_use_count > 0);
+
+    free_slots.push_back(storage);
+    in_use_count--;
+}
@@ -6,6 +6,7 @@ LICENSE file in the root directory of this source tree.
 #include "congestion_aware/Device.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Link.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
@@ -30,33 +31,46 @@ void Device::send(std::unique_ptr<Chunk> chunk) noexcept {
     // assert the chunk hasn't arrived its final destination yet
     assert(!chunk->arrived_dest());
 
-    // get next dest
-    const auto next_dest = chunk->next_device();
-    const auto next_dest_id = next_dest->get_id();
+    // get the link to the next dest, which the route already holds
+    auto* const link = chunk->next_link();
+    assert(link->get_src() == device_id);
 
-    // assert the next dest is connected to this node
-    assert(connected(next_dest_id));
+    // in cut-through mode, transmit over the rest of the route at once if it's idle
+    if (link->get_packet_size() > 0 && Link::cut_through(chunk)) {
+        return;
+    }
 
     // send the chunk to the next dest
     // delegate this task to the link
-    links[next_dest_id]->send(std::move(chunk));
+    link->send(std::move(chunk));
 }
 
-void Device::connect(const DeviceId id, const Bandwidth bandwidth, const Latency latency) noexcept {
+void Device::connect(const DeviceId id, const LinkId link) noexcept {
     assert(id >= 0);
-    assert(bandwidth > 0);
-    assert(latency >= 0);
+    assert(link >= 0);
 
     // assert there's no existing connection
     assert(!connected(id));
 
-    // create link
-    links[id] = std::make_shared<Link>(bandwidth, latency);
+    // register link, keeping the links sorted
+    const auto position = std::lower_bound(links.begin(), links.end(), std::make_pair(id, link));
+    links.insert(position, {id, link});
+}
+
+LinkId Device::get_link_id(const DeviceId dest) const noexcept {
+    // assert the connection exists
+    assert(connected(dest));
+
+    const auto position = std::lower_bound(links.begin(), links.end(), dest,
+                                           [](const auto& entry, const DeviceId id) { return entry.first < id; });
+    return position->second;
 }
 
 bool Device::connected(const DeviceId dest) const noexcept {
     assert(dest >= 0);
 
     // check whether the connection exists
-    return links.find(dest) != links.end();
+    const auto position = std::lower_bound(links.begin(), links.end(), dest,
+                                           [](const auto& entry, const DeviceId id) { return entry.first < id; });
+    return position != links.end() && position->first == dest;
 }
@@ -7,67 +7,338 @@ LICENSE file in the root directory of this source tree.
 #include "common/NetworkFunction.h"
 #include "congestion_aware/Chunk.h"
 #include "congestion_aware/Device.h"
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-// declaring static event_queue
-std::shared_ptr<EventQueue> Link::event_queue;
+void Link::link_become_free(Link* const link) noexcept {
+    assert(link != nullptr);
 
-void Link::link_become_free(void* const link_ptr) noexcept {
-    assert(link_ptr != nullptr);
+    // the drain event is scheduled only when the link has pending chunks
+    assert(link->pending_chunk_exists());
+    assert(!link->is_busy());
 
-    // cast to Link*
-    auto* const link = static_cast<Link*>(link_ptr);
+    // the link is free now, process pending chunks
+    link->reserved_chunk = nullptr;
+    link->process_pending_transmission();
+}
 
-    // set link free
-    link->set_free();
+bool Link::cut_through(std::unique_ptr<Chunk>& chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(!chunk->arrived_dest());
 
-    // process pending chunks if one exist
-    if (link->pending_chunk_exists()) {
-        link->process_pending_transmission();
+    // chunks handed over to another partition are transmitted as a whole
+    const auto& route = chunk->get_route();
+    const auto hops_count = route.size() - 1;
+    for (auto i = size_t(0); i < hops_count; i++) {
+        if (route.link(i)->outbox != nullptr) {
+            return false;
+        }
+    }
+
+    // settle the express reservations along the route first, so that the check below only reads the links
+    for (auto i = size_t(0); i < hops_count; i++) {
+        route.link(i)->settle_reservation();
+    }
+    auto contended = false;
+    for (auto i = size_t(0); i < hops_count; i++) {
+        const auto* const link = route.link(i);
+        contended |= !link->analytical && (link->is_busy() || link->pending_chunk_exists());
     }
-}
 
-void Link::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
-    assert(event_queue_ptr != nullptr);
+    // a contended route: split the chunk into packets queued on the links hop by hop,
+    // each of which cuts through again once the rest of its route is idle
+    auto* const first_link = route.link(0);
+    assert(first_link->packet_size > 0);
+    if (contended) {
+        if (chunk->get_size() <= first_link->packet_size) {
+            return false;
+        }
+        assert(first_link->chunk_pool != nullptr);
+        auto& chunk_pool = *first_link->chunk_pool;
+        for (auto& packet : Chunk::split_into_packets(std::move(chunk), first_link->packet_size, chunk_pool)) {
+            first_link->send(std::move(packet));
+        }
+        return true;
+    }
 
-    // set the event queue
-    Link::event_queue = std::move(event_queue_ptr);
+    // an idle route: the head packet can't be larger than the chunk
+    const auto chunk_size = chunk->get_size();
+    const auto packet_size = std::min(chunk_size, first_link->packet_size);
+    const auto tail_size = chunk_size - packet_size;
+
+    // forward the head packet hop by hop, while the tail follows at the bottleneck bandwidth so far
+    // times are accumulated in ps, and truncated to ns only once they're scheduled
+    const auto current_time = first_link->event_queue->get_current_time();
+    auto head_time = static_cast<PicoTime>(current_time) * ps_per_ns;
+    auto bottleneck_reciprocal_bandwidth = static_cast<ReciprocalBandwidth>(0);
+    auto arrival_time = head_time;
+    for (auto i = size_t(0); i < hops_count; i++) {
+        auto* const link = route.link(i);
+        const auto reciprocal_bandwidth = link->link_states->get_reciprocal_bandwidth(link->slot);
+        const auto latency = link->link_states->get_latency_ps(link->slot);
+        bottleneck_reciprocal_bandwidth = std::max(bottleneck_reciprocal_bandwidth, reciprocal_bandwidth);
+
+        // reserve the link until the tail leaves it, unless it's analytical
+        const auto head_serialization_delay = serialization_delay_ps(packet_size, reciprocal_bandwidth);
+        const auto link_free_time =
+            head_time + head_serialization_delay + serialization_delay_ps(tail_size, bottleneck_reciprocal_bandwidth);
+        const auto busy_until = ps_to_event_time(link_free_time);
+        if (!link->analytical) {
+            link->set_busy_until(busy_until);
+        }
+        if (link->tracer != nullptr) {
+            link->tracer->record(TraceRecordType::Transmission, current_time, busy_until, link->src, link->dest,
+                                 chunk_size);
+        }
+#ifdef ANALYTICAL_TELEMETRY
+        link->telemetry->record_transmission(link->telemetry_id, chunk_size, busy_until - current_time);
+#endif
+
+        // the tail arrives at the next device after the link latency
+        arrival_time = link_free_time + latency;
+        head_time += head_serialization_delay + latency;
+    }
+
+    // skip to the last hop, so the arrival delivers the chunk to its destination
+    while (chunk->get_route().size() > 2) {
+        chunk->mark_arrived_next_device();
+    }
+    chunk.release()->schedule_arrival(first_link->event_queue, ps_to_event_time(arrival_time));
+
+    return true;
 }
 
-Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
-    : bandwidth(bandwidth), latency(latency), pending_chunks(), busy(false) {
+Link::Link(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth, const Latency latency) noexcept
+    : Link(src, dest, bandwidth, latency, nullptr) {}
+
+Link::Link(const DeviceId src,
+           const DeviceId dest,
+           const Bandwidth bandwidth,
+           const Latency latency,
+           LinkStateTable& link_states) noexcept
+    : Link(src, dest, bandwidth, latency, &link_states) {}
+
+Link::Link(const DeviceId src,
+           const DeviceId dest,
+           const Bandwidth bandwidth,
+           const Latency latency,
+           LinkStateTable* const link_states) noexcept
+    : src(src),
+      dest(dest),
+      bandwidth(bandwidth),
+      owned_link_states(link_states == nullptr ? std::make_unique<LinkStateTable>() : nullptr),
+      link_states(link_states == nullptr ? owned_link_states.get() : link_states),
+      slot(0),
+      pending_chunks(),
+      coalescing(false),
+      packet_size(0),
+      express(false),
+      analytical(false),
+      reserved_chunk(nullptr),
+      reservation_time(0),
+      event_queue(nullptr),
+#ifdef ANALYTICAL_TELEMETRY
+      outbox(nullptr),
+      tracer(nullptr),
+      callback_batcher(nullptr),
+      chunk_pool(nullptr),
+      telemetry(nullptr),
+      telemetry_id(-1) {
+#else
+      outbox(nullptr),
+      tracer(nullptr),
+      callback_batcher(nullptr),
+      chunk_pool(nullptr) {
+#endif
+    assert(src >= 0);
+    assert(dest >= 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    // convert bandwidth from GB/s to B/ns
-    bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    // register the link to the state table, converting bandwidth from GB/s to B/ns
+    slot = this->link_states->add_link(bw_GBps_to_Bpns(bandwidth), latency);
+}
+
+void Link::set_event_queue(EventQueue* const event_queue) noexcept {
+    assert(event_queue != nullptr);
+
+    // set the event queue
+    this->event_queue = event_queue;
+    if (express) {
+        event_queue->enable_relayed_events();
+    }
+}
+
+void Link::set_outbox(ChunkMailbox* const outbox) noexcept {
+    this->outbox = outbox;
+}
+
+DeviceId Link::get_src() const noexcept {
+    return src;
+}
+
+DeviceId Link::get_dest() const noexcept {
+    return dest;
+}
+
+void Link::set_tracer(Tracer* const tracer) noexcept {
+    this->tracer = tracer;
+}
+
+Tracer* Link::get_tracer() const noexcept {
+    return tracer;
+}
+
+void Link::set_callback_batcher(CallbackBatcher* const callback_batcher) noexcept {
+    this->callback_batcher = callback_batcher;
+}
+
+CallbackBatcher* Link::get_callback_batcher() const noexcept {
+    return callback_batcher;
+}
+
+void Link::set_chunk_pool(ChunkPool* const chunk_pool) noexcept {
+    this->chunk_pool = chunk_pool;
+}
+
+#ifdef ANALYTICAL_TELEMETRY
+void Link::set_telemetry(Telemetry* const telemetry, const LinkId id) noexcept {
+    assert(telemetry != nullptr);
+    assert(id >= 0);
+
+    this->telemetry = telemetry;
+    telemetry_id = id;
+}
+#endif
+
+void Link::set_coalescing(const bool coalescing) noexcept {
+    this->coalescing = coalescing;
+}
+
+void Link::set_packet_size(const ChunkSize packet_size) noexcept {
+    this->packet_size = packet_size;
+}
+
+ChunkSize Link::get_packet_size() const noexcept {
+    return packet_size;
+}
+
+void Link::set_express(const bool express) noexcept {
+    this->express = express;
+
+    // the express arrivals are relayed events, see Chunk::schedule_express_arrival()
+    if (express && event_queue != nullptr) {
+        event_queue->enable_relayed_events();
+    }
+}
+
+void Link::release_reservation(const Chunk* const chunk) noexcept {
+    if (reserved_chunk == chunk) {
+        reserved_chunk = nullptr;
+    }
+}
+
+void Link::set_analytical(const bool analytical) noexcept {
+    this->analytical = analytical;
+}
+
+bool Link::is_analytical() const noexcept {
+    return analytical;
+}
+
+Bandwidth Link::get_bandwidth() const noexcept {
+    return bandwidth;
+}
+
+Latency Link::get_latency() const noexcept {
+    return link_states->get_latency(slot);
+}
+
+EventTime Link::get_busy_until() const noexcept {
+    return link_states->get_busy_until(slot);
+}
+
+void Link::set_busy_until(const EventTime busy_until) noexcept {
+    link_states->set_busy_until(slot, busy_until);
+}
+
+Bandwidth Link::get_bandwidth_Bpns() const noexcept {
+    return link_states->get_bandwidth_Bpns(slot);
 }
 
 void Link::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
-    if (busy) {
-        // link is busy, add to pending chunks
-        pending_chunks.push_back(std::move(chunk));
-    } else {
+    // analytical: transmit right away, regardless of the other chunks
+    if (analytical) {
+        transmit_chunk(std::move(chunk), event_queue->get_current_time());
+        return;
+    }
+
+    settle_reservation();
+
+    if (!is_busy() && !pending_chunk_exists()) {
         // service this chunk immediately
         schedule_chunk_transmission(std::move(chunk));
+        return;
+    }
+
+    // link is busy, add to pending chunks
+    // the first pending chunk schedules the drain at the time the link becomes free
+    if (!pending_chunk_exists()) {
+        event_queue->schedule_event<Link, link_become_free>(get_busy_until(), this);
     }
+    pending_chunks.push_back(std::move(chunk));
+
+#ifdef ANALYTICAL_TELEMETRY
+    const auto current_time = event_queue->get_current_time();
+    pending_since.push_back(current_time);
+    telemetry->record_pending_depth(telemetry_id, current_time, pending_chunks.size());
+#endif
 }
 
 void Link::process_pending_transmission() noexcept {
     // pending chunk should exist
     assert(pending_chunk_exists());
 
-    // get chunk to process
-    auto chunk = std::move(pending_chunks.front());
-    pending_chunks.pop_front();
+    // link should be free
+    assert(!is_busy());
+    assert(event_queue != nullptr);
+
+    if (!coalescing) {
+        // service the first chunk
+        schedule_chunk_transmission(pop_pending_chunk(event_queue->get_current_time()));
+
+        // drain the next one when the link becomes free again
+        if (pending_chunk_exists()) {
+            event_queue->schedule_event<Link, link_become_free>(get_busy_until(), this);
+        }
+        return;
+    }
+
+    // serialize every pending chunk back-to-back
+    // link becomes free after the last chunk
+    auto link_free_time = event_queue->get_current_time();
+    while (pending_chunk_exists()) {
+        link_free_time = transmit_chunk(pop_pending_chunk(link_free_time), link_free_time);
+    }
+    set_busy_until(link_free_time);
+}
+
+std::unique_ptr<Chunk> Link::pop_pending_chunk([[maybe_unused]] const EventTime send_time) noexcept {
+    assert(pending_chunk_exists());
+
+#ifdef ANALYTICAL_TELEMETRY
+    const auto current_time = event_queue->get_current_time();
+    telemetry->record_queuing_delay(telemetry_id, send_time - pending_since.pop_front());
+    telemetry->record_pending_depth(telemetry_id, current_time, pending_chunks.size() - 1);
+#endif
 
-    // service this chunk
-    schedule_chunk_transmission(std::move(chunk));
+    return pending_chunks.pop_front();
 }
 
 bool Link::pending_chunk_exists() const noexcept {
@@ -75,58 +346,168 @@ bool Link::pending_chunk_exists() const noexcept {
     return !pending_chunks.empty();
 }
 
-void Link::set_busy() noexcept {
-    // set busy to true
-    busy = true;
-}
-
-void Link::set_free() noexcept {
-    // set busy to false
-    busy = false;
+bool Link::is_busy() const noexcept {
+    // the link is busy until it finishes serializing its last chunk
+    assert(event_queue != nullptr);
+    return get_busy_until() > event_queue->get_current_time();
 }
 
 EventTime Link::serialization_delay(const ChunkSize chunk_size) const noexcept {
     assert(chunk_size > 0);
 
-    // calculate serialization delay
-    const auto delay = static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns;
-
-    // return serialization delay in EventTime type
-    return static_cast<EventTime>(delay);
+    // computed in fixed point by the link state table
+    return link_states->get_serialization_delay(slot, chunk_size);
 }
 
 EventTime Link::communication_delay(const ChunkSize chunk_size) const noexcept {
     assert(chunk_size > 0);
 
-    // calculate communication delay
-    const auto delay = latency + (static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns);
-
-    // return communication delay in EventTime type
-    return static_cast<EventTime>(delay);
+    // computed in fixed point by the link state table
+    return link_states->get_communication_delay(slot, chunk_size);
 }
 
 void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
     // link should be free
-    assert(!busy);
+    assert(event_queue != nullptr);
+    assert(!is_busy());
+
+    // schedule chunk arrival event, the link is busy until the chunk is serialized
+    const auto current_time = event_queue->get_current_time();
+    set_busy_until(transmit_chunk(std::move(chunk), current_time));
+}
 
-    // set link busy
-    set_busy();
+EventTime Link::transmit_chunk(std::unique_ptr<Chunk> chunk, const EventTime send_time) noexcept {
+    assert(chunk != nullptr);
+    assert(send_time >= event_queue->get_current_time());
 
     // get metadata
     const auto chunk_size = chunk->get_size();
-    const auto current_time = Link::event_queue->get_current_time();
+
+    if (tracer != nullptr) {
+        tracer->record(TraceRecordType::Transmission, send_time, send_time + serialization_delay(chunk_size), src, dest,
+                       chunk_size);
+    }
+#ifdef ANALYTICAL_TELEMETRY
+    telemetry->record_transmission(telemetry_id, chunk_size, serialization_delay(chunk_size));
+#endif
 
     // schedule chunk arrival event
+    // if the next device is in another partition, the arrival is handed over to that partition
     const auto communication_time = communication_delay(chunk_size);
-    const auto chunk_arrival_time = current_time + communication_time;
-    auto* const chunk_ptr = static_cast<void*>(chunk.release());
-    Link::event_queue->schedule_event(chunk_arrival_time, Chunk::chunk_arrived_next_device, chunk_ptr);
-
-    // schedule link free time
-    const auto serialization_time = serialization_delay(chunk_size);
-    const auto link_free_time = current_time + serialization_time;
-    auto* const link_ptr = static_cast<void*>(this);
-    Link::event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+    auto chunk_arrival_time = send_time + communication_time;
+    auto* const chunk_ptr = chunk.release();
+    if (outbox != nullptr) {
+        outbox->push_back({chunk_arrival_time, send_time, chunk_ptr});
+        return send_time + serialization_delay(chunk_size);
+    }
+
+    // in express mode, reserve the following idle links of the route
+    // and relay the arrivals at the devices in between
+    thread_local auto hop_arrival_times = std::vector<EventTime>();
+    hop_arrival_times.clear();
+    if (express && event_queue->get_time_quantum() <= 1) {
+        const auto& route = chunk_ptr->get_route();
+        while (hop_arrival_times.size() + 2 < route.size()) {
+            auto* const next_link = route.link(hop_arrival_times.size() + 1);
+            if (!next_link->express || next_link->analytical || next_link->packet_size > 0 || next_link->is_busy() ||
+                next_link->pending_chunk_exists() || next_link->outbox != nullptr) {
+                break;
+            }
+
+            hop_arrival_times.push_back(chunk_arrival_time);
+            chunk_arrival_time = next_link->reserve(chunk_ptr, chunk_arrival_time);
+        }
+    }
+    if (hop_arrival_times.empty()) {
+        chunk_ptr->schedule_arrival(event_queue, chunk_arrival_time);
+    } else {
+        chunk_ptr->schedule_express_arrival(event_queue, hop_arrival_times, chunk_arrival_time);
+    }
+
+    // return the time the link finishes serializing the chunk
+    return send_time + serialization_delay(chunk_size);
+}
+
+EventTime Link::reserve(Chunk* const chunk, const EventTime arrival_time) noexcept {
+    assert(chunk != nullptr);
+    assert(!is_busy());
+    assert(!pending_chunk_exists());
+
+    // the chunk is transmitted as soon as it arrives
+    // the link is busy from now on, so that other chunks notice the reservation
+    reserved_chunk = chunk;
+    reservation_time = arrival_time;
+    const auto chunk_size = chunk->get_size();
+    set_busy_until(arrival_time + serialization_delay(chunk_size));
+
+    if (tracer != nullptr) {
+        tracer->record(TraceRecordType::Transmission, arrival_time, get_busy_until(), src, dest, chunk_size);
+    }
+#ifdef ANALYTICAL_TELEMETRY
+    telemetry->record_transmission(telemetry_id, chunk_size, serialization_delay(chunk_size));
+#endif
+
+    return arrival_time + communication_delay(chunk_size);
+}
+
+void Link::rollback_reservation() noexcept {
+    assert(reserved_chunk != nullptr);
+    auto* const chunk = reserved_chunk;
+    const auto arrival_time = reservation_time;
+    const auto& route = chunk->get_route();
+    const auto express_hops = chunk->get_express_hops();
+    const auto hop = reserved_hop();
+
+    // release this link and the following ones
+    // they were idle when reserved, and no chunk is pending on them before the reservation
+    const auto current_time = event_queue->get_current_time();
+    for (auto i = hop; i <= express_hops; i++) {
+        auto* const link = route.link(i);
+        assert(link->reserved_chunk == chunk);
+        assert(!link->pending_chunk_exists());
+        link->reserved_chunk = nullptr;
+        link->set_busy_until(current_time);
+
+        if (link->tracer != nullptr) {
+            link->tracer->record(TraceRecordType::Rollback, current_time, current_time, link->src, link->dest,
+                                 chunk->get_size());
+        }
+
+#ifdef ANALYTICAL_TELEMETRY
+        const auto chunk_size = chunk->get_size();
+        link->telemetry->cancel_transmission(link->telemetry_id, chunk_size, link->serialization_delay(chunk_size));
+#endif
+    }
+
+    // the chunk arrives at the src device of this link instead
+    chunk->cut_express_hops(event_queue, hop, arrival_time);
+}
+
+size_t Link::reserved_hop() const noexcept {
+    assert(reserved_chunk != nullptr);
+
+    // find this link among the express hops of the chunk
+    const auto& route = reserved_chunk->get_route();
+    auto hop = size_t(1);
+    while (route.link(hop) != this) {
+        hop++;
+        assert(hop <= reserved_chunk->get_express_hops());
+    }
+    return hop;
+}
+
+void Link::settle_reservation() noexcept {
+    if (reserved_chunk == nullptr) {
+        return;
+    }
+
+    if (reserved_chunk->passed_express_hop(event_queue, reserved_hop())) {
+        // the reservation is already in effect
+        reserved_chunk = nullptr;
+    } else {
+        // the reserved chunk hasn't arrived yet, so the current request goes first
+        rollback_reservation();
+    }
 }
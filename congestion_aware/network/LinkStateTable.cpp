@@ -0,0 +1,104 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LinkStateTable.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+LinkStateTable::LinkStateTable() noexcept = default;
+
+size_t LinkStateTable::add_link(const Bandwidth bandwidth_Bpns, const Latency latency) noexcept {
+    assert(bandwidth_Bpns > 0);
+    assert(latency >= 0);
+
+    busy_until.push_back(0);
+    this->bandwidth_Bpns.push_back(bandwidth_Bpns);
+    this->latency.push_back(latency);
+    reciprocal_bandwidth.push_back(bw_Bpns_to_reciprocal(bandwidth_Bpns));
+    latency_ps.push_back(latency_ns_to_ps(latency));
+    delay_memos.push_back({0, 0, 0});
+
+    return busy_until.size() - 1;
+}
+
+void LinkStateTable::clear() noexcept {
+    busy_until.clear();
+    bandwidth_Bpns.clear();
+    latency.clear();
+    reciprocal_bandwidth.clear();
+    latency_ps.clear();
+    delay_memos.clear();
+}
+
+size_t LinkStateTable::size() const noexcept {
+    return busy_until.size();
+}
+
+EventTime LinkStateTable::get_busy_until(const size_t slot) const noexcept {
+    assert(slot < size());
+
+    return busy_until[slot];
+}
+
+void LinkStateTable::set_busy_until(const size_t slot, const EventTime busy_until) noexcept {
+    assert(slot < size());
+
+    this->busy_until[slot] = busy_until;
+}
+
+Bandwidth LinkStateTable::get_bandwidth_Bpns(const size_t slot) const noexcept {
+    assert(slot < size());
+
+    return bandwidth_Bpns[slot];
+}
+
+Latency LinkStateTable::get_latency(const size_t slot) const noexcept {
+    assert(slot < size());
+
+    return latency[slot];
+}
+
+ReciprocalBandwidth LinkStateTable::get_reciprocal_bandwidth(const size_t slot) const noexcept {
+    assert(slot < size());
+
+    return reciprocal_bandwidth[slot];
+}
+
+PicoTime LinkStateTable::get_latency_ps(const size_t slot) const noexcept {
+    assert(slot < size());
+
+    return latency_ps[slot];
+}
+
+EventTime LinkStateTable::get_serialization_delay(const size_t slot, const ChunkSize chunk_size) noexcept {
+    return get_delays(slot, chunk_size).serialization_delay;
+}
+
+EventTime LinkStateTable::get_communication_delay(const size_t slot, const ChunkSize chunk_size) noexcept {
+    return get_delays(slot, chunk_size).communication_delay;
+}
+
+const LinkStateTable::DelayMemo& LinkStateTable::get_delays(const size_t slot, const ChunkSize chunk_size) noexcept {
+    assert(slot < size());
+    assert(chunk_size > 0);
+
+    // a chunk is serialized, then takes the latency to arrive, truncated to ns once per hop
+    auto& delay_memo = delay_memos[slot];
+    if (delay_memo.chunk_size != chunk_size) {
+        const auto serialization_delay = serialization_delay_ps(chunk_size, reciprocal_bandwidth[slot]);
+        delay_memo = {chunk_size, ps_to_event_time(serialization_delay),
+                      ps_to_event_time(latency_ps[slot] + serialization_delay)};
+    }
+    return delay_memo;
+}
+
+size_t LinkStateTable::count_busy_links(const EventTime current_time) const noexcept {
+    return static_cast<size_t>(std::count_if(busy_until.begin(), busy_until.end(),
+                                             [current_time](const EventTime time) { return time > current_time; }));
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Route.h"
+#include "congestion_aware/Device.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Topology.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Route::Route(const Topology& topology) noexcept
+    : topology(&topology),
+      src(-1),
+      last_device(-1),
+      links_count(0),
+      cursor(0),
+      interned_links(nullptr),
+      inline_links() {}
+
+Route::Route(const Topology& topology, const DeviceId src, const std::vector<LinkId>& interned_links) noexcept
+    : Route(topology, src, interned_links.data(), interned_links.size()) {}
+
+Route::Route(const Topology& topology,
+             const DeviceId src,
+             const LinkId* const interned_links,
+             const size_t links_count) noexcept
+    : topology(&topology),
+      src(src),
+      last_device(-1),
+      links_count(static_cast<uint32_t>(links_count)),
+      cursor(0),
+      interned_links(interned_links),
+      inline_links() {
+    assert(0 <= src && src < topology.get_devices_count());
+}
+
+void Route::push_back(const DeviceId device) noexcept {
+    assert(0 <= device && device < topology->get_devices_count());
+
+    // interned routes are immutable
+    assert(interned_links == nullptr);
+
+    // the first device is the src
+    if (src < 0) {
+        src = device;
+        last_device = device;
+        return;
+    }
+
+    // resolve the link of the new hop
+    const auto link = topology->get_link_id(last_device, device);
+    if (links_count < inline_capacity) {
+        inline_links[links_count] = link;
+    } else {
+        // moving out of the inline storage
+        if (links_count == inline_capacity) {
+            heap_links.assign(inline_links.begin(), inline_links.end());
+        }
+        heap_links.push_back(link);
+    }
+
+    links_count++;
+    last_device = device;
+}
+
+bool Route::empty() const noexcept {
+    return size() == 0;
+}
+
+size_t Route::size() const noexcept {
+    // a route with a src has one more device than hops
+    if (src < 0) {
+        return 0;
+    }
+    return links_count + 1 - cursor;
+}
+
+DeviceId Route::at(const size_t index) const noexcept {
+    assert(index < size());
+
+    // the device at a position is the src, or the dest of the hop reaching it
+    const auto position = cursor + index;
+    if (position == 0) {
+        return src;
+    }
+    return topology->get_link(link_id_at(position - 1))->get_dest();
+}
+
+Device* Route::device(const size_t index) const noexcept {
+    return topology->get_device(at(index));
+}
+
+LinkId Route::link_id(const size_t index) const noexcept {
+    assert(index + 1 < size());
+
+    return link_id_at(cursor + index);
+}
+
+Link* Route::link(const size_t index) const noexcept {
+    return topology->get_link(link_id(index));
+}
+
+void Route::pop_front() noexcept {
+    assert(!empty());
+
+    cursor++;
+}
+
+Route Route::share() const noexcept {
+    assert(!empty());
+
+    // the shared route is interned in the hops of this route
+    const auto* links = interned_links;
+    if (links == nullptr) {
+        links = links_count <= inline_capacity ? inline_links.data() : heap_links.data();
+    }
+    return {*topology, at(0), links + cursor, links_count - cursor};
+}
+
+LinkId Route::link_id_at(const size_t position) const noexcept {
+    assert(position < links_count);
+
+    if (interned_links != nullptr) {
+        return interned_links[position];
+    }
+    if (links_count <= inline_capacity) {
+        return inline_links[position];
+    }
+    return heap_links[position];
+}
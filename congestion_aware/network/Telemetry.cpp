@@ -0,0 +1,282 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Telemetry.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /**
+ * Append the elements of a counter array to a byte buffer.
+ *
+ * @param buffer buffer to append to
+ * @param counters counter array to append
+ */
+    template <typename T>
+    void append_counters(std::vector<char>& buffer, const std::vector<T>& counters) noexcept {
+        const auto* const bytes = reinterpret_cast<const char*>(counters.data());
+        buffer.insert(buffer.end(), bytes, bytes + (counters.size() * sizeof(T)));
+    }
+
+    /**
+ * Read the elements of a counter array appended by append_counters(), advancing the cursor.
+ *
+ * @param cursor current position in the buffer
+ * @param counters counter array to read into, already of the number of links
+ */
+    template <typename T>
+    void read_counters(const char*& cursor, std::vector<T>& counters) noexcept {
+        std::memcpy(counters.data(), cursor, counters.size() * sizeof(T));
+        cursor += counters.size() * sizeof(T);
+    }
+
+}  // namespace
+
+Telemetry::Telemetry() noexcept = default;
+
+void Telemetry::register_link(const LinkId id, const DeviceId src, const DeviceId dest) noexcept {
+    assert(id >= 0);
+
+    // grow the arrays to hold the link
+    reserve_links(id + 1);
+
+    this->src[id] = src;
+    this->dest[id] = dest;
+}
+
+void Telemetry::reserve_links(const int links_count) noexcept {
+    assert(links_count >= 0);
+
+    const auto new_links_count = std::max(static_cast<size_t>(links_count), this->src.size());
+    this->src.resize(new_links_count, -1);
+    this->dest.resize(new_links_count, -1);
+    bytes_sent.resize(new_links_count, 0);
+    chunks_sent.resize(new_links_count, 0);
+    busy_time.resize(new_links_count, 0);
+    pending_depth.resize(new_links_count, 0);
+    max_pending_depth.resize(new_links_count, 0);
+    pending_depth_integral.resize(new_links_count, 0);
+    pending_depth_changed_time.resize(new_links_count, 0);
+    queued_chunks.resize(new_links_count, 0);
+    queuing_delay_sum.resize(new_links_count, 0);
+    max_queuing_delay.resize(new_links_count, 0);
+}
+
+int Telemetry::get_links_count() const noexcept {
+    return static_cast<int>(src.size());
+}
+
+void Telemetry::record_transmission(const LinkId id, const ChunkSize chunk_size, const EventTime busy_time) noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    bytes_sent[id] += chunk_size;
+    chunks_sent[id]++;
+    this->busy_time[id] += busy_time;
+}
+
+void Telemetry::cancel_transmission(const LinkId id, const ChunkSize chunk_size, const EventTime busy_time) noexcept {
+    assert(0 <= id && id < get_links_count());
+    assert(bytes_sent[id] >= chunk_size);
+    assert(chunks_sent[id] > 0);
+    assert(this->busy_time[id] >= busy_time);
+
+    bytes_sent[id] -= chunk_size;
+    chunks_sent[id]--;
+    this->busy_time[id] -= busy_time;
+}
+
+void Telemetry::record_pending_depth(const LinkId id, const EventTime current_time, const size_t depth) noexcept {
+    assert(0 <= id && id < get_links_count());
+    assert(current_time >= pending_depth_changed_time[id]);
+
+    // accumulate the previous depth until now
+    const auto elapsed_time = current_time - pending_depth_changed_time[id];
+    pending_depth_integral[id] += static_cast<double>(pending_depth[id]) * static_cast<double>(elapsed_time);
+    pending_depth_changed_time[id] = current_time;
+
+    // update the depth
+    pending_depth[id] = depth;
+    max_pending_depth[id] = std::max(max_pending_depth[id], depth);
+}
+
+void Telemetry::record_queuing_delay(const LinkId id, const EventTime queuing_delay) noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    queued_chunks[id]++;
+    queuing_delay_sum[id] += queuing_delay;
+    max_queuing_delay[id] = std::max(max_queuing_delay[id], queuing_delay);
+}
+
+ChunkSize Telemetry::get_bytes_sent(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return bytes_sent[id];
+}
+
+uint64_t Telemetry::get_chunks_sent(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return chunks_sent[id];
+}
+
+EventTime Telemetry::get_busy_time(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return busy_time[id];
+}
+
+size_t Telemetry::get_max_pending_depth(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return max_pending_depth[id];
+}
+
+double Telemetry::get_average_pending_depth(const LinkId id, const EventTime end_time) const noexcept {
+    assert(0 <= id && id < get_links_count());
+    assert(end_time >= pending_depth_changed_time[id]);
+
+    if (end_time == 0) {
+        return 0;
+    }
+
+    // the current depth lasts until end_time
+    const auto elapsed_time = end_time - pending_depth_changed_time[id];
+    const auto integral =
+        pending_depth_integral[id] + (static_cast<double>(pending_depth[id]) * static_cast<double>(elapsed_time));
+    return integral / static_cast<double>(end_time);
+}
+
+uint64_t Telemetry::get_queued_chunks(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return queued_chunks[id];
+}
+
+double Telemetry::get_average_queuing_delay(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    if (queued_chunks[id] == 0) {
+        return 0;
+    }
+
+    return static_cast<double>(queuing_delay_sum[id]) / static_cast<double>(queued_chunks[id]);
+}
+
+EventTime Telemetry::get_max_queuing_delay(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    return max_queuing_delay[id];
+}
+
+void Telemetry::write_csv(std::ostream& out, const EventTime end_time) const noexcept {
+    out << "link,src,dest,bytes_sent,chunks_sent,busy_time,utilization,max_pending_depth,average_pending_depth,"
+        << "queued_chunks,average_queuing_delay,max_queuing_delay" << std::endl;
+
+    for (auto id = 0; id < get_links_count(); id++) {
+        const auto utilization =
+            (end_time == 0) ? 0.0 : static_cast<double>(busy_time[id]) / static_cast<double>(end_time);
+        out << id << "," << src[id] << "," << dest[id] << "," << bytes_sent[id] << "," << chunks_sent[id] << ","
+            << busy_time[id] << "," << utilization << "," << max_pending_depth[id] << ","
+            << get_average_pending_depth(id, end_time) << "," << queued_chunks[id] << ","
+            << get_average_queuing_delay(id) << "," << max_queuing_delay[id] << std::endl;
+    }
+}
+
+void Telemetry::write_json(std::ostream& out, const EventTime end_time) const noexcept {
+    out << "{\"end_time\": " << end_time << ", \"links\": [";
+
+    for (auto id = 0; id < get_links_count(); id++) {
+        const auto utilization =
+            (end_time == 0) ? 0.0 : static_cast<double>(busy_time[id]) / static_cast<double>(end_time);
+        out << ((id == 0) ? "" : ", ") << "{\"link\": " << id << ", \"src\": " << src[id]
+            << ", \"dest\": " << dest[id] << ", \"bytes_sent\": " << bytes_sent[id]
+            << ", \"chunks_sent\": " << chunks_sent[id] << ", \"busy_time\": " << busy_time[id]
+            << ", \"utilization\": " << utilization << ", \"max_pending_depth\": " << max_pending_depth[id]
+            << ", \"average_pending_depth\": " << get_average_pending_depth(id, end_time)
+            << ", \"queued_chunks\": " << queued_chunks[id]
+            << ", \"average_queuing_delay\": " << get_average_queuing_delay(id)
+            << ", \"max_queuing_delay\": " << max_queuing_delay[id] << "}";
+    }
+
+    out << "]}" << std::endl;
+}
+
+void Telemetry::merge(const Telemetry& other) noexcept {
+    for (auto id = 0; id < other.get_links_count(); id++) {
+        // skip the ids the other table never registered
+        if (other.src[id] < 0) {
+            continue;
+        }
+        if (id >= get_links_count() || src[id] < 0) {
+            register_link(id, other.src[id], other.dest[id]);
+        }
+
+        bytes_sent[id] += other.bytes_sent[id];
+        chunks_sent[id] += other.chunks_sent[id];
+        busy_time[id] += other.busy_time[id];
+        pending_depth[id] += other.pending_depth[id];
+        max_pending_depth[id] = std::max(max_pending_depth[id], other.max_pending_depth[id]);
+        pending_depth_integral[id] += other.pending_depth_integral[id];
+        pending_depth_changed_time[id] = std::max(pending_depth_changed_time[id], other.pending_depth_changed_time[id]);
+        queued_chunks[id] += other.queued_chunks[id];
+        queuing_delay_sum[id] += other.queuing_delay_sum[id];
+        max_queuing_delay[id] = std::max(max_queuing_delay[id], other.max_queuing_delay[id]);
+    }
+}
+
+void Telemetry::serialize(std::vector<char>& buffer) const noexcept {
+    // number of links, followed by each counter array
+    const auto links_count = static_cast<uint64_t>(get_links_count());
+    const auto* const header = reinterpret_cast<const char*>(&links_count);
+    buffer.insert(buffer.end(), header, header + sizeof(links_count));
+
+    append_counters(buffer, src);
+    append_counters(buffer, dest);
+    append_counters(buffer, bytes_sent);
+    append_counters(buffer, chunks_sent);
+    append_counters(buffer, busy_time);
+    append_counters(buffer, pending_depth);
+    append_counters(buffer, max_pending_depth);
+    append_counters(buffer, pending_depth_integral);
+    append_counters(buffer, pending_depth_changed_time);
+    append_counters(buffer, queued_chunks);
+    append_counters(buffer, queuing_delay_sum);
+    append_counters(buffer, max_queuing_delay);
+}
+
+Telemetry Telemetry::deserialize(const char* const data, [[maybe_unused]] const size_t size) noexcept {
+    assert(data != nullptr);
+    assert(size >= sizeof(uint64_t));
+
+    auto links_count = uint64_t(0);
+    std::memcpy(&links_count, data, sizeof(links_count));
+
+    // size the arrays, then fill them in the order serialized
+    auto telemetry = Telemetry();
+    if (links_count > 0) {
+        telemetry.register_link(static_cast<LinkId>(links_count - 1), -1, -1);
+    }
+    auto cursor = data + sizeof(links_count);
+    read_counters(cursor, telemetry.src);
+    read_counters(cursor, telemetry.dest);
+    read_counters(cursor, telemetry.bytes_sent);
+    read_counters(cursor, telemetry.chunks_sent);
+    read_counters(cursor, telemetry.busy_time);
+    read_counters(cursor, telemetry.pending_depth);
+    read_counters(cursor, telemetry.max_pending_depth);
+    read_counters(cursor, telemetry.pending_depth_integral);
+    read_counters(cursor, telemetry.pending_depth_changed_time);
+    read_counters(cursor, telemetry.queued_chunks);
+    read_counters(cursor, telemetry.queuing_delay_sum);
+    read_counters(cursor, telemetry.max_queuing_delay);
+    assert(cursor == data + size);
+
+    return telemetry;
+}
@@ -0,0 +1,277 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Tracer.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// magic number at the beginning of a binary trace file
+    constexpr char trace_magic[8] = {'A', 'N', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    /// number of records read at once when converting a trace file
+    constexpr size_t conversion_block_size = 4'096;
+
+    /// serial of the next tracer
+    std::atomic<uint64_t> next_tracer_serial(1);
+
+    /// buffer of the tracer the calling thread recorded to last
+    struct CachedThreadBuffer {
+        /// serial of the tracer, 0 if none
+        uint64_t serial;
+
+        /// buffer of the calling thread in the tracer
+        void* buffer;
+    };
+    thread_local CachedThreadBuffer cached_thread_buffer = {0, nullptr};
+
+    /// write a time in ns as us, which the Chrome trace format uses
+    void write_us(std::ostream& out, const EventTime time_ns) noexcept {
+        out << (time_ns / 1'000) << "." << std::setw(3) << std::setfill('0') << (time_ns % 1'000);
+    }
+
+}  // namespace
+
+static_assert(sizeof(TraceRecord) == 40, "trace records are written to the file as is");
+
+Tracer::Tracer(const std::string& path, const size_t buffer_capacity) noexcept
+    : serial(next_tracer_serial.fetch_add(1)),
+      buffer_capacity(buffer_capacity),
+      records_count(0),
+      stopping(false),
+      writing(false) {
+    assert(buffer_capacity > 0);
+
+    // create the trace file
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot create the trace file: " << path << std::endl;
+        std::exit(-1);
+    }
+    file.write(trace_magic, sizeof(trace_magic));
+
+    // start the writer
+    writer = std::thread(&Tracer::write_queued_buffers, this);
+}
+
+Tracer::~Tracer() noexcept {
+    flush();
+
+    // stop the writer
+    {
+        const auto lock = std::lock_guard<std::mutex>(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    writer.join();
+
+    file.close();
+}
+
+void Tracer::record(const TraceRecordType type,
+                    const EventTime begin,
+                    const EventTime end,
+                    const DeviceId src,
+                    const DeviceId dest,
+                    const ChunkSize chunk_size) noexcept {
+    assert(begin <= end);
+
+    auto* const buffer = thread_buffer();
+    buffer->records.push_back({begin, end, chunk_size, src, dest, type, buffer->thread});
+
+    // hand the full buffer to the writer
+    if (buffer->records.size() >= buffer_capacity) {
+        auto lock = std::unique_lock<std::mutex>(mutex);
+        enqueue(lock, *buffer);
+    }
+}
+
+void Tracer::flush() noexcept {
+    auto lock = std::unique_lock<std::mutex>(mutex);
+
+    // hand every non-empty buffer to the writer
+    for (const auto& buffer : thread_buffers) {
+        if (!buffer->records.empty()) {
+            enqueue(lock, *buffer);
+        }
+    }
+
+    // wait for the writer
+    condition.wait(lock, [this] { return queued_buffers.empty() && !writing; });
+    file.flush();
+}
+
+uint64_t Tracer::get_records_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+
+    // written or queued records, and the ones still buffered
+    auto count = records_count;
+    for (const auto& buffer : thread_buffers) {
+        count += buffer->records.size();
+    }
+    return count;
+}
+
+Tracer::ThreadBuffer* Tracer::thread_buffer() noexcept {
+    // fast path: the calling thread recorded to this tracer last time
+    if (cached_thread_buffer.serial == serial) {
+        return static_cast<ThreadBuffer*>(cached_thread_buffer.buffer);
+    }
+
+    // find the buffer of the calling thread, or register a new one
+    const auto lock = std::lock_guard<std::mutex>(mutex);
+    const auto thread_id = std::this_thread::get_id();
+    auto* buffer = static_cast<ThreadBuffer*>(nullptr);
+    for (const auto& thread_buffer : thread_buffers) {
+        if (thread_buffer->owner == thread_id) {
+            buffer = thread_buffer.get();
+            break;
+        }
+    }
+    if (buffer == nullptr) {
+        const auto thread = static_cast<uint32_t>(thread_buffers.size());
+        thread_buffers.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{thread, thread_id, {}}));
+        buffer = thread_buffers.back().get();
+        buffer->records.reserve(buffer_capacity);
+    }
+
+    cached_thread_buffer = {serial, buffer};
+    return buffer;
+}
+
+void Tracer::enqueue(std::unique_lock<std::mutex>& lock, ThreadBuffer& buffer) noexcept {
+    assert(lock.owns_lock());
+
+    // bound the memory held by the queued buffers
+    condition.wait(lock, [this] { return queued_buffers.size() < max_queued_buffers; });
+
+    records_count += buffer.records.size();
+    queued_buffers.push_back(std::move(buffer.records));
+    buffer.records = std::vector<TraceRecord>();
+    buffer.records.reserve(buffer_capacity);
+
+    condition.notify_all();
+}
+
+void Tracer::write_queued_buffers() noexcept {
+    auto lock = std::unique_lock<std::mutex>(mutex);
+
+    while (true) {
+        condition.wait(lock, [this] { return stopping || !queued_buffers.empty(); });
+        if (queued_buffers.empty()) {
+            // stopping
+            return;
+        }
+
+        // write the buffer without holding the lock
+        auto records = std::move(queued_buffers.front());
+        queued_buffers.pop_front();
+        writing = true;
+        lock.unlock();
+
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+
+        lock.lock();
+        writing = false;
+        condition.notify_all();
+    }
+}
+
+void Tracer::convert_to_chrome_json(const std::string& trace_path, const std::string& json_path) noexcept {
+    // open the trace file
+    auto trace = std::ifstream(trace_path, std::ios::binary);
+    char magic[sizeof(trace_magic)];
+    if (!trace.read(magic, sizeof(magic)) || std::memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "not a trace file: " << trace_path << std::endl;
+        std::exit(-1);
+    }
+
+    auto json = std::ofstream(json_path, std::ios::trunc);
+    if (!json.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot create the JSON file: " << json_path << std::endl;
+        std::exit(-1);
+    }
+
+    // stream the records as trace events
+    // a device is a process, and a link is a thread of its src device
+    auto tracks = std::set<std::pair<DeviceId, DeviceId>>();
+    auto records = std::vector<TraceRecord>(conversion_block_size);
+    auto first_event = true;
+    json << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    while (true) {
+        trace.read(reinterpret_cast<char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+        const auto records_read = static_cast<size_t>(trace.gcount()) / sizeof(TraceRecord);
+        if (records_read == 0) {
+            break;
+        }
+
+        for (auto i = size_t(0); i < records_read; i++) {
+            const auto& record = records[i];
+            json << (first_event ? "\n" : ",\n");
+            first_event = false;
+
+            switch (record.type) {
+            case TraceRecordType::Transmission:
+                tracks.insert({record.src, record.dest});
+                json << "{\"name\": \"chunk\", \"cat\": \"transmission\", \"ph\": \"X\", \"ts\": ";
+                write_us(json, record.begin);
+                json << ", \"dur\": ";
+                write_us(json, record.end - record.begin);
+                json << ", \"pid\": " << record.src << ", \"tid\": " << record.dest;
+                break;
+            case TraceRecordType::Arrival:
+                tracks.insert({record.dest, record.dest});
+                json << "{\"name\": \"arrival\", \"cat\": \"arrival\", \"ph\": \"i\", \"s\": \"t\", \"ts\": ";
+                write_us(json, record.begin);
+                json << ", \"pid\": " << record.dest << ", \"tid\": " << record.dest;
+                break;
+            case TraceRecordType::Rollback:
+                tracks.insert({record.src, record.dest});
+                json << "{\"name\": \"rollback\", \"cat\": \"express\", \"ph\": \"i\", \"s\": \"t\", \"ts\": ";
+                write_us(json, record.begin);
+                json << ", \"pid\": " << record.src << ", \"tid\": " << record.dest;
+                break;
+            }
+            json << ", \"args\": {\"src\": " << record.src << ", \"dest\": " << record.dest
+                 << ", \"size\": " << record.chunk_size << ", \"thread\": " << record.thread << "}}";
+        }
+    }
+
+    // name the tracks
+    auto named_device = DeviceId(-1);
+    for (const auto& [device, track] : tracks) {
+        if (device != named_device) {
+            json << (first_event ? "\n" : ",\n") << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << device
+                 << ", \"args\": {\"name\": \"device " << device << "\"}}";
+            first_event = false;
+            named_device = device;
+        }
+
+        json << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << device << ", \"tid\": " << track
+             << ", \"args\": {\"name\": \"";
+        if (device == track) {
+            json << "arrivals";
+        } else {
+            json << "link " << device << " -> " << track;
+        }
+        json << "\"}}";
+    }
+    json << "\n]}" << std::endl;
+}
@@ -0,0 +1,417 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ParallelSimulator.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Link.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /**
+ * Reusable barrier synchronizing a fixed number of threads.
+ */
+    class Barrier {
+    public:
+        explicit Barrier(const int threads_count) noexcept
+            : threads_count(threads_count), waiting_count(0), generation(0) {}
+
+        void wait() noexcept {
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            const auto arrived_generation = generation;
+
+            if (++waiting_count == threads_count) {
+                // last thread to arrive releases the others
+                waiting_count = 0;
+                generation++;
+                condition.notify_all();
+            } else {
+                condition.wait(lock, [&] { return generation != arrived_generation; });
+            }
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        int threads_count;
+        int waiting_count;
+        unsigned long generation;
+    };
+
+}  // namespace
+
+ParallelSimulator::ParallelSimulator(std::shared_ptr<Topology> topology, const int partitions_count) noexcept
+    : topology(std::move(topology)),
+      partitions_count(partitions_count),
+      running(false),
+      next_rank(0),
+      lookahead(std::numeric_limits<EventTime>::max()) {
+    assert(this->topology != nullptr);
+
+    const auto devices_count = this->topology->get_devices_count();
+    assert(0 < partitions_count && partitions_count <= devices_count);
+
+    // express scheduling relays the arrivals, which can't be held at the window barrier
+    if (this->topology->get_express_scheduling()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "parallel simulation doesn't support express scheduling" << std::endl;
+        std::exit(-1);
+    }
+
+    // partition devices into contiguous id ranges
+    partition_of_device = std::vector<int>(devices_count);
+    for (auto device = 0; device < devices_count; device++) {
+        partition_of_device[device] = static_cast<int>(static_cast<long>(device) * partitions_count / devices_count);
+    }
+
+    // create partitions, whose events are intercepted to keep the sequential order
+    for (auto id = 0; id < partitions_count; id++) {
+        auto partition = std::make_unique<Partition>();
+        partition->simulator = this;
+        partition->id = id;
+        partition->event_queue = std::make_unique<EventQueue>();
+        partition->event_queue->set_schedule_hook(intercept_event, partition.get());
+        partitions.push_back(std::move(partition));
+    }
+
+    // the lookahead is the smallest latency of the links crossing partitions
+    // lazy links share a single latency, so they're not created to find it
+    if (this->topology->has_lazy_links()) {
+        if (partitions_count > 1) {
+            lookahead = static_cast<EventTime>(this->topology->get_min_link_latency());
+        }
+    } else {
+        const auto links_count = this->topology->get_links_count();
+        for (auto link_id = 0; link_id < links_count; link_id++) {
+            const auto* const link = this->topology->get_link(link_id);
+            if (partition_of_device[link->get_src()] != partition_of_device[link->get_dest()]) {
+                lookahead = std::min(lookahead, static_cast<EventTime>(link->get_latency()));
+            }
+        }
+    }
+
+    // bind links to partitions, including the lazy links created later
+    this->topology->set_link_event_queues(
+            [this](const Link& link) { return partitions[partition_of_device[link.get_src()]]->event_queue.get(); });
+    bind_outboxes();
+
+    // chunks are created and destroyed, and lazy links created, by every worker
+    this->topology->set_concurrent(true);
+
+    // a chunk arrival should never be scheduled within the window it's sent
+    if (lookahead == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "parallel simulation requires links crossing partitions to have latency of at least 1 ns"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+ParallelSimulator::~ParallelSimulator() noexcept {
+    // bind links back to the event queue of the topology
+    topology->set_link_event_queues(nullptr);
+    topology->set_link_outboxes(nullptr);
+
+    topology->set_concurrent(false);
+}
+
+int ParallelSimulator::get_partitions_count() const noexcept {
+    return partitions_count;
+}
+
+int ParallelSimulator::get_partition(const DeviceId device) const noexcept {
+    assert(0 <= device && device < static_cast<DeviceId>(partition_of_device.size()));
+
+    return partition_of_device[device];
+}
+
+EventQueue* ParallelSimulator::get_event_queue(const DeviceId device) const noexcept {
+    return partitions[get_partition(device)]->event_queue.get();
+}
+
+EventTime ParallelSimulator::get_lookahead() const noexcept {
+    return lookahead;
+}
+
+EventTime ParallelSimulator::get_current_time() const noexcept {
+    auto current_time = static_cast<EventTime>(0);
+    for (const auto& partition : partitions) {
+        current_time = std::max(current_time, partition->event_queue->get_current_time());
+    }
+
+    return current_time;
+}
+
+RunSummary ParallelSimulator::run() noexcept {
+    constexpr auto no_event = std::numeric_limits<EventTime>::max();
+    const auto start = std::chrono::steady_clock::now();
+
+    // held events are merged by time, keeping the order each partition scheduled them
+    const auto sort_held_events = [](Partition& partition) {
+        std::stable_sort(partition.held_events.begin(), partition.held_events.end(),
+                         [](const auto& lhs, const auto& rhs) { return lhs.time < rhs.time; });
+    };
+
+    // events scheduled before the run are held in the order scheduled, so schedule them first
+    hold_idle_handovers();
+    running = true;
+    bind_outboxes();
+    for (auto& partition : partitions) {
+        sort_held_events(*partition);
+    }
+    merge_held_events();
+    for (auto& partition : partitions) {
+        deliver_held_events(*partition);
+    }
+
+    // per-partition shared states
+    auto next_event_times = std::vector<EventTime>(partitions_count, no_event);
+    auto summaries = std::vector<RunSummary>(partitions_count);
+    auto barrier = Barrier(partitions_count);
+
+    const auto run_partition = [&](const int id) {
+        auto& partition = *partitions[id];
+        auto& event_queue = *partition.event_queue;
+
+        while (true) {
+            // publish the next event time of this partition
+            next_event_times[id] = event_queue.finished() ? no_event : event_queue.peek_next_event_time();
+            barrier.wait();
+
+            // every partition computes the same window
+            const auto window_start = *std::min_element(next_event_times.begin(), next_event_times.end());
+            if (window_start == no_event) {
+                // every partition is finished, and no event is held
+                return;
+            }
+            partition.window_end = (window_start > no_event - lookahead) ? no_event : window_start + lookahead - 1;
+
+            // run the window independently
+            const auto summary = event_queue.run_until(partition.window_end);
+            summaries[id].events_count += summary.events_count;
+            summaries[id].event_times_count += summary.event_times_count;
+            sort_held_events(partition);
+            barrier.wait();
+
+            // the events held by every partition are merged at once, while the invocation logs are intact
+            if (id == 0) {
+                merge_held_events();
+            }
+            barrier.wait();
+
+            deliver_held_events(partition);
+        }
+    };
+
+    // run partition 0 on this thread, and the others on worker threads
+    auto workers = std::vector<std::thread>();
+    for (auto id = 1; id < partitions_count; id++) {
+        workers.emplace_back(run_partition, id);
+    }
+    run_partition(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    running = false;
+    bind_outboxes();
+
+    // accumulate summaries
+    auto summary = RunSummary();
+    for (const auto& partition_summary : summaries) {
+        summary.events_count += partition_summary.events_count;
+        summary.event_times_count += partition_summary.event_times_count;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    summary.wall_time = std::chrono::duration<double>(end - start).count();
+
+    return summary;
+}
+
+void ParallelSimulator::bind_outboxes() noexcept {
+    // chunks crossing partitions are handed over through the outbox of their src partition,
+    // or, while not running, through a single outbox keeping the order they're sent across partitions
+    topology->set_link_outboxes([this](const Link& link) -> ChunkMailbox* {
+        const auto src_partition = partition_of_device[link.get_src()];
+        if (src_partition == partition_of_device[link.get_dest()]) {
+            return nullptr;
+        }
+        return running ? &partitions[src_partition]->outbox : &idle_outbox;
+    });
+}
+
+bool ParallelSimulator::intercept_event(void* const partition_ptr,
+                                        const EventTime event_time,
+                                        Callback& callback,
+                                        CallbackArg& callback_arg) noexcept {
+    assert(partition_ptr != nullptr);
+
+    // events delivered at the barrier are tracked already
+    if (callback == invoke_tracked_event) {
+        return false;
+    }
+
+    auto& partition = *static_cast<Partition*>(partition_ptr);
+    auto& simulator = *partition.simulator;
+
+    // scheduled outside of the run: ranked in the order scheduled, after the chunks handed over so far
+    if (partition.invocation == no_invocation) {
+        simulator.hold_idle_handovers();
+        partition.held_events.push_back({event_time, {false, simulator.next_rank++}, partition.id, callback,
+                                         callback_arg});
+        return true;
+    }
+
+    // scheduled by the event in progress: held if it's due past the window, tracked otherwise
+    const auto origin = EventOrigin{true, partition.invocation};
+    if (event_time > partition.window_end) {
+        partition.held_events.push_back({event_time, origin, partition.id, callback, callback_arg});
+        return true;
+    }
+    callback_arg = track_event(partition, origin, callback, callback_arg);
+    callback = invoke_tracked_event;
+    return false;
+}
+
+void ParallelSimulator::invoke_tracked_event(void* const tracked_event_ptr) noexcept {
+    assert(tracked_event_ptr != nullptr);
+
+    auto* const tracked_event = static_cast<TrackedEvent*>(tracked_event_ptr);
+    auto& partition = *tracked_event->partition;
+    const auto callback = tracked_event->callback;
+    const auto callback_arg = tracked_event->callback_arg;
+
+    // log the invocation, as the origin of the events it schedules
+    partition.invocations.push_back({partition.event_queue->get_current_time(), tracked_event->origin});
+    partition.free_tracked_events.push_back(tracked_event);
+    partition.invocation = partition.invocations.size() - 1;
+
+    (*callback)(callback_arg);
+
+    // the chunks handed over to other partitions are held as well
+    partition.simulator->hold_handovers(partition, partition.outbox, {true, partition.invocation});
+    partition.invocation = no_invocation;
+}
+
+ParallelSimulator::TrackedEvent* ParallelSimulator::track_event(Partition& partition,
+                                                                const EventOrigin origin,
+                                                                const Callback callback,
+                                                                const CallbackArg callback_arg) noexcept {
+    // reuse a free tracked event if any
+    auto* tracked_event = static_cast<TrackedEvent*>(nullptr);
+    if (partition.free_tracked_events.empty()) {
+        tracked_event = &partition.tracked_events.emplace_back();
+    } else {
+        tracked_event = partition.free_tracked_events.back();
+        partition.free_tracked_events.pop_back();
+    }
+
+    *tracked_event = {&partition, origin, callback, callback_arg};
+    return tracked_event;
+}
+
+void ParallelSimulator::hold_idle_handovers() noexcept {
+    for (const auto& delivery : idle_outbox) {
+        auto& partition = *partitions[partition_of_device[delivery.chunk->next_device()->get_id()]];
+        partition.held_events.push_back({delivery.arrival_time, {false, next_rank++}, partition.id,
+                                         invoke_typed_event<Chunk, Chunk::chunk_arrived_next_device>, delivery.chunk});
+    }
+    idle_outbox.clear();
+}
+
+void ParallelSimulator::hold_handovers(Partition& partition,
+                                       ChunkMailbox& outbox,
+                                       const EventOrigin origin) const noexcept {
+    for (const auto& delivery : outbox) {
+        partition.held_events.push_back({delivery.arrival_time, origin,
+                                         partition_of_device[delivery.chunk->next_device()->get_id()],
+                                         invoke_typed_event<Chunk, Chunk::chunk_arrived_next_device>, delivery.chunk});
+    }
+    outbox.clear();
+}
+
+bool ParallelSimulator::precedes(const int lhs_partition,
+                                 const HeldEvent& lhs,
+                                 const int rhs_partition,
+                                 const HeldEvent& rhs) const noexcept {
+    if (lhs.time != rhs.time) {
+        return lhs.time < rhs.time;
+    }
+
+    // at the same time, the event scheduled first sequentially is invoked first:
+    // trace back the events scheduling them, until they're ranked or invoked by the same partition
+    // the events scheduled within the window descend from the events of the same partition only
+    auto lhs_origin = lhs.origin;
+    auto rhs_origin = rhs.origin;
+    while (true) {
+        if (!lhs_origin.in_window || !rhs_origin.in_window) {
+            // the ranked events are scheduled before the window
+            if (lhs_origin.in_window == rhs_origin.in_window) {
+                return lhs_origin.index < rhs_origin.index;
+            }
+            return !lhs_origin.in_window;
+        }
+        if (lhs_partition == rhs_partition) {
+            return lhs_origin.index < rhs_origin.index;
+        }
+
+        const auto& lhs_invocation = partitions[lhs_partition]->invocations[lhs_origin.index];
+        const auto& rhs_invocation = partitions[rhs_partition]->invocations[rhs_origin.index];
+        if (lhs_invocation.time != rhs_invocation.time) {
+            return lhs_invocation.time < rhs_invocation.time;
+        }
+        lhs_origin = lhs_invocation.origin;
+        rhs_origin = rhs_invocation.origin;
+    }
+}
+
+void ParallelSimulator::merge_held_events() noexcept {
+    // merge the sorted held events of the partitions, picking the first one sequentially each time
+    auto cursors = std::vector<size_t>(partitions_count, 0);
+    while (true) {
+        auto first = -1;
+        for (auto id = 0; id < partitions_count; id++) {
+            const auto& held_events = partitions[id]->held_events;
+            if (cursors[id] < held_events.size() &&
+                (first < 0 || precedes(id, held_events[cursors[id]], first,
+                                       partitions[first]->held_events[cursors[first]]))) {
+                first = id;
+            }
+        }
+        if (first < 0) {
+            break;
+        }
+
+        // rank the event in the sequential order, and hand it over to its partition
+        const auto& event = partitions[first]->held_events[cursors[first]++];
+        partitions[event.partition]->deliveries.push_back(
+                {event.time, {false, next_rank++}, event.partition, event.callback, event.callback_arg});
+    }
+
+    for (auto& partition : partitions) {
+        partition->held_events.clear();
+    }
+}
+
+void ParallelSimulator::deliver_held_events(Partition& partition) noexcept {
+    // the ranks of the delivered events replace the invocations of the window
+    partition.invocations.clear();
+
+    for (const auto& event : partition.deliveries) {
+        auto* const tracked_event = track_event(partition, event.origin, event.callback, event.callback_arg);
+        partition.event_queue->schedule_event(event.time, invoke_tracked_event, tracked_event);
+    }
+    partition.deliveries.clear();
+}
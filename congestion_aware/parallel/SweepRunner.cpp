@@ -0,0 +1,69 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SweepRunner.h"
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Helper.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+SweepRunner::SweepRunner(const int threads_count) noexcept : threads_count(threads_count) {
+    assert(threads_count > 0);
+}
+
+void SweepRunner::add_config(const std::string& network_config_path, SweepWorkload workload) noexcept {
+    assert(workload != nullptr);
+
+    configs.push_back({network_config_path, std::move(workload)});
+}
+
+int SweepRunner::get_configs_count() const noexcept {
+    return static_cast<int>(configs.size());
+}
+
+std::vector<EventTime> SweepRunner::run() const noexcept {
+    auto finish_times = std::vector<EventTime>(configs.size(), 0);
+
+    // each worker repeatedly takes the next configuration not yet simulated
+    auto next_config = std::atomic<size_t>(0);
+    const auto run_worker = [&] {
+        for (auto i = next_config++; i < configs.size(); i = next_config++) {
+            finish_times[i] = run_config(configs[i]);
+        }
+    };
+
+    // run one worker on this thread, and the others on worker threads
+    const auto workers_count = std::min<size_t>(threads_count, configs.size());
+    auto workers = std::vector<std::thread>();
+    for (size_t i = 1; i < workers_count; i++) {
+        workers.emplace_back(run_worker);
+    }
+    run_worker();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return finish_times;
+}
+
+EventTime SweepRunner::run_config(const SweepConfig& config) noexcept {
+    // construct a topology bound to its own event queue
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser(config.network_config_path);
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    // run the workload
+    config.workload(*topology);
+    event_queue->run_to_completion();
+
+    return event_queue->get_current_time();
+}
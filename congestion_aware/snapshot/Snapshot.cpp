@@ -0,0 +1,306 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Snapshot.h"
+#include "common/Event.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Route.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// magic number at the beginning of a snapshot file
+    constexpr char snapshot_magic[8] = {'A', 'N', 'S', 'N', 'A', 'P', '0', '1'};
+
+    /// event handlers of the network components
+    const auto chunk_arrival_handler = &invoke_typed_event<Chunk, Chunk::chunk_arrived_next_device>;
+    const auto link_free_handler = &invoke_typed_event<Link, Link::link_become_free>;
+
+    [[noreturn]] void snapshot_error(const std::string& message) noexcept {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << message << std::endl;
+        std::exit(-1);
+    }
+
+    template <typename T>
+    void write_value(std::ostream& out, const T& value) noexcept {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    [[nodiscard]] T read_value(std::istream& in) noexcept {
+        auto value = T();
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            snapshot_error("truncated snapshot file");
+        }
+        return value;
+    }
+
+}  // namespace
+
+Snapshot::Snapshot() noexcept : time(0), devices_count(0) {}
+
+Snapshot Snapshot::capture(const Topology& topology, const CallbackEncoder& encoder) noexcept {
+    const auto event_queue = topology.get_event_queue();
+    assert(event_queue != nullptr);
+
+    auto snapshot = Snapshot();
+    snapshot.time = event_queue->get_current_time();
+    snapshot.devices_count = topology.get_devices_count();
+
+    // capture the links
+    const auto links_count = topology.get_links_count();
+    auto link_ids = std::unordered_map<const Link*, LinkId>();
+    snapshot.links.reserve(links_count);
+    for (auto id = 0; id < links_count; id++) {
+        const auto* const link = topology.get_link(id);
+        link_ids[link] = id;
+
+        if (link->outbox != nullptr) {
+            snapshot_error("snapshots are not supported while a parallel simulation is alive");
+        }
+        if (link->reserved_chunk != nullptr && link->reservation_time > snapshot.time) {
+            snapshot_error("snapshots of in-flight express reservations are not supported");
+        }
+
+        auto link_state = LinkState{link->get_busy_until(), {}};
+        for (auto i = size_t(0); i < link->pending_chunks.size(); i++) {
+            link_state.pending_chunks.push_back(capture_chunk(*link->pending_chunks.at(i), encoder));
+        }
+        snapshot.links.push_back(std::move(link_state));
+    }
+
+    // capture the pending events, in order
+    event_queue->for_each_event([&](const EventTime time, const Callback callback, const CallbackArg callback_arg) {
+        auto event = EventState{time, EventKind::UserEvent, -1, 0, {}};
+
+        if (callback == chunk_arrival_handler) {
+            event.kind = EventKind::ChunkArrival;
+            event.chunk = capture_chunk(*static_cast<const Chunk*>(callback_arg), encoder);
+        } else if (callback == link_free_handler) {
+            event.kind = EventKind::LinkFree;
+            event.link = link_ids.at(static_cast<const Link*>(callback_arg));
+        } else {
+            event.callback = encoder(callback, callback_arg);
+        }
+
+        snapshot.events.push_back(std::move(event));
+    });
+
+    return snapshot;
+}
+
+Snapshot Snapshot::load(const std::string& path) noexcept {
+    auto in = std::ifstream(path, std::ios::binary);
+    char magic[sizeof(snapshot_magic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, snapshot_magic, sizeof(magic)) != 0) {
+        snapshot_error("not a snapshot file: " + path);
+    }
+
+    const auto read_chunk = [&in]() {
+        auto chunk = ChunkState();
+        chunk.chunk_size = read_value<ChunkSize>(in);
+        chunk.callback = read_value<CallbackHandle>(in);
+        chunk.route.resize(read_value<uint32_t>(in));
+        for (auto& device : chunk.route) {
+            device = read_value<DeviceId>(in);
+        }
+        return chunk;
+    };
+
+    auto snapshot = Snapshot();
+    snapshot.time = read_value<EventTime>(in);
+    snapshot.devices_count = read_value<int32_t>(in);
+
+    snapshot.links.resize(read_value<uint32_t>(in));
+    for (auto& link : snapshot.links) {
+        link.busy_until = read_value<EventTime>(in);
+        link.pending_chunks.resize(read_value<uint32_t>(in));
+        for (auto& chunk : link.pending_chunks) {
+            chunk = read_chunk();
+        }
+    }
+
+    snapshot.events.resize(read_value<uint64_t>(in));
+    for (auto& event : snapshot.events) {
+        event.time = read_value<EventTime>(in);
+        event.kind = read_value<EventKind>(in);
+        switch (event.kind) {
+        case EventKind::ChunkArrival:
+            event.chunk = read_chunk();
+            break;
+        case EventKind::LinkFree:
+            event.link = read_value<LinkId>(in);
+            break;
+        case EventKind::UserEvent:
+            event.callback = read_value<CallbackHandle>(in);
+            break;
+        default:
+            snapshot_error("corrupted snapshot file: " + path);
+        }
+    }
+
+    return snapshot;
+}
+
+void Snapshot::save(const std::string& path) const noexcept {
+    auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        snapshot_error("cannot create the snapshot file: " + path);
+    }
+
+    const auto write_chunk = [&out](const ChunkState& chunk) {
+        write_value(out, chunk.chunk_size);
+        write_value(out, chunk.callback);
+        write_value(out, static_cast<uint32_t>(chunk.route.size()));
+        for (const auto device : chunk.route) {
+            write_value(out, device);
+        }
+    };
+
+    out.write(snapshot_magic, sizeof(snapshot_magic));
+    write_value(out, time);
+    write_value(out, static_cast<int32_t>(devices_count));
+
+    write_value(out, static_cast<uint32_t>(links.size()));
+    for (const auto& link : links) {
+        write_value(out, link.busy_until);
+        write_value(out, static_cast<uint32_t>(link.pending_chunks.size()));
+        for (const auto& chunk : link.pending_chunks) {
+            write_chunk(chunk);
+        }
+    }
+
+    write_value(out, static_cast<uint64_t>(events.size()));
+    for (const auto& event : events) {
+        write_value(out, event.time);
+        write_value(out, event.kind);
+        switch (event.kind) {
+        case EventKind::ChunkArrival:
+            write_chunk(event.chunk);
+            break;
+        case EventKind::LinkFree:
+            write_value(out, event.link);
+            break;
+        case EventKind::UserEvent:
+            write_value(out, event.callback);
+            break;
+        }
+    }
+
+    if (!out) {
+        snapshot_error("cannot write the snapshot file: " + path);
+    }
+}
+
+void Snapshot::restore(Topology& topology, const CallbackDecoder& decoder) const noexcept {
+    const auto event_queue = topology.get_event_queue();
+    assert(event_queue != nullptr);
+
+    // the topology should be of the same shape, and idle
+    if (topology.get_devices_count() != devices_count ||
+        static_cast<size_t>(topology.get_links_count()) != links.size()) {
+        snapshot_error("snapshot doesn't match the topology");
+    }
+    if (!event_queue->finished()) {
+        snapshot_error("snapshot should be restored into an empty event queue");
+    }
+
+    // resume from the snapshot time
+    event_queue->set_current_time(time);
+
+    // restore the links
+    for (auto id = 0; id < static_cast<int>(links.size()); id++) {
+        auto* const link = topology.get_link(id);
+        assert(!link->pending_chunk_exists());
+
+        link->set_busy_until(links[id].busy_until);
+        link->reserved_chunk = nullptr;
+        for (const auto& chunk : links[id].pending_chunks) {
+            link->pending_chunks.push_back(restore_chunk(topology, chunk, decoder));
+#ifdef ANALYTICAL_TELEMETRY
+            link->pending_since.push_back(time);
+#endif
+        }
+    }
+
+    // restore the pending events, in order
+    for (const auto& event : events) {
+        switch (event.kind) {
+        case EventKind::ChunkArrival:
+            restore_chunk(topology, event.chunk, decoder).release()->schedule_arrival(event_queue.get(), event.time);
+            break;
+        case EventKind::LinkFree:
+            event_queue->schedule_event<Link, Link::link_become_free>(event.time, topology.get_link(event.link));
+            break;
+        case EventKind::UserEvent: {
+            const auto [callback, callback_arg] = decoder(event.callback);
+            event_queue->schedule_event(event.time, callback, callback_arg);
+            break;
+        }
+        }
+    }
+}
+
+EventTime Snapshot::get_time() const noexcept {
+    return time;
+}
+
+size_t Snapshot::get_events_count() const noexcept {
+    return events.size();
+}
+
+size_t Snapshot::get_chunks_count() const noexcept {
+    auto chunks_count = size_t(0);
+    for (const auto& link : links) {
+        chunks_count += link.pending_chunks.size();
+    }
+    for (const auto& event : events) {
+        if (event.kind == EventKind::ChunkArrival) {
+            chunks_count++;
+        }
+    }
+    return chunks_count;
+}
+
+Snapshot::ChunkState Snapshot::capture_chunk(const Chunk& chunk, const CallbackEncoder& encoder) noexcept {
+    if (chunk.express_hops > 0) {
+        snapshot_error("snapshots of in-flight express reservations are not supported");
+    }
+    if (chunk.callback == Chunk::packet_arrived) {
+        snapshot_error("snapshots of in-flight cut-through packets are not supported");
+    }
+
+    auto chunk_state = ChunkState{chunk.get_size(), encoder(chunk.callback, chunk.callback_arg), {}};
+
+    const auto& route = chunk.get_route();
+    chunk_state.route.reserve(route.size());
+    for (auto i = size_t(0); i < route.size(); i++) {
+        chunk_state.route.push_back(route.at(i));
+    }
+
+    return chunk_state;
+}
+
+std::unique_ptr<Chunk> Snapshot::restore_chunk(Topology& topology,
+                                               const ChunkState& chunk,
+                                               const CallbackDecoder& decoder) noexcept {
+    auto route = Route(topology);
+    for (const auto device : chunk.route) {
+        route.push_back(device);
+    }
+
+    const auto [callback, callback_arg] = decoder(chunk.callback);
+    return std::unique_ptr<Chunk>(new (topology.get_chunk_pool())
+                                      Chunk(chunk.chunk_size, std::move(route), callback, callback_arg));
+}
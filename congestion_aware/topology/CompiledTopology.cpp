@@ -0,0 +1,281 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CompiledTopology.h"
+#include "common/Hash.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Route.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// magic number at the beginning of a compiled topology file
+    constexpr char compiled_topology_magic[8] = {'A', 'N', 'T', 'O', 'P', 'O', 'L', 'G'};
+
+    /// header of a compiled topology file
+    struct FileHeader {
+        /// magic number
+        char magic[8];
+
+        /// format version
+        uint32_t version;
+
+        /// number of network dimensions
+        int32_t dims_count;
+
+        /// hash of the network configuration
+        uint64_t config_hash;
+
+        /// number of devices
+        int32_t devices_count;
+
+        /// number of NPUs
+        int32_t npus_count;
+
+        /// number of links
+        uint64_t links_count;
+
+        /// number of hops of every route in total
+        uint64_t route_links_count;
+    };
+
+    /// record of a network dimension
+    struct DimRecord {
+        /// number of NPUs of the dimension
+        int32_t npus_count;
+
+        /// unused, keeps the bandwidth aligned
+        int32_t reserved;
+
+        /// bandwidth of the dimension
+        Bandwidth bandwidth;
+    };
+
+    /// record of a link, in LinkId order
+    struct LinkRecord {
+        /// src device
+        DeviceId src;
+
+        /// dest device
+        DeviceId dest;
+
+        /// bandwidth of the link
+        Bandwidth bandwidth;
+
+        /// latency of the link
+        Latency latency;
+
+        /// 1 if the link is analytical (never queues), 0 otherwise
+        uint32_t analytical;
+
+        /// unused, keeps the records aligned
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 48, "compiled topology records are mapped as is");
+    static_assert(sizeof(DimRecord) == 16, "compiled topology records are mapped as is");
+    static_assert(sizeof(LinkRecord) == 32, "compiled topology records are mapped as is");
+
+    /// size of a compiled topology file with the given header
+    [[nodiscard]] size_t compiled_file_size(const FileHeader& header) noexcept {
+        const auto npu_pairs_count = static_cast<size_t>(header.npus_count) * static_cast<size_t>(header.npus_count);
+        return sizeof(FileHeader) + (static_cast<size_t>(header.dims_count) * sizeof(DimRecord)) +
+               (header.links_count * sizeof(LinkRecord)) + ((npu_pairs_count + 1) * sizeof(uint64_t)) +
+               (header.route_links_count * sizeof(LinkId));
+    }
+
+    template <typename T>
+    void write_array(std::ostream& out, const std::vector<T>& values) noexcept {
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+}  // namespace
+
+void CompiledTopology::compile(const Topology& topology, const uint64_t config_hash, const std::string& path) noexcept {
+    const auto dims_count = topology.get_dims_count();
+    const auto npus_count = topology.get_npus_count();
+    const auto links_count = topology.get_links_count();
+
+    // collect the dimensions
+    const auto npus_count_per_dim = topology.get_npus_count_per_dim();
+    const auto bandwidth_per_dim = topology.get_bandwidth_per_dim();
+    auto dims = std::vector<DimRecord>();
+    for (auto dim = 0; dim < dims_count; dim++) {
+        dims.push_back({npus_count_per_dim[dim], 0, bandwidth_per_dim[dim]});
+    }
+
+    // collect the link table
+    auto links = std::vector<LinkRecord>();
+    links.reserve(links_count);
+    for (auto id = 0; id < links_count; id++) {
+        const auto* const link = topology.get_link(id);
+        links.push_back({link->get_src(), link->get_dest(), link->get_bandwidth(), link->get_latency(),
+                         link->is_analytical() ? 1U : 0U, 0});
+    }
+
+    // collect the route of every NPU pair
+    auto route_offsets = std::vector<uint64_t>();
+    route_offsets.reserve((static_cast<size_t>(npus_count) * npus_count) + 1);
+    auto route_links = std::vector<LinkId>();
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            route_offsets.push_back(route_links.size());
+            if (src == dest) {
+                continue;
+            }
+
+            const auto route = topology.route(src, dest);
+            for (auto i = size_t(0); i + 1 < route.size(); i++) {
+                route_links.push_back(route.link_id(i));
+            }
+        }
+    }
+    route_offsets.push_back(route_links.size());
+
+    // write to a temporary file first, so that runs loading the file concurrently never see a partial one
+    const auto temporary_path = path + ".tmp." + std::to_string(getpid());
+    auto out = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot create the compiled topology file: " << temporary_path << std::endl;
+        std::exit(-1);
+    }
+
+    auto header = FileHeader();
+    std::memcpy(header.magic, compiled_topology_magic, sizeof(compiled_topology_magic));
+    header.version = format_version;
+    header.dims_count = dims_count;
+    header.config_hash = config_hash;
+    header.devices_count = topology.get_devices_count();
+    header.npus_count = npus_count;
+    header.links_count = links.size();
+    header.route_links_count = route_links.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_array(out, dims);
+    write_array(out, links);
+    write_array(out, route_offsets);
+    write_array(out, route_links);
+    out.close();
+
+    if (!out || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot write the compiled topology file: " << path << std::endl;
+        std::remove(temporary_path.c_str());
+        std::exit(-1);
+    }
+}
+
+std::shared_ptr<CompiledTopology> CompiledTopology::load(const std::string& path, const uint64_t config_hash) noexcept {
+    // a missing file is a cache miss
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping stays valid after the file is closed
+    const auto mapping_size = static_cast<size_t>(file_stat.st_size);
+    auto* const mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // reject a file of another format, version, or configuration
+    const auto* const header = static_cast<const FileHeader*>(mapping);
+    if (std::memcmp(header->magic, compiled_topology_magic, sizeof(compiled_topology_magic)) != 0 ||
+        header->version != format_version || header->config_hash != config_hash || header->dims_count <= 0 ||
+        header->npus_count <= 0 || header->devices_count < header->npus_count ||
+        compiled_file_size(*header) != mapping_size) {
+        munmap(mapping, mapping_size);
+        return nullptr;
+    }
+
+    return std::shared_ptr<CompiledTopology>(new CompiledTopology(mapping, mapping_size));
+}
+
+uint64_t CompiledTopology::hash_network_config(const std::string& network_config_path) noexcept {
+    auto in = std::ifstream(network_config_path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot open the network configuration file: " << network_config_path << std::endl;
+        std::exit(-1);
+    }
+
+    // FNV-1a over the contents of the file
+    auto hash = fnv1a_offset_basis;
+    char buffer[4'096];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        hash_bytes(hash, buffer, static_cast<size_t>(in.gcount()));
+    }
+    return hash;
+}
+
+CompiledTopology::CompiledTopology(void* const mapping, const size_t mapping_size) noexcept
+    : Topology(),
+      mapping(mapping),
+      mapping_size(mapping_size),
+      route_offsets(nullptr),
+      route_links(nullptr) {
+    assert(mapping != nullptr);
+
+    // locate the sections
+    const auto* const header = static_cast<const FileHeader*>(mapping);
+    const auto* const dims = reinterpret_cast<const DimRecord*>(header + 1);
+    const auto* const link_records = reinterpret_cast<const LinkRecord*>(dims + header->dims_count);
+    route_offsets = reinterpret_cast<const uint64_t*>(link_records + header->links_count);
+    const auto npu_pairs_count = static_cast<size_t>(header->npus_count) * static_cast<size_t>(header->npus_count);
+    route_links = reinterpret_cast<const LinkId*>(route_offsets + npu_pairs_count + 1);
+
+    // set the shape of the topology
+    devices_count = header->devices_count;
+    npus_count = header->npus_count;
+    dims_count = header->dims_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npus_count_per_dim.push_back(dims[dim].npus_count);
+        bandwidth_per_dim.push_back(dims[dim].bandwidth);
+    }
+
+    // instantiate the devices, and the links in LinkId order
+    instantiate_devices();
+    links.reserve(header->links_count);
+    for (auto id = size_t(0); id < header->links_count; id++) {
+        const auto& link = link_records[id];
+        connect(link.src, link.dest, link.bandwidth, link.latency, false);
+        links.back()->set_analytical(link.analytical != 0);
+    }
+}
+
+CompiledTopology::~CompiledTopology() noexcept {
+    munmap(mapping, mapping_size);
+}
+
+Route CompiledTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    const auto pair = (static_cast<size_t>(src) * npus_count) + dest;
+    const auto offset = route_offsets[pair];
+    return Route(*this, src, route_links + offset, route_offsets[pair + 1] - offset);
+}
@@ -4,46 +4,147 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/CompiledTopology.h"
+#include "congestion_aware/FatTree.h"
 #include "congestion_aware/FullyConnected.h"
+#include "congestion_aware/MultiDimTopology.h"
 #include "congestion_aware/Ring.h"
 #include "congestion_aware/Switch.h"
-#include <cstdlib>
-#include <iostream>
+#include "congestion_aware/Torus.h"
+#include <string>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
 std::shared_ptr<Topology>
 NetworkAnalyticalCongestionAware::construct_topology(const NetworkParser& network_parser) noexcept {
-    // get network_parser info
-    const auto dims_count = network_parser.get_dims_count();
-    const auto topologies_per_dim = network_parser.get_topologies_per_dim();
-    const auto npus_counts_per_dim = network_parser.get_npus_counts_per_dim();
-    const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
-    const auto latencies_per_dim = network_parser.get_latencies_per_dim();
-
-    // for now, congestion_aware backend supports 1-dim topology only
-    if (dims_count != 1) {
-        std::cerr << "[Error] (network/analytical/congestion_aware) " << "only support 1-dim topology" << std::endl;
-        std::exit(-1);
+    return construct_topology(network_parser.get_network_config());
+}
+
+std::shared_ptr<Topology>
+NetworkAnalyticalCongestionAware::construct_topology(const NetworkConfig& network_config) noexcept {
+    auto error = std::string();
+    return construct_topology(network_config, error);
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(const NetworkConfig& network_config,
+                                                                               std::string& error) noexcept {
+    // invalid configs are reported to the caller
+    error = network_config.validate({TopologyBuildingBlock::Ring, TopologyBuildingBlock::Switch,
+                                     TopologyBuildingBlock::FullyConnected, TopologyBuildingBlock::FatTree,
+                                     TopologyBuildingBlock::Torus, TopologyBuildingBlock::Mesh});
+    if (!error.empty()) {
+        return nullptr;
+    }
+
+    // get network_config info
+    const auto dims_count = network_config.get_dims_count();
+    const auto& topologies_per_dim = network_config.get_topologies_per_dim();
+    const auto& npus_counts_per_dim = network_config.get_npus_counts_per_dim();
+    const auto& bandwidths_per_dim = network_config.get_bandwidths_per_dim();
+    const auto& latencies_per_dim = network_config.get_latencies_per_dim();
+    const auto& radixes_per_dim = network_config.get_radixes_per_dim();
+    const auto& oversubscriptions_per_dim = network_config.get_oversubscriptions_per_dim();
+    const auto& shapes_per_dim = network_config.get_shapes_per_dim();
+    const auto& fidelities_per_dim = network_config.get_fidelities_per_dim();
+
+    // if dims_count is 1, just create basic topology (an unaware dimension is built by MultiDimTopology)
+    if (dims_count == 1 && fidelities_per_dim[0] == DimensionFidelity::CongestionAware) {
+        // retrieve basic topology info
+        const auto topology_type = topologies_per_dim[0];
+        const auto npus_count = npus_counts_per_dim[0];
+        const auto bandwidth = bandwidths_per_dim[0];
+        const auto latency = latencies_per_dim[0];
+
+        // create and return basic topology
+        switch (topology_type) {
+        case TopologyBuildingBlock::Ring:
+            return std::make_shared<Ring>(npus_count, bandwidth, latency);
+        case TopologyBuildingBlock::Switch:
+            return std::make_shared<Switch>(npus_count, bandwidth, latency);
+        case TopologyBuildingBlock::FullyConnected:
+            return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+        case TopologyBuildingBlock::FatTree:
+            return std::make_shared<FatTree>(npus_count, bandwidth, latency, radixes_per_dim[0],
+                                             oversubscriptions_per_dim[0]);
+        case TopologyBuildingBlock::Torus:
+            return std::make_shared<Torus>(npus_count, bandwidth, latency, shapes_per_dim[0]);
+        case TopologyBuildingBlock::Mesh:
+            return std::make_shared<Torus>(npus_count, bandwidth, latency, shapes_per_dim[0], false);
+        default:
+            // shouldn't reach here: unsupported building blocks are rejected by the validation
+            error = "topology of dimension 0 is not supported by this backend";
+            return nullptr;
+        }
+    }
+
+    // otherwise, create multi-dim topology
+    const auto multi_dim_topology = std::make_shared<MultiDimTopology>();
+
+    // create and append dims
+    for (auto dim = 0; dim < dims_count; dim++) {
+        // retrieve info
+        const auto topology_type = topologies_per_dim[dim];
+        const auto npus_count = npus_counts_per_dim[dim];
+        const auto bandwidth = bandwidths_per_dim[dim];
+        const auto latency = latencies_per_dim[dim];
+
+        // create a network dim
+        std::unique_ptr<BasicTopology> dim_topology;
+        switch (topology_type) {
+        case TopologyBuildingBlock::Ring:
+            dim_topology = std::make_unique<Ring>(npus_count, bandwidth, latency);
+            break;
+        case TopologyBuildingBlock::Switch:
+            dim_topology = std::make_unique<Switch>(npus_count, bandwidth, latency);
+            break;
+        case TopologyBuildingBlock::FullyConnected:
+            dim_topology = std::make_unique<FullyConnected>(npus_count, bandwidth, latency);
+            break;
+        case TopologyBuildingBlock::FatTree:
+            dim_topology = std::make_unique<FatTree>(npus_count, bandwidth, latency, radixes_per_dim[dim],
+                                                     oversubscriptions_per_dim[dim]);
+            break;
+        case TopologyBuildingBlock::Torus:
+            dim_topology = std::make_unique<Torus>(npus_count, bandwidth, latency, shapes_per_dim[dim]);
+            break;
+        case TopologyBuildingBlock::Mesh:
+            dim_topology = std::make_unique<Torus>(npus_count, bandwidth, latency, shapes_per_dim[dim], false);
+            break;
+        default:
+            // shouldn't reach here: unsupported building blocks are rejected by the validation
+            error = "topology of dimension " + std::to_string(dim) + " is not supported by this backend";
+            return nullptr;
+        }
+
+        // append network dimension
+        multi_dim_topology->append_dimension(std::move(dim_topology), fidelities_per_dim[dim]);
+    }
+
+    // return created multi-dimensional topology
+    return multi_dim_topology;
+}
+
+std::shared_ptr<Topology>
+NetworkAnalyticalCongestionAware::construct_topology(const std::string& network_config_path,
+                                                     const std::string& compiled_topology_path) noexcept {
+    // load the compiled topology if it's up to date
+    const auto config_hash = CompiledTopology::hash_network_config(network_config_path);
+    if (auto compiled_topology = CompiledTopology::load(compiled_topology_path, config_hash)) {
+        return compiled_topology;
     }
 
-    // retrieve basic basic-topology info
-    const auto topology_type = topologies_per_dim[0];
-    const auto npus_count = npus_counts_per_dim[0];
-    const auto bandwidth = bandwidths_per_dim[0];
-    const auto latency = latencies_per_dim[0];
-
-    switch (topology_type) {
-    case TopologyBuildingBlock::Ring:
-        return std::make_shared<Ring>(npus_count, bandwidth, latency);
-    case TopologyBuildingBlock::Switch:
-        return std::make_shared<Switch>(npus_count, bandwidth, latency);
-    case TopologyBuildingBlock::FullyConnected:
-        return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
-    default:
-        // shouldn't reaach here
-        std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported basic-topology" << std::endl;
-        std::exit(-1);
+    // otherwise, construct the topology and compile it for the next runs
+    // an invalid configuration is never compiled
+    auto error = std::string();
+    const auto network_config = NetworkConfig::load_yaml_file(network_config_path, error);
+    if (!network_config.has_value()) {
+        return nullptr;
+    }
+    auto topology = construct_topology(*network_config, error);
+    if (topology == nullptr) {
+        return nullptr;
     }
+    CompiledTopology::compile(*topology, config_hash, compiled_topology_path);
+    return topology;
 }
@@ -0,0 +1,94 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/OrbitTopology.h"
+#include <cassert>
+#include <map>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+bool OrbitTopology::reducible(const Topology& topology) noexcept {
+    const auto* const basic_topology = dynamic_cast<const BasicTopology*>(&topology);
+    if (basic_topology == nullptr) {
+        return false;
+    }
+
+    // the other building blocks aren't invariant under the rotation of the NPUs
+    const auto type = basic_topology->get_basic_topology_type();
+    return type == TopologyBuildingBlock::Ring || type == TopologyBuildingBlock::Switch ||
+           type == TopologyBuildingBlock::FullyConnected;
+}
+
+OrbitTopology::OrbitTopology(const BasicTopology& topology) noexcept
+    : Topology(),
+      represented_npus_count(topology.get_npus_count()) {
+    assert(reducible(topology));
+
+    // the NPUs form a single orbit, and so does the switch, if any
+    const auto represented_npus_count = this->represented_npus_count;
+    npus_count = 1;
+    devices_count = (topology.get_devices_count() > represented_npus_count) ? 2 : 1;
+    dims_count = 1;
+    npus_count_per_dim.push_back(npus_count);
+    bandwidth_per_dim = topology.get_bandwidth_per_dim();
+    instantiate_devices();
+
+    // orbit of a device, and the device rotated by -shift
+    const auto orbit = [=](const DeviceId device) { return (device < represented_npus_count) ? 0 : 1; };
+    const auto rotate = [=](const DeviceId device, const DeviceId shift) {
+        return (device < represented_npus_count) ? (device - shift + represented_npus_count) % represented_npus_count
+                                                 : device;
+    };
+
+    // map every hop of the routes from NPU 0 to the orbit of its link
+    auto link_orbits = std::map<std::pair<DeviceId, DeviceId>, LinkId>();
+    orbit_routes.resize(represented_npus_count);
+    for (auto dest = 1; dest < represented_npus_count; dest++) {
+        const auto route = topology.route(0, dest);
+        for (auto hop = size_t(0); hop + 1 < route.size(); hop++) {
+            const auto src_device = route.at(hop);
+            const auto dest_device = route.at(hop + 1);
+
+            // key the link by rotating its NPU endpoint to NPU 0
+            const auto shift = (src_device < represented_npus_count) ? src_device : dest_device;
+            const auto key = std::make_pair(rotate(src_device, shift), rotate(dest_device, shift));
+
+            // create the quotient link of a new orbit
+            auto link_orbit = link_orbits.find(key);
+            if (link_orbit == link_orbits.end()) {
+                const auto* const link = route.link(hop);
+                const auto id = add_detached_link(orbit(src_device), orbit(dest_device), link->get_bandwidth(),
+                                                  link->get_latency());
+                link_orbit = link_orbits.emplace(key, id).first;
+            }
+            orbit_routes[dest].push_back(link_orbit->second);
+        }
+    }
+}
+
+int OrbitTopology::get_represented_npus_count() const noexcept {
+    return represented_npus_count;
+}
+
+std::unique_ptr<Chunk> OrbitTopology::make_orbit_chunk(const ChunkSize chunk_size,
+                                                       const DeviceId dest,
+                                                       const Callback callback,
+                                                       const CallbackArg callback_arg) noexcept {
+    assert(0 < dest && dest < represented_npus_count);
+
+    auto route = Route(*this, 0, orbit_routes[dest]);
+    return std::unique_ptr<Chunk>(new (chunk_pool) Chunk(chunk_size, std::move(route), callback, callback_arg));
+}
+
+Route OrbitTopology::compute_route(const DeviceId src, [[maybe_unused]] const DeviceId dest) const noexcept {
+    assert(src == 0 && dest == 0);
+
+    // NPU 0 reaches the other NPUs only through make_orbit_chunk()
+    auto route = Route(*this);
+    route.push_back(src);
+    return route;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/RouteCache.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+RouteCache::RouteCache(const int devices_count, const size_t memory_cap) noexcept
+    : devices_count(devices_count), memory_cap(memory_cap), memory_usage(0), hits_count(0), misses_count(0) {
+    assert(devices_count > 0);
+}
+
+const std::vector<LinkId>* RouteCache::find(const DeviceId src, const DeviceId dest) noexcept {
+    const auto entry = routes.find(key(src, dest));
+    if (entry == routes.end()) {
+        misses_count++;
+        return nullptr;
+    }
+
+    hits_count++;
+    return &entry->second;
+}
+
+const std::vector<LinkId>* RouteCache::insert(const DeviceId src, const DeviceId dest, const Route& route) noexcept {
+    assert(!route.empty());
+    assert(route.at(0) == src);
+    assert(route.at(route.size() - 1) == dest);
+
+    // check the memory cap
+    const auto links_count = route.size() - 1;
+    const auto entry_memory = entry_overhead + links_count * sizeof(LinkId);
+    if (memory_usage + entry_memory > memory_cap) {
+        return nullptr;
+    }
+
+    // intern the route
+    auto [entry, inserted] = routes.try_emplace(key(src, dest));
+    if (inserted) {
+        entry->second.reserve(links_count);
+        for (size_t i = 0; i < links_count; i++) {
+            entry->second.push_back(route.link_id(i));
+        }
+        memory_usage += entry_memory;
+    }
+
+    return &entry->second;
+}
+
+size_t RouteCache::get_routes_count() const noexcept {
+    return routes.size();
+}
+
+uint64_t RouteCache::get_hits_count() const noexcept {
+    return hits_count;
+}
+
+uint64_t RouteCache::get_misses_count() const noexcept {
+    return misses_count;
+}
+
+size_t RouteCache::get_memory_usage() const noexcept {
+    return memory_usage;
+}
+
+size_t RouteCache::get_memory_cap() const noexcept {
+    return memory_cap;
+}
+
+int64_t RouteCache::key(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    return static_cast<int64_t>(src) * devices_count + dest;
+}
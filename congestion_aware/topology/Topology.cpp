@@ -5,19 +5,41 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Topology.h"
 #include "congestion_aware/Link.h"
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+Topology::Topology() noexcept : devices_count(-1), npus_count(-1), dims_count(-1), event_queue(nullptr),
+      route_cache(nullptr), lazy_links(false), lazy_links_count(0), lazy_link_bandwidth(0), lazy_link_latency(0),
+      link_coalescing(false), link_packet_size(0), link_express(false), link_tracer(nullptr), concurrent(false),
+      callback_batcher(nullptr) {
+    npus_count_per_dim = {};
+}
+
 void Topology::set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept {
     assert(event_queue != nullptr);
 
-    // pass the given event_queue to Link
-    Link::set_event_queue(std::move(event_queue));
+    // bind every link to the given event_queue, unless it's bound to an event queue of its own
+    this->event_queue = std::move(event_queue);
+    for_each_link([this](Link& link) { link.set_event_queue(resolve_event_queue(link)); });
+    if (callback_batcher != nullptr) {
+        callback_batcher->set_event_queue(this->event_queue.get());
+    }
 }
 
-Topology::Topology() noexcept : npus_count(-1), devices_count(-1), dims_count(-1) {
-    npus_count_per_dim = {};
+void Topology::set_link_event_queues(LinkEventQueueResolver resolver) noexcept {
+    link_event_queue_resolver = std::move(resolver);
+    for_each_link([this](Link& link) {
+        if (auto* const link_event_queue = resolve_event_queue(link); link_event_queue != nullptr) {
+            link.set_event_queue(link_event_queue);
+        }
+    });
+}
+
+std::shared_ptr<EventQueue> Topology::get_event_queue() const noexcept {
+    return event_queue;
 }
 
 int Topology::get_devices_count() const noexcept {
@@ -36,6 +58,63 @@ int Topology::get_npus_count() const noexcept {
     return npus_count;
 }
 
+Device* Topology::get_device(const DeviceId id) const noexcept {
+    assert(0 <= id && id < devices_count);
+
+    return devices[id].get();
+}
+
+int Topology::get_links_count() const noexcept {
+    if (lazy_links) {
+        return lazy_links_count;
+    }
+    return static_cast<int>(links.size());
+}
+
+Link* Topology::get_link(const LinkId id) const noexcept {
+    assert(0 <= id && id < get_links_count());
+
+    if (lazy_links) {
+        return get_lazy_link(id);
+    }
+    return links[id].get();
+}
+
+LinkId Topology::get_link_id(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    if (lazy_links) {
+        return compute_lazy_link_id(src, dest);
+    }
+    return devices[src]->get_link_id(dest);
+}
+
+bool Topology::has_lazy_links() const noexcept {
+    return lazy_links;
+}
+
+size_t Topology::get_instantiated_links_count() const noexcept {
+    return links.size() + lazy_link_table.size();
+}
+
+Latency Topology::get_min_link_latency() const noexcept {
+    // lazy links share a single latency
+    if (lazy_links) {
+        return lazy_link_latency;
+    }
+
+    auto min_latency = std::numeric_limits<Latency>::max();
+    for (const auto& link : links) {
+        min_latency = std::min(min_latency, link->get_latency());
+    }
+    return links.empty() ? 0 : min_latency;
+}
+
+const LinkStateTable& Topology::get_link_states() const noexcept {
+    return link_states;
+}
+
 int Topology::get_dims_count() const noexcept {
     assert(dims_count > 0);
 
@@ -54,6 +133,103 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
     return bandwidth_per_dim;
 }
 
+Route Topology::route(const DeviceId src, const DeviceId dest) const noexcept {
+    // without the cache, construct the route every time
+    if (route_cache == nullptr) {
+        return compute_route(src, dest);
+    }
+
+    // the cache is shared by the threads of the concurrent mode
+    if (concurrent) {
+        const auto lock = std::lock_guard<std::mutex>(route_cache_mutex);
+        return cached_route(src, dest);
+    }
+    return cached_route(src, dest);
+}
+
+Route Topology::cached_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(route_cache != nullptr);
+
+    // reference the interned route
+    if (const auto* const interned_route = route_cache->find(src, dest)) {
+        return Route(*this, src, *interned_route);
+    }
+
+    // intern the new route if the memory cap allows
+    auto new_route = compute_route(src, dest);
+    if (const auto* const interned_route = route_cache->insert(src, dest, new_route)) {
+        return Route(*this, src, *interned_route);
+    }
+    return new_route;
+}
+
+void Topology::set_link_coalescing(const bool coalescing) noexcept {
+    link_coalescing = coalescing;
+    for_each_link([coalescing](Link& link) { link.set_coalescing(coalescing); });
+}
+
+void Topology::set_cut_through(const ChunkSize packet_size) noexcept {
+    link_packet_size = packet_size;
+    for_each_link([packet_size](Link& link) { link.set_packet_size(packet_size); });
+}
+
+void Topology::set_express_scheduling(const bool express) noexcept {
+    link_express = express;
+    for_each_link([express](Link& link) { link.set_express(express); });
+}
+
+bool Topology::get_express_scheduling() const noexcept {
+    return link_express;
+}
+
+void Topology::set_tracer(Tracer* const tracer) noexcept {
+    link_tracer = tracer;
+    for_each_link([tracer](Link& link) { link.set_tracer(tracer); });
+}
+
+void Topology::set_link_outboxes(LinkOutboxResolver resolver) noexcept {
+    link_outbox_resolver = std::move(resolver);
+    for_each_link([this](Link& link) { link.set_outbox(link_outbox_resolver ? link_outbox_resolver(link) : nullptr); });
+}
+
+void Topology::set_callback_batching(const Callback callback, const BatchCallback batch_callback) noexcept {
+    assert(event_queue != nullptr);
+
+    // the batcher is created on first use, and shared by every link
+    if (callback_batcher == nullptr) {
+        callback_batcher = std::make_unique<CallbackBatcher>();
+        callback_batcher->set_event_queue(event_queue.get());
+        auto* const batcher = callback_batcher.get();
+        for_each_link([batcher](Link& link) { link.set_callback_batcher(batcher); });
+    }
+    callback_batcher->register_callback(callback, batch_callback);
+}
+
+const CallbackBatcher* Topology::get_callback_batcher() const noexcept {
+    return callback_batcher.get();
+}
+
+void Topology::enable_route_cache(const size_t memory_cap, const bool precompute) noexcept {
+    route_cache = std::make_unique<RouteCache>(get_devices_count(), memory_cap);
+
+    if (!precompute) {
+        return;
+    }
+
+    // intern the routes of every NPU pair
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                route_cache->insert(src, dest, compute_route(src, dest));
+            }
+        }
+    }
+}
+
+const RouteCache* Topology::get_route_cache() const noexcept {
+    return route_cache.get();
+}
+
 void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
 
@@ -67,6 +243,89 @@ void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
     devices[src]->send(std::move(chunk));
 }
 
+void Topology::send_batch(const std::vector<SendRequest>& requests) noexcept {
+    // with lazy links, counting the chunks per link would touch every (mostly idle) link
+    if (lazy_links) {
+        send_batch_sorted(requests);
+        return;
+    }
+
+    // create every chunk, counting the chunks per first link
+    const auto links_count = get_links_count();
+    auto chunks = std::vector<std::unique_ptr<Chunk>>();
+    chunks.reserve(requests.size());
+    auto first_link_offsets = std::vector<size_t>(links_count + 1, 0);
+    for (const auto& request : requests) {
+        assert(request.src != request.dest);
+        auto chunk = make_chunk(request.chunk_size, request.src, request.dest, request.callback, request.callback_arg);
+        first_link_offsets[chunk->get_route().link_id(0) + 1]++;
+        chunks.push_back(std::move(chunk));
+    }
+
+    // group the chunks by their first link, keeping the requested order within each group
+    for (auto link = 0; link < links_count; link++) {
+        first_link_offsets[link + 1] += first_link_offsets[link];
+    }
+    auto grouped_chunks = std::vector<std::unique_ptr<Chunk>>(chunks.size());
+    for (auto& chunk : chunks) {
+        const auto link = chunk->get_route().link_id(0);
+        grouped_chunks[first_link_offsets[link]++] = std::move(chunk);
+    }
+
+    // initiate the transmissions
+    for (auto& chunk : grouped_chunks) {
+        send(std::move(chunk));
+    }
+}
+
+void Topology::send_batch_sorted(const std::vector<SendRequest>& requests) noexcept {
+    // create every chunk
+    auto chunks = std::vector<std::unique_ptr<Chunk>>();
+    chunks.reserve(requests.size());
+    for (const auto& request : requests) {
+        assert(request.src != request.dest);
+        chunks.push_back(
+            make_chunk(request.chunk_size, request.src, request.dest, request.callback, request.callback_arg));
+    }
+
+    // group the chunks by their first link, keeping the requested order within each group
+    std::stable_sort(chunks.begin(), chunks.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->get_route().link_id(0) < rhs->get_route().link_id(0);
+    });
+
+    // initiate the transmissions
+    for (auto& chunk : chunks) {
+        send(std::move(chunk));
+    }
+}
+
+std::unique_ptr<Chunk> Topology::make_chunk(const ChunkSize chunk_size, const DeviceId src, const DeviceId dest,
+                                            const Callback callback, const CallbackArg callback_arg) noexcept {
+    return std::unique_ptr<Chunk>(new (chunk_pool) Chunk(chunk_size, route(src, dest), callback, callback_arg));
+}
+
+#ifdef ANALYTICAL_TELEMETRY
+const Telemetry& Topology::get_telemetry() const noexcept {
+    return telemetry;
+}
+#endif
+
+ChunkPool& Topology::get_chunk_pool() noexcept {
+    return chunk_pool;
+}
+
+void Topology::set_concurrent(const bool concurrent) noexcept {
+    this->concurrent = concurrent;
+    chunk_pool.set_concurrent(concurrent);
+
+#ifdef ANALYTICAL_TELEMETRY
+    // the lazy links register to the telemetry as they're created, without growing its arrays
+    if (concurrent && lazy_links) {
+        telemetry.reserve_links(lazy_links_count);
+    }
+#endif
+}
+
 void Topology::connect(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth, const Latency latency,
                        const bool bidirectional) noexcept {
     // assert the src and dest are valid
@@ -78,12 +337,121 @@ void Topology::connect(const DeviceId src, const DeviceId dest, const Bandwidth
     assert(latency >= 0);
 
     // connect src -> dest
-    devices[src]->connect(dest, bandwidth, latency);
+    add_link(src, dest, bandwidth, latency);
 
     // if bidirectional, connect dest -> src
     if (bidirectional) {
-        devices[dest]->connect(src, bandwidth, latency);
+        add_link(dest, src, bandwidth, latency);
+    }
+}
+
+void Topology::add_link(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth,
+                        const Latency latency) noexcept {
+    // lazy links are never connected explicitly
+    assert(!lazy_links);
+
+    // create link
+    const auto link_id = static_cast<LinkId>(links.size());
+    links.push_back(std::make_unique<Link>(src, dest, bandwidth, latency, link_states));
+    devices[src]->connect(dest, link_id);
+    setup_link(link_id, *links.back());
+}
+
+LinkId Topology::add_detached_link(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth,
+                                   const Latency latency) noexcept {
+    assert(!lazy_links);
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // create link, but leave the devices unconnected
+    const auto link_id = static_cast<LinkId>(links.size());
+    links.push_back(std::make_unique<Link>(src, dest, bandwidth, latency, link_states));
+    setup_link(link_id, *links.back());
+    return link_id;
+}
+
+void Topology::setup_link([[maybe_unused]] const LinkId id, Link& link) const noexcept {
+#ifdef ANALYTICAL_TELEMETRY
+    telemetry.register_link(id, link.get_src(), link.get_dest());
+    link.set_telemetry(&telemetry, id);
+#endif
+
+    // apply the link settings of the topology
+    link.set_coalescing(link_coalescing);
+    link.set_packet_size(link_packet_size);
+    link.set_express(link_express);
+    link.set_tracer(link_tracer);
+    link.set_callback_batcher(callback_batcher.get());
+    link.set_chunk_pool(&chunk_pool);
+    if (link_outbox_resolver) {
+        link.set_outbox(link_outbox_resolver(link));
+    }
+
+    // links connected before the event queue is set are bound by set_event_queue()
+    if (auto* const link_event_queue = resolve_event_queue(link); link_event_queue != nullptr) {
+        link.set_event_queue(link_event_queue);
+    }
+}
+
+EventQueue* Topology::resolve_event_queue(const Link& link) const noexcept {
+    if (link_event_queue_resolver) {
+        return link_event_queue_resolver(link);
+    }
+    return event_queue.get();
+}
+
+void Topology::enable_lazy_links(const int links_count, const Bandwidth bandwidth, const Latency latency) noexcept {
+    assert(links_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(links.empty());
+
+    lazy_links = true;
+    lazy_links_count = links_count;
+    lazy_link_bandwidth = bandwidth;
+    lazy_link_latency = latency;
+}
+
+LinkId Topology::compute_lazy_link_id([[maybe_unused]] const DeviceId src,
+                                      [[maybe_unused]] const DeviceId dest) const noexcept {
+    // shouldn't reach here: topologies enabling lazy links override it
+    assert(false);
+    return -1;
+}
+
+std::pair<DeviceId, DeviceId> Topology::compute_lazy_link_devices([[maybe_unused]] const LinkId id) const noexcept {
+    // shouldn't reach here: topologies enabling lazy links override it
+    assert(false);
+    return {-1, -1};
+}
+
+Link* Topology::get_lazy_link(const LinkId id) const noexcept {
+    assert(lazy_links);
+
+    // the link table is shared by the threads of the concurrent mode
+    auto lock = std::unique_lock<std::mutex>(lazy_links_mutex, std::defer_lock);
+    if (concurrent) {
+        lock.lock();
+    }
+
+    // the link already exists
+    if (const auto link = lazy_link_table.find(id); link != lazy_link_table.end()) {
+        return link->second.get();
+    }
+
+    // create the link on first use
+    // in the concurrent mode, the link holds its own state, as the other threads read the shared table
+    const auto [src, dest] = compute_lazy_link_devices(id);
+    auto& link = lazy_link_table[id];
+    if (concurrent) {
+        link = std::make_unique<Link>(src, dest, lazy_link_bandwidth, lazy_link_latency);
+    } else {
+        link = std::make_unique<Link>(src, dest, lazy_link_bandwidth, lazy_link_latency, link_states);
     }
+    setup_link(id, *link);
+    return link.get();
 }
 
 void Topology::instantiate_devices() noexcept {
@@ -0,0 +1,123 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkGenerator.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+ChunkGenerator::ChunkGenerator(Topology* const topology, const int window) noexcept
+    : topology(topology),
+      window(window),
+      in_flight_count(0),
+      peak_in_flight_count(0),
+      sent_count(0),
+      arrived_count(0) {
+    assert(topology != nullptr);
+    assert(window > 0);
+
+    npus_count = topology->get_npus_count();
+
+    // every slot is free initially
+    slots.resize(npus_count * window);
+    free_slots.resize(npus_count * window);
+    free_slots_count.resize(npus_count, window);
+    for (auto i = 0; i < npus_count * window; i++) {
+        slots[i].generator = this;
+        slots[i].npu = i / window;
+        free_slots[i] = i;
+    }
+}
+
+ChunkGenerator::~ChunkGenerator() noexcept = default;
+
+void ChunkGenerator::start() noexcept {
+    for (auto npu = 0; npu < npus_count; npu++) {
+        wake(npu);
+    }
+}
+
+void ChunkGenerator::wake(const DeviceId npu) noexcept {
+    assert(0 <= npu && npu < npus_count);
+
+    while (free_slots_count[npu] > 0) {
+        // stop if no chunk is ready
+        auto chunk = GeneratedChunk();
+        if (!next_chunk(npu, chunk)) {
+            return;
+        }
+        assert(0 <= chunk.dest && chunk.dest < npus_count && chunk.dest != npu);
+
+        // take a free slot of the NPU
+        free_slots_count[npu]--;
+        auto& slot = slots[free_slots[(npu * window) + free_slots_count[npu]]];
+        slot.chunk = chunk;
+
+        in_flight_count++;
+        peak_in_flight_count = std::max(peak_in_flight_count, in_flight_count);
+        sent_count++;
+        topology->send(topology->make_chunk(chunk.chunk_size, npu, chunk.dest, slot_arrived, &slot));
+    }
+}
+
+uint64_t ChunkGenerator::get_sent_count() const noexcept {
+    return sent_count;
+}
+
+uint64_t ChunkGenerator::get_arrived_count() const noexcept {
+    return arrived_count;
+}
+
+size_t ChunkGenerator::get_peak_in_flight_count() const noexcept {
+    return peak_in_flight_count;
+}
+
+void ChunkGenerator::chunk_arrived([[maybe_unused]] const DeviceId npu,
+                                   [[maybe_unused]] const GeneratedChunk& chunk) noexcept {
+    // no dependency by default
+}
+
+void ChunkGenerator::slot_arrived(void* const slot) noexcept {
+    assert(slot != nullptr);
+
+    // typecast slot
+    auto* const arrived_slot = static_cast<Slot*>(slot);
+    auto* const generator = arrived_slot->generator;
+    const auto npu = arrived_slot->npu;
+    const auto chunk = arrived_slot->chunk;
+
+    // release the slot
+    const auto slot_index = static_cast<int>(arrived_slot - generator->slots.data());
+    generator->free_slots[(npu * generator->window) + generator->free_slots_count[npu]] = slot_index;
+    generator->free_slots_count[npu]++;
+    generator->in_flight_count--;
+    generator->arrived_count++;
+
+    // notify the arrival, then refill the window of the NPU
+    generator->chunk_arrived(npu, chunk);
+    generator->wake(npu);
+}
+
+AllToAllGenerator::AllToAllGenerator(Topology* const topology, const ChunkSize chunk_size, const int window) noexcept
+    : ChunkGenerator(topology, window),
+      chunk_size(chunk_size) {
+    assert(chunk_size > 0);
+
+    next_offsets.resize(npus_count, 1);
+}
+
+bool AllToAllGenerator::next_chunk(const DeviceId npu, GeneratedChunk& chunk) noexcept {
+    // every other NPU is sent a chunk
+    auto& offset = next_offsets[npu];
+    if (offset >= npus_count) {
+        return false;
+    }
+
+    chunk = {(npu + offset) % npus_count, chunk_size, static_cast<uint64_t>(offset)};
+    offset++;
+    return true;
+}
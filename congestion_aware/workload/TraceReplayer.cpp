@@ -0,0 +1,214 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TraceReplayer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+    /// magic number at the beginning of a trace file
+    constexpr char trace_magic[8] = {'A', 'N', 'T', 'R', 'A', 'C', 'E', 'S'};
+
+    /// header of a trace file
+    struct FileHeader {
+        /// magic number
+        char magic[8];
+
+        /// format version
+        uint32_t version;
+
+        /// unused, keeps the count aligned
+        uint32_t reserved;
+
+        /// number of sends
+        uint64_t sends_count;
+    };
+
+    static_assert(sizeof(FileHeader) == 24, "trace records are mapped as is");
+    static_assert(sizeof(TraceSend) == 24, "trace records are mapped as is");
+
+}  // namespace
+
+void TraceReplayer::write(const std::string& path, const std::vector<TraceSend>& sends) noexcept {
+    auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot create the trace file: " << path << std::endl;
+        std::exit(-1);
+    }
+
+    auto header = FileHeader();
+    std::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+    header.version = format_version;
+    header.reserved = 0;
+    header.sends_count = sends.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sends.data()),
+              static_cast<std::streamsize>(sends.size() * sizeof(TraceSend)));
+    out.close();
+
+    if (!out) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "cannot write the trace file: " << path << std::endl;
+        std::exit(-1);
+    }
+}
+
+std::unique_ptr<TraceReplayer> TraceReplayer::open(const std::string& path,
+                                                   Topology& topology,
+                                                   const size_t window_sends_count) noexcept {
+    assert(window_sends_count > 0);
+
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping stays valid after the file is closed
+    const auto mapping_size = static_cast<size_t>(file_stat.st_size);
+    auto* const mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // reject a file of another format or version, or a truncated one
+    const auto* const header = static_cast<const FileHeader*>(mapping);
+    if (std::memcmp(header->magic, trace_magic, sizeof(trace_magic)) != 0 || header->version != format_version ||
+        sizeof(FileHeader) + (header->sends_count * sizeof(TraceSend)) != mapping_size) {
+        munmap(mapping, mapping_size);
+        return nullptr;
+    }
+
+    // the sends are read in order
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+
+    return std::unique_ptr<TraceReplayer>(new TraceReplayer(mapping, mapping_size, topology, window_sends_count));
+}
+
+TraceReplayer::TraceReplayer(void* const mapping,
+                             const size_t mapping_size,
+                             Topology& topology,
+                             const size_t window_sends_count) noexcept
+    : mapping(mapping),
+      mapping_size(mapping_size),
+      topology(&topology),
+      window_sends_count(window_sends_count),
+      cursor(0),
+      window_end(0),
+      dropped_end(0),
+      finished_count(0) {
+    assert(mapping != nullptr);
+
+    const auto* const header = static_cast<const FileHeader*>(mapping);
+    sends = reinterpret_cast<const TraceSend*>(header + 1);
+    sends_count = header->sends_count;
+}
+
+TraceReplayer::~TraceReplayer() noexcept {
+    munmap(mapping, mapping_size);
+}
+
+void TraceReplayer::start() noexcept {
+    auto* const event_queue = topology->get_event_queue().get();
+    assert(event_queue != nullptr);
+    assert(cursor == 0);
+
+    if (sends_count == 0) {
+        return;
+    }
+
+    // schedule the first send
+    advance_window();
+    assert(sends[0].time >= event_queue->get_current_time());
+    event_queue->schedule_event<TraceReplayer, inject>(sends[0].time, this);
+}
+
+uint64_t TraceReplayer::get_sends_count() const noexcept {
+    return sends_count;
+}
+
+uint64_t TraceReplayer::get_injected_count() const noexcept {
+    return cursor;
+}
+
+uint64_t TraceReplayer::get_finished_count() const noexcept {
+    return finished_count;
+}
+
+void TraceReplayer::inject(TraceReplayer* const replayer) noexcept {
+    assert(replayer != nullptr);
+    assert(replayer->cursor < replayer->sends_count);
+
+    auto* const topology = replayer->topology;
+    auto* const event_queue = topology->get_event_queue().get();
+    const auto current_time = event_queue->get_current_time();
+
+    // send every chunk due now
+    while (replayer->cursor < replayer->sends_count && replayer->sends[replayer->cursor].time <= current_time) {
+        const auto& send = replayer->sends[replayer->cursor];
+        replayer->cursor++;
+        if (replayer->cursor >= replayer->window_end) {
+            replayer->advance_window();
+        }
+
+        // a send to itself arrives right away
+        if (send.src == send.dest) {
+            replayer->finished_count++;
+            continue;
+        }
+        topology->send(topology->make_chunk(send.chunk_size, send.src, send.dest, send_finished, replayer));
+    }
+
+    // schedule the next send
+    if (replayer->cursor < replayer->sends_count) {
+        event_queue->schedule_event<TraceReplayer, inject>(replayer->sends[replayer->cursor].time, replayer);
+    }
+}
+
+void TraceReplayer::send_finished(void* const replayer) noexcept {
+    assert(replayer != nullptr);
+
+    static_cast<TraceReplayer*>(replayer)->finished_count++;
+}
+
+void TraceReplayer::advance_window() noexcept {
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto* const bytes = static_cast<char*>(mapping);
+
+    // drop the whole pages of the injected sends
+    const auto injected_end = (sizeof(FileHeader) + (cursor * sizeof(TraceSend))) / page_size * page_size;
+    if (injected_end > dropped_end) {
+        madvise(bytes + dropped_end, injected_end - dropped_end, MADV_DONTNEED);
+        dropped_end = injected_end;
+    }
+
+    // prefetch the next window
+    window_end = std::min<uint64_t>(cursor + window_sends_count, sends_count);
+    const auto prefetch_end = sizeof(FileHeader) + (window_end * sizeof(TraceSend));
+    if (prefetch_end > dropped_end) {
+        madvise(bytes + dropped_end, prefetch_end - dropped_end, MADV_WILLNEED);
+    }
+}
@@ -5,13 +5,20 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_unaware/BasicTopology.h"
 #include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 BasicTopology::BasicTopology(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
-    : latency(latency), basic_topology_type(TopologyBuildingBlock::Undefined), Topology() {
+    : latency(latency),
+      latency_ps(latency_ns_to_ps(latency)),
+      basic_topology_type(TopologyBuildingBlock::Undefined),
+      lookup_table_mode(LookupTableMode::None),
+      Topology() {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -23,39 +30,70 @@ BasicTopology::BasicTopology(const int npus_count, const Bandwidth bandwidth, co
     this->bandwidth = bandwidth;
     bandwidth_per_dim.push_back(bandwidth);
 
-    // translate bandwidth from GB/s to B/ns
-    bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    // translate bandwidth from GB/s to B/ns, and take its reciprocal in fixed point
+    reciprocal_bandwidth = bw_Bpns_to_reciprocal(bw_GBps_to_Bpns(bandwidth));
 }
 
 // default destructor
 BasicTopology::~BasicTopology() noexcept = default;
 
-EventTime BasicTopology::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
-    assert(0 <= src && src < npus_count);
-    assert(0 <= dest && dest < npus_count);
-    assert(src != dest);
-    assert(chunk_size > 0);
+void BasicTopology::send_batch(const DeviceId* const srcs,
+                               const DeviceId* const dests,
+                               const ChunkSize* const chunk_sizes,
+                               EventTime* const comms_delays,
+                               const size_t count) const noexcept {
+    // look up the link delays
+    if (lookup_table_mode != LookupTableMode::None) {
+        for (auto i = size_t(0); i < count; i++) {
+            comms_delays[i] = compute_communication_delay(lookup_link_delay(srcs[i], dests[i]), chunk_sizes[i]);
+        }
+        return;
+    }
+
+    int hops_counts[batch_block_size];
+
+    for (auto begin = size_t(0); begin < count; begin += batch_block_size) {
+        const auto block_size = std::min(batch_block_size, count - begin);
+
+        // get hops counts of the block
+        compute_hops_counts(srcs + begin, dests + begin, hops_counts, block_size);
 
-    // get hops count
-    auto hops_count = compute_hops_count(src, dest);
+        // compute communication delays of the block
+        for (auto i = size_t(0); i < block_size; i++) {
+            comms_delays[begin + i] = compute_communication_delay(hops_counts[i], chunk_sizes[begin + i]);
+        }
+    }
+}
 
-    // return communication delay
-    return compute_communication_delay(hops_count, chunk_size);
+void BasicTopology::compute_hops_counts(const DeviceId* const srcs,
+                                        const DeviceId* const dests,
+                                        int* const hops_counts,
+                                        const size_t count) const noexcept {
+    for (auto i = size_t(0); i < count; i++) {
+        hops_counts[i] = compute_hops_count(srcs[i], dests[i]);
+    }
 }
 
 EventTime BasicTopology::compute_communication_delay(const int hops_count, const ChunkSize chunk_size) const noexcept {
     assert(hops_count > 0);
     assert(chunk_size > 0);
 
-    // compute link delay and serialization delay
-    auto link_delay = hops_count * latency;
-    auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bpns;
+    // compute link delay
+    const auto link_delay = static_cast<PicoTime>(hops_count) * latency_ps;
+
+    // add serialization delay
+    return compute_communication_delay(link_delay, chunk_size);
+}
 
-    // comms_delay is the summation of the two
-    auto comms_delay = link_delay + serialization_delay;
+EventTime BasicTopology::compute_communication_delay(const PicoTime link_delay,
+                                                     const ChunkSize chunk_size) const noexcept {
+    assert(chunk_size > 0);
 
-    // return EventTime type of comms_delay
-    return static_cast<EventTime>(comms_delay);
+    // compute serialization delay, an integer multiply-shift
+    const auto serialization_delay = serialization_delay_ps(chunk_size, reciprocal_bandwidth);
+
+    // comms_delay is the summation of the two, truncated to ns
+    return ps_to_event_time(link_delay + serialization_delay);
 }
 
 TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
@@ -63,3 +101,195 @@ TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
 
     return basic_topology_type;
 }
+
+void BasicTopology::build_lookup_tables(const size_t memory_budget) noexcept {
+    // drop the existing table
+    lookup_table_mode = LookupTableMode::None;
+    link_delay_table.clear();
+    link_delay_table.shrink_to_fit();
+
+    // select the layout fitting the budget
+    const auto npus = static_cast<size_t>(npus_count);
+    const auto dense_table_size = npus * npus * sizeof(PicoTime);
+    const auto distance_class_table_size = npus * sizeof(PicoTime);
+    if (dense_table_size <= memory_budget) {
+        lookup_table_mode = LookupTableMode::Dense;
+    } else if (is_rotation_invariant() && distance_class_table_size <= memory_budget) {
+        lookup_table_mode = LookupTableMode::DistanceClass;
+    } else {
+        return;
+    }
+
+    // precompute the link delays (hops_count * latency) as compute_communication_delay does
+    // the diagonal and distance 0 are never looked up
+    if (lookup_table_mode == LookupTableMode::Dense) {
+        link_delay_table.resize(npus * npus, 0);
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    const auto hops_count = static_cast<PicoTime>(compute_hops_count(src, dest));
+                    link_delay_table[(src * npus) + dest] = hops_count * latency_ps;
+                }
+            }
+        }
+    } else {
+        link_delay_table.resize(npus, 0);
+        for (auto distance = 1; distance < npus_count; distance++) {
+            link_delay_table[distance] = static_cast<PicoTime>(compute_hops_count(0, distance)) * latency_ps;
+        }
+    }
+}
+
+LookupTableMode BasicTopology::get_lookup_table_mode() const noexcept {
+    return lookup_table_mode;
+}
+
+PicoTime BasicTopology::compute_link_delay(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    if (lookup_table_mode != LookupTableMode::None) {
+        return lookup_link_delay(src, dest);
+    }
+
+    return static_cast<PicoTime>(compute_hops_count(src, dest)) * latency_ps;
+}
+
+bool BasicTopology::is_rotation_invariant() const noexcept {
+    return false;
+}
+
+PicoTime BasicTopology::lookup_link_delay(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(lookup_table_mode != LookupTableMode::None);
+
+    if (lookup_table_mode == LookupTableMode::Dense) {
+        return link_delay_table[(static_cast<size_t>(src) * npus_count) + dest];
+    }
+
+    // distance class
+    const auto distance = dest - src;
+    return link_delay_table[(distance < 0) ? (distance + npus_count) : distance];
+}
+
+EventTime BasicTopology::estimate_collective(const CollectiveType type,
+                                             const CollectiveAlgorithm algorithm,
+                                             const ChunkSize size) const noexcept {
+    // a single NPU doesn't communicate
+    if (npus_count == 1) {
+        return 0;
+    }
+
+    // the buffer should be large enough to be split into shards
+    if (size < static_cast<ChunkSize>(npus_count)) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) "
+                  << "collective size should be at least the number of NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    // halving-doubling pairs NPUs by their id bits
+    if (algorithm == CollectiveAlgorithm::HalvingDoubling && (npus_count & (npus_count - 1)) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) "
+                  << "halving-doubling collective requires a power-of-2 number of NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    // all-reduce: reduce-scatter followed by all-gather
+    if (type == CollectiveType::AllReduce) {
+        return estimate_collective(CollectiveType::ReduceScatter, algorithm, size) +
+               estimate_collective(CollectiveType::AllGather, algorithm, size);
+    }
+
+    // hops summed over the steps, and the shards sent per NPU
+    const auto shard_size = size / npus_count;
+    const auto steps_count = npus_count - 1;
+    auto hops_count = int64_t(0);
+    auto shards_count = int64_t(steps_count);
+
+    switch (algorithm) {
+    case CollectiveAlgorithm::Direct:
+        // a single step: shards to every other NPU are sent at once
+        hops_count = compute_max_hops_count();
+        shards_count = 1;
+        break;
+    case CollectiveAlgorithm::Ring:
+        if (type == CollectiveType::AllToAll) {
+            // pairwise exchange with the i-th next NPU at step i
+            hops_count = compute_shift_hops_count_sum();
+        } else {
+            // forward a shard to the next NPU per step
+            hops_count = int64_t(steps_count) * compute_shift_hops_count(1);
+        }
+        break;
+    case CollectiveAlgorithm::HalvingDoubling:
+        if (type == CollectiveType::AllToAll) {
+            // pairwise exchange with the NPU of id (npu XOR i) at step i
+            hops_count = compute_xor_hops_count_sum();
+        } else {
+            // recursive doubling / halving: steps of 1, 2, 4, ... shards, N-1 shards in total
+            for (auto distance = 1; distance < npus_count; distance *= 2) {
+                hops_count += compute_xor_hops_count(distance);
+            }
+        }
+        break;
+    }
+
+    // link delays plus the serialization delays of the shards
+    const auto link_delay = static_cast<PicoTime>(hops_count) * latency_ps;
+    const auto serialization_delay = serialization_delay_ps(shards_count * shard_size, reciprocal_bandwidth);
+    return ps_to_event_time(link_delay + serialization_delay);
+}
+
+int BasicTopology::compute_max_hops_count() const noexcept {
+    auto max_hops_count = 0;
+    for (auto distance = 1; distance < npus_count; distance++) {
+        max_hops_count = std::max(max_hops_count, compute_shift_hops_count(distance));
+    }
+    return max_hops_count;
+}
+
+int64_t BasicTopology::compute_shift_hops_count_sum() const noexcept {
+    auto hops_count_sum = int64_t(0);
+    for (auto distance = 1; distance < npus_count; distance++) {
+        hops_count_sum += compute_shift_hops_count(distance);
+    }
+    return hops_count_sum;
+}
+
+int64_t BasicTopology::compute_xor_hops_count_sum() const noexcept {
+    auto hops_count_sum = int64_t(0);
+    for (auto distance = 1; distance < npus_count; distance++) {
+        hops_count_sum += compute_xor_hops_count(distance);
+    }
+    return hops_count_sum;
+}
+
+int BasicTopology::compute_shift_hops_count(const int distance) const noexcept {
+    assert(0 < distance && distance < npus_count);
+
+    // every NPU is the same distance away from its peer
+    if (is_rotation_invariant()) {
+        return compute_hops_count(0, distance);
+    }
+
+    auto max_hops_count = 0;
+    for (auto npu = 0; npu < npus_count; npu++) {
+        max_hops_count = std::max(max_hops_count, compute_hops_count(npu, (npu + distance) % npus_count));
+    }
+    return max_hops_count;
+}
+
+int BasicTopology::compute_xor_hops_count(const int distance) const noexcept {
+    assert(0 < distance && distance < npus_count);
+
+    // for a power-of-2 distance, (npu XOR distance) is either npu + distance or npu - distance
+    if (is_rotation_invariant() && (distance & (distance - 1)) == 0) {
+        return std::max(compute_hops_count(0, distance), compute_hops_count(0, npus_count - distance));
+    }
+
+    auto max_hops_count = 0;
+    for (auto npu = 0; npu < npus_count; npu++) {
+        max_hops_count = std::max(max_hops_count, compute_hops_count(npu, npu ^ distance));
+    }
+    return max_hops_count;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/FatTree.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+FatTree::FatTree(const int npus_count, const Bandwidth bandwidth, const Latency latency, const int radix) noexcept
+    : BasicTopologyImpl(npus_count, bandwidth, latency),
+      radix(radix),
+      levels_count(0) {
+    assert(npus_count >= radix);
+    assert(radix >= 2);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set the building block type
+    basic_topology_type = TopologyBuildingBlock::FatTree;
+
+    // npus_count = radix^levels_count
+    for (auto subtrees_count = npus_count; subtrees_count > 1; subtrees_count /= radix) {
+        assert(subtrees_count % radix == 0);
+        levels_count++;
+    }
+}
+
+int FatTree::get_levels_count() const noexcept {
+    return levels_count;
+}
+
+int FatTree::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // go up to the lowest level whose subtree holds both src and dest, then down
+    auto top_level = 1;
+    for (auto src_subtree = src / radix, dest_subtree = dest / radix; src_subtree != dest_subtree; top_level++) {
+        src_subtree /= radix;
+        dest_subtree /= radix;
+    }
+    return 2 * top_level;
+}
+
+int FatTree::compute_max_hops_count() const noexcept {
+    // NPUs of different top-level subtrees meet at the top level
+    return 2 * levels_count;
+}
+
+int64_t FatTree::compute_shift_hops_count_sum() const noexcept {
+    // no shift maps every top-level subtree onto itself,
+    // so every step has a pair meeting at the top level
+    return int64_t(2) * levels_count * (npus_count - 1);
+}
+
+int64_t FatTree::compute_xor_hops_count_sum() const noexcept {
+    // npus_count is a power of 2, so is radix:
+    // npu XOR i meets npu at the lowest level L with i < radix^L,
+    // and (radix^L - radix^(L-1)) steps meet at level L
+    auto hops_count_sum = int64_t(0);
+    auto subtree_size = int64_t(1);
+    for (auto level = 1; level <= levels_count; level++) {
+        const auto next_subtree_size = subtree_size * radix;
+        hops_count_sum += int64_t(2) * level * (next_subtree_size - subtree_size);
+        subtree_size = next_subtree_size;
+    }
+    return hops_count_sum;
+}
@@ -4,13 +4,14 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/FullyConnected.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
-    : BasicTopology(npus_count, bandwidth, latency) {
+    : BasicTopologyImpl(npus_count, bandwidth, latency) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -19,7 +20,8 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
     basic_topology_type = TopologyBuildingBlock::FullyConnected;
 }
 
-int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+int FullyConnected::compute_hops_count([[maybe_unused]] const DeviceId src,
+                                       [[maybe_unused]] const DeviceId dest) const noexcept {
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
     assert(src != dest);
@@ -27,3 +29,31 @@ int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest)
     // for FullyConnected, hops_count is always 1 (src -> dest)
     return 1;
 }
+
+void FullyConnected::compute_hops_counts([[maybe_unused]] const DeviceId* const srcs,
+                                         [[maybe_unused]] const DeviceId* const dests,
+                                         int* const hops_counts,
+                                         const size_t count) const noexcept {
+    // hops_count is always 1
+    std::fill_n(hops_counts, count, 1);
+}
+
+bool FullyConnected::is_rotation_invariant() const noexcept {
+    // hops_count is always 1
+    return true;
+}
+
+int FullyConnected::compute_max_hops_count() const noexcept {
+    // every pair is a single hop apart
+    return 1;
+}
+
+int64_t FullyConnected::compute_shift_hops_count_sum() const noexcept {
+    // every step is a single hop
+    return npus_count - 1;
+}
+
+int64_t FullyConnected::compute_xor_hops_count_sum() const noexcept {
+    // every step is a single hop
+    return npus_count - 1;
+}
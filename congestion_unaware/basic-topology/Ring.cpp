@@ -10,7 +10,7 @@ using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latency, const bool bidirectional) noexcept
-    : bidirectional(bidirectional), BasicTopology(npus_count, bandwidth, latency) {
+    : bidirectional(bidirectional), BasicTopologyImpl(npus_count, bandwidth, latency) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -46,3 +46,47 @@ int Ring::compute_hops_count(const DeviceId src, const DeviceId dest) const noex
     // bidirectional: return shorter distance
     return (clockwise_distance < anticlockwise_distance) ? clockwise_distance : anticlockwise_distance;
 }
+
+void Ring::compute_hops_counts(const DeviceId* const srcs,
+                               const DeviceId* const dests,
+                               int* const hops_counts,
+                               const size_t count) const noexcept {
+    // same as compute_hops_count, with selects instead of branches so that the loop vectorizes
+    for (auto i = size_t(0); i < count; i++) {
+        assert(srcs[i] != dests[i]);
+
+        const auto distance = dests[i] - srcs[i];
+        const auto clockwise_distance = (distance < 0) ? (distance + npus_count) : distance;
+        const auto anticlockwise_distance = npus_count - clockwise_distance;
+        const auto shorter_distance =
+            (clockwise_distance < anticlockwise_distance) ? clockwise_distance : anticlockwise_distance;
+        hops_counts[i] = bidirectional ? shorter_distance : clockwise_distance;
+    }
+}
+
+bool Ring::is_rotation_invariant() const noexcept {
+    // hops_count is the (shorter) distance along the ring
+    return true;
+}
+
+int Ring::compute_max_hops_count() const noexcept {
+    // unidirectional: the previous NPU is the farthest
+    if (!bidirectional) {
+        return npus_count - 1;
+    }
+
+    // bidirectional: the opposite NPU is the farthest
+    return npus_count / 2;
+}
+
+int64_t Ring::compute_shift_hops_count_sum() const noexcept {
+    const auto n = int64_t(npus_count);
+
+    // unidirectional: 1 + 2 + ... + (n - 1)
+    if (!bidirectional) {
+        return n * (n - 1) / 2;
+    }
+
+    // bidirectional: the sum of min(i, n - i) over 0 < i < n
+    return (n * n) / 4;
+}
@@ -4,13 +4,14 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/Switch.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
-    : BasicTopology(npus_count, bandwidth, latency) {
+    : BasicTopologyImpl(npus_count, bandwidth, latency) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -19,7 +20,8 @@ Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency la
     basic_topology_type = TopologyBuildingBlock::Switch;
 }
 
-int Switch::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+int Switch::compute_hops_count([[maybe_unused]] const DeviceId src,
+                               [[maybe_unused]] const DeviceId dest) const noexcept {
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
     assert(src != dest);
@@ -27,3 +29,31 @@ int Switch::compute_hops_count(const DeviceId src, const DeviceId dest) const no
     // for switch, hops_count is always 2 (src -> switch -> dest)
     return 2;
 }
+
+void Switch::compute_hops_counts([[maybe_unused]] const DeviceId* const srcs,
+                                 [[maybe_unused]] const DeviceId* const dests,
+                                 int* const hops_counts,
+                                 const size_t count) const noexcept {
+    // hops_count is always 2
+    std::fill_n(hops_counts, count, 2);
+}
+
+bool Switch::is_rotation_invariant() const noexcept {
+    // hops_count is always 2
+    return true;
+}
+
+int Switch::compute_max_hops_count() const noexcept {
+    // every pair is two hops apart, through the switch
+    return 2;
+}
+
+int64_t Switch::compute_shift_hops_count_sum() const noexcept {
+    // every step is two hops, through the switch
+    return int64_t(2) * (npus_count - 1);
+}
+
+int64_t Switch::compute_xor_hops_count_sum() const noexcept {
+    // every step is two hops, through the switch
+    return int64_t(2) * (npus_count - 1);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/Torus.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+Torus::Torus(const int npus_count,
+             const Bandwidth bandwidth,
+             const Latency latency,
+             const std::vector<int>& shape,
+             const bool wraparound) noexcept
+    : BasicTopologyImpl(npus_count, bandwidth, latency),
+      shape(shape.empty() ? std::vector<int>{npus_count} : shape),
+      wraparound(wraparound) {
+    assert(npus_count > 1);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set the building block type
+    basic_topology_type = wraparound ? TopologyBuildingBlock::Torus : TopologyBuildingBlock::Mesh;
+
+    // side i is strided by the product of the lower sides
+    auto stride = 1;
+    for (const auto side : this->shape) {
+        assert(side > 1);
+        strides.push_back(stride);
+        stride *= side;
+    }
+    assert(stride == npus_count);
+}
+
+const std::vector<int>& Torus::get_shape() const noexcept {
+    return shape;
+}
+
+int Torus::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // sum the distances along each side
+    auto hops_count = 0;
+    for (auto side = 0; side < static_cast<int>(shape.size()); side++) {
+        const auto length = shape[side];
+        const auto distance = ((dest / strides[side]) % length) - ((src / strides[side]) % length);
+        const auto forward_distance = (distance < 0) ? (distance + length) : distance;
+
+        // Mesh: straight along the side, Torus: the shorter way around
+        if (!wraparound) {
+            hops_count += (distance < 0) ? -distance : distance;
+        } else {
+            const auto backward_distance = length - forward_distance;
+            hops_count += (forward_distance < backward_distance) ? forward_distance : backward_distance;
+        }
+    }
+    return hops_count;
+}
+
+bool Torus::is_rotation_invariant() const noexcept {
+    // a one-sided Torus is a bidirectional Ring
+    return wraparound && shape.size() == 1;
+}
+
+int Torus::compute_max_hops_count() const noexcept {
+    // the farthest NPUs are the farthest along every side
+    auto max_hops_count = 0;
+    for (const auto length : shape) {
+        max_hops_count += wraparound ? (length / 2) : (length - 1);
+    }
+    return max_hops_count;
+}
@@ -4,6 +4,8 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/MultiDimTopology.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
@@ -11,10 +13,13 @@ LICENSE file in the root directory of this source tree.
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
-MultiDimTopology::MultiDimTopology() noexcept : Topology() {
+MultiDimTopology::MultiDimTopology() noexcept : Topology(), routing(MultiDimRouting::FirstDim) {
     // initialize values
     topology_per_dim.clear();
+    dim_topology_per_dim.clear();
     npus_count_per_dim = {};
+    stride_per_dim = {};
+    reciprocal_bandwidth_per_dim = {};
 
     // initialize topology shape
     npus_count = 1;
@@ -22,29 +27,88 @@ MultiDimTopology::MultiDimTopology() noexcept : Topology() {
 }
 
 EventTime MultiDimTopology::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
-    // translate src and dest to multi-dim address
-    const auto src_address = translate_address(src);
-    const auto dest_address = translate_address(dest);
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
 
-    // get dim to transfer
-    const auto dim_to_transfer = get_dim_to_transfer(src_address, dest_address);
+    // traverse every differing dim
+    if (routing == MultiDimRouting::DimOrder) {
+        return send_dim_order(src, dest, chunk_size);
+    }
 
-    // prepare localized topology and address info
-    auto* const topology = topology_per_dim[dim_to_transfer].get();
-    const auto src_local_id = src_address[dim_to_transfer];
-    const auto dest_local_id = dest_address[dim_to_transfer];
+    // get dim to transfer
+    const auto transfer = find_dim_to_transfer(src, dest);
 
-    // run localized communication
-    const auto comms_delay = topology->send(src_local_id, dest_local_id, chunk_size);
+    // run localized communication, statically dispatched to the building block
+    const auto comms_delay = std::visit(
+        [&](const auto* const topology) {
+            return topology->send(transfer.src_local_id, transfer.dest_local_id, chunk_size);
+        },
+        dim_topology_per_dim[transfer.dim]);
 
     // return communication delay
     return comms_delay;
 }
 
+void MultiDimTopology::send_batch(const DeviceId* const srcs,
+                                  const DeviceId* const dests,
+                                  const ChunkSize* const chunk_sizes,
+                                  EventTime* const comms_delays,
+                                  const size_t count) const noexcept {
+    // chunks may cross multiple dims
+    if (routing == MultiDimRouting::DimOrder) {
+        Topology::send_batch(srcs, dests, chunk_sizes, comms_delays, count);
+        return;
+    }
+
+    // group the chunks by the dim to transfer
+    auto indices_per_dim = std::vector<std::vector<size_t>>(dims_count);
+    auto local_srcs = std::vector<DeviceId>(count);
+    auto local_dests = std::vector<DeviceId>(count);
+    for (auto i = size_t(0); i < count; i++) {
+        const auto transfer = find_dim_to_transfer(srcs[i], dests[i]);
+        indices_per_dim[transfer.dim].push_back(i);
+        local_srcs[i] = transfer.src_local_id;
+        local_dests[i] = transfer.dest_local_id;
+    }
+
+    // send each group as a batch of its dim
+    auto batch_srcs = std::vector<DeviceId>();
+    auto batch_dests = std::vector<DeviceId>();
+    auto batch_chunk_sizes = std::vector<ChunkSize>();
+    auto batch_comms_delays = std::vector<EventTime>();
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto& indices = indices_per_dim[dim];
+        if (indices.empty()) {
+            continue;
+        }
+
+        // gather the group
+        batch_srcs.clear();
+        batch_dests.clear();
+        batch_chunk_sizes.clear();
+        for (const auto i : indices) {
+            batch_srcs.push_back(local_srcs[i]);
+            batch_dests.push_back(local_dests[i]);
+            batch_chunk_sizes.push_back(chunk_sizes[i]);
+        }
+
+        // send the group, and scatter the delays
+        batch_comms_delays.resize(indices.size());
+        topology_per_dim[dim]->send_batch(batch_srcs.data(), batch_dests.data(), batch_chunk_sizes.data(),
+                                          batch_comms_delays.data(), indices.size());
+        for (auto j = size_t(0); j < indices.size(); j++) {
+            comms_delays[indices[j]] = batch_comms_delays[j];
+        }
+    }
+}
+
 void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology) noexcept {
     // increment dims_count
     dims_count++;
 
+    // NPUs of the new dimension are strided by the NPUs of the existing dimensions
+    stride_per_dim.push_back(npus_count);
+
     // increase npus_count
     const auto topology_size = topology->get_npus_count();
     npus_count *= topology_size;
@@ -52,56 +116,145 @@ void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology)
     // append bandwidth
     const auto bandwidth = topology->get_bandwidth_per_dim()[0];
     bandwidth_per_dim.push_back(bandwidth);
+    reciprocal_bandwidth_per_dim.push_back(bw_Bpns_to_reciprocal(bw_GBps_to_Bpns(bandwidth)));
+
+    // resolve the building block
+    switch (topology->get_basic_topology_type()) {
+    case TopologyBuildingBlock::Ring:
+        dim_topology_per_dim.emplace_back(static_cast<const Ring*>(topology.get()));
+        break;
+    case TopologyBuildingBlock::FullyConnected:
+        dim_topology_per_dim.emplace_back(static_cast<const FullyConnected*>(topology.get()));
+        break;
+    case TopologyBuildingBlock::Switch:
+        dim_topology_per_dim.emplace_back(static_cast<const Switch*>(topology.get()));
+        break;
+    case TopologyBuildingBlock::FatTree:
+        dim_topology_per_dim.emplace_back(static_cast<const FatTree*>(topology.get()));
+        break;
+    case TopologyBuildingBlock::Torus:
+    case TopologyBuildingBlock::Mesh:
+        dim_topology_per_dim.emplace_back(static_cast<const Torus*>(topology.get()));
+        break;
+    default:
+        dim_topology_per_dim.emplace_back(static_cast<const BasicTopology*>(topology.get()));
+        break;
+    }
 
     // push back topology and npus_count
     topology_per_dim.push_back(std::move(topology));
     npus_count_per_dim.push_back(topology_size);
 }
 
-MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
-    // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-    // 47 // 16 = 2, leftover = 47 % 16 = 15
-    // 15 // 2 = 7, leftover = 15 % 2 = 1
-    // 1 // 1 = 1, leftover = 0
-    // therefore the address is [1, 7, 2]
-
-    // create empty address
-    auto multi_dim_address = MultiDimAddress();
-    for (auto i = 0; i < dims_count; i++) {
-        multi_dim_address.push_back(-1);
+void MultiDimTopology::set_routing(const MultiDimRouting routing) noexcept {
+    this->routing = routing;
+}
+
+EventTime MultiDimTopology::send_dim_order(const DeviceId src,
+                                           const DeviceId dest,
+                                           const ChunkSize chunk_size) const noexcept {
+    assert(src != dest);
+    assert(chunk_size > 0);
+
+    // sum the link delays of the differing dims, and find the bottleneck bandwidth (the largest reciprocal)
+    auto link_delay = PicoTime(0);
+    auto bottleneck_reciprocal_bandwidth = ReciprocalBandwidth(0);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto stride = stride_per_dim[dim];
+        const auto src_local_id = (src / stride) % npus_count_per_dim[dim];
+        const auto dest_local_id = (dest / stride) % npus_count_per_dim[dim];
+        if (src_local_id == dest_local_id) {
+            continue;
+        }
+
+        link_delay += topology_per_dim[dim]->compute_link_delay(src_local_id, dest_local_id);
+        bottleneck_reciprocal_bandwidth = std::max(bottleneck_reciprocal_bandwidth, reciprocal_bandwidth_per_dim[dim]);
     }
+    assert(bottleneck_reciprocal_bandwidth > 0);
+
+    // the chunk is serialized once, at the bottleneck
+    const auto serialization_delay = serialization_delay_ps(chunk_size, bottleneck_reciprocal_bandwidth);
+    return ps_to_event_time(link_delay + serialization_delay);
+}
 
-    auto leftover = npu_id;
-    auto denominator = npus_count;
+void MultiDimTopology::build_lookup_tables(const size_t memory_budget) noexcept {
+    for (const auto& topology : topology_per_dim) {
+        topology->build_lookup_tables(memory_budget / dims_count);
+    }
+}
 
-    for (auto dim = dims_count - 1; dim >= 0; dim--) {
-        // change denominator
-        denominator /= npus_count_per_dim[dim];
+EventTime MultiDimTopology::estimate_collective(const CollectiveType type,
+                                                const CollectiveAlgorithm algorithm,
+                                                const ChunkSize size) const noexcept {
+    // all-reduce: reduce-scatter followed by all-gather
+    if (type == CollectiveType::AllReduce) {
+        return estimate_collective(CollectiveType::ReduceScatter, algorithm, size) +
+               estimate_collective(CollectiveType::AllGather, algorithm, size);
+    }
 
-        // get and update address
-        const auto quotient = leftover / denominator;
-        leftover %= denominator;
+    auto collective_time = EventTime(0);
 
-        // update address
-        multi_dim_address[dim] = quotient;
+    // all-to-all: every dim exchanges the whole buffer
+    if (type == CollectiveType::AllToAll) {
+        for (const auto& topology : topology_per_dim) {
+            collective_time += topology->estimate_collective(type, algorithm, size);
+        }
+        return collective_time;
     }
 
-    // check address translation
-    for (auto i = 0; i < dims_count; i++) {
-        assert(0 <= multi_dim_address[i]);
-        assert(multi_dim_address[i] < npus_count_per_dim[i]);
+    // reduce-scatter: dim 1 scatters the whole buffer, and the next dims the shard left
+    // all-gather mirrors it, so each dim takes the same buffer size and time in the reverse order
+    auto buffer_size = size;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        collective_time += topology_per_dim[dim]->estimate_collective(type, algorithm, buffer_size);
+        buffer_size /= npus_count_per_dim[dim];
     }
+    return collective_time;
+}
+
+const BasicTopology& MultiDimTopology::get_topology_of_dim(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
 
-    // return retrieved address
-    return multi_dim_address;
+    return *topology_per_dim[dim];
 }
 
-int MultiDimTopology::get_dim_to_transfer(const MultiDimAddress& src_address,
-                                          const MultiDimAddress& dest_address) const noexcept {
-    for (auto dim = 0; dim < dims_count; dim++) {
+MultiDimTopology::DimTransfer MultiDimTopology::find_dim_to_transfer(const DeviceId src,
+                                                                     const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // unrolled for the common dims counts
+    switch (dims_count) {
+    case 2:
+        return get_dim_to_transfer<2>(src, dest);
+    case 3:
+        return get_dim_to_transfer<3>(src, dest);
+    case 4:
+        return get_dim_to_transfer<4>(src, dest);
+    default:
+        return get_dim_to_transfer<0>(src, dest);
+    }
+}
+
+template <int DimsCount>
+MultiDimTopology::DimTransfer MultiDimTopology::get_dim_to_transfer(const DeviceId src,
+                                                                    const DeviceId dest) const noexcept {
+    assert(DimsCount == 0 || DimsCount == dims_count);
+
+    // If units-count is [2, 8, 4], the strides are [1, 2, 16],
+    // and the dim-1 address of NPU 47 is (47 / 2) % 8 = 7.
+    // The address of each dim only depends on its own stride,
+    // so the divisions of an unrolled loop don't wait for each other.
+    const auto dims = (DimsCount > 0) ? DimsCount : dims_count;
+    const auto* const strides = stride_per_dim.data();
+    const auto* const sizes = npus_count_per_dim.data();
+
+    for (auto dim = 0; dim < dims; dim++) {
         // check the dim that has different address
-        if (src_address[dim] != dest_address[dim]) {
-            return dim;
+        const auto src_local_id = (src / strides[dim]) % sizes[dim];
+        const auto dest_local_id = (dest / strides[dim]) % sizes[dim];
+        if (src_local_id != dest_local_id) {
+            return {dim, src_local_id, dest_local_id};
         }
     }
 
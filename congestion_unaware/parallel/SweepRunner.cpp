@@ -0,0 +1,177 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/SweepRunner.h"
+#include "congestion_unaware/Helper.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+size_t SweepResults::get_rows_count() const noexcept {
+    return sizes.size();
+}
+
+void SweepResults::write_csv(std::ostream& out) const noexcept {
+    const auto dims_count = npus_counts_per_dim.size();
+
+    // header
+    for (auto dim = size_t(0); dim < dims_count; dim++) {
+        out << "dim" << dim << "_npus_count,dim" << dim << "_bandwidth,dim" << dim << "_latency,";
+    }
+    out << "size";
+    for (const auto& name : metric_names) {
+        out << "," << name;
+    }
+    out << std::endl;
+
+    // rows
+    for (auto row = size_t(0); row < get_rows_count(); row++) {
+        for (auto dim = size_t(0); dim < dims_count; dim++) {
+            out << npus_counts_per_dim[dim][row] << "," << bandwidths_per_dim[dim][row] << ","
+                << latencies_per_dim[dim][row] << ",";
+        }
+        out << sizes[row];
+        for (const auto& values : metric_values) {
+            out << "," << values[row];
+        }
+        out << std::endl;
+    }
+}
+
+SweepRunner::SweepRunner(const int threads_count) noexcept : threads_count(threads_count) {
+    assert(threads_count > 0);
+}
+
+void SweepRunner::add_dimension(const TopologyBuildingBlock topology,
+                                std::vector<int> npus_counts,
+                                std::vector<Bandwidth> bandwidths,
+                                std::vector<Latency> latencies) noexcept {
+    assert(!npus_counts.empty());
+    assert(!bandwidths.empty());
+    assert(!latencies.empty());
+
+    dimensions.push_back({topology, std::move(npus_counts), std::move(bandwidths), std::move(latencies)});
+}
+
+void SweepRunner::add_message_size(const ChunkSize size) noexcept {
+    assert(size > 0);
+
+    sizes.push_back(size);
+}
+
+void SweepRunner::add_metric(const std::string& name, SweepMetric metric) noexcept {
+    assert(metric != nullptr);
+
+    metric_names.push_back(name);
+    metrics.push_back(std::move(metric));
+}
+
+size_t SweepRunner::get_configs_count() const noexcept {
+    if (dimensions.empty()) {
+        return 0;
+    }
+
+    auto configs_count = size_t(1);
+    for (const auto& dimension : dimensions) {
+        configs_count *= dimension.get_candidates_count();
+    }
+    return configs_count;
+}
+
+SweepResults SweepRunner::run() const noexcept {
+    const auto dims_count = dimensions.size();
+    const auto configs_count = get_configs_count();
+    const auto rows_count = configs_count * sizes.size();
+
+    // allocate the columns, so that each row is written by a single worker
+    auto results = SweepResults();
+    results.npus_counts_per_dim.assign(dims_count, std::vector<int>(rows_count));
+    results.bandwidths_per_dim.assign(dims_count, std::vector<Bandwidth>(rows_count));
+    results.latencies_per_dim.assign(dims_count, std::vector<Latency>(rows_count));
+    results.sizes.resize(rows_count);
+    results.metric_names = metric_names;
+    results.metric_values.assign(metrics.size(), std::vector<EventTime>(rows_count));
+
+    // construct the topology of each configuration
+    auto topologies = std::vector<SharedTopology>(configs_count);
+    run_parallel(configs_count, [&](const size_t config) {
+        auto topologies_per_dim = std::vector<TopologyBuildingBlock>(dims_count);
+        auto npus_counts_per_dim = std::vector<int>(dims_count);
+        auto bandwidths_per_dim = std::vector<Bandwidth>(dims_count);
+        auto latencies_per_dim = std::vector<Latency>(dims_count);
+
+        // decode the candidate of each dimension, the last dimension varying the fastest
+        auto leftover = config;
+        for (auto dim = dims_count; dim-- > 0;) {
+            const auto& dimension = dimensions[dim];
+            auto candidate = leftover % dimension.get_candidates_count();
+            leftover /= dimension.get_candidates_count();
+
+            topologies_per_dim[dim] = dimension.topology;
+            latencies_per_dim[dim] = dimension.latencies[candidate % dimension.latencies.size()];
+            candidate /= dimension.latencies.size();
+            bandwidths_per_dim[dim] = dimension.bandwidths[candidate % dimension.bandwidths.size()];
+            candidate /= dimension.bandwidths.size();
+            npus_counts_per_dim[dim] = dimension.npus_counts[candidate];
+        }
+
+        // fill in the configuration columns of its rows
+        for (auto i = size_t(0); i < sizes.size(); i++) {
+            const auto row = (config * sizes.size()) + i;
+            for (auto dim = size_t(0); dim < dims_count; dim++) {
+                results.npus_counts_per_dim[dim][row] = npus_counts_per_dim[dim];
+                results.bandwidths_per_dim[dim][row] = bandwidths_per_dim[dim];
+                results.latencies_per_dim[dim][row] = latencies_per_dim[dim];
+            }
+            results.sizes[row] = sizes[i];
+        }
+
+        topologies[config] =
+            construct_topology(topologies_per_dim, npus_counts_per_dim, bandwidths_per_dim, latencies_per_dim);
+    });
+
+    // evaluate the rows, sharing the topology of a configuration across the workers
+    // a configuration that doesn't describe a valid topology is skipped, keeping its metrics 0
+    run_parallel(rows_count, [&](const size_t row) {
+        const auto& topology = topologies[row / sizes.size()];
+        if (topology == nullptr) {
+            return;
+        }
+        for (auto metric = size_t(0); metric < metrics.size(); metric++) {
+            results.metric_values[metric][row] = metrics[metric](*topology, results.sizes[row]);
+        }
+    });
+
+    return results;
+}
+
+size_t SweepRunner::SweepDimension::get_candidates_count() const noexcept {
+    return npus_counts.size() * bandwidths.size() * latencies.size();
+}
+
+void SweepRunner::run_parallel(const size_t jobs_count, const std::function<void(size_t index)>& job) const noexcept {
+    // each worker repeatedly takes the next job not yet run
+    auto next_job = std::atomic<size_t>(0);
+    const auto run_worker = [&] {
+        for (auto i = next_job++; i < jobs_count; i = next_job++) {
+            job(i);
+        }
+    };
+
+    // run one worker on this thread, and the others on worker threads
+    const auto workers_count = std::min<size_t>(threads_count, jobs_count);
+    auto workers = std::vector<std::thread>();
+    for (size_t i = 1; i < workers_count; i++) {
+        workers.emplace_back(run_worker);
+    }
+    run_worker();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
@@ -5,24 +5,77 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_unaware/Helper.h"
 #include "congestion_unaware/BasicTopology.h"
+#include "congestion_unaware/FatTree.h"
 #include "congestion_unaware/FullyConnected.h"
 #include "congestion_unaware/MultiDimTopology.h"
 #include "congestion_unaware/Ring.h"
 #include "congestion_unaware/Switch.h"
-#include <cstdlib>
-#include <iostream>
+#include "congestion_unaware/Torus.h"
+#include <cassert>
+#include <string>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 std::shared_ptr<Topology>
 NetworkAnalyticalCongestionUnaware::construct_topology(const NetworkParser& network_parser) noexcept {
-    // get network_parser info
-    const auto dims_count = network_parser.get_dims_count();
-    const auto topologies_per_dim = network_parser.get_topologies_per_dim();
-    const auto npus_counts_per_dim = network_parser.get_npus_counts_per_dim();
-    const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
-    const auto latencies_per_dim = network_parser.get_latencies_per_dim();
+    return construct_topology(network_parser.get_network_config());
+}
+
+std::shared_ptr<Topology>
+NetworkAnalyticalCongestionUnaware::construct_topology(const NetworkConfig& network_config) noexcept {
+    auto error = std::string();
+    return construct_topology(network_config, error);
+}
+
+std::shared_ptr<Topology>
+NetworkAnalyticalCongestionUnaware::construct_topology(const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+                                                       const std::vector<int>& npus_counts_per_dim,
+                                                       const std::vector<Bandwidth>& bandwidths_per_dim,
+                                                       const std::vector<Latency>& latencies_per_dim,
+                                                       const std::vector<int>& radixes_per_dim,
+                                                       const std::vector<std::vector<int>>& shapes_per_dim) noexcept {
+    // every dimension should be fully described
+    const auto dims_count = static_cast<int>(topologies_per_dim.size());
+    assert(dims_count > 0);
+    assert(npus_counts_per_dim.size() == dims_count);
+    assert(bandwidths_per_dim.size() == dims_count);
+    assert(latencies_per_dim.size() == dims_count);
+
+    // describe the dimensions as a config, to validate them the same way
+    auto network_config = NetworkConfig();
+    for (auto dim = 0; dim < dims_count; dim++) {
+        network_config.add_dimension(topologies_per_dim[dim], npus_counts_per_dim[dim], bandwidths_per_dim[dim],
+                                     latencies_per_dim[dim]);
+        if (dim < static_cast<int>(radixes_per_dim.size())) {
+            network_config.set_fat_tree(dim, radixes_per_dim[dim]);
+        }
+        if (dim < static_cast<int>(shapes_per_dim.size())) {
+            network_config.set_shape(dim, shapes_per_dim[dim]);
+        }
+    }
+
+    return construct_topology(network_config);
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology(const NetworkConfig& network_config,
+                                                                                 std::string& error) noexcept {
+    // invalid configs are reported to the caller
+    error = network_config.validate({TopologyBuildingBlock::Ring, TopologyBuildingBlock::Switch,
+                                     TopologyBuildingBlock::FullyConnected, TopologyBuildingBlock::FatTree,
+                                     TopologyBuildingBlock::Torus, TopologyBuildingBlock::Mesh});
+    if (!error.empty()) {
+        return nullptr;
+    }
+
+    // get network_config info
+    const auto dims_count = network_config.get_dims_count();
+    const auto& topologies_per_dim = network_config.get_topologies_per_dim();
+    const auto& npus_counts_per_dim = network_config.get_npus_counts_per_dim();
+    const auto& bandwidths_per_dim = network_config.get_bandwidths_per_dim();
+    const auto& latencies_per_dim = network_config.get_latencies_per_dim();
+    const auto& radixes_per_dim = network_config.get_radixes_per_dim();
+    const auto& shapes_per_dim = network_config.get_shapes_per_dim();
 
     // if dims_count is 1, just create basic topology
     if (dims_count == 1) {
@@ -40,10 +93,16 @@ NetworkAnalyticalCongestionUnaware::construct_topology(const NetworkParser& netw
             return std::make_shared<Switch>(npus_count, bandwidth, latency);
         case TopologyBuildingBlock::FullyConnected:
             return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+        case TopologyBuildingBlock::FatTree:
+            return std::make_shared<FatTree>(npus_count, bandwidth, latency, radixes_per_dim[0]);
+        case TopologyBuildingBlock::Torus:
+            return std::make_shared<Torus>(npus_count, bandwidth, latency, shapes_per_dim[0]);
+        case TopologyBuildingBlock::Mesh:
+            return std::make_shared<Torus>(npus_count, bandwidth, latency, shapes_per_dim[0], false);
         default:
-            // shouldn't reach here
-            std::cerr << "[Error] (network/analytical/congestion_unaware)" << "Not supported topology" << std::endl;
-            std::exit(-1);
+            // shouldn't reach here: unsupported building blocks are rejected by the validation
+            error = "topology of dimension 0 is not supported by this backend";
+            return nullptr;
         }
     }
 
@@ -70,11 +129,19 @@ NetworkAnalyticalCongestionUnaware::construct_topology(const NetworkParser& netw
         case TopologyBuildingBlock::FullyConnected:
             dim_topology = std::make_unique<FullyConnected>(npus_count, bandwidth, latency);
             break;
+        case TopologyBuildingBlock::FatTree:
+            dim_topology = std::make_unique<FatTree>(npus_count, bandwidth, latency, radixes_per_dim[dim]);
+            break;
+        case TopologyBuildingBlock::Torus:
+            dim_topology = std::make_unique<Torus>(npus_count, bandwidth, latency, shapes_per_dim[dim]);
+            break;
+        case TopologyBuildingBlock::Mesh:
+            dim_topology = std::make_unique<Torus>(npus_count, bandwidth, latency, shapes_per_dim[dim], false);
+            break;
         default:
-            // shouldn't reach here
-            std::cerr << "[Error] (network/analytical/congestion_unaware)" << "Not supported basic-topology"
-                      << std::endl;
-            std::exit(-1);
+            // shouldn't reach here: unsupported building blocks are rejected by the validation
+            error = "topology of dimension " + std::to_string(dim) + " is not supported by this backend";
+            return nullptr;
         }
 
         // append network dimension
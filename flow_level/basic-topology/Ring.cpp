@@ -0,0 +1,70 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "flow_level/Ring.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalFlowLevel;
+
+Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latency, const bool bidirectional) noexcept
+    : BasicTopology(npus_count, npus_count, bandwidth, latency), bidirectional(bidirectional) {
+    assert(npus_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // connect npus in a ring
+    for (auto i = 0; i < npus_count - 1; i++) {
+        connect(i, i + 1, bandwidth, latency, bidirectional);
+    }
+
+    // close the ring, unless a bidirectional 2-NPU ring is already closed
+    if (!(bidirectional && npus_count == 2)) {
+        connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+    }
+}
+
+Route Ring::route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // construct empty route
+    auto route = Route();
+
+    auto step = 1;  // default direction: clockwise
+    if (bidirectional) {
+        // check whether going anticlockwise is shorter
+        auto clockwise_dist = dest - src;
+        if (clockwise_dist < 0) {
+            clockwise_dist += npus_count;
+        }
+        const auto anticlockwise_dist = npus_count - clockwise_dist;
+
+        if (anticlockwise_dist < clockwise_dist) {
+            // traverse the ring anticlockwise
+            step = -1;
+        }
+    }
+
+    // construct the route
+    auto current = src;
+    while (current != dest) {
+        // traverse the ring until reaches dest
+        auto next = current + step;
+
+        // wrap around
+        if (next < 0) {
+            next += npus_count;
+        } else if (next >= npus_count) {
+            next -= npus_count;
+        }
+
+        append_link(route, current, next);
+        current = next;
+    }
+
+    // return the constructed route
+    return route;
+}
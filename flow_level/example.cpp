@@ -0,0 +1,67 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "flow_level/Flow.h"
+#include "flow_level/Helper.h"
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalFlowLevel;
+
+void flow_arrived_callback(void* const event_queue_ptr) {
+    // typecast event_queue_ptr
+    auto* const event_queue = static_cast<EventQueue*>(event_queue_ptr);
+
+    // print flow arrival time
+    const auto current_time = event_queue->get_current_time();
+    std::cout << "A flow arrived at destination at time: " << current_time << " ns" << std::endl;
+}
+
+int main() {
+    // Instantiate shared resources
+    const auto event_queue = std::make_shared<EventQueue>();
+
+    // Parse network config and create topology
+    const auto network_parser = NetworkParser("../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+    const auto devices_count = topology->get_devices_count();
+
+    // message settings
+    const auto flow_size = 1'048'576;  // 1 MB
+
+    // Run All-Gather
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            // create a flow
+            auto route = topology->route(i, j);
+            auto* event_queue_ptr = static_cast<void*>(event_queue.get());
+            auto flow = std::make_unique<Flow>(flow_size, route, flow_arrived_callback, event_queue_ptr);
+
+            // send a flow
+            topology->send(std::move(flow));
+        }
+    }
+
+    // Run simulation
+    const auto summary = event_queue->run_to_completion();
+
+    // Print simulation result
+    const auto finish_time = event_queue->get_current_time();
+    std::cout << "Total NPUs Count: " << npus_count << std::endl;
+    std::cout << "Total devices Count: " << devices_count << std::endl;
+    std::cout << "Simulation finished at time: " << finish_time << " ns" << std::endl;
+    std::cout << "Events executed: " << summary.events_count << " (" << summary.event_times_count
+              << " event times, " << summary.wall_time << " s)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "flow_level/Flow.h"
+#include <cassert>
+#include <memory>
+
+using namespace NetworkAnalyticalFlowLevel;
+
+void Flow::flow_arrived_dest(Flow* const flow_ptr) noexcept {
+    assert(flow_ptr != nullptr);
+
+    // take back the ownership from the event queue
+    // as flow is unique_ptr, will be destroyed automatically
+    auto flow = std::unique_ptr<Flow>(flow_ptr);
+    flow->invoke_callback();
+}
+
+Flow::Flow(const ChunkSize flow_size, Route route, const Callback callback, const CallbackArg callback_arg) noexcept
+    : flow_size(flow_size),
+      route(std::move(route)),
+      callback(callback),
+      callback_arg(callback_arg),
+      remaining_bytes(static_cast<double>(flow_size)),
+      rate(0),
+      drain_time(0),
+      route_latency(0),
+      active_index(0) {
+    assert(flow_size > 0);
+    assert(!this->route.empty());
+    assert(callback != nullptr);
+}
+
+ChunkSize Flow::get_size() const noexcept {
+    return flow_size;
+}
+
+const Route& Flow::get_route() const noexcept {
+    return route;
+}
+
+Bandwidth Flow::get_rate() const noexcept {
+    return rate;
+}
+
+void Flow::invoke_callback() noexcept {
+    // invoke the callback
+    (*callback)(callback_arg);
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "flow_level/Helper.h"
+#include "flow_level/FullyConnected.h"
+#include "flow_level/Ring.h"
+#include "flow_level/Switch.h"
+#include <string>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalFlowLevel;
+
+std::shared_ptr<Topology>
+NetworkAnalyticalFlowLevel::construct_topology(const NetworkParser& network_parser) noexcept {
+    return construct_topology(network_parser.get_network_config());
+}
+
+std::shared_ptr<Topology>
+NetworkAnalyticalFlowLevel::construct_topology(const NetworkConfig& network_config) noexcept {
+    auto error = std::string();
+    return construct_topology(network_config, error);
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalFlowLevel::construct_topology(const NetworkConfig& network_config,
+                                                                         std::string& error) noexcept {
+    // invalid configs are reported to the caller
+    // for now, flow_level backend supports 1-dim topology of the basic building blocks only
+    error = network_config.validate(
+            {TopologyBuildingBlock::Ring, TopologyBuildingBlock::Switch, TopologyBuildingBlock::FullyConnected}, 1);
+    if (!error.empty()) {
+        return nullptr;
+    }
+
+    // get network_config info
+    const auto& topologies_per_dim = network_config.get_topologies_per_dim();
+    const auto& npus_counts_per_dim = network_config.get_npus_counts_per_dim();
+    const auto& bandwidths_per_dim = network_config.get_bandwidths_per_dim();
+    const auto& latencies_per_dim = network_config.get_latencies_per_dim();
+
+    // retrieve basic basic-topology info
+    const auto topology_type = topologies_per_dim[0];
+    const auto npus_count = npus_counts_per_dim[0];
+    const auto bandwidth = bandwidths_per_dim[0];
+    const auto latency = latencies_per_dim[0];
+
+    switch (topology_type) {
+    case TopologyBuildingBlock::Ring:
+        return std::make_shared<Ring>(npus_count, bandwidth, latency);
+    case TopologyBuildingBlock::Switch:
+        return std::make_shared<Switch>(npus_count, bandwidth, latency);
+    case TopologyBuildingBlock::FullyConnected:
+        return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+    default:
+        // shouldn't reach here: unsupported building blocks are rejected by the validation
+        error = "topology of dimension 0 is not supported by this backend";
+        return nullptr;
+    }
+}
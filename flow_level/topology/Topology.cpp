@@ -0,0 +1,299 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "flow_level/Topology.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalFlowLevel;
+
+void Topology::flows_drained(Topology* const topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    topology_ptr->process_drained_flows();
+}
+
+Topology::Topology() noexcept
+    : devices_count(-1),
+      npus_count(-1),
+      dims_count(-1),
+      event_queue(nullptr),
+      last_update_time(0),
+      next_drain_time(0),
+      rate_updates_count(0) {
+    npus_count_per_dim = {};
+}
+
+// default destructor
+Topology::~Topology() noexcept = default;
+
+void Topology::set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept {
+    assert(event_queue != nullptr);
+
+    // in-flight flows are bound to the event queue they were sent on
+    assert(active_flows.empty());
+
+    this->event_queue = std::move(event_queue);
+    last_update_time = this->event_queue->get_current_time();
+}
+
+std::shared_ptr<EventQueue> Topology::get_event_queue() const noexcept {
+    return event_queue;
+}
+
+void Topology::send(std::unique_ptr<Flow> flow) noexcept {
+    assert(flow != nullptr);
+    assert(event_queue != nullptr);
+
+    // bring the active flows up to date, as the fair rates are about to change
+    advance_flows(event_queue->get_current_time());
+
+    // accumulate the route latency
+    auto route_latency = Latency(0);
+    for (const auto link_id : flow->route) {
+        assert(0 <= link_id && link_id < static_cast<LinkId>(links.size()));
+        route_latency += links[link_id].latency;
+    }
+    flow->route_latency = route_latency;
+
+    // register the flow
+    flow->active_index = active_flows.size();
+    active_flows.push_back(std::move(flow));
+
+    // re-share the bandwidth
+    update_rates();
+    schedule_drain();
+}
+
+size_t Topology::get_active_flows_count() const noexcept {
+    return active_flows.size();
+}
+
+size_t Topology::get_rate_updates_count() const noexcept {
+    return rate_updates_count;
+}
+
+int Topology::get_devices_count() const noexcept {
+    assert(devices_count > 0);
+    assert(npus_count > 0);
+    assert(devices_count >= npus_count);
+
+    return devices_count;
+}
+
+int Topology::get_npus_count() const noexcept {
+    assert(devices_count > 0);
+    assert(npus_count > 0);
+    assert(devices_count >= npus_count);
+
+    return npus_count;
+}
+
+int Topology::get_links_count() const noexcept {
+    return static_cast<int>(links.size());
+}
+
+int Topology::get_dims_count() const noexcept {
+    assert(dims_count > 0);
+
+    return dims_count;
+}
+
+std::vector<int> Topology::get_npus_count_per_dim() const noexcept {
+    assert(static_cast<int>(npus_count_per_dim.size()) == dims_count);
+
+    return npus_count_per_dim;
+}
+
+std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
+    assert(static_cast<int>(bandwidth_per_dim.size()) == dims_count);
+
+    return bandwidth_per_dim;
+}
+
+void Topology::instantiate_devices() noexcept {
+    // a device is represented by its outgoing link table
+    device_links.resize(devices_count);
+}
+
+void Topology::connect(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth, const Latency latency,
+                       const bool bidirectional) noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    // assert bandwidth and latency are valid
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // connect src -> dest
+    const auto link_id = static_cast<LinkId>(links.size());
+    links.push_back({src, dest, bw_GBps_to_Bpns(bandwidth), latency});
+
+    auto& src_links = device_links[src];
+    const auto position = std::lower_bound(src_links.begin(), src_links.end(), std::make_pair(dest, LinkId(-1)));
+    assert(position == src_links.end() || position->first != dest);
+    src_links.insert(position, {dest, link_id});
+
+    // if bidirectional, connect dest -> src
+    if (bidirectional) {
+        connect(dest, src, bandwidth, latency, false);
+    }
+}
+
+void Topology::append_link(Route& route, const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    // find the src -> dest link
+    const auto& src_links = device_links[src];
+    const auto position = std::lower_bound(src_links.begin(), src_links.end(), std::make_pair(dest, LinkId(-1)));
+    assert(position != src_links.end() && position->first == dest);
+
+    route.push_back(position->second);
+}
+
+void Topology::advance_flows(const EventTime current_time) noexcept {
+    assert(current_time >= last_update_time);
+
+    // every active flow has been draining at its rate since the last update
+    const auto elapsed_time = static_cast<double>(current_time - last_update_time);
+    for (const auto& flow : active_flows) {
+        flow->remaining_bytes = std::max(0.0, flow->remaining_bytes - (flow->rate * elapsed_time));
+    }
+
+    last_update_time = current_time;
+}
+
+void Topology::update_rates() noexcept {
+    rate_updates_count++;
+
+    // initially, every link is unallocated and every flow is unfrozen
+    const auto links_count = links.size();
+    residual_bandwidth.resize(links_count);
+    unfrozen_flows_count.assign(links_count, 0);
+    for (auto i = size_t(0); i < links_count; i++) {
+        residual_bandwidth[i] = links[i].bandwidth_Bpns;
+    }
+    for (const auto& flow : active_flows) {
+        flow->rate = -1;  // unfrozen
+        for (const auto link_id : flow->route) {
+            unfrozen_flows_count[link_id]++;
+        }
+    }
+
+    // progressive filling:
+    // repeatedly find the bottleneck link offering the smallest fair share,
+    // and freeze the flows crossing it at that share
+    auto unfrozen_count = active_flows.size();
+    while (unfrozen_count > 0) {
+        auto fair_share = std::numeric_limits<Bandwidth>::max();
+        for (auto i = size_t(0); i < links_count; i++) {
+            if (unfrozen_flows_count[i] > 0) {
+                fair_share = std::min(fair_share, residual_bandwidth[i] / unfrozen_flows_count[i]);
+            }
+        }
+
+        // links within the rounding error of the fair share are bottlenecks as well
+        const auto bottleneck_share = fair_share * (1 + 1e-9);
+        for (const auto& flow : active_flows) {
+            if (flow->rate >= 0) {
+                continue;
+            }
+
+            const auto bottlenecked =
+                std::any_of(flow->route.begin(), flow->route.end(), [&](const LinkId link_id) {
+                    return residual_bandwidth[link_id] / unfrozen_flows_count[link_id] <= bottleneck_share;
+                });
+            if (!bottlenecked) {
+                continue;
+            }
+
+            // freeze the flow, and allocate its share
+            flow->rate = fair_share;
+            unfrozen_count--;
+            for (const auto link_id : flow->route) {
+                residual_bandwidth[link_id] = std::max(0.0, residual_bandwidth[link_id] - fair_share);
+                unfrozen_flows_count[link_id]--;
+            }
+        }
+    }
+
+    // compute when each flow drains at its new rate
+    const auto current_time = static_cast<double>(last_update_time);
+    for (const auto& flow : active_flows) {
+        assert(flow->rate > 0);
+        flow->drain_time = current_time + (flow->remaining_bytes / flow->rate);
+    }
+}
+
+void Topology::schedule_drain() noexcept {
+    if (active_flows.empty()) {
+        // nothing to drain: cancel the pending drain event, if any
+        event_queue->cancel(drain_event);
+        drain_event = EventHandle();
+        return;
+    }
+
+    // find the earliest drain time
+    auto earliest_drain_time = std::numeric_limits<double>::max();
+    for (const auto& flow : active_flows) {
+        earliest_drain_time = std::min(earliest_drain_time, flow->drain_time);
+    }
+
+    // drain events are scheduled strictly in the future
+    const auto current_time = event_queue->get_current_time();
+    const auto drain_time = std::max(static_cast<EventTime>(std::ceil(earliest_drain_time)), current_time + 1);
+    if (event_queue->is_pending(drain_event)) {
+        // move the pending drain event, unless it's already at the time
+        if (next_drain_time != drain_time) {
+            next_drain_time = drain_time;
+            drain_event = event_queue->reschedule(drain_event, drain_time);
+        }
+        return;
+    }
+
+    next_drain_time = drain_time;
+    drain_event = event_queue->schedule_event<Topology, Topology::flows_drained>(drain_time, this);
+}
+
+void Topology::process_drained_flows() noexcept {
+    const auto current_time = event_queue->get_current_time();
+    assert(current_time == next_drain_time);
+    drain_event = EventHandle();
+
+    advance_flows(current_time);
+
+    // retire the drained flows
+    auto i = size_t(0);
+    while (i < active_flows.size()) {
+        if (active_flows[i]->drain_time > static_cast<double>(current_time)) {
+            i++;
+            continue;
+        }
+
+        // take the flow out of the active flows: swap with the last one
+        auto flow = std::move(active_flows[i]);
+        if (i + 1 < active_flows.size()) {
+            active_flows[i] = std::move(active_flows.back());
+            active_flows[i]->active_index = i;
+        }
+        active_flows.pop_back();
+
+        // the last byte arrives at dest after the route latency
+        const auto arrival_time = current_time + static_cast<EventTime>(flow->route_latency);
+        flow->remaining_bytes = 0;
+        flow->rate = 0;
+        event_queue->schedule_event<Flow, Flow::flow_arrived_dest>(arrival_time, flow.release());
+    }
+
+    // re-share the released bandwidth
+    update_rates();
+    schedule_drain();
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventList.h"
+#include "common/EventListPool.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /**
+ * CalendarQueue is a priority queue of EventLists keyed on EventTime,
+ * following the calendar queue of R. Brown (CACM 1988).
+ *
+ * Event times are hashed into a circular array of buckets ("days"),
+ * each covering bucket_width ns, and each bucket keeps its EventLists sorted.
+ * Both insertion and min-extraction take amortized O(1) time,
+ * as the number of buckets and the bucket width are re-calibrated
+ * whenever the queue grows or shrinks by a factor of two.
+ *
+ * The queue doesn't own the EventLists: they're acquired from an EventListPool.
+ */
+    class CalendarQueue {
+    public:
+        /**
+   * Constructor.
+   */
+        CalendarQueue() noexcept;
+
+        /**
+   * Check if the calendar queue is empty.
+   *
+   * @return true if no EventList is registered, false otherwise
+   */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+   * Get the number of registered EventLists.
+   *
+   * @return number of registered EventLists
+   */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+   * Get the EventList registered at the given event time.
+   * If there's no such EventList, an empty one is acquired from the pool.
+   *
+   * @param event_time event time of the EventList
+   * @param pool pool to acquire a new EventList from
+   * @return EventList registered at event_time
+   */
+        [[nodiscard]] EventList* find_or_insert(EventTime event_time, EventListPool& pool) noexcept;
+
+        /**
+   * Get the smallest event time among the registered EventLists.
+   * The queue must not be empty.
+   *
+   * @return smallest registered event time
+   */
+        [[nodiscard]] EventTime peek_min_time() noexcept;
+
+        /**
+   * Remove and return the EventList with the smallest event time.
+   * The queue must not be empty.
+   *
+   * @return EventList with the smallest event time
+   */
+        [[nodiscard]] EventList* pop_min() noexcept;
+
+        /**
+   * Remove a registered EventList, e.g., once its events are all cancelled.
+   *
+   * @param event_list registered EventList to remove
+   */
+        void erase(EventList* event_list) noexcept;
+
+        /**
+   * Get every registered EventList, sorted by event time.
+   *
+   * @return registered EventLists
+   */
+        [[nodiscard]] std::vector<const EventList*> get_event_lists() const noexcept;
+
+    private:
+        /// minimum number of buckets
+        static constexpr size_t min_buckets_count = 16;
+
+        /// number of EventLists sampled to estimate the bucket width
+        static constexpr size_t width_samples_count = 32;
+
+        /// buckets of EventLists, each sorted by event time
+        std::vector<std::vector<EventList*>> buckets;
+
+        /// (number of buckets - 1), number of buckets is always a power of 2
+        size_t bucket_mask;
+
+        /// time range covered by a single bucket
+        EventTime bucket_width;
+
+        /// number of registered EventLists
+        size_t event_lists_count;
+
+        /// bucket the dequeue cursor points to
+        /// no registered EventList is earlier than the cursor bucket's current day
+        size_t cursor_bucket;
+
+        /// exclusive upper bound of the event times in the cursor bucket's current day
+        EventTime cursor_bucket_top;
+
+        /**
+   * Compute the bucket index of an event time.
+   *
+   * @param event_time event time
+   * @return index of the bucket holding event_time
+   */
+        [[nodiscard]] size_t bucket_index(EventTime event_time) const noexcept;
+
+        /**
+   * Move the dequeue cursor to the given event time.
+   *
+   * @param event_time event time to move the cursor to
+   */
+        void set_cursor(EventTime event_time) noexcept;
+
+        /**
+   * Advance the dequeue cursor until it points to the bucket
+   * whose first EventList has the smallest event time.
+   * The queue must not be empty.
+   */
+        void locate_min() noexcept;
+
+        /**
+   * Insert a new EventList into its bucket, keeping the bucket sorted.
+   * There must be no registered EventList at the same event time.
+   *
+   * @param event_list EventList to insert
+   */
+        void insert(EventList* event_list) noexcept;
+
+        /**
+   * Rebuild the calendar with the given number of buckets,
+   * and re-estimate the bucket width from the earliest registered EventLists.
+   *
+   * @param new_buckets_count new number of buckets (power of 2)
+   */
+        void resize(size_t new_buckets_count) noexcept;
+    };
+
+}  // namespace NetworkAnalytical
@@ -10,6 +10,20 @@ LICENSE file in the root directory of this source tree.
 
 namespace NetworkAnalytical {
 
+    /**
+ * Type-erasing thunk of a typed event handler.
+ * As the handler is a template parameter, it's bound at compile time
+ * and can be inlined into the thunk, which is registered as an ordinary Callback.
+ *
+ * @tparam T payload type of the event
+ * @tparam Handler typed event handler
+ * @param payload pointer to the payload, which is originally of type T*
+ */
+    template <typename T, TypedCallback<T> Handler>
+    void invoke_typed_event(void* const payload) noexcept {
+        Handler(static_cast<T*>(payload));
+    }
+
     /**
  * Event is a wrapper for a callback function and its argument.
  */
@@ -35,8 +49,20 @@ namespace NetworkAnalytical {
    */
         [[nodiscard]] std::pair<Callback, CallbackArg> get_handler_arg() const noexcept;
 
+        /**
+   * Cancel the event, so that it's skipped instead of invoked.
+   */
+        void cancel() noexcept;
+
+        /**
+   * Check if the event is cancelled.
+   *
+   * @return true if the event is cancelled, false otherwise
+   */
+        [[nodiscard]] bool cancelled() const noexcept;
+
     private:
-        /// pointer to the callback function
+        /// pointer to the callback function, nullptr if cancelled
         Callback callback;
 
         /// argument of the callback function
@@ -7,12 +7,41 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Event.h"
 #include "common/Type.h"
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace NetworkAnalytical {
 
+    class EventList;
+
+    /**
+ * EventHandle refers to a scheduled event, to cancel or reschedule it through the EventQueue.
+ *
+ * The handle locates the event by its EventList and its index in the list: no lookup is needed.
+ * EventLists are recycled once invoked, so the handle also holds the generation of the list,
+ * and a handle of an invoked (or cancelled) event is stale: cancelling it has no effect.
+ */
+    struct EventHandle {
+        /// EventList the event is registered to, nullptr if the handle refers to no event
+        EventList* event_list = nullptr;
+
+        /// index of the event in the EventList
+        uint32_t index = 0;
+
+        /// generation of the EventList when the event was registered
+        uint32_t generation = 0;
+
+        /// true if the handle refers to a relayed event (see EventQueue::schedule_relayed_event()),
+        /// whose index is then in the relay table of the event queue
+        bool relayed = false;
+    };
+
     /**
  * EventList encapsulates a number of Events along with its event time.
+ *
+ * Events are stored in a contiguous buffer which is retained
+ * when the EventList is recycled by the EventListPool.
  */
     class EventList {
     public:
@@ -30,25 +59,152 @@ namespace NetworkAnalytical {
    */
         [[nodiscard]] EventTime get_event_time() const noexcept;
 
+        /**
+   * Re-initialize an empty EventList with a new event time,
+   * keeping the allocated event buffer.
+   *
+   * @param event_time new event time of the event list
+   */
+        void reset(EventTime event_time) noexcept;
+
+        /**
+   * Check if the event list has no registered events.
+   *
+   * @return true if no event is registered, false otherwise
+   */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+   * Get the registered events, in the order of registration.
+   *
+   * @return registered events
+   */
+        [[nodiscard]] const std::vector<Event>& get_events() const noexcept;
+
+        /**
+   * Get the next EventList, when EventLists are chained as an intrusive linked list.
+   *
+   * @return next EventList, nullptr if this is the last one
+   */
+        [[nodiscard]] EventList* get_next() const noexcept;
+
+        /**
+   * Set the next EventList of the intrusive linked list.
+   *
+   * @param next_event_list next EventList, nullptr if this is the last one
+   */
+        void set_next(EventList* next_event_list) noexcept;
+
+        /**
+   * Get the bound of how late the events of the list are invoked, due to the time quantum of the event queue.
+   *
+   * @return time error bound of the events
+   */
+        [[nodiscard]] EventTime get_time_error() const noexcept;
+
+        /**
+   * Raise the time error bound of the event list, if the given error is larger.
+   *
+   * @param time_error time error bound of an event of the list
+   */
+        void raise_time_error(EventTime time_error) noexcept;
+
         /**
    * Register an event into the event list.
    *
    * @param callback callback function pointer
    * @param callback_arg argument of the callback function
+   * @return handle of the event
+   */
+        EventHandle add_event(Callback callback, CallbackArg callback_arg) noexcept;
+
+        /**
+   * Register an event into the event list, along with its sequence number,
+   * i.e., the number of events registered to the event queue before it.
+   * Sequence numbers grow in the order of registration.
+   *
+   * @param callback callback function pointer
+   * @param callback_arg argument of the callback function
+   * @param sequence sequence number of the event
+   * @return handle of the event
+   */
+        EventHandle add_event(Callback callback, CallbackArg callback_arg, uint64_t sequence) noexcept;
+
+        /**
+   * Get the sequence number of an event.
+   * The events registered without one (before the event queue started numbering them) are numbered by their index.
+   *
+   * @param index index of the event
+   * @return sequence number of the event
    */
-        void add_event(Callback callback, CallbackArg callback_arg) noexcept;
+        [[nodiscard]] uint64_t get_sequence(size_t index) const noexcept;
 
         /**
-   * Invoke all events in the event list.
+   * Check if an event of the list is still to be invoked.
+   *
+   * @param index index of the event
+   * @param generation generation of the list the event was registered to
+   * @return true if the event is neither invoked nor cancelled, false otherwise
    */
-        void invoke_events() noexcept;
+        [[nodiscard]] bool pending(uint32_t index, uint32_t generation) const noexcept;
+
+        /**
+   * Cancel a pending event, which is then skipped by invoke_events().
+   *
+   * @param index index of the pending event
+   */
+        void cancel_event(uint32_t index) noexcept;
+
+        /**
+   * Check if every registered event is cancelled.
+   * Shouldn't be called while the events are being invoked.
+   *
+   * @return true if every event is cancelled, false otherwise
+   */
+        [[nodiscard]] bool all_events_cancelled() const noexcept;
+
+        /**
+   * Drop every registered event without invoking them, e.g., once they're all cancelled.
+   */
+        void discard_events() noexcept;
+
+        /**
+   * Invoke all events in the event list, skipping the cancelled ones.
+   *
+   * @return number of invoked events
+   */
+        size_t invoke_events() noexcept;
 
     private:
+        /// the event queue interleaves the events with the relayed ones of the same time
+        friend class EventQueue;
+
         /// event time of the event list
         EventTime event_time;
 
-        /// list of registered events
-        std::list<Event> events;
+        /// registered events, in the order of registration
+        std::vector<Event> events;
+
+        /// sequence numbers of the last registered events, if the event queue numbers them, empty otherwise
+        std::vector<uint64_t> sequences;
+
+        /// ids of the pending relayed events at the event time, in the relay table of the event queue
+        std::vector<uint32_t> relayed_events;
+
+        /// next EventList of the intrusive linked list
+        EventList* next;
+
+        /// bound of how late the events are invoked, due to the time quantum of the event queue
+        EventTime time_error;
+
+        /// generation of the list, bumped whenever it's recycled, so that stale handles are told apart
+        uint32_t generation;
+
+        /// number of events invoked (or skipped) so far by invoke_events(), 0 otherwise
+        size_t invoked_count;
+
+        /// number of cancelled events
+        size_t cancelled_count;
     };
 
 }  // namespace NetworkAnalytical
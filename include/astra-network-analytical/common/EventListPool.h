@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventList.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /**
+ * EventListPool owns the storage of EventLists used by an EventQueue.
+ *
+ * EventLists are allocated from a block-allocated arena and never freed
+ * until the pool is destroyed. Released EventLists are kept in a free list
+ * together with their event buffers, so that a steady-state simulation
+ * doesn't allocate memory for scheduling events.
+ */
+    class EventListPool {
+    public:
+        /**
+   * Constructor.
+   */
+        EventListPool() noexcept;
+
+        /**
+   * Take an empty EventList out of the pool.
+   *
+   * @param event_time event time of the EventList
+   * @return pointer to the EventList, owned by the pool
+   */
+        [[nodiscard]] EventList* acquire(EventTime event_time) noexcept;
+
+        /**
+   * Return an EventList to the pool.
+   * All events of the EventList should have been invoked.
+   *
+   * @param event_list EventList to return, which was acquired from this pool
+   */
+        void release(EventList* event_list) noexcept;
+
+        /**
+   * Pre-allocate EventLists so that the pool holds at least the given number of them.
+   *
+   * @param event_lists_count number of EventLists to pre-allocate
+   */
+        void reserve(size_t event_lists_count) noexcept;
+
+        /**
+   * Get the number of EventLists currently in use.
+   *
+   * @return number of acquired but not yet released EventLists
+   */
+        [[nodiscard]] size_t get_in_use_count() const noexcept;
+
+        /**
+   * Get the peak number of EventLists simultaneously in use.
+   * This is the pool size needed to run the simulation without growing the pool.
+   *
+   * @return peak number of EventLists in use
+   */
+        [[nodiscard]] size_t get_peak_usage() const noexcept;
+
+        /**
+   * Get the number of EventLists allocated by the pool.
+   *
+   * @return number of allocated EventLists
+   */
+        [[nodiscard]] size_t get_capacity() const noexcept;
+
+    private:
+        /// arena of EventLists, std::deque keeps the addresses stable on growth
+        std::deque<EventList> event_lists;
+
+        /// EventLists available to be acquired
+        std::vector<EventList*> free_event_lists;
+
+        /// number of EventLists in use
+        size_t in_use_count;
+
+        /// peak number of EventLists in use
+        size_t peak_usage;
+    };
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,153 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /**
+ * EventProfiler attributes the time spent invoking events to each callback function,
+ * along with the number of invocations, and records how many events are invoked per event time.
+ *
+ * Time is measured in ticks: TSC cycles (rdtsc) on x86-64, and steady_clock nanoseconds elsewhere.
+ * The time of a callback includes everything it does, e.g., scheduling new events.
+ *
+ * EventLists record into the profiler only if the backend is compiled with ANALYTICAL_PROFILING
+ * (CMake option NETWORK_BACKEND_PROFILING), otherwise the instrumentation is compiled out.
+ * Then each thread records into its own profiler, which is merged into a process-wide profile when the thread exits.
+ * The process-wide profile is printed to stderr at exit.
+ */
+    class EventProfiler {
+    public:
+        /// Counters of a callback function
+        struct CallbackProfile {
+            /// number of invocations
+            uint64_t invocations_count = 0;
+
+            /// ticks spent in the invocations
+            uint64_t ticks = 0;
+        };
+
+        /**
+   * Constructor.
+   */
+        EventProfiler() noexcept;
+
+        /**
+   * Get the profiler of the calling thread.
+   *
+   * @return profiler of the calling thread
+   */
+        [[nodiscard]] static EventProfiler& get_thread_profiler() noexcept;
+
+        /**
+   * Read the tick counter.
+   *
+   * @return current ticks
+   */
+        [[nodiscard]] static uint64_t read_ticks() noexcept;
+
+        /**
+   * Get the unit of the ticks.
+   *
+   * @return "cycles" or "ns"
+   */
+        [[nodiscard]] static const char* get_ticks_unit() noexcept;
+
+        /**
+   * Record an invocation of a callback.
+   *
+   * @param callback invoked callback function
+   * @param ticks ticks spent in the invocation
+   */
+        void record_callback(Callback callback, uint64_t ticks) noexcept;
+
+        /**
+   * Record the number of events invoked at an event time.
+   *
+   * @param events_count number of invoked events
+   */
+        void record_batch(size_t events_count) noexcept;
+
+        /**
+   * Get the counters of every invoked callback function.
+   *
+   * @return counters per callback function
+   */
+        [[nodiscard]] const std::unordered_map<Callback, CallbackProfile>& get_callback_profiles() const noexcept;
+
+        /**
+   * Get the histogram of the number of events invoked per event time:
+   * bucket i counts the event times with [2^i, 2^(i+1)) events.
+   *
+   * @return histogram of the batch sizes
+   */
+        [[nodiscard]] const std::vector<uint64_t>& get_batch_sizes_histogram() const noexcept;
+
+        /**
+   * Get the number of recorded event times.
+   *
+   * @return number of batches
+   */
+        [[nodiscard]] uint64_t get_batches_count() const noexcept;
+
+        /**
+   * Get the largest number of events invoked at an event time.
+   *
+   * @return largest batch size
+   */
+        [[nodiscard]] size_t get_max_batch_size() const noexcept;
+
+        /**
+   * Add the counters of another profiler.
+   *
+   * @param other profiler to add
+   */
+        void merge(const EventProfiler& other) noexcept;
+
+        /**
+   * Clear every counter.
+   */
+        void reset() noexcept;
+
+        /**
+   * Print the counters as a table, callbacks sorted by their ticks.
+   *
+   * @param out output stream
+   */
+        void print_summary(std::ostream& out) const noexcept;
+
+        /**
+   * Get a printable name of a callback function:
+   * the demangled symbol if it can be resolved, the address otherwise.
+   *
+   * @param callback callback function
+   * @return name of the callback
+   */
+        [[nodiscard]] static std::string get_callback_name(Callback callback) noexcept;
+
+    private:
+        /// counters of every invoked callback function
+        std::unordered_map<Callback, CallbackProfile> callback_profiles;
+
+        /// histogram of the number of events per event time, in power-of-two buckets
+        std::vector<uint64_t> batch_sizes_histogram;
+
+        /// number of recorded event times
+        uint64_t batches_count;
+
+        /// largest number of events invoked at an event time
+        size_t max_batch_size;
+    };
+
+}  // namespace NetworkAnalytical
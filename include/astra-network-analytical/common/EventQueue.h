@@ -5,11 +5,35 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/CalendarQueue.h"
 #include "common/EventList.h"
+#include "common/EventListPool.h"
 #include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
 
 namespace NetworkAnalytical {
 
+    /**
+ * Summary of a batch execution of the EventQueue.
+ */
+    struct RunSummary {
+        /// number of invoked events
+        uint64_t events_count = 0;
+
+        /// number of distinct event times visited
+        uint64_t event_times_count = 0;
+
+        /// wall-clock time taken by the execution, in seconds
+        double wall_time = 0;
+
+        /// bound of how late any event has been invoked so far, due to the time quantum (0 if not quantized)
+        EventTime time_error_bound = 0;
+    };
+
     /**
  * EventQueue manages scheduled EventLists.
  */
@@ -17,8 +41,17 @@ namespace NetworkAnalytical {
     public:
         /**
    * Constructor.
+   *
+   * @param backend scheduler backend to hold the scheduled EventLists
+   */
+        explicit EventQueue(EventQueueBackend backend = EventQueueBackend::Calendar) noexcept;
+
+        /**
+   * Get the scheduler backend of the event queue.
+   *
+   * @return scheduler backend
    */
-        EventQueue() noexcept;
+        [[nodiscard]] EventQueueBackend get_backend() const noexcept;
 
         /**
    * Get current event time of the event queue.
@@ -43,6 +76,14 @@ namespace NetworkAnalytical {
       */
      int counter() const noexcept;
      
+        /**
+   * Get the earliest registered event time.
+   * The event queue must not be empty.
+   *
+   * @return earliest registered event time
+   */
+        [[nodiscard]] EventTime peek_next_event_time() noexcept;
+
         /**
    * Proceed the event queue.
    * i.e., first update the current event time to the next registered event
@@ -51,21 +92,430 @@ namespace NetworkAnalytical {
    */
         void proceed() noexcept;
 
+        /**
+   * Invoke all events whose event time is not later than end_time,
+   * including the ones newly scheduled during the execution.
+   * The current time stays at the last visited event time.
+   *
+   * @param end_time time horizon of the execution (inclusive)
+   * @return summary of the execution
+   */
+        RunSummary run_until(EventTime end_time) noexcept;
+
+        /**
+   * Invoke all events whose event time is not later than time, then move the current time to time.
+   * Unlike run_until(), the current time ends at the bound even if no event is due then,
+   * so that a co-simulator can interleave its own events: e.g., repeatedly advance to
+   * the earlier of its next event time and peek_next_event_time(), then schedule from there.
+   * No event later than the bound is invoked.
+   *
+   * @param time time bound to advance to (inclusive), not earlier than the current time
+   * @return summary of the execution
+   */
+        RunSummary advance_to(EventTime time) noexcept;
+
+        /**
+   * Invoke events until the event queue becomes empty.
+   *
+   * @return summary of the execution
+   */
+        RunSummary run_to_completion() noexcept;
+
         /**
    * Schedule an event with a given event time.
    *
    * @param event_time time of event
    * @param callback callback function pointer
    * @param callback_arg argument of the callback function
+   * @return handle of the event, to cancel or reschedule it
+   */
+        EventHandle schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+        /**
+   * Schedule a typed event with a given event time.
+   * The handler is bound at compile time, e.g.,
+   * schedule_event<Chunk, Chunk::chunk_arrived_next_device>(event_time, chunk),
+   * so no void* cast is needed by the caller nor by the handler.
+   *
+   * @tparam T payload type of the event
+   * @tparam Handler handler to be invoked with the payload
+   * @param event_time time of event
+   * @param payload payload of the event
+   * @return handle of the event, to cancel or reschedule it
+   */
+        template <typename T, TypedCallback<T> Handler>
+        EventHandle schedule_event(const EventTime event_time, T* const payload) noexcept {
+            return schedule_event(event_time, invoke_typed_event<T, Handler>, static_cast<CallbackArg>(payload));
+        }
+
+        /**
+   * Intercept the events scheduled from now on, e.g., to hold or wrap them. See ScheduleHook.
+   * An event taken over by the hook isn't scheduled, and its handle refers to no event.
+   * Relayed events can't be scheduled while a hook is set.
+   *
+   * @param hook hook intercepting the scheduled events, nullptr to schedule them as usual
+   * @param context context passed to the hook
+   */
+        void set_schedule_hook(ScheduleHook hook, void* context) noexcept;
+
+        /**
+   * Check if a scheduled event is still to be invoked.
+   *
+   * @param handle handle of the event
+   * @return true if the event is neither invoked nor cancelled yet, false otherwise
+   */
+        [[nodiscard]] bool is_pending(const EventHandle& handle) const noexcept;
+
+        /**
+   * Cancel a scheduled event in O(1), so that it's never invoked.
+   * Once every event of its time is cancelled, the EventList of the time is dropped as well
+   * (in O(1) on average with the Calendar backend, O(n) with the List backend).
+   *
+   * @param handle handle of the event
+   * @return true if the event is cancelled, false if it's already invoked or cancelled
+   */
+        bool cancel(const EventHandle& handle) noexcept;
+
+        /**
+   * Move a scheduled event to another time, i.e., cancel it and schedule its callback again.
+   * The moved event is invoked after the events already scheduled at the new time.
+   * A relayed event loses its relays, see cut_relays() to keep its order instead.
+   *
+   * @param handle handle of the event
+   * @param event_time new time of the event
+   * @return handle of the moved event, a handle referring to no event if the event isn't pending
+   */
+        EventHandle reschedule(const EventHandle& handle, EventTime event_time) noexcept;
+
+        /**
+   * Track the registration order of the events, so that relayed events can be scheduled.
+   * See schedule_relayed_event(). The events already pending keep their order.
+   * Shouldn't be called while the event queue is proceeding, unless relayed events are already enabled.
+   */
+        void enable_relayed_events() noexcept;
+
+        /**
+   * Check if relayed events can be scheduled, i.e., enable_relayed_events() has been called.
+   *
+   * @return true if relayed events are enabled, false otherwise
+   */
+        [[nodiscard]] bool relayed_events_enabled() const noexcept;
+
+        /**
+   * Schedule an event as if it were scheduled by a chain of relays:
+   * the first relay is scheduled now, each relay schedules the next one once it's invoked,
+   * and the last relay schedules the event.
+   * The relays have no callback and are never invoked: the event queue only keeps track of the point
+   * each relay would have been invoked at among the other events, so the event is invoked in the same order
+   * (among the events of its time) as if the relays were scheduled as events of their own.
+   *
+   * Relayed events should be enabled, and the event times not quantized.
+   *
+   * @param relay_times times of the relays, in order, not earlier than the current time
+   * @param event_time time of the event, not earlier than the last relay
+   * @param callback callback function pointer
+   * @param callback_arg argument of the callback function
+   * @return handle of the event, to cancel it or cut its relays
+   */
+        EventHandle schedule_relayed_event(const std::vector<EventTime>& relay_times,
+                                           EventTime event_time,
+                                           Callback callback,
+                                           CallbackArg callback_arg) noexcept;
+
+        /**
+   * Check if a relay of a pending relayed event has been passed,
+   * i.e., if it would have been invoked already, had it been an event of its own.
+   *
+   * @param handle handle of the relayed event
+   * @param relay index of the relay
+   * @return true if the relay has been passed, false otherwise
+   */
+        [[nodiscard]] bool relay_passed(const EventHandle& handle, size_t relay) const noexcept;
+
+        /**
+   * Cut the relays of a pending relayed event from a relay on, which isn't passed yet:
+   * the event is invoked at the time of the relay instead, as if the relay were the event itself.
+   *
+   * @param handle handle of the relayed event
+   * @param relay index of the first relay to cut
+   * @return handle of the moved event
    */
-        void schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+        EventHandle cut_relays(const EventHandle& handle, size_t relay) noexcept;
+
+        /**
+   * Visit every pending event, in the order they would be invoked.
+   * Shouldn't be called while the event queue is proceeding.
+   *
+   * @param visitor function invoked with the time, callback, and argument of each event
+   */
+        void for_each_event(const std::function<void(EventTime, Callback, CallbackArg)>& visitor) const noexcept;
+
+        /**
+   * Move the current time of an empty event queue forward, e.g., to resume a simulation from a snapshot.
+   *
+   * @param time new current time, not earlier than the current time
+   */
+        void set_current_time(EventTime time) noexcept;
+
+        /**
+   * Quantize the event times for approximate, faster simulations.
+   * Every event time is rounded up to a multiple of the quantum,
+   * so the events within a quantum are invoked together, as a single EventList.
+   *
+   * Each rounding delays an event by less than a quantum, and the delay propagates to the events it schedules.
+   * The event queue tracks the accumulated delay along every chain of events: see get_time_error_bound().
+   * Link modes relying on exact arrival times (express scheduling, cut-through) shouldn't be combined with it.
+   *
+   * @param time_quantum quantum of the event times, 0 or 1 to disable the quantization
+   */
+        void set_time_quantum(EventTime time_quantum) noexcept;
+
+        /**
+   * Get the quantum of the event times.
+   *
+   * @return quantum of the event times, 0 or 1 if not quantized
+   */
+        [[nodiscard]] EventTime get_time_quantum() const noexcept;
+
+        /**
+   * Get the bound of how late any invoked event has been, compared to its exact time,
+   * i.e., the largest rounding delay accumulated along a chain of events.
+   *
+   * @return time error bound, 0 if the event times are not quantized
+   */
+        [[nodiscard]] EventTime get_time_error_bound() const noexcept;
+
+        /**
+   * Pre-allocate EventLists, so that up to the given number of distinct event times
+   * can be pending without allocating memory.
+   *
+   * @param event_lists_count number of EventLists to pre-allocate
+   */
+        void reserve(size_t event_lists_count) noexcept;
+
+        /**
+   * Get the peak number of EventLists (i.e., distinct pending event times)
+   * simultaneously held by the event queue.
+   * This can be used to reserve() the pool of later runs.
+   *
+   * @return peak number of EventLists in use
+   */
+        [[nodiscard]] size_t get_peak_pool_usage() const noexcept;
 
     private:
         /// current time of the event queue
         EventTime current_time;
 
-        /// list of EventLists
-        std::list<EventList> event_queue;
+        /// scheduler backend in use
+        EventQueueBackend backend;
+
+        /// storage of EventLists used by both backends
+        EventListPool event_list_pool;
+
+        /// head of the intrusive sorted list of EventLists, used by EventQueueBackend::List
+        EventList* event_queue;
+
+        /// calendar queue of EventLists, used by EventQueueBackend::Calendar
+        CalendarQueue calendar_queue;
+
+        /// EventList being invoked by proceed(), nullptr otherwise
+        /// events scheduled at the current time while proceeding are appended here
+        EventList* current_event_list;
+
+        /// quantum the event times are rounded up to, 0 or 1 if not quantized
+        EventTime time_quantum;
+
+        /// time error bound of the last invoked EventList, inherited by the events it schedules
+        EventTime current_time_error;
+
+        /// largest time error bound of the invoked EventLists
+        EventTime time_error_bound;
+
+        /// relayed event id of the EventOrder of an ordinary event
+        static constexpr uint32_t no_relayed_event = std::numeric_limits<uint32_t>::max();
+
+        /**
+   * Relayed event and the relays scheduling it. See schedule_relayed_event().
+   */
+        struct RelayedEvent {
+            /// times of the relays, then of the event
+            std::vector<EventTime> times;
+
+            /// positions (see EventOrder) of the relays, then of the event, as far as they're resolved
+            /// the position of a relay is resolved once the relay before it is passed
+            std::vector<uint64_t> positions;
+
+            /// callback function pointer
+            Callback callback;
+
+            /// argument of the callback function
+            CallbackArg callback_arg;
+
+            /// EventList of the event time, nullptr if the event isn't pending
+            EventList* event_list;
+
+            /// generation of the entry, bumped whenever it's recycled, so that stale handles are told apart
+            uint32_t generation;
+        };
+
+        /**
+   * Point of an event, or of a relay, in the order of invocation among the events of its time.
+   *
+   * The position of an event is twice its sequence number,
+   * and a relay registered while the sequence number is n is positioned at 2n - 1,
+   * after the events registered before it and before the ones registered after it.
+   * Relays at the same position are registered in the order of the relays before them.
+   */
+        struct EventOrder {
+            /// id of the relayed event in the relay table, if it's a relay or a relayed event
+            uint32_t relayed_event;
+
+            /// index of the relay, or the number of relays if it's the relayed event itself
+            uint32_t relay;
+
+            /// position of the event or the relay
+            uint64_t position;
+        };
+
+        /**
+   * Relay whose passing is due, to resolve the position of the next relay (or of the relayed event).
+   */
+        struct RelayPass {
+            /// time of the relay
+            EventTime time;
+
+            /// relay to pass
+            EventOrder order;
+
+            /// generation of the relayed event when the relay was registered
+            uint32_t generation;
+        };
+
+        /// hook intercepting the scheduled events, nullptr if none
+        ScheduleHook schedule_hook;
+
+        /// context passed to the schedule hook
+        void* schedule_hook_context;
+
+        /// true if the registration order of the events is tracked, for the relayed events
+        bool relays_enabled;
+
+        /// number of events registered so far, if relayed events are enabled
+        uint64_t next_sequence;
+
+        /// relayed events, indexed by their ids
+        std::vector<RelayedEvent> relayed_events;
+
+        /// ids of the free entries of relayed_events
+        std::vector<uint32_t> free_relayed_events;
+
+        /// heap of the relays to pass, earliest first
+        std::vector<RelayPass> relay_passes;
+
+        /// heap of the relayed events resolved at the time of current_event_list, earliest first
+        std::vector<RelayPass> current_relayed_events;
+
+        /**
+   * Find the EventList of an event time, or insert a new one.
+   *
+   * @param event_time time of the EventList
+   * @return EventList of the given time
+   */
+        [[nodiscard]] EventList* find_or_insert_event_list(EventTime event_time) noexcept;
+
+        /**
+   * Take out the earliest EventList and invoke its events.
+   * The event queue must not be empty.
+   *
+   * @return number of invoked events
+   */
+        size_t proceed_event_list() noexcept;
+
+        /**
+   * Take a pending EventList out of the scheduler and return it to the pool, without invoking its events.
+   *
+   * @param event_list EventList to drop
+   */
+        void drop_event_list(EventList* event_list) noexcept;
+
+        /**
+   * Invoke the events of an EventList interleaved with its relayed events, and pass the relays of its time.
+   *
+   * @param event_list EventList to invoke
+   * @return number of invoked events
+   */
+        size_t invoke_relayed_event_list(EventList* event_list) noexcept;
+
+        /**
+   * Pass the relays due until a time, as if they were invoked in order.
+   *
+   * @param time time to pass the relays until
+   * @param inclusive true to pass the relays at the time as well, false to pass the earlier ones only
+   */
+        void pass_relays(EventTime time, bool inclusive) noexcept;
+
+        /**
+   * Pass a relay: resolve the position of the next relay (or of the relayed event) to the current point.
+   *
+   * @param relay_pass relay to pass
+   */
+        void pass_relay(const RelayPass& relay_pass) noexcept;
+
+        /**
+   * Check if a relay pass refers to a relay whose passing is still due.
+   *
+   * @param relay_pass relay pass to check
+   * @return true if the relay is still to pass, false if the pass is stale
+   */
+        [[nodiscard]] bool relay_pass_due(const RelayPass& relay_pass) const noexcept;
+
+        /**
+   * Compare two points in the order of invocation of the same time.
+   *
+   * @param lhs first point
+   * @param rhs second point
+   * @return true if lhs is invoked (or passed) before rhs, false otherwise
+   */
+        [[nodiscard]] bool precedes(EventOrder lhs, EventOrder rhs) const noexcept;
+
+        /**
+   * Compare two relay passes, earliest first, to keep them in a heap.
+   *
+   * @param lhs first relay pass
+   * @param rhs second relay pass
+   * @return true if lhs is due after rhs, false otherwise
+   */
+        [[nodiscard]] bool later_relay_pass(const RelayPass& lhs, const RelayPass& rhs) const noexcept;
+
+        /**
+   * Get the order of a pending relayed event, whose position is resolved.
+   *
+   * @param id id of the relayed event
+   * @return order of the relayed event
+   */
+        [[nodiscard]] EventOrder relayed_event_order(uint32_t id) const noexcept;
+
+        /**
+   * Take a relayed event out of its EventList, dropping the list if nothing is left to invoke.
+   *
+   * @param id id of the relayed event
+   */
+        void unlink_relayed_event(uint32_t id) noexcept;
+
+        /**
+   * Register a relayed event to the EventList of its (last) time.
+   *
+   * @param id id of the relayed event
+   * @return handle of the event
+   */
+        EventHandle link_relayed_event(uint32_t id) noexcept;
+
+        /**
+   * Recycle the entry of a relayed event that's no longer pending.
+   *
+   * @param id id of the relayed event
+   */
+        void release_relayed_event(uint32_t id) noexcept;
     };
 
 }  // namespace NetworkAnalytical
@@ -0,0 +1,47 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NetworkAnalytical {
+
+    /// offset basis of the 64-bit FNV-1a hash, i.e., the hash of no byte
+    constexpr uint64_t fnv1a_offset_basis = 14'695'981'039'346'656'037ULL;
+
+    /// prime of the 64-bit FNV-1a hash
+    constexpr uint64_t fnv1a_prime = 1'099'511'628'211ULL;
+
+    /**
+ * Fold bytes into a 64-bit FNV-1a hash, starting from fnv1a_offset_basis.
+ * The hashes key on-disk caches (e.g., CompiledTopology, CollectiveCache), so they should never change.
+ *
+ * @param hash hash to update
+ * @param bytes bytes to hash
+ * @param size number of bytes
+ */
+    inline void hash_bytes(uint64_t& hash, const void* const bytes, const size_t size) noexcept {
+        const auto* const data = static_cast<const unsigned char*>(bytes);
+        for (auto i = size_t(0); i < size; i++) {
+            hash ^= data[i];
+            hash *= fnv1a_prime;
+        }
+    }
+
+    /**
+ * Fold the bytes of a value into a 64-bit FNV-1a hash. See hash_bytes().
+ *
+ * @tparam T type of the value
+ * @param hash hash to update
+ * @param value value to hash
+ */
+    template <typename T>
+    void hash_value(uint64_t& hash, const T& value) noexcept {
+        hash_bytes(hash, &value, sizeof(T));
+    }
+
+}  // namespace NetworkAnalytical
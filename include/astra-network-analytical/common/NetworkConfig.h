@@ -0,0 +1,260 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /**
+ * NetworkConfig describes the shape of a network, dimension by dimension:
+ * the topology building block, the number of NPUs, the link bandwidth, and the link latency of each dimension.
+ *
+ * A config can be built programmatically, e.g.,
+ *   NetworkConfig().add_dimension(TopologyBuildingBlock::Ring, 8, 50, 500)
+ *                  .add_dimension(TopologyBuildingBlock::Switch, 4, 25, 1'000);
+ * or parsed from a YAML file or a YAML string in the format of the network configuration file.
+ * FatTree dimensions are further shaped by the optional "radix" and "oversubscription" lists of the YAML,
+ * and Torus and Mesh dimensions by the optional "shape" list of the sides of each dimension, e.g., [ [ 4, 4 ] ].
+ * The optional "fidelity" list marks each dimension "aware" (default) or "unaware",
+ * for the congestion-aware backend to simulate the unaware dimensions in closed form.
+ *
+ * Nothing here exits the process: parse errors and invalid values are returned as error messages,
+ * so a single process can build and evaluate many configs.
+ */
+    class NetworkConfig {
+    public:
+        /**
+   * Constructor of an empty config, with no dimension.
+   */
+        NetworkConfig() noexcept;
+
+        /**
+   * Parse a config from a YAML string.
+   *
+   * @param yaml network configuration in YAML format
+   * @param error set to the error message if parsing fails
+   * @return parsed and validated config, std::nullopt if parsing fails or the config is invalid
+   */
+        [[nodiscard]] static std::optional<NetworkConfig> parse_yaml(const std::string& yaml,
+                                                                     std::string& error) noexcept;
+
+        /**
+   * Parse a config from a YAML file.
+   *
+   * @param path path of the yml file
+   * @param error set to the error message if loading or parsing fails
+   * @return parsed and validated config, std::nullopt if loading or parsing fails or the config is invalid
+   */
+        [[nodiscard]] static std::optional<NetworkConfig> load_yaml_file(const std::string& path,
+                                                                         std::string& error) noexcept;
+
+        /**
+   * Parse topology name (in string) into TopologyBuildingBlock enum
+   *
+   * @param topology_name topology name in string
+   *    which can be "Ring", "FullyConnected", "Switch", "FatTree", "Torus", or "Mesh"
+   * @return parsed TopologyBuildingBlock enum class value, TopologyBuildingBlock::Undefined if not supported
+   */
+        [[nodiscard]] static TopologyBuildingBlock parse_topology_name(const std::string& topology_name) noexcept;
+
+        /**
+   * Append a dimension, as the outermost one.
+   *
+   * @param topology topology building block of the dimension
+   * @param npus_count number of NPUs of the dimension
+   * @param bandwidth link bandwidth of the dimension (GB/s)
+   * @param latency link latency of the dimension (ns)
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& add_dimension(TopologyBuildingBlock topology,
+                                     int npus_count,
+                                     Bandwidth bandwidth,
+                                     Latency latency) noexcept;
+
+        /**
+   * Set the number of NPUs of a dimension.
+   *
+   * @param dim dimension
+   * @param npus_count number of NPUs of the dimension
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_npus_count(int dim, int npus_count) noexcept;
+
+        /**
+   * Set the link bandwidth of a dimension.
+   *
+   * @param dim dimension
+   * @param bandwidth link bandwidth of the dimension (GB/s)
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_bandwidth(int dim, Bandwidth bandwidth) noexcept;
+
+        /**
+   * Set the link latency of a dimension.
+   *
+   * @param dim dimension
+   * @param latency link latency of the dimension (ns)
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_latency(int dim, Latency latency) noexcept;
+
+        /**
+   * Set the shape of a FatTree dimension.
+   * The NPUs count of the dimension should be a power of the radix.
+   *
+   * @param dim dimension
+   * @param radix number of down ports of each switch
+   * @param oversubscription ratio of the down ports to the up ports of each leaf switch, which should divide radix
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_fat_tree(int dim, int radix, int oversubscription = 1) noexcept;
+
+        /**
+   * Set the sides of a Torus or Mesh dimension, e.g., {4, 4} for a 4x4 torus.
+   * The product of the sides should be the NPUs count of the dimension.
+   * If not set, the dimension is one-dimensional.
+   *
+   * @param dim dimension
+   * @param shape number of NPUs along each side
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_shape(int dim, const std::vector<int>& shape) noexcept;
+
+        /**
+   * Set the fidelity the congestion-aware backend simulates a dimension at.
+   * Defaults to DimensionFidelity::CongestionAware.
+   *
+   * @param dim dimension
+   * @param fidelity fidelity of the dimension
+   * @return the config itself, to chain the calls
+   */
+        NetworkConfig& set_fidelity(int dim, DimensionFidelity fidelity) noexcept;
+
+        /**
+   * Check the validity of the config.
+   *
+   * @return error message describing the first invalid value, empty if the config is valid
+   */
+        [[nodiscard]] std::string validate() const noexcept;
+
+        /**
+   * Check the validity of the config for a backend, which may support only some of the building blocks
+   * and a limited number of dimensions.
+   *
+   * @param supported_topologies building blocks supported by the backend
+   * @param max_dims_count largest number of dimensions supported by the backend, 0 if unlimited
+   * @return error message describing the first invalid or unsupported value, empty if the config is valid
+   */
+        [[nodiscard]] std::string validate(const std::vector<TopologyBuildingBlock>& supported_topologies,
+                                           int max_dims_count = 0) const noexcept;
+
+        /**
+   * Compute a canonical hash of the config (FNV-1a over its parsed values),
+   * so that configs describing the same network hash the same regardless of how they're written.
+   *
+   * @return hash of the config
+   */
+        [[nodiscard]] uint64_t hash() const noexcept;
+
+        /**
+   * Get the number of network dimensions.
+   *
+   * @return number of network dimensions
+   */
+        [[nodiscard]] int get_dims_count() const noexcept;
+
+        /**
+   * Get the number of NPUs of each dimension.
+   *
+   * @return number of NPUs per each dimension
+   */
+        [[nodiscard]] const std::vector<int>& get_npus_counts_per_dim() const noexcept;
+
+        /**
+   * Get the link bandwidth of each dimension.
+   *
+   * @return bandwidth per each dimension
+   */
+        [[nodiscard]] const std::vector<Bandwidth>& get_bandwidths_per_dim() const noexcept;
+
+        /**
+   * Get the link latency of each dimension.
+   *
+   * @return link latency per each dimension
+   */
+        [[nodiscard]] const std::vector<Latency>& get_latencies_per_dim() const noexcept;
+
+        /**
+   * Get the topology building block of each dimension.
+   *
+   * @return topology building block per each dimension
+   */
+        [[nodiscard]] const std::vector<TopologyBuildingBlock>& get_topologies_per_dim() const noexcept;
+
+        /**
+   * Get the switch radix of each dimension, 0 if not set.
+   * Only FatTree dimensions use it.
+   *
+   * @return radix per each dimension
+   */
+        [[nodiscard]] const std::vector<int>& get_radixes_per_dim() const noexcept;
+
+        /**
+   * Get the leaf switch oversubscription of each dimension, 1 if not set.
+   * Only FatTree dimensions use it.
+   *
+   * @return oversubscription per each dimension
+   */
+        [[nodiscard]] const std::vector<int>& get_oversubscriptions_per_dim() const noexcept;
+
+        /**
+   * Get the sides of each dimension, empty if not set.
+   * Only Torus and Mesh dimensions use them.
+   *
+   * @return shape per each dimension
+   */
+        [[nodiscard]] const std::vector<std::vector<int>>& get_shapes_per_dim() const noexcept;
+
+        /**
+   * Get the fidelity of each dimension.
+   * Only the congestion-aware backend uses them.
+   *
+   * @return fidelity per each dimension
+   */
+        [[nodiscard]] const std::vector<DimensionFidelity>& get_fidelities_per_dim() const noexcept;
+
+    private:
+        /// NPUs count per each dimension
+        std::vector<int> npus_count_per_dim;
+
+        /// bandwidth per each dimension
+        std::vector<Bandwidth> bandwidth_per_dim;
+
+        /// latency per each dimension
+        std::vector<Latency> latency_per_dim;
+
+        /// topology building block per each dimension
+        std::vector<TopologyBuildingBlock> topology_per_dim;
+
+        /// switch radix per each dimension (FatTree)
+        std::vector<int> radix_per_dim;
+
+        /// leaf switch oversubscription per each dimension (FatTree)
+        std::vector<int> oversubscription_per_dim;
+
+        /// sides per each dimension (Torus and Mesh)
+        std::vector<std::vector<int>> shape_per_dim;
+
+        /// simulation fidelity per each dimension (congestion-aware backend)
+        std::vector<DimensionFidelity> fidelity_per_dim;
+    };
+
+}  // namespace NetworkAnalytical
@@ -19,4 +19,52 @@ namespace NetworkAnalytical {
  */
     Bandwidth bw_GBps_to_Bpns(Bandwidth bw_GBps) noexcept;
 
+    /// number of fraction bits of ReciprocalBandwidth
+    constexpr int reciprocal_bandwidth_fraction_bits = 32;
+
+    /// number of ps in a ns
+    constexpr PicoTime ps_per_ns = 1'000;
+
+    /**
+ * Convert bandwidth from B/ns to its reciprocal in ps/B, in fixed point.
+ * The reciprocal is rounded to the nearest, so that the serialization delay of a chunk of 2^32 B
+ * is off by at most 0.5 ps.
+ *
+ * @param bw_Bpns bandwidth in B/ns
+ * @return reciprocal bandwidth in ps/B
+ */
+    ReciprocalBandwidth bw_Bpns_to_reciprocal(Bandwidth bw_Bpns) noexcept;
+
+    /**
+ * Convert latency from ns to ps, rounded to the nearest.
+ *
+ * @param latency latency in ns
+ * @return latency in ps
+ */
+    PicoTime latency_ns_to_ps(Latency latency) noexcept;
+
+    /**
+ * Compute the serialization delay of a chunk in ps: an integer multiply-shift.
+ *
+ * @param chunk_size size of the chunk
+ * @param reciprocal_bandwidth reciprocal bandwidth of the link in ps/B
+ * @return serialization delay in ps
+ */
+    inline PicoTime serialization_delay_ps(const ChunkSize chunk_size,
+                                           const ReciprocalBandwidth reciprocal_bandwidth) noexcept {
+        // chunk sizes beyond 2^32 B overflow 64 bits before the shift
+        const auto delay = static_cast<unsigned __int128>(chunk_size) * reciprocal_bandwidth;
+        return static_cast<PicoTime>(delay >> reciprocal_bandwidth_fraction_bits);
+    }
+
+    /**
+ * Convert time from ps to EventTime (ns), truncated as the delays in ns are.
+ *
+ * @param time time in ps
+ * @return time in ns
+ */
+    inline EventTime ps_to_event_time(const PicoTime time) noexcept {
+        return time / ps_per_ns;
+    }
+
 }  // namespace NetworkAnalytical
@@ -5,14 +5,17 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/NetworkConfig.h"
 #include "common/Type.h"
-#include <iostream>
-#include <yaml-cpp/yaml.h>
+#include <string>
+#include <vector>
 
 namespace NetworkAnalytical {
 
     /**
  * NetworkParser parses the network configuration file in YAML format.
+ * The process exits if the file can't be parsed:
+ * use NetworkConfig directly to get the error returned instead.
  */
     class NetworkParser {
     public:
@@ -60,75 +63,16 @@ namespace NetworkAnalytical {
    */
         [[nodiscard]] std::vector<TopologyBuildingBlock> get_topologies_per_dim() const noexcept;
 
-    private:
-        /// number of network dimensions
-        int dims_count;
-
-        /// NPUs count per each dimension
-        std::vector<int> npus_count_per_dim;
-
-        /// bandwidth per each dimension
-        std::vector<Bandwidth> bandwidth_per_dim;
-
-        /// latency per each dimension
-        std::vector<Latency> latency_per_dim;
-
-        /// topology building block per each dimension
-        std::vector<TopologyBuildingBlock> topology_per_dim;
-
-        /**
-   * Parse topology name (in string) into TopologyBuildingBlock enum
-   *
-   * @param topology_name topology name in string
-   *    which can be "Ring", "FullyConnected", or "Switch"
-   * @return parsed TopologyBuildingBlock enum class value
-   */
-        [[nodiscard]] static TopologyBuildingBlock parse_topology_name(const std::string& topology_name) noexcept;
-
         /**
-   * Parse the given YAML node and retrieve network configuration values
+   * Get the parsed network configuration.
    *
-   * @param network_config opened and parsed YAML node
+   * @return parsed network configuration
    */
-        void parse_network_config_yml(const YAML::Node& network_config) noexcept;
+        [[nodiscard]] const NetworkConfig& get_network_config() const noexcept;
 
-        /**
-   * Check the validity and correctness of the parsed network input
-   * configurations.
-   */
-        void check_validity() const noexcept;
-
-        /**
-   * Given a yaml node whose type is list of type T,
-   * Read the value from the node and create a std::vector<T>.
-   *
-   * @tparam T type of the element to be read
-   * @param node YAML node (in list type) to read
-   * @return std::vector<T> of read elements
-   */
-        template<typename T>
-        std::vector<T> parse_vector(const YAML::Node& node) const noexcept {
-            // create empty vector to store parsed values
-            auto parsed_vector = std::vector<T>();
-
-            // try to read each element
-            for (const auto& element : node) {
-                try {
-                    // read an element in type T
-                    const auto element_value = element.as<T>();
-
-                    // store the read element
-                    parsed_vector.push_back(element_value);
-                } catch (const YAML::BadConversion& e) {
-                    // error reading an element from the yaml file as type T
-                    std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
-                    std::exit(-1);
-                }
-            }
-
-            // return parsed vector
-            return parsed_vector;
-        }
+    private:
+        /// parsed network configuration
+        NetworkConfig network_config;
     };
 
 }  // namespace NetworkAnalytical
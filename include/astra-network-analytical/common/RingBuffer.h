@@ -0,0 +1,140 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /**
+ * RingBuffer is a FIFO queue stored in a circular array.
+ *
+ * The capacity is always a power of 2, and doubles when the buffer is full.
+ * Once grown, enqueueing and dequeueing never allocate memory.
+ *
+ * @tparam T type of the elements, which should be default-constructible and movable
+ */
+    template <typename T>
+    class RingBuffer {
+    public:
+        /**
+   * Constructor.
+   */
+        RingBuffer() noexcept : head(0), elements_count(0) {}
+
+        /**
+   * Check if the buffer is empty.
+   *
+   * @return true if the buffer is empty, false otherwise
+   */
+        [[nodiscard]] bool empty() const noexcept {
+            return elements_count == 0;
+        }
+
+        /**
+   * Get the number of elements in the buffer.
+   *
+   * @return number of elements
+   */
+        [[nodiscard]] size_t size() const noexcept {
+            return elements_count;
+        }
+
+        /**
+   * Get the number of elements the buffer can hold without growing.
+   *
+   * @return capacity of the buffer
+   */
+        [[nodiscard]] size_t capacity() const noexcept {
+            return elements.size();
+        }
+
+        /**
+   * Get the first element of the buffer.
+   * The buffer must not be empty.
+   *
+   * @return first element
+   */
+        [[nodiscard]] T& front() noexcept {
+            assert(!empty());
+
+            return elements[head];
+        }
+
+        /**
+   * Get an element of the buffer.
+   *
+   * @param index index of the element, from the front
+   * @return element at the index
+   */
+        [[nodiscard]] const T& at(const size_t index) const noexcept {
+            assert(index < elements_count);
+
+            return elements[(head + index) & (elements.size() - 1)];
+        }
+
+        /**
+   * Append an element at the end of the buffer.
+   *
+   * @param element element to append
+   */
+        void push_back(T element) noexcept {
+            if (elements_count == elements.size()) {
+                grow();
+            }
+
+            elements[(head + elements_count) & (elements.size() - 1)] = std::move(element);
+            elements_count++;
+        }
+
+        /**
+   * Remove and return the first element of the buffer.
+   * The buffer must not be empty.
+   *
+   * @return first element
+   */
+        T pop_front() noexcept {
+            assert(!empty());
+
+            auto element = std::move(elements[head]);
+            head = (head + 1) & (elements.size() - 1);
+            elements_count--;
+
+            return element;
+        }
+
+    private:
+        /// initial capacity of the buffer
+        static constexpr size_t initial_capacity = 4;
+
+        /// circular array of elements
+        std::vector<T> elements;
+
+        /// index of the first element
+        size_t head;
+
+        /// number of elements
+        size_t elements_count;
+
+        /**
+   * Double the capacity, moving the elements to the front of the new array.
+   */
+        void grow() noexcept {
+            const auto new_capacity = elements.empty() ? initial_capacity : 2 * elements.size();
+            auto new_elements = std::vector<T>(new_capacity);
+            for (size_t i = 0; i < elements_count; i++) {
+                new_elements[i] = std::move(elements[(head + i) & (elements.size() - 1)]);
+            }
+
+            elements = std::move(new_elements);
+            head = 0;
+        }
+    };
+
+}  // namespace NetworkAnalytical
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace NetworkAnalytical {
@@ -15,6 +16,14 @@ namespace NetworkAnalytical {
     /// Callback function argument: void*
     using CallbackArg = void*;
 
+    /// Batched callback function pointer: "void func(void* const* args, size_t count)"
+    /// invoked once with the arguments of multiple callbacks
+    using BatchCallback = void (*)(const CallbackArg* callback_args, size_t count);
+
+    /// Type-safe callback function pointer: "void func(T*) noexcept"
+    template <typename T>
+    using TypedCallback = void (*)(T*) noexcept;
+
     /// Device ID which starts from 0
     using DeviceId = int;
 
@@ -30,7 +39,37 @@ namespace NetworkAnalytical {
     /// Event time in ns
     using EventTime = uint64_t;
 
+    /// Hook intercepting the events scheduled on an event queue:
+    /// "bool func(void* context, EventTime event_time, Callback& callback, CallbackArg& callback_arg)"
+    /// it may replace the callback and its argument, and returns true to take the event over instead of scheduling it
+    using ScheduleHook = bool (*)(void* context, EventTime event_time, Callback& callback, CallbackArg& callback_arg);
+
+    /// Time in ps, the fixed-point time base of the delay math
+    using PicoTime = uint64_t;
+
+    /// Reciprocal bandwidth in ps/B, in fixed point of reciprocal_bandwidth_fraction_bits fraction bits
+    using ReciprocalBandwidth = uint64_t;
+
     /// Basic multi-dimensional topology building blocks
-    enum class TopologyBuildingBlock { Undefined, Ring, FullyConnected, Switch };
+    enum class TopologyBuildingBlock { Undefined, Ring, FullyConnected, Switch, FatTree, Torus, Mesh };
+
+    /// Fidelity a network dimension is simulated at by the congestion-aware backend
+    ///   - CongestionAware: chunks are queued at every link of the dimension
+    ///   - CongestionUnaware: chunks cross the dimension in a single closed-form delay, without contention
+    enum class DimensionFidelity { CongestionAware, CongestionUnaware };
+
+    /// Collective communication patterns
+    enum class CollectiveType { AllGather, ReduceScatter, AllReduce, AllToAll };
+
+    /// Collective algorithms
+    ///   - Ring: N-1 steps, each NPU sends a shard to its ring neighbor per step
+    ///   - Direct: a single step, each NPU sends a shard to every other NPU at once
+    ///   - HalvingDoubling: log2(N) steps, each NPU exchanges with the NPU whose id differs by a single bit
+    enum class CollectiveAlgorithm { Ring, Direct, HalvingDoubling };
+
+    /// Scheduler backends of the EventQueue
+    ///   - List: sorted linked list of EventLists, O(pending timestamps) insertion
+    ///   - Calendar: calendar queue, amortized O(1) insertion and pop-min
+    enum class EventQueueBackend { List, Calendar };
 
 }  // namespace NetworkAnalytical
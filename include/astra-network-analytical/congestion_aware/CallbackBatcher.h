@@ -0,0 +1,115 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * CallbackBatcher groups the destination callbacks of chunks arriving at the same event time.
+ *
+ * A callback is registered together with its batched counterpart.
+ * When a chunk with a registered callback arrives at its destination, its callback argument is deferred,
+ * and a single flush event is scheduled at the current event time.
+ * The flush runs after every arrival already scheduled at that time,
+ * then invokes each batched callback once with the arguments of its deferred chunks, in arrival order.
+ * Chunks with any other callback are delivered one by one, as usual.
+ *
+ * The batcher schedules on a single event queue, so it's not meant for ParallelSimulator partitions.
+ */
+    class CallbackBatcher {
+    public:
+        /**
+   * Constructor.
+   */
+        CallbackBatcher() noexcept;
+
+        /**
+   * Set the event queue the flush events are scheduled on.
+   *
+   * @param event_queue event queue of the topology
+   */
+        void set_event_queue(EventQueue* event_queue) noexcept;
+
+        /**
+   * Batch the arrivals of the chunks with a callback.
+   * Registering a callback again replaces its batched callback.
+   *
+   * @param callback callback of the chunks to batch
+   * @param batch_callback callback invoked with the arguments of the chunks arrived at the same time
+   */
+        void register_callback(Callback callback, BatchCallback batch_callback) noexcept;
+
+        /**
+   * Defer the callback of an arrived chunk to the flush of the current event time.
+   *
+   * @param callback callback of the chunk
+   * @param callback_arg argument of the callback
+   * @return true if deferred, false if the callback isn't registered (the caller should invoke it)
+   */
+        [[nodiscard]] bool defer(Callback callback, CallbackArg callback_arg) noexcept;
+
+        /**
+   * Get the number of batched callbacks invoked so far.
+   *
+   * @return number of batches
+   */
+        [[nodiscard]] uint64_t get_batches_count() const noexcept;
+
+        /**
+   * Get the number of callbacks delivered in batches so far.
+   *
+   * @return number of deferred callbacks
+   */
+        [[nodiscard]] uint64_t get_deferred_count() const noexcept;
+
+    private:
+        /// batch of a registered callback
+        struct Batch {
+            /// callback of the chunks
+            Callback callback;
+
+            /// batched counterpart of the callback
+            BatchCallback batch_callback;
+
+            /// arguments deferred at the current event time
+            std::vector<CallbackArg> callback_args;
+        };
+
+        /**
+   * Invoke every batch deferred at the current event time.
+   *
+   * @param batcher batcher to flush
+   */
+        static void flush(CallbackBatcher* batcher) noexcept;
+
+        /// event queue the flush events are scheduled on
+        EventQueue* event_queue;
+
+        /// batch per registered callback, only a few are expected
+        std::vector<Batch> batches;
+
+        /// arguments being delivered by the flush, reused across flushes
+        std::vector<CallbackArg> flushed_args;
+
+        /// true if a flush is scheduled at the current event time
+        bool flush_scheduled;
+
+        /// number of batched callbacks invoked
+        uint64_t batches_count;
+
+        /// number of callbacks delivered in batches
+        uint64_t deferred_count;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
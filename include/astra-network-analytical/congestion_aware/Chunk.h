@@ -5,9 +5,14 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/EventQueue.h"
 #include "common/Type.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/Route.h"
 #include "congestion_aware/Type.h"
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -24,9 +29,35 @@ namespace NetworkAnalyticalCongestionAware {
    *   - if the chunk arrived at its destination, the final callback is invoked
    *   - if not, the chunk is sent to the next device as designated by the route
    *
+   * The event queue holds the ownership of the chunk while it's in flight.
+   * A chunk sent in express mode passes through its express hops. See Link::set_express().
+   *
    * @param chunk_ptr: pointer to the chunk that's arrived at the next device
    */
-        static void chunk_arrived_next_device(void* chunk_ptr) noexcept;
+        static void chunk_arrived_next_device(Chunk* chunk_ptr) noexcept;
+
+        /**
+   * Callback to be invoked when a packet of a chunk arrives at the destination. See split_into_packets().
+   * The chunk arrives at its destination with its last packet.
+   *
+   * @param chunk_ptr: pointer to the chunk the packet is of
+   */
+        static void packet_arrived(void* chunk_ptr) noexcept;
+
+        /**
+   * Split a chunk into packets along the rest of its route, the last of which may be smaller.
+   * The packets are transmitted as chunks of their own, so they're pipelined over the links hop by hop.
+   * The chunk is held meanwhile, and arrives at its destination with its last packet.
+   * The packets share the route of the chunk, and are allocated from the given pool.
+   *
+   * @param chunk: chunk to split
+   * @param packet_size: size of each packet
+   * @param pool: pool to allocate the packets from
+   * @return packets of the chunk, in order
+   */
+        [[nodiscard]] static std::vector<std::unique_ptr<Chunk>> split_into_packets(std::unique_ptr<Chunk> chunk,
+                                                                                   ChunkSize packet_size,
+                                                                                   ChunkPool& pool) noexcept;
 
         /**
    * Constructor.
@@ -38,19 +69,65 @@ namespace NetworkAnalyticalCongestionAware {
    */
         Chunk(ChunkSize chunk_size, Route route, Callback callback, CallbackArg callback_arg) noexcept;
 
+        /**
+   * Allocate a Chunk outside of any pool (e.g., by std::make_unique).
+   *
+   * @param size size of the Chunk object
+   * @return storage for the Chunk
+   */
+        static void* operator new(size_t size);
+
+        /**
+   * Allocate a Chunk from a ChunkPool.
+   *
+   * @param size size of the Chunk object
+   * @param pool pool to allocate the Chunk from
+   * @return storage for the Chunk
+   */
+        static void* operator new(size_t size, ChunkPool& pool);
+
+        /**
+   * Free a Chunk, returning it to its pool if it has one.
+   *
+   * @param storage storage of the Chunk
+   */
+        static void operator delete(void* storage) noexcept;
+
+        /**
+   * Free a pooled Chunk whose construction failed.
+   *
+   * @param storage storage of the Chunk
+   * @param pool pool the Chunk was allocated from
+   */
+        static void operator delete(void* storage, ChunkPool& pool) noexcept;
+
         /**
    * Get the current sitting device of the chunk
    *
    * @return current device of the chunk
    */
-        [[nodiscard]] std::shared_ptr<Device> current_device() const noexcept;
+        [[nodiscard]] Device* current_device() const noexcept;
 
         /**
    * Get the next destined device of the chunk
    *
    * @return next device of the chunk
    */
-        [[nodiscard]] std::shared_ptr<Device> next_device() const noexcept;
+        [[nodiscard]] Device* next_device() const noexcept;
+
+        /**
+   * Get the link to the next destined device of the chunk
+   *
+   * @return link to the next device of the chunk
+   */
+        [[nodiscard]] Link* next_link() const noexcept;
+
+        /**
+   * Get the remaining route of the chunk, starting from its current device
+   *
+   * @return remaining route of the chunk
+   */
+        [[nodiscard]] const Route& get_route() const noexcept;
 
         /**
    * Mark the chunk arrived at its next device
@@ -58,6 +135,55 @@ namespace NetworkAnalyticalCongestionAware {
    */
         void mark_arrived_next_device() noexcept;
 
+        /**
+   * Schedule the arrival of the chunk at its next device.
+   * The event queue takes the ownership of the chunk.
+   *
+   * @param event_queue event queue to schedule the arrival on
+   * @param arrival_time time the chunk arrives at its next device
+   */
+        void schedule_arrival(EventQueue* event_queue, EventTime arrival_time) noexcept;
+
+        /**
+   * Schedule the arrival of the chunk after its express hops, i.e., the links after the next one
+   * that are already reserved for the chunk. The event queue takes the ownership of the chunk.
+   * The arrival keeps its order among the events of its time, as if it were scheduled hop by hop.
+   *
+   * @param event_queue event queue to schedule the arrival on, with relayed events enabled
+   * @param hop_arrival_times times the chunk arrives at the devices before the express hops, in order
+   * @param arrival_time time the chunk arrives after the last express hop
+   */
+        void schedule_express_arrival(EventQueue* event_queue,
+                                      const std::vector<EventTime>& hop_arrival_times,
+                                      EventTime arrival_time) noexcept;
+
+        /**
+   * Get the number of hops the chunk takes in express mode after its next device,
+   * i.e., the links after the next one that are already reserved for the chunk.
+   *
+   * @return number of express hops
+   */
+        [[nodiscard]] size_t get_express_hops() const noexcept;
+
+        /**
+   * Check if the chunk would have arrived at the src device of an express hop by now, had it been sent hop by hop.
+   *
+   * @param event_queue event queue the arrival is scheduled on
+   * @param hop index of the express hop, from 1 to get_express_hops()
+   * @return true if the chunk passed the src device of the hop, false otherwise
+   */
+        [[nodiscard]] bool passed_express_hop(const EventQueue* event_queue, size_t hop) const noexcept;
+
+        /**
+   * Cut the express hops of the chunk from a hop on, as its express transmission has been rolled back.
+   * The chunk arrives at the src device of the hop instead, in the order it would have hop by hop.
+   *
+   * @param event_queue event queue the arrival is scheduled on
+   * @param hop index of the first express hop to cut, from 1 to get_express_hops(), not passed yet
+   * @param arrival_time time the chunk arrives at the src device of the hop
+   */
+        void cut_express_hops(EventQueue* event_queue, size_t hop, EventTime arrival_time) noexcept;
+
         /**
    * Check if the chunk arrived at its destination
    * i.e., if the route length is 1 (only destination device left)
@@ -80,6 +206,12 @@ namespace NetworkAnalyticalCongestionAware {
         void invoke_callback() noexcept;
 
     private:
+        /// snapshots capture and restore the state of chunks
+        friend class Snapshot;
+
+        /// distributed simulations hand chunks over to other processes
+        friend class DistributedSimulator;
+
         /// size of the chunk
         ChunkSize chunk_size;
 
@@ -94,6 +226,18 @@ namespace NetworkAnalyticalCongestionAware {
 
         /// argument of the callback
         CallbackArg callback_arg;
+
+        /// time of the scheduled arrival at the next device
+        EventTime arrival_time;
+
+        /// handle of the scheduled arrival at the next device
+        EventHandle arrival_event;
+
+        /// number of links after the next one reserved in express mode
+        size_t express_hops;
+
+        /// number of packets in flight, if the chunk is split into packets, 0 otherwise
+        size_t packets_count;
     };
 
 }  // namespace NetworkAnalyticalCongestionAware
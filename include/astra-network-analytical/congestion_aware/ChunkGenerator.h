@@ -0,0 +1,190 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /// chunk produced by a ChunkGenerator
+    struct GeneratedChunk {
+        /// dest NPU id, different from the src NPU
+        DeviceId dest;
+
+        /// size of the chunk
+        ChunkSize chunk_size;
+
+        /// tag of the chunk, handed back when the chunk arrives
+        uint64_t tag;
+    };
+
+    /**
+ * ChunkGenerator is a pull-based source of chunks, which produces the traffic of each NPU on demand
+ * instead of injecting every chunk up front.
+ *
+ * Each NPU keeps at most a window of generated chunks in flight.
+ * The generator is pulled for the next chunk of an NPU whenever one of its chunks arrives at the destination,
+ * so only O(NPUs count * window) chunks ever exist, and the pending queues of the links stay as short.
+ * A generator may also report that an NPU has no chunk ready (e.g., until a dependency completes),
+ * and wake() the NPU once it has, e.g., from chunk_arrived() of another NPU's chunk.
+ *
+ * The generator should outlive the simulation.
+ */
+    class ChunkGenerator {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param topology topology to send the chunks to
+   * @param window maximum number of chunks in flight per NPU
+   */
+        ChunkGenerator(Topology* topology, int window) noexcept;
+
+        /**
+   * Destructor.
+   */
+        virtual ~ChunkGenerator() noexcept;
+
+        ChunkGenerator(const ChunkGenerator&) = delete;
+        ChunkGenerator& operator=(const ChunkGenerator&) = delete;
+
+        /**
+   * Pull the first chunks of every NPU.
+   */
+        void start() noexcept;
+
+        /**
+   * Pull the chunks of an NPU, as long as its window has room and the generator has chunks ready.
+   *
+   * @param npu NPU to pull the chunks of
+   */
+        void wake(DeviceId npu) noexcept;
+
+        /**
+   * Get the number of chunks sent so far.
+   *
+   * @return number of sent chunks
+   */
+        [[nodiscard]] uint64_t get_sent_count() const noexcept;
+
+        /**
+   * Get the number of chunks arrived at their destinations so far.
+   *
+   * @return number of arrived chunks
+   */
+        [[nodiscard]] uint64_t get_arrived_count() const noexcept;
+
+        /**
+   * Get the peak number of chunks in flight at once.
+   *
+   * @return peak number of chunks in flight
+   */
+        [[nodiscard]] size_t get_peak_in_flight_count() const noexcept;
+
+    protected:
+        /**
+   * Produce the next chunk of an NPU.
+   *
+   * @param npu src NPU of the chunk
+   * @param chunk chunk to fill in
+   * @return true if a chunk is produced, false if the NPU has no chunk ready now
+   */
+        [[nodiscard]] virtual bool next_chunk(DeviceId npu, GeneratedChunk& chunk) noexcept = 0;
+
+        /**
+   * Notified when a generated chunk arrives at its destination, before its NPU is pulled again.
+   *
+   * @param npu src NPU of the chunk
+   * @param chunk arrived chunk
+   */
+        virtual void chunk_arrived(DeviceId npu, const GeneratedChunk& chunk) noexcept;
+
+        /// topology to send the chunks to
+        Topology* topology;
+
+        /// number of NPUs
+        int npus_count;
+
+    private:
+        /// slot of a chunk in flight, which is the callback argument of the chunk
+        struct Slot {
+            /// generator the chunk belongs to
+            ChunkGenerator* generator;
+
+            /// src NPU of the chunk
+            DeviceId npu;
+
+            /// chunk in flight
+            GeneratedChunk chunk;
+        };
+
+        /// maximum number of chunks in flight per NPU
+        int window;
+
+        /// slots of the chunks in flight, indexed by (npu * window + i)
+        std::vector<Slot> slots;
+
+        /// stack of the free slot indices of each NPU, in the range [npu * window, (npu + 1) * window)
+        std::vector<int> free_slots;
+
+        /// number of the free slots of each NPU
+        std::vector<int> free_slots_count;
+
+        /// number of chunks in flight
+        size_t in_flight_count;
+
+        /// peak number of chunks in flight
+        size_t peak_in_flight_count;
+
+        /// number of sent chunks
+        uint64_t sent_count;
+
+        /// number of arrived chunks
+        uint64_t arrived_count;
+
+        /**
+   * Callback invoked when a generated chunk arrives at its destination.
+   *
+   * @param slot slot of the chunk
+   */
+        static void slot_arrived(void* slot) noexcept;
+    };
+
+    /**
+ * AllToAllGenerator generates an all-to-all: every NPU sends a chunk to every other NPU,
+ * the (npu + i)-th NPU as its i-th chunk, so that the NPUs start with distinct destinations.
+ */
+    class AllToAllGenerator final : public ChunkGenerator {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param topology topology to run the all-to-all on
+   * @param chunk_size size of each chunk
+   * @param window maximum number of chunks in flight per NPU
+   */
+        AllToAllGenerator(Topology* topology, ChunkSize chunk_size, int window) noexcept;
+
+    private:
+        /**
+   * Implementation of next_chunk function in ChunkGenerator.
+   */
+        [[nodiscard]] bool next_chunk(DeviceId npu, GeneratedChunk& chunk) noexcept override;
+
+        /// size of each chunk
+        ChunkSize chunk_size;
+
+        /// offset of the next dest of each NPU
+        std::vector<int> next_offsets;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
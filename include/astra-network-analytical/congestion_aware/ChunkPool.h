@@ -0,0 +1,149 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "congestion_aware/Type.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * ChunkPool owns the storage of Chunks created by Topology::make_chunk().
+ *
+ * Chunk slots are allocated in slabs, and never freed until the pool is destroyed.
+ * Destroying a pooled Chunk returns its slot to the pool it came from
+ * (regardless of whether it's destroyed by the simulator or by the user),
+ * so that a steady-state simulation doesn't allocate memory for injecting chunks.
+ *
+ * Every Chunk allocation, pooled or not, is prefixed with a header naming its pool.
+ * Chunks created by plain `new` or std::make_unique have no pool, and are freed as usual.
+ *
+ * Chunks of the pool must not be used once the pool is destroyed.
+ * The pool is not thread-safe by default.
+ * If chunks may be created or destroyed by multiple threads, enable the concurrent mode.
+ */
+    class ChunkPool {
+    public:
+        /**
+   * Constructor.
+   */
+        ChunkPool() noexcept;
+
+        ChunkPool(const ChunkPool&) = delete;
+
+        ChunkPool& operator=(const ChunkPool&) = delete;
+
+        /**
+   * Take a Chunk slot out of the pool.
+   *
+   * @return storage for a single Chunk
+   */
+        [[nodiscard]] void* allocate() noexcept;
+
+        /**
+   * Return a Chunk slot to the pool.
+   *
+   * @param storage storage of a destroyed Chunk, which was allocated from this pool
+   */
+        void release(void* storage) noexcept;
+
+        /**
+   * Pre-allocate Chunk slots so that the pool holds at least the given number of them.
+   *
+   * @param chunks_count number of Chunk slots to pre-allocate
+   */
+        void reserve(size_t chunks_count) noexcept;
+
+        /**
+   * Guard the pool with a lock, so that Chunks can be created and destroyed by multiple threads.
+   *
+   * @param concurrent true to enable the concurrent mode, false to disable it
+   */
+        void set_concurrent(bool concurrent) noexcept;
+
+        /**
+   * Get the number of Chunk slots currently in use.
+   *
+   * @return number of allocated but not yet released Chunk slots
+   */
+        [[nodiscard]] size_t get_in_use_count() const noexcept;
+
+        /**
+   * Get the peak number of Chunk slots simultaneously in use.
+   *
+   * @return peak number of Chunk slots in use
+   */
+        [[nodiscard]] size_t get_peak_usage() const noexcept;
+
+        /**
+   * Get the number of Chunk slots allocated by the pool.
+   *
+   * @return number of allocated Chunk slots
+   */
+        [[nodiscard]] size_t get_capacity() const noexcept;
+
+        /**
+   * Allocate storage for a Chunk outside of any pool.
+   *
+   * @param size size of the Chunk object
+   * @return storage for the Chunk
+   */
+        [[nodiscard]] static void* allocate_unpooled(size_t size) noexcept;
+
+        /**
+   * Free the storage of a destroyed Chunk,
+   * by returning it to its pool, or to the heap if it has no pool.
+   *
+   * @param storage storage of the destroyed Chunk
+   */
+        static void deallocate(void* storage) noexcept;
+
+    private:
+        /// number of Chunk slots per slab
+        static constexpr size_t slab_slots_count = 256;
+
+        /// slabs of Chunk slots
+        std::vector<std::unique_ptr<unsigned char[]>> slabs;
+
+        /// Chunk storages available to be allocated
+        std::vector<void*> free_slots;
+
+        /// number of Chunk slots in use
+        size_t in_use_count;
+
+        /// peak number of Chunk slots in use
+        size_t peak_usage;
+
+        /// true if the pool is guarded by mutex
+        bool concurrent;
+
+        /// lock of the pool in the concurrent mode
+        std::mutex mutex;
+
+        /**
+   * Allocate a new slab, and add its slots to the free slots.
+   */
+        void allocate_slab() noexcept;
+
+        /**
+   * Implementation of allocate(), without locking.
+   *
+   * @return storage for a single Chunk
+   */
+        [[nodiscard]] void* allocate_slot() noexcept;
+
+        /**
+   * Implementation of release(), without locking.
+   *
+   * @param storage storage of a destroyed Chunk
+   */
+        void release_slot(void* storage) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,326 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/CollectiveCache.h"
+#include "congestion_aware/OrbitTopology.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Collective runs a collective communication over every NPU of a topology.
+ *
+ * The collective buffer of each NPU is split into (NPUs count) shards,
+ * and the algorithm is expanded into steps: at each step, every NPU sends chunks to its peers of the step.
+ * An NPU starts a step once it has received every chunk of its previous step,
+ * so the steps of different NPUs proceed independently.
+ *   - AllGather, ReduceScatter: Ring, Direct, or HalvingDoubling (recursive doubling / halving)
+ *   - AllReduce: ReduceScatter followed by AllGather of the same algorithm
+ *   - AllToAll: Ring (pairwise exchange with the i-th next NPU at step i), Direct,
+ *     or HalvingDoubling (pairwise exchange with the NPU of id (npu XOR i))
+ *
+ * The chunks are created from the chunk pool of the topology (sharing interned routes if the route cache is enabled),
+ * and a single callback is invoked once every chunk of the collective arrives.
+ * The collective should outlive the simulation.
+ *
+ * With the symmetry reduction enabled, a rotation-invariant collective on a Ring, Switch, or FullyConnected
+ * simulates only the chunks of NPU 0 over the rotation orbits of the links (see OrbitTopology),
+ * and every NPU finishes when NPU 0 does.
+ *
+ * With a result cache set, the collective is looked up before it's simulated:
+ * a cached collective only schedules its callback at the cached finish time. See CollectiveCache.
+ *
+ * In a distributed simulation, every rank runs the same collective restricted to its local NPUs,
+ * and maps the chunk callbacks to handles by encode_callback() and decode_callback(). See DistributedSimulator.
+ */
+    class Collective {
+    public:
+        /**
+   * Constructor.
+   * HalvingDoubling requires a power-of-2 number of NPUs.
+   *
+   * @param topology topology to run the collective on
+   * @param type collective communication pattern
+   * @param algorithm collective algorithm
+   * @param size collective buffer size of each NPU
+   * @param callback callback to be invoked when the collective finishes
+   * @param callback_arg argument of the callback
+   */
+        Collective(Topology* topology,
+                   CollectiveType type,
+                   CollectiveAlgorithm algorithm,
+                   ChunkSize size,
+                   Callback callback,
+                   CallbackArg callback_arg) noexcept;
+
+        /**
+   * Send the chunks of the first step of every NPU.
+   * The following steps are initiated as the chunks arrive.
+   */
+        void start() noexcept;
+
+        /**
+   * Enable or disable the symmetry reduction, before start().
+   * The collective is reduced only if the topology is reducible (see OrbitTopology::reducible())
+   * and every step is invariant under the rotation of the NPUs (i.e., not HalvingDoubling),
+   * otherwise every chunk is simulated as usual.
+   * The quotient links take the default link settings, and the reduced chunks are sent over them,
+   * not over the links of the topology.
+   *
+   * @param symmetry_reduction true to enable the symmetry reduction, false to disable it
+   */
+        void set_symmetry_reduction(bool symmetry_reduction) noexcept;
+
+        /**
+   * Check if the collective is simulated over the rotation orbits, once started.
+   *
+   * @return true if the collective is reduced, false otherwise
+   */
+        [[nodiscard]] bool is_symmetry_reduced() const noexcept;
+
+        /**
+   * Set the cache of the collective results, before start().
+   * The collective is looked up by the network configuration hash and its own traffic descriptor,
+   * and a simulated collective caches its result once finished.
+   *
+   * @param result_cache cache to consult, nullptr to always simulate
+   * @param config_hash hash of the network configuration of the topology, e.g., NetworkConfig::hash()
+   */
+        void set_result_cache(CollectiveCache* result_cache, uint64_t config_hash) noexcept;
+
+        /**
+   * Simulate only the NPUs in [begin, end), before start(), as a rank of a distributed simulation
+   * where the other NPUs are simulated by the other ranks.
+   * The collective sends the chunks of its local NPUs, and finishes once every chunk destined to them arrives.
+   * Unless every NPU is local, the symmetry reduction and the result cache are skipped, as they need every NPU.
+   *
+   * @param begin first local NPU
+   * @param end NPU after the last local NPU
+   */
+        void set_local_npus(DeviceId begin, DeviceId end) noexcept;
+
+        /**
+   * Map the callback of a chunk of the collective to a handle, e.g., to hand the chunk over to another rank.
+   *
+   * @param callback callback of the chunk
+   * @param callback_arg argument of the callback
+   * @return handle of the callback, the same on every rank running the collective
+   */
+        [[nodiscard]] CallbackHandle encode_callback(Callback callback, CallbackArg callback_arg) const noexcept;
+
+        /**
+   * Map a handle from encode_callback() back to the callback of a chunk of the collective.
+   *
+   * @param handle handle of the callback
+   * @return callback and its argument
+   */
+        [[nodiscard]] std::pair<Callback, CallbackArg> decode_callback(CallbackHandle handle) noexcept;
+
+        /**
+   * Check if the result of the collective is replayed from the cache, once started.
+   *
+   * @return true if the result is cached, false if simulated
+   */
+        [[nodiscard]] bool is_result_cached() const noexcept;
+
+        /**
+   * Check if every chunk of the collective has arrived.
+   *
+   * @return true if the collective is finished, false otherwise
+   */
+        [[nodiscard]] bool finished() const noexcept;
+
+        /**
+   * Get the number of steps of the collective.
+   *
+   * @return number of steps
+   */
+        [[nodiscard]] int get_steps_count() const noexcept;
+
+        /**
+   * Get the total number of chunks of the collective, destined to its local NPUs.
+   *
+   * @return number of chunks
+   */
+        [[nodiscard]] size_t get_chunks_count() const noexcept;
+
+        /**
+   * Get the time an NPU has received every chunk of the collective, once finished.
+   * If the collective is reduced, every NPU shares the finish time of NPU 0.
+   *
+   * @param npu NPU id, which should be local
+   * @return finish time of the NPU
+   */
+        [[nodiscard]] EventTime get_npu_finish_time(DeviceId npu) const noexcept;
+
+    private:
+        /// chunks every NPU sends at a step
+        struct Step {
+            /// size of each chunk
+            ChunkSize chunk_size;
+
+            /// dest NPUs of each NPU, i.e., peers[npu] = { dest NPUs }
+            std::vector<std::vector<DeviceId>> peers;
+        };
+
+        /// callback argument of the chunks arriving at an NPU at a step
+        struct StepArrival {
+            /// collective the chunk belongs to
+            Collective* collective;
+
+            /// NPU the chunk arrives at
+            DeviceId npu;
+
+            /// step of the chunk
+            int step;
+        };
+
+        /// topology to run the collective on
+        Topology* topology;
+
+        /// collective communication pattern
+        CollectiveType type;
+
+        /// collective algorithm
+        CollectiveAlgorithm algorithm;
+
+        /// collective buffer size of each NPU
+        ChunkSize size;
+
+        /// number of NPUs
+        int npus_count;
+
+        /// steps of the collective
+        std::vector<Step> steps;
+
+        /// callback arguments, indexed by (npu * steps count + step)
+        std::vector<StepArrival> step_arrivals;
+
+        /// number of chunks each NPU receives at each step, indexed by (npu * steps count + step)
+        std::vector<int> expected_chunks;
+
+        /// number of chunks each NPU has received at each step, indexed by (npu * steps count + step)
+        std::vector<int> received_chunks;
+
+        /// next step each NPU should start
+        std::vector<int> next_steps;
+
+        /// number of chunks each NPU is yet to receive
+        std::vector<size_t> pending_chunks;
+
+        /// time each NPU has received every chunk
+        std::vector<EventTime> npu_finish_times;
+
+        /// event queue of the topology, once started
+        EventQueue* event_queue;
+
+        /// true if the symmetry reduction is enabled
+        bool symmetry_reduction;
+
+        /// quotient of the topology the reduced collective is simulated on, nullptr if not reduced
+        std::unique_ptr<OrbitTopology> orbit_topology;
+
+        /// cache of the collective results, nullptr if not set
+        CollectiveCache* result_cache;
+
+        /// key of the collective in the result cache
+        uint64_t result_key;
+
+        /// true if the result is replayed from the cache
+        bool result_cached;
+
+        /// first local NPU
+        DeviceId local_npus_begin;
+
+        /// NPU after the last local NPU
+        DeviceId local_npus_end;
+
+        /// time the collective started
+        EventTime start_time;
+
+        /// total number of chunks
+        size_t chunks_count;
+
+        /// number of chunks arrived so far
+        size_t arrived_chunks_count;
+
+        /// callback to be invoked when the collective finishes
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+
+        /**
+   * Callback to be invoked when a chunk of the collective arrives.
+   *
+   * @param step_arrival pointer to the StepArrival of the chunk
+   */
+        static void chunk_arrived(void* step_arrival) noexcept;
+
+        /**
+   * Check if every NPU of the collective is simulated by this process.
+   *
+   * @return true if every NPU is local, false otherwise
+   */
+        [[nodiscard]] bool all_npus_local() const noexcept;
+
+        /**
+   * Callback to be invoked at the cached finish time of the collective.
+   *
+   * @param collective pointer to the Collective
+   */
+        static void cached_result_arrived(void* collective) noexcept;
+
+        /**
+   * Invoke the callback of the finished collective, caching its result if simulated.
+   */
+        void finish() noexcept;
+
+        /**
+   * Append the steps of a collective pattern to the collective.
+   *
+   * @param type collective communication pattern, AllReduce is not allowed
+   * @param algorithm collective algorithm
+   * @param shard_size size of a shard
+   */
+        void append_steps(CollectiveType type, CollectiveAlgorithm algorithm, ChunkSize shard_size) noexcept;
+
+        /**
+   * Append a step, where every NPU sends a chunk to the NPU of id peer(npu).
+   *
+   * @param chunk_size size of each chunk
+   * @param peer function mapping an NPU to its peer
+   */
+        template <typename PeerFunction>
+        void append_pairwise_step(ChunkSize chunk_size, PeerFunction peer) noexcept;
+
+        /**
+   * Check if every step is invariant under the rotation of the NPUs,
+   * i.e., NPU n sends to the peers of NPU 0 rotated by n.
+   *
+   * @return true if the collective is rotation-invariant, false otherwise
+   */
+        [[nodiscard]] bool rotation_invariant() const noexcept;
+
+        /**
+   * Start the steps of an NPU whose previous step has completed.
+   *
+   * @param npu NPU to proceed
+   */
+        void proceed(DeviceId npu) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,194 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * CollectiveCache memoizes the results of collectives, so that a rerun of the same
+ * (network configuration, collective) pair replays the result instead of simulating it.
+ *
+ * A result is keyed by hash_key(): a hash of the network configuration (e.g., NetworkConfig::hash()),
+ * the traffic descriptor of the collective, and the library version,
+ * so that results of a different library version are never hit.
+ * The results are kept in an in-process LRU of a fixed number of entries,
+ * backed by an on-disk store shared between processes: a file per key in the store directory.
+ * A file is written to a temporary file first and renamed, so that concurrent processes never read a partial one.
+ * The cache is thread-safe, so may be shared by the simulations of a sweep.
+ *
+ * The configuration hash should cover every setting that changes the results but isn't part of the
+ * network configuration (e.g., the link settings of the topology).
+ */
+    class CollectiveCache {
+    public:
+        /// result of a collective, relative to its start time
+        struct CollectiveResult {
+            /// time from the start until every NPU finishes
+            EventTime duration;
+
+            /// time from the start until each NPU finishes, indexed by NPU
+            std::vector<EventTime> npu_durations;
+        };
+
+        /**
+   * Constructor.
+   *
+   * @param capacity maximum number of results kept in memory
+   * @param directory directory of the on-disk store (created if missing), empty to keep the results in memory only
+   */
+        explicit CollectiveCache(size_t capacity, std::string directory = "") noexcept;
+
+        /**
+   * Get the library version the results are keyed by.
+   *
+   * @return library version
+   */
+        [[nodiscard]] static const char* get_library_version() noexcept;
+
+        /**
+   * Compute the key of a collective.
+   *
+   * @param config_hash hash of the network configuration
+   * @param type collective communication pattern
+   * @param algorithm collective algorithm
+   * @param size collective buffer size of each NPU
+   * @return key of the collective
+   */
+        [[nodiscard]] static uint64_t hash_key(uint64_t config_hash,
+                                               CollectiveType type,
+                                               CollectiveAlgorithm algorithm,
+                                               ChunkSize size) noexcept;
+
+        /**
+   * Look up the result of a collective, in memory first and on disk next.
+   * A result found on disk is brought into memory.
+   *
+   * @param key key of the collective
+   * @return result of the collective, std::nullopt if not cached
+   */
+        [[nodiscard]] std::optional<CollectiveResult> find(uint64_t key) noexcept;
+
+        /**
+   * Cache the result of a collective, in memory and on disk.
+   * The least recently used result is evicted from memory if it's full.
+   *
+   * @param key key of the collective
+   * @param result result of the collective
+   */
+        void insert(uint64_t key, const CollectiveResult& result) noexcept;
+
+        /**
+   * Get the number of results kept in memory.
+   *
+   * @return number of results in memory
+   */
+        [[nodiscard]] size_t get_entries_count() const noexcept;
+
+        /**
+   * Get the number of lookups hit in memory.
+   *
+   * @return number of memory hits
+   */
+        [[nodiscard]] uint64_t get_memory_hits_count() const noexcept;
+
+        /**
+   * Get the number of lookups missed in memory but hit on disk.
+   *
+   * @return number of disk hits
+   */
+        [[nodiscard]] uint64_t get_disk_hits_count() const noexcept;
+
+        /**
+   * Get the number of lookups missed both in memory and on disk.
+   *
+   * @return number of misses
+   */
+        [[nodiscard]] uint64_t get_misses_count() const noexcept;
+
+        /**
+   * Get the ratio of the lookups hit, either in memory or on disk.
+   *
+   * @return hit rate in [0, 1], 0 if nothing was looked up
+   */
+        [[nodiscard]] double get_hit_rate() const noexcept;
+
+    private:
+        /// results in memory, the most recently used first
+        using ResultList = std::list<std::pair<uint64_t, CollectiveResult>>;
+
+        /// maximum number of results kept in memory
+        size_t capacity;
+
+        /// directory of the on-disk store, empty if none
+        std::string directory;
+
+        /// results in memory
+        ResultList results;
+
+        /// results in memory, keyed by key
+        std::unordered_map<uint64_t, ResultList::iterator> result_table;
+
+        /// number of lookups hit in memory
+        uint64_t memory_hits_count;
+
+        /// number of lookups hit on disk
+        uint64_t disk_hits_count;
+
+        /// number of lookups missed
+        uint64_t misses_count;
+
+        /// guards the results and the counters
+        mutable std::mutex mutex;
+
+        /**
+   * Keep a result in memory as the most recently used one, evicting the least recently used one if full.
+   * The mutex should be held.
+   *
+   * @param key key of the collective
+   * @param result result of the collective
+   */
+        void remember(uint64_t key, CollectiveResult result) noexcept;
+
+        /**
+   * Get the path of the file of a key in the on-disk store.
+   *
+   * @param key key of the collective
+   * @return path of the file
+   */
+        [[nodiscard]] std::string get_path(uint64_t key) const noexcept;
+
+        /**
+   * Read a result from the on-disk store.
+   *
+   * @param key key of the collective
+   * @return result of the collective, std::nullopt if the file is missing or stale
+   */
+        [[nodiscard]] std::optional<CollectiveResult> read_result(uint64_t key) const noexcept;
+
+        /**
+   * Write a result to the on-disk store.
+   * A failed write is dropped, as the result is still kept in memory.
+   *
+   * @param key key of the collective
+   * @param result result of the collective
+   */
+        void write_result(uint64_t key, const CollectiveResult& result) const noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
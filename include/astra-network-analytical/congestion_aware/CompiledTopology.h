@@ -0,0 +1,102 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * CompiledTopology is a topology loaded from a compiled topology file,
+ * which holds the link table and the route of every NPU pair of a constructed topology.
+ *
+ * The file is memory-mapped: routes reference the mapped route table directly,
+ * so neither the network configuration is parsed nor any route is computed at startup.
+ * Only the devices and links, which hold the simulation state, are instantiated from the link table.
+ * LinkIds are preserved, so a compiled topology simulates identically to the topology it's compiled from.
+ *
+ * The file is keyed by a hash of the network configuration and a format version:
+ * load() rejects a file compiled from a different configuration or by a different version.
+ */
+    class CompiledTopology final : public Topology {
+    public:
+        /// version of the compiled topology format, bumped whenever the format or the routing changes
+        static constexpr uint32_t format_version = 2;
+
+        /**
+   * Compile a constructed topology into a file.
+   *
+   * @param topology topology to compile
+   * @param config_hash hash of the network configuration the topology is constructed from
+   * @param path path of the compiled topology file
+   */
+        static void compile(const Topology& topology, uint64_t config_hash, const std::string& path) noexcept;
+
+        /**
+   * Load a compiled topology file.
+   *
+   * @param path path of the compiled topology file
+   * @param config_hash hash of the network configuration the file should be compiled from
+   * @return loaded topology, nullptr if the file is missing or stale
+   */
+        [[nodiscard]] static std::shared_ptr<CompiledTopology> load(const std::string& path,
+                                                                    uint64_t config_hash) noexcept;
+
+        /**
+   * Compute the hash of a network configuration file, over its contents (FNV-1a).
+   *
+   * @param network_config_path path of the network configuration file
+   * @return hash of the file
+   */
+        [[nodiscard]] static uint64_t hash_network_config(const std::string& network_config_path) noexcept;
+
+        /**
+   * Destructor.
+   * Unmaps the compiled topology file.
+   */
+        ~CompiledTopology() noexcept;
+
+        CompiledTopology(const CompiledTopology&) = delete;
+        CompiledTopology& operator=(const CompiledTopology&) = delete;
+
+    private:
+        /// mapped compiled topology file
+        void* mapping;
+
+        /// size of the mapping in bytes
+        size_t mapping_size;
+
+        /// offset of the route of each NPU pair into route_links, indexed by (src * npus_count + dest)
+        const uint64_t* route_offsets;
+
+        /// hops of every route, back to back
+        const LinkId* route_links;
+
+        /**
+   * Constructor.
+   * Instantiates the devices and links from the mapped file, which load() validated.
+   *
+   * @param mapping mapped compiled topology file
+   * @param mapping_size size of the mapping in bytes
+   */
+        CompiledTopology(void* mapping, size_t mapping_size) noexcept;
+
+        /**
+   * Implementation of compute_route function in Topology.
+   * References the mapped route table.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -7,8 +7,9 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
-#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -37,27 +38,35 @@ namespace NetworkAnalyticalCongestionAware {
         /**
    * Initiate a chunk transmission.
    * You must invoke this method on the source device of the chunk.
+   * The chunk is sent through the link designated by its route.
    *
    * @param chunk chunk to send
    */
         void send(std::unique_ptr<Chunk> chunk) noexcept;
 
         /**
-   * Connect a device to another device.
+   * Register a link from this device to another device.
    *
    * @param id id of the device to connect this device to
-   * @param bandwidth bandwidth of the link
-   * @param latency latency of the link
+   * @param link id of the link in the topology's link table
    */
-        void connect(DeviceId id, Bandwidth bandwidth, Latency latency) noexcept;
+        void connect(DeviceId id, LinkId link) noexcept;
+
+        /**
+   * Get the link from this device to another device.
+   *
+   * @param dest id of the connected device
+   * @return id of the link in the topology's link table
+   */
+        [[nodiscard]] LinkId get_link_id(DeviceId dest) const noexcept;
 
     private:
         /// device Id
         DeviceId device_id;
 
-        /// links to other nodes
-        /// map[dest node node_id] -> link
-        std::map<DeviceId, std::shared_ptr<Link>> links;
+        /// links to other nodes, sorted by the dest device id
+        /// only used to construct routes, as chunks carry the link id of each hop
+        std::vector<std::pair<DeviceId, LinkId>> links;
 
         /**
    * Check if this device is connected to another device.
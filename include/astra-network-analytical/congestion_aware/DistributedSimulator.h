@@ -0,0 +1,172 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Telemetry.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/Type.h"
+#include <memory>
+#include <mpi.h>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * DistributedSimulator runs a congestion-aware simulation over the ranks of an MPI communicator,
+ * using the conservative synchronization of ParallelSimulator across processes instead of threads.
+ * Available only if the backend is compiled with ANALYTICAL_MPI (CMake option NETWORK_BACKEND_MPI).
+ *
+ * Every rank builds the same topology from the same network configuration (e.g., NetworkParser input),
+ * bound to its own EventQueue, and owns a contiguous range of device IDs,
+ * so a multi-dimensional topology is sharded along its outer dimensions.
+ * A rank simulates the links starting from its devices: the links of the other ranks are never sent over,
+ * and lazy links (e.g., of a Torus) are never created for them, but for the last hop of a chunk handed over.
+ *
+ * Ranks advance in synchronous windows [T, T + lookahead), where T is the earliest pending event time
+ * across the ranks and the lookahead is the minimum latency of the links crossing ranks.
+ * Chunks arriving over links of at least the lookahead latency are handed over at the window barrier,
+ * in a single batched all-to-all exchange per window, and delivered in the order of
+ * (arrival time, send time, src rank). Unlike ParallelSimulator, the sequential order isn't reproduced exactly:
+ * chunks sent at the same time from different ranks that then arrive at the same time follow the src rank order,
+ * so if they contend for the same link, their arrival times may differ from a sequential run.
+ * As the chunk callbacks are raw pointers, a chunk handed over to another rank carries a handle of its callback:
+ * the encoder and decoder map callbacks to handles and back, the same way on every rank
+ * (e.g., Collective::encode_callback() and Collective::decode_callback()).
+ *
+ * Each rank should send only the chunks from its own devices, e.g., by Collective::set_local_npus(),
+ * and the callback of a chunk is invoked by the rank owning its destination device.
+ */
+    class DistributedSimulator {
+    public:
+        /**
+   * Constructor. A collective call: every rank of the communicator should construct it.
+   * Shards the devices of the topology across the ranks and binds the links crossing ranks to mailboxes.
+   *
+   * @param topology topology to simulate, bound to the event queue of this rank
+   * @param communicator communicator of the ranks
+   * @param encoder maps the callbacks of the chunks handed over to another rank to handles
+   * @param decoder maps handles back to the callbacks of the chunks handed over from another rank
+   */
+        DistributedSimulator(std::shared_ptr<Topology> topology,
+                             MPI_Comm communicator,
+                             CallbackEncoder encoder,
+                             CallbackDecoder decoder) noexcept;
+
+        /**
+   * Destructor.
+   * Unbinds the links of the topology from the mailboxes.
+   */
+        ~DistributedSimulator() noexcept;
+
+        DistributedSimulator(const DistributedSimulator&) = delete;
+
+        DistributedSimulator& operator=(const DistributedSimulator&) = delete;
+
+        /**
+   * Get the rank of this process.
+   *
+   * @return rank of this process
+   */
+        [[nodiscard]] int get_rank() const noexcept;
+
+        /**
+   * Get the number of ranks.
+   *
+   * @return number of ranks
+   */
+        [[nodiscard]] int get_ranks_count() const noexcept;
+
+        /**
+   * Get the rank owning a device.
+   *
+   * @param device id of the device
+   * @return rank of the device
+   */
+        [[nodiscard]] int get_device_rank(DeviceId device) const noexcept;
+
+        /**
+   * Get the NPUs owned by this rank.
+   *
+   * @return [begin, end) of the local NPU ids
+   */
+        [[nodiscard]] std::pair<DeviceId, DeviceId> get_local_npus() const noexcept;
+
+        /**
+   * Get the lookahead, i.e., the size of a synchronization window.
+   *
+   * @return lookahead in ns
+   */
+        [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+        /**
+   * Get the time of the latest event invoked among all ranks, as of the end of the last run().
+   *
+   * @return current time of the simulation
+   */
+        [[nodiscard]] EventTime get_current_time() const noexcept;
+
+        /**
+   * Run the simulation until every rank runs out of events. A collective call.
+   *
+   * @return summary of the execution, accumulated over all ranks
+   */
+        RunSummary run() noexcept;
+
+#ifdef ANALYTICAL_TELEMETRY
+        /**
+   * Gather the telemetry counters of every rank to a root rank. A collective call.
+   * Available only if the backend is compiled with ANALYTICAL_TELEMETRY.
+   *
+   * @param root rank to gather to
+   * @return telemetry counters of every link on the root, an empty table on the other ranks
+   */
+        [[nodiscard]] Telemetry gather_telemetry(int root = 0) const noexcept;
+#endif
+
+    private:
+        /// simulated topology
+        std::shared_ptr<Topology> topology;
+
+        /// communicator of the ranks
+        MPI_Comm communicator;
+
+        /// rank of this process
+        int rank;
+
+        /// number of ranks
+        int ranks_count;
+
+        /// maps the callbacks of the chunks handed over to handles
+        CallbackEncoder encoder;
+
+        /// maps handles back to the callbacks of the chunks handed over
+        CallbackDecoder decoder;
+
+        /// first device of each rank, followed by the number of devices
+        std::vector<DeviceId> rank_offsets;
+
+        /// mailboxes[dest rank], written by the links of this rank within a window
+        std::vector<ChunkMailbox> mailboxes;
+
+        /// lookahead of the simulation
+        EventTime lookahead;
+
+        /// time of the latest event invoked among all ranks
+        EventTime current_time;
+
+        /**
+   * Hand the chunks sent since the last barrier over to their ranks,
+   * and schedule the chunk arrivals handed over to this rank. A collective call.
+   */
+        void exchange_mailboxes() noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Implements a k-ary n-level FatTree topology of k^n NPUs.
+ *
+ * FatTree(4, radix=2) example:
+ *   [t0]  [t1]      level 2 (top)
+ *    | \  / |
+ *    |  \/  |
+ *    |  /\  |
+ *   [l0]  [l1]      level 1 (leaf)
+ *   | |   | |
+ *   0 1   2 3
+ *
+ * Each leaf switch connects k NPUs. A level-l switch serves the subtree of k^l NPUs,
+ * and the subtree has W_l parallel switches: W_1 = 1, W_2 = k / oversubscription, and W_(l+1) = W_l * k.
+ * Therefore, the oversubscription is the ratio of the down ports to the up ports of each leaf switch,
+ * and the upper levels are non-blocking.
+ *
+ * Device IDs are assigned level by level after the NPUs:
+ * switch y of the g-th subtree of level l has the ID npus_count + offset(l) + g * W_l + y.
+ *
+ * A route goes up to the lowest level L whose subtree holds both src and dest, then down, so takes 2L hops.
+ * The switch y of the top level L is chosen by hashing (src, dest) (ECMP),
+ * and the route passes the switch y mod W_l of each level l.
+ * Nothing but the widths of the levels is stored: routes are computed arithmetically in O(levels).
+ */
+    class FatTree final : public BasicTopology {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param npus_count number of NPUs, which should be a power of radix
+   * @param bandwidth bandwidth of each link
+   * @param latency latency of each link
+   * @param radix number of down ports of each switch
+   * @param oversubscription ratio of the down ports to the up ports of each leaf switch, which should divide radix
+   */
+        FatTree(int npus_count, Bandwidth bandwidth, Latency latency, int radix, int oversubscription = 1) noexcept;
+
+        /**
+   * Get the number of switch levels.
+   *
+   * @return number of levels
+   */
+        [[nodiscard]] int get_levels_count() const noexcept;
+
+        /**
+   * Get the ID of a switch.
+   *
+   * @param level level of the switch, in [1, levels_count]
+   * @param subtree index of the subtree the switch serves
+   * @param index index of the switch among the parallel switches of the subtree, in [0, W_level)
+   * @return device ID of the switch
+   */
+        [[nodiscard]] DeviceId get_switch_id(int level, int subtree, int index) const noexcept;
+
+    private:
+        /**
+   * Implementation of compute_route function in Topology.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+        /// number of down ports of each switch
+        int radix;
+
+        /// number of switch levels
+        int levels_count;
+
+        /// number of parallel switches per subtree, indexed by level
+        std::vector<int> widths_per_level;
+
+        /// ID offset of the switches of each level, indexed by level
+        std::vector<int> offsets_per_level;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -23,6 +23,10 @@ namespace NetworkAnalyticalCongestionAware {
  * Therefore, the number of NPUs and devices are both 4.
  *
  * Arbitrary send between two pair of NPUs will take 1 hop.
+ *
+ * The src -> dest link has the id src * (npus_count - 1) + (dest < src ? dest : dest - 1).
+ * With lazy links, the N * (N - 1) links aren't created upfront:
+ * the link of a pair is created on its first use, so large topologies cost memory only for the links in use.
  */
     class FullyConnected final : public BasicTopology {
     public:
@@ -32,13 +36,25 @@ namespace NetworkAnalyticalCongestionAware {
    * @param npus_count number of npus in the FullyConnected topology
    * @param bandwidth bandwidth of each link
    * @param latency latency of each link
+   * @param lazy true to create each link on its first use, false to create every link now
+   */
+        FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency, bool lazy = false) noexcept;
+
+    private:
+        /**
+   * Implementation of compute_route function in Topology.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implementation of compute_lazy_link_id function in Topology.
    */
-        FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
+        [[nodiscard]] LinkId compute_lazy_link_id(DeviceId src, DeviceId dest) const noexcept override;
 
         /**
-   * Implementation of route function in Topology.
+   * Implementation of compute_lazy_link_devices function in Topology.
    */
-        [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+        [[nodiscard]] std::pair<DeviceId, DeviceId> compute_lazy_link_devices(LinkId id) const noexcept override;
     };
 
 }  // namespace NetworkAnalyticalCongestionAware
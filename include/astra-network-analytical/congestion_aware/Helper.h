@@ -5,9 +5,11 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
 #include "congestion_aware/Topology.h"
 #include <memory>
+#include <string>
 
 using namespace NetworkAnalytical;
 
@@ -17,8 +19,39 @@ namespace NetworkAnalyticalCongestionAware {
  * Construct a topology from a NetworkParser.
  *
  * @param network_parser NetworkParser to parse the network input file
- * @return pointer to the constructed topology
+ * @return pointer to the constructed topology, nullptr if the config isn't supported by the backend
  */
     [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
 
+    /**
+ * Construct a topology from an in-memory NetworkConfig.
+ *
+ * @param network_config network configuration
+ * @return pointer to the constructed topology, nullptr if the config is invalid (see NetworkConfig::validate())
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config) noexcept;
+
+    /**
+ * Construct a topology from an in-memory NetworkConfig, returning the error message if it fails.
+ *
+ * @param network_config network configuration
+ * @param error set to the error message if the config is invalid or not supported, empty otherwise
+ * @return pointer to the constructed topology, nullptr if the config is invalid or not supported
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config,
+                                                               std::string& error) noexcept;
+
+    /**
+ * Construct a topology from a network configuration file, through a compiled topology file.
+ * If the compiled file is compiled from the same configuration, the topology is loaded from it
+ * without parsing the configuration. Otherwise, the topology is constructed and compiled into the file.
+ * See CompiledTopology.
+ *
+ * @param network_config_path path of the network configuration file
+ * @param compiled_topology_path path of the compiled topology file
+ * @return pointer to the constructed topology, nullptr if the configuration can't be parsed or is invalid
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const std::string& network_config_path,
+                                                               const std::string& compiled_topology_path) noexcept;
+
 }  // namespace NetworkAnalyticalCongestionAware
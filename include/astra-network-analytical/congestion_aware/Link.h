@@ -6,7 +6,13 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/EventQueue.h"
+#include "common/RingBuffer.h"
 #include "common/Type.h"
+#include "congestion_aware/LinkStateTable.h"
+#include "congestion_aware/Telemetry.h"
+#include "congestion_aware/CallbackBatcher.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/Tracer.h"
 #include "congestion_aware/Type.h"
 #include <memory>
 
@@ -16,32 +22,233 @@ namespace NetworkAnalyticalCongestionAware {
 
     /**
  * Link models physical links between two devices.
+ *
+ * The state touched per hop (busy-until time, bandwidth, and latency) lives in a LinkStateTable,
+ * usually shared by every link of the topology; the link keeps its slot in the table.
+ * The pending chunks and the rest of the (colder) state are kept in the link.
  */
     class Link {
     public:
         /**
-   * Callback to be called when a link becomes free.
-   *  - If the link has pending chunks, process the first one.
-   *  - If the link has no pending chunks, set the link as free.
+   * Callback to be called when a link with pending chunks becomes free.
+   * The link tracks the time it becomes free instead of scheduling an event for every chunk:
+   * the event is scheduled only when a chunk has to wait for the link, and processes the first pending chunk.
    *
-   * @param link_ptr pointer to the link that becomes free
+   * @param link pointer to the link that becomes free
    */
-        static void link_become_free(void* link_ptr) noexcept;
+        static void link_become_free(Link* link) noexcept;
 
         /**
-   * Set the event queue to be used by the link.
+   * Transmit a chunk over the rest of its route in cut-through mode.
+   * If every link of the route is idle, the arrival time at the destination is computed in closed form:
+   * the head packet is forwarded hop by hop, and the rest of the chunk follows at the bottleneck bandwidth.
+   * The delays of the hops are summed in ps, so the arrival time is truncated to ns only once.
+   * Each link is reserved from now until the tail of the chunk leaves it (conservatively,
+   * as the head packet reaches the later links a bit later),
+   * so only a single arrival event is scheduled.
    *
-   * @param event_queue_ptr pointer to the event queue
+   * If a link of the route is busy or has pending chunks, the chunk is split into packets
+   * (see Chunk::split_into_packets()), which are queued and forwarded hop by hop,
+   * so they're pipelined over the contended links at the cost of an event per packet and hop.
+   * Each packet cuts through again in closed form once the rest of its route is idle.
+   * A chunk not larger than a packet, or over a link that hands its arrivals to another partition,
+   * falls back to hop-by-hop (store-and-forward) transmission as a whole.
+   *
+   * @param chunk chunk to be transmitted, moved out if the transmission is done in cut-through mode
+   * @return true if the chunk is transmitted in cut-through mode (as a whole or in packets), false otherwise
    */
-        static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+        static bool cut_through(std::unique_ptr<Chunk>& chunk) noexcept;
 
         /**
    * Constructor.
    *
+   * @param src id of the device the link starts from
+   * @param dest id of the device the link ends at
+   * @param bandwidth bandwidth of the link
+   * @param latency latency of the link
+   */
+        Link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+        /**
+   * Constructor of a link whose state is kept in a shared state table.
+   * The table should outlive the link.
+   *
+   * @param src id of the device the link starts from
+   * @param dest id of the device the link ends at
    * @param bandwidth bandwidth of the link
    * @param latency latency of the link
+   * @param link_states state table to register the link to
+   */
+        Link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, LinkStateTable& link_states) noexcept;
+
+        Link(const Link&) = delete;
+        Link& operator=(const Link&) = delete;
+
+        /**
+   * Get the id of the device the link starts from.
+   *
+   * @return src device id
+   */
+        [[nodiscard]] DeviceId get_src() const noexcept;
+
+        /**
+   * Get the id of the device the link ends at.
+   *
+   * @return dest device id
+   */
+        [[nodiscard]] DeviceId get_dest() const noexcept;
+
+        /**
+   * Set the event queue the link schedules its events on.
+   *
+   * @param event_queue event queue of the link
+   */
+        void set_event_queue(EventQueue* event_queue) noexcept;
+
+        /**
+   * Hand arriving chunks to a mailbox instead of scheduling them on the link's event queue.
+   * Used when the dest device is simulated by another partition of a parallel simulation.
+   *
+   * @param outbox mailbox to hand arriving chunks to, nullptr to schedule them directly
+   */
+        void set_outbox(ChunkMailbox* outbox) noexcept;
+
+        /**
+   * Set the tracer the link records its transmissions to.
+   *
+   * @param tracer tracer to record to, nullptr to disable tracing
+   */
+        void set_tracer(Tracer* tracer) noexcept;
+
+        /**
+   * Get the tracer the link records its transmissions to.
+   *
+   * @return tracer of the link, nullptr if tracing is disabled
+   */
+        [[nodiscard]] Tracer* get_tracer() const noexcept;
+
+        /**
+   * Set the batcher the callbacks of the chunks arriving through the link are deferred to.
+   *
+   * @param callback_batcher batcher to defer to, nullptr to invoke every callback right away
+   */
+        void set_callback_batcher(CallbackBatcher* callback_batcher) noexcept;
+
+        /**
+   * Get the batcher the callbacks of the chunks arriving through the link are deferred to.
+   *
+   * @return batcher of the link, nullptr if callbacks are not batched
+   */
+        [[nodiscard]] CallbackBatcher* get_callback_batcher() const noexcept;
+
+        /**
+   * Set the pool the packets of the chunks split at the link are allocated from. See set_packet_size().
+   *
+   * @param chunk_pool pool to allocate the packets from
+   */
+        void set_chunk_pool(ChunkPool* chunk_pool) noexcept;
+
+#ifdef ANALYTICAL_TELEMETRY
+        /**
+   * Set the telemetry table the link records its counters to.
+   *
+   * @param telemetry telemetry table
+   * @param id id of the link in the telemetry table
+   */
+        void set_telemetry(Telemetry* telemetry, LinkId id) noexcept;
+#endif
+
+        /**
+   * Enable or disable coalescing of pending chunks.
+   * If enabled, when the link becomes free, every pending chunk is transmitted back-to-back in one pass:
+   * their arrivals are scheduled at once, and the link becomes free only after the last one.
+   *
+   * @param coalescing true to enable coalescing, false to transmit pending chunks one by one
+   */
+        void set_coalescing(bool coalescing) noexcept;
+
+        /**
+   * Set the packet size of the cut-through mode. See cut_through().
+   *
+   * @param packet_size size of the packets, 0 to disable cut-through
+   */
+        void set_packet_size(ChunkSize packet_size) noexcept;
+
+        /**
+   * Get the packet size of the cut-through mode.
+   *
+   * @return size of the packets, 0 if cut-through is disabled
+   */
+        [[nodiscard]] ChunkSize get_packet_size() const noexcept;
+
+        /**
+   * Enable or disable express scheduling.
+   * If enabled, when a chunk is transmitted, the following links of its route that are idle
+   * are reserved for it right away, and only its arrival after the last reserved link is scheduled:
+   * the arrival events of the intermediate hops are not returned to the event queue.
+   *
+   * Express hops stop before links in cut-through mode, analytical links, and links to another partition.
+   *
+   * The arrivals at the intermediate devices are kept as relays of the final arrival
+   * (see EventQueue::schedule_relayed_event()), so the event queue knows when the reserved chunk
+   * would have arrived at each of them, down to its order among the events of the same time.
+   * If another chunk requests a reserved link before the reserved chunk would have arrived,
+   * the reservation (and the reservations after it) are rolled back,
+   * and the reserved chunk arrives at the link's src device as it would have hop by hop, in the same order.
+   * Therefore, the results are identical to the hop-by-hop simulation, including who goes first
+   * when chunks request the same link at the same time.
+   * Express scheduling is skipped when the event times are quantized.
+   *
+   * @param express true to enable express scheduling, false to disable it
+   */
+        void set_express(bool express) noexcept;
+
+        /**
+   * Release the express reservation of the link for a chunk that has arrived after its express hops.
+   * The link stays busy until the chunk is serialized.
+   *
+   * @param chunk chunk that has arrived, ignored if the link isn't reserved for it
+   */
+        void release_reservation(const Chunk* chunk) noexcept;
+
+        /**
+   * Enable or disable the analytical mode.
+   * An analytical link stands for a whole path of a congestion-unaware network dimension:
+   * each chunk is transmitted as soon as it arrives, and arrives after the closed-form delay
+   * (latency + serialization delay) in a single event, never waiting for the other chunks.
+   * Analytical links are never reserved by express or cut-through transmissions.
+   *
+   * @param analytical true to enable the analytical mode, false to disable it
    */
-        Link(Bandwidth bandwidth, Latency latency) noexcept;
+        void set_analytical(bool analytical) noexcept;
+
+        /**
+   * Check if the link is in analytical mode.
+   *
+   * @return true if the link is analytical, false otherwise
+   */
+        [[nodiscard]] bool is_analytical() const noexcept;
+
+        /**
+   * Get the bandwidth of the link.
+   *
+   * @return bandwidth of the link in GB/s
+   */
+        [[nodiscard]] Bandwidth get_bandwidth() const noexcept;
+
+        /**
+   * Get the latency of the link.
+   *
+   * @return latency of the link in ns
+   */
+        [[nodiscard]] Latency get_latency() const noexcept;
+
+        /**
+   * Get the time the link is busy until.
+   *
+   * @return time the link finishes serializing its last chunk
+   */
+        [[nodiscard]] EventTime get_busy_until() const noexcept;
 
         /**
    * Try to send a chunk through the link.
@@ -55,6 +262,7 @@ namespace NetworkAnalyticalCongestionAware {
         /**
    * Dequeue and try to send the first pending chunk
    * in the pending chunks list.
+   * If coalescing is enabled, every pending chunk is sent back-to-back.
    */
         void process_pending_transmission() noexcept;
 
@@ -66,33 +274,107 @@ namespace NetworkAnalyticalCongestionAware {
         [[nodiscard]] bool pending_chunk_exists() const noexcept;
 
         /**
-   * Set the link as busy.
-   */
-        void set_busy() noexcept;
-
-        /**
-   * Set the link as free.
+   * Check if the link is serializing a chunk (or reserved for one) at the current time.
+   *
+   * @return true if the link is busy, false otherwise
    */
-        void set_free() noexcept;
+        [[nodiscard]] bool is_busy() const noexcept;
 
     private:
-        /// event queue Link uses to schedule events
-        static std::shared_ptr<EventQueue> event_queue;
+        /// snapshots capture and restore the state of links
+        friend class Snapshot;
+
+        /// id of the device the link starts from
+        DeviceId src;
+
+        /// id of the device the link ends at
+        DeviceId dest;
 
         /// bandwidth of the link in GB/s
         Bandwidth bandwidth;
 
-        /// bandwidth of the link in B/ns, used in actual computation
-        Bandwidth bandwidth_Bpns;
+        /// state table owned by the link, if it's not registered to a shared one
+        std::unique_ptr<LinkStateTable> owned_link_states;
 
-        /// latency of the link in ns
-        Latency latency;
+        /// state table holding the busy-until time, the bandwidth (B/ns), and the latency of the link
+        LinkStateTable* link_states;
+
+        /// slot of the link in the state table
+        size_t slot;
 
         /// queue of pending chunks
-        std::list<std::unique_ptr<Chunk>> pending_chunks;
+        RingBuffer<std::unique_ptr<Chunk>> pending_chunks;
+
+        /// true if pending chunks are transmitted back-to-back
+        bool coalescing;
+
+        /// packet size of the cut-through mode, 0 if disabled
+        ChunkSize packet_size;
+
+        /// true if express scheduling is enabled
+        bool express;
+
+        /// true if chunks are transmitted in closed form, without contention
+        bool analytical;
+
+        /// chunk the link is reserved for in express mode, nullptr if not reserved
+        /// the reservation takes effect once the chunk would have arrived at the link's src device
+        Chunk* reserved_chunk;
 
-        /// flag to indicate if the link is busy
-        bool busy;
+        /// time the reserved chunk arrives at the link's src device
+        EventTime reservation_time;
+
+        /// event queue the link schedules its events on
+        EventQueue* event_queue;
+
+        /// mailbox to the partition owning the dest device in a parallel simulation
+        /// nullptr if the chunk arrival is scheduled on this link's event queue
+        ChunkMailbox* outbox;
+
+        /// tracer to record transmissions to, nullptr if tracing is disabled
+        Tracer* tracer;
+
+        /// batcher to defer the callbacks of arriving chunks to, nullptr if callbacks are not batched
+        CallbackBatcher* callback_batcher;
+
+        /// pool to allocate the packets of the cut-through mode from
+        ChunkPool* chunk_pool;
+
+#ifdef ANALYTICAL_TELEMETRY
+        /// telemetry table the link records its counters to
+        Telemetry* telemetry;
+
+        /// id of the link in the telemetry table
+        LinkId telemetry_id;
+
+        /// time each pending chunk started waiting, in the order of pending_chunks
+        RingBuffer<EventTime> pending_since;
+#endif
+
+        /**
+   * Constructor, registering the link to the given state table, or to a table of its own if nullptr.
+   *
+   * @param src id of the device the link starts from
+   * @param dest id of the device the link ends at
+   * @param bandwidth bandwidth of the link
+   * @param latency latency of the link
+   * @param link_states state table to register the link to, nullptr to own one
+   */
+        Link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, LinkStateTable* link_states) noexcept;
+
+        /**
+   * Set the time the link is busy until.
+   *
+   * @param busy_until time the link finishes serializing its last chunk
+   */
+        void set_busy_until(EventTime busy_until) noexcept;
+
+        /**
+   * Get the bandwidth of the link in B/ns.
+   *
+   * @return bandwidth of the link in B/ns
+   */
+        [[nodiscard]] Bandwidth get_bandwidth_Bpns() const noexcept;
 
         /**
    * Compute the serialization delay of a chunk on the link.
@@ -114,13 +396,59 @@ namespace NetworkAnalyticalCongestionAware {
 
         /**
    * Schedule the transmission of a chunk.
-   * - Set the link as busy.
-   * - Link becomes free after the serialization delay.
+   * - Link is busy until the serialization delay passes.
    * - Chunk arrives next node after the communication delay.
    *
    * @param chunk chunk to be transmitted
    */
         void schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+
+        /**
+   * Schedule the arrival of a chunk whose transmission starts at the given time.
+   *
+   * @param chunk chunk to be transmitted
+   * @param send_time time the link starts serializing the chunk
+   * @return time the link finishes serializing the chunk
+   */
+        EventTime transmit_chunk(std::unique_ptr<Chunk> chunk, EventTime send_time) noexcept;
+
+        /**
+   * Reserve the link in express mode for a chunk arriving at its src device later.
+   * The link should be idle.
+   *
+   * @param chunk chunk to reserve the link for
+   * @param arrival_time time the chunk arrives at the link's src device
+   * @return time the chunk arrives at the link's dest device
+   */
+        EventTime reserve(Chunk* chunk, EventTime arrival_time) noexcept;
+
+        /**
+   * Roll back the express reservation of the link, and the reservations after it on the route.
+   * The reserved chunk is then scheduled to arrive at the link's src device as usual.
+   */
+        void rollback_reservation() noexcept;
+
+        /**
+   * Find the link among the express hops of the chunk it's reserved for.
+   *
+   * @return index of the express hop, from 1 to the number of express hops of the chunk
+   */
+        [[nodiscard]] size_t reserved_hop() const noexcept;
+
+        /**
+   * Settle the express reservation of the link (if any) before the link is used at the current time:
+   * the reservation is in effect if the reserved chunk would have arrived at the link's src device by now,
+   * otherwise it's rolled back.
+   */
+        void settle_reservation() noexcept;
+
+        /**
+   * Dequeue the first pending chunk, recording its queuing delay if telemetry is enabled.
+   *
+   * @param send_time time the link starts transmitting the chunk
+   * @return the first pending chunk
+   */
+        [[nodiscard]] std::unique_ptr<Chunk> pop_pending_chunk(EventTime send_time) noexcept;
     };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,176 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstddef>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * LinkStateTable holds the state of the links a transmission touches per hop,
+ * as struct-of-arrays indexed by the slot of each link:
+ * the time each link is busy until, its bandwidth (B/ns), and its latency.
+ * The delays of a link are computed in fixed point (ps), by an integer multiply-add
+ * with the reciprocal bandwidth precomputed, and memoized for the last chunk size sent over the link,
+ * as a workload sends only a few chunk sizes.
+ * The delays of a hop are truncated to ns, as event times are, and no sub-ns remainder is carried
+ * to the next hop: a chunk forwarded over n hops may arrive less than n ns earlier than the exact sum.
+ * Only a cut-through transmission (see Link::cut_through()) accumulates its hops in ps.
+ *
+ * A topology owns a single table for all of its links, so the hot state of thousands of links
+ * stays in a few contiguous arrays, and scanning a field over many links (e.g., which links are busy)
+ * touches no Link object. Links keep their slot, and read and update their state through the table.
+ * Links are appended to the table as they're created, so slots equal LinkIds unless the links are lazy.
+ */
+    class LinkStateTable {
+    public:
+        /**
+   * Constructor.
+   */
+        LinkStateTable() noexcept;
+
+        /**
+   * Append the state of a new link.
+   * The link is free initially.
+   *
+   * @param bandwidth_Bpns bandwidth of the link in B/ns
+   * @param latency latency of the link in ns
+   * @return slot of the link
+   */
+        [[nodiscard]] size_t add_link(Bandwidth bandwidth_Bpns, Latency latency) noexcept;
+
+        /**
+   * Remove every link from the table.
+   */
+        void clear() noexcept;
+
+        /**
+   * Get the number of links in the table.
+   *
+   * @return number of links
+   */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+   * Get the time a link is busy until.
+   *
+   * @param slot slot of the link
+   * @return time the link finishes serializing its last chunk
+   */
+        [[nodiscard]] EventTime get_busy_until(size_t slot) const noexcept;
+
+        /**
+   * Set the time a link is busy until.
+   *
+   * @param slot slot of the link
+   * @param busy_until time the link finishes serializing its last chunk
+   */
+        void set_busy_until(size_t slot, EventTime busy_until) noexcept;
+
+        /**
+   * Get the bandwidth of a link.
+   *
+   * @param slot slot of the link
+   * @return bandwidth of the link in B/ns
+   */
+        [[nodiscard]] Bandwidth get_bandwidth_Bpns(size_t slot) const noexcept;
+
+        /**
+   * Get the latency of a link.
+   *
+   * @param slot slot of the link
+   * @return latency of the link in ns
+   */
+        [[nodiscard]] Latency get_latency(size_t slot) const noexcept;
+
+        /**
+   * Get the reciprocal bandwidth of a link, to compute its delays in ps (see serialization_delay_ps()).
+   *
+   * @param slot slot of the link
+   * @return reciprocal bandwidth of the link in ps/B
+   */
+        [[nodiscard]] ReciprocalBandwidth get_reciprocal_bandwidth(size_t slot) const noexcept;
+
+        /**
+   * Get the latency of a link in ps.
+   *
+   * @param slot slot of the link
+   * @return latency of the link in ps
+   */
+        [[nodiscard]] PicoTime get_latency_ps(size_t slot) const noexcept;
+
+        /**
+   * Get the serialization delay of a chunk on a link.
+   *
+   * @param slot slot of the link
+   * @param chunk_size size of the chunk
+   * @return serialization delay of the chunk in ns
+   */
+        [[nodiscard]] EventTime get_serialization_delay(size_t slot, ChunkSize chunk_size) noexcept;
+
+        /**
+   * Get the communication delay (latency + serialization delay) of a chunk on a link.
+   *
+   * @param slot slot of the link
+   * @param chunk_size size of the chunk
+   * @return communication delay of the chunk in ns
+   */
+        [[nodiscard]] EventTime get_communication_delay(size_t slot, ChunkSize chunk_size) noexcept;
+
+        /**
+   * Count the links busy at the given time.
+   *
+   * @param current_time time to check
+   * @return number of busy links
+   */
+        [[nodiscard]] size_t count_busy_links(EventTime current_time) const noexcept;
+
+    private:
+        /// delays of the last chunk size sent over a link
+        struct DelayMemo {
+            /// chunk size the delays are of, 0 if none
+            ChunkSize chunk_size;
+
+            /// serialization delay in ns
+            EventTime serialization_delay;
+
+            /// communication delay in ns
+            EventTime communication_delay;
+        };
+
+        /// time each link finishes serializing its last chunk, the link is busy until then
+        std::vector<EventTime> busy_until;
+
+        /// bandwidth of each link in B/ns, used in actual computation
+        std::vector<Bandwidth> bandwidth_Bpns;
+
+        /// latency of each link in ns
+        std::vector<Latency> latency;
+
+        /// reciprocal bandwidth of each link in ps/B
+        std::vector<ReciprocalBandwidth> reciprocal_bandwidth;
+
+        /// latency of each link in ps
+        std::vector<PicoTime> latency_ps;
+
+        /// delays of the last chunk size sent over each link
+        std::vector<DelayMemo> delay_memos;
+
+        /**
+   * Get the delays of a chunk on a link, computing them unless memoized.
+   *
+   * @param slot slot of the link
+   * @param chunk_size size of the chunk
+   * @return delays of the chunk on the link
+   */
+        [[nodiscard]] const DelayMemo& get_delays(size_t slot, ChunkSize chunk_size) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,122 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include "congestion_aware/Topology.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * MultiDimTopology implements multi-dimensional network topologies
+ * which can be constructed by stacking up multiple BasicTopology instances.
+ *
+ * NPU IDs are laid out dimension by dimension, the first dimension being the innermost:
+ * e.g., if the topology size is [2, 8, 4], NPU 47 has the address [1, 7, 2],
+ * and its dim-1 neighbors are NPU 47 +- 2 (i.e., the stride of dim 1 is 2).
+ * Non-NPU devices (e.g., switches) follow the NPUs, grouped by dimension,
+ * then by the dimension instance they belong to.
+ *
+ * Chunks are routed in dimension order: the route of each dimension is
+ * the route of its BasicTopology, translated to global device IDs by stride arithmetic.
+ * Therefore, no route is stored per NPU pair.
+ *
+ * A dimension can be simulated at DimensionFidelity::CongestionUnaware instead:
+ * at its every instance, each NPU pair is connected by a single analytical link
+ * whose latency is the latency of the route of the dimension, and which never queues.
+ * Crossing the dimension then takes (hops * latency + chunk_size / bandwidth) in a single event,
+ * the closed-form delay of the congestion-unaware backend, and no device or link of the dimension is instantiated.
+ */
+    class MultiDimTopology final : public Topology {
+    public:
+        /**
+   * Constructor.
+   */
+        MultiDimTopology() noexcept;
+
+        /**
+   * Add a dimension to the multi-dimensional topology.
+   * The devices and links of the topology are rebuilt,
+   * so dimensions should be appended before the topology is used.
+   *
+   * @param basic_topology BasicTopology instance to be added.
+   * @param fidelity fidelity the dimension is simulated at
+   */
+        void append_dimension(std::unique_ptr<BasicTopology> basic_topology,
+                              DimensionFidelity fidelity = DimensionFidelity::CongestionAware) noexcept;
+
+        /**
+   * Get the BasicTopology of a dimension.
+   *
+   * @param dim dimension
+   * @return BasicTopology instance of the dimension
+   */
+        [[nodiscard]] const BasicTopology* get_topology_of_dim(int dim) const noexcept;
+
+        /**
+   * Get the fidelity of a dimension.
+   *
+   * @param dim dimension
+   * @return fidelity the dimension is simulated at
+   */
+        [[nodiscard]] DimensionFidelity get_fidelity_of_dim(int dim) const noexcept;
+
+    private:
+        /// BasicTopology instances per dimension.
+        std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
+
+        /// simulation fidelity per each dimension
+        std::vector<DimensionFidelity> fidelity_per_dim;
+
+        /// NPU ID distance between two neighboring NPUs of each dimension
+        std::vector<int> stride_per_dim;
+
+        /// device ID of the first non-NPU device of each dimension
+        std::vector<DeviceId> extra_devices_offset_per_dim;
+
+        /**
+   * Implementation of compute_route function in Topology.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Instantiate the devices, and connect every instance of every dimension.
+   */
+        void build_dimensions() noexcept;
+
+        /**
+   * Connect every NPU pair of every instance of an unaware dimension by an analytical link.
+   *
+   * @param dim dimension
+   */
+        void connect_analytical_dimension(int dim) noexcept;
+
+        /**
+   * Get the address of an NPU in a dimension.
+   *
+   * @param dim dimension
+   * @param npu_id id of the NPU
+   * @return local id of the NPU within its dim-instance
+   */
+        [[nodiscard]] DeviceId local_address(int dim, DeviceId npu_id) const noexcept;
+
+        /**
+   * Translate a local device ID of a dim-instance to the global device ID.
+   *
+   * @param dim dimension
+   * @param npu_id id of any NPU within the dim-instance
+   * @param local_id device id local to the BasicTopology of the dimension
+   * @return global device id
+   */
+        [[nodiscard]] DeviceId global_id(int dim, DeviceId npu_id, DeviceId local_id) const noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
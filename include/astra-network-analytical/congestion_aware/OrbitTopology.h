@@ -0,0 +1,86 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include "congestion_aware/Topology.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * OrbitTopology is the quotient of a rotation-symmetric topology (Ring, Switch, or FullyConnected)
+ * by the rotation of its NPUs (npu -> npu + 1 mod N).
+ *
+ * Every NPU falls into a single orbit, represented by NPU 0, and so does the switch of a Switch.
+ * A link of the quotient stands for the orbit of a link under the rotation:
+ * src -> dest is keyed by rotating its NPU endpoint to NPU 0.
+ *   - Ring: the clockwise link (and the anticlockwise one, if bidirectional), self-loops of NPU 0
+ *   - Switch: the uplink NPU 0 -> switch, and the downlink switch -> NPU 0
+ *   - FullyConnected: a link of each offset 0 -> k, self-loops of NPU 0
+ *
+ * If the traffic is rotation-invariant (i.e., NPU n sends whatever NPU 0 sends, to the dest rotated by n),
+ * every link of an orbit sees the same chunks at the same times, up to the rotation.
+ * Therefore, simulating only the chunks of NPU 0 over the quotient links reproduces the full simulation:
+ * a chunk 0 -> d crossing the quotient links stands for the chunk (n - d) -> n arriving at every NPU n.
+ * This takes O(N) links and chunks instead of O(N^2). See Collective::set_symmetry_reduction().
+ */
+    class OrbitTopology final : public Topology {
+    public:
+        /**
+   * Check if a topology can be reduced to its rotation orbits.
+   *
+   * @param topology topology to check
+   * @return true if the topology is a congestion-aware Ring, Switch, or FullyConnected
+   */
+        [[nodiscard]] static bool reducible(const Topology& topology) noexcept;
+
+        /**
+   * Constructor.
+   * The links of the topology are traversed to build the quotient, but aren't sent over.
+   *
+   * @param topology topology to reduce, which should be reducible
+   */
+        explicit OrbitTopology(const BasicTopology& topology) noexcept;
+
+        /**
+   * Get the number of NPUs of the reduced topology, all represented by NPU 0.
+   *
+   * @return number of NPUs of the reduced topology
+   */
+        [[nodiscard]] int get_represented_npus_count() const noexcept;
+
+        /**
+   * Create a chunk from NPU 0 to an NPU of the reduced topology, routed over the quotient links.
+   *
+   * @param chunk_size size of the chunk
+   * @param dest dest NPU id of the reduced topology, other than 0
+   * @param callback callback to be invoked when the chunk arrives dest
+   * @param callback_arg argument of the callback
+   * @return the created chunk
+   */
+        [[nodiscard]] std::unique_ptr<Chunk> make_orbit_chunk(ChunkSize chunk_size, DeviceId dest,
+                                                              Callback callback, CallbackArg callback_arg) noexcept;
+
+    private:
+        /**
+   * Implementation of compute_route function in Topology.
+   * The quotient has a single NPU: chunks are routed by make_orbit_chunk() instead.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+        /// number of NPUs of the reduced topology
+        int represented_npus_count;
+
+        /// quotient links of the route from NPU 0 to each NPU of the reduced topology, indexed by dest
+        std::vector<std::vector<LinkId>> orbit_routes;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
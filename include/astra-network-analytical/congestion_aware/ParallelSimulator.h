@@ -0,0 +1,324 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * ParallelSimulator runs a congestion-aware simulation on multiple threads,
+ * using conservative parallel discrete-event simulation.
+ *
+ * Devices are partitioned into contiguous ID ranges, each with its own EventQueue
+ * processed by a dedicated worker thread. Chunks crossing partitions are handed over through outboxes.
+ * Workers advance in synchronous windows [T, T + lookahead), where T is the earliest pending event time
+ * across all partitions and the lookahead is the minimum latency of the links crossing partitions.
+ * A chunk sent within a window cannot arrive at another partition within the same window,
+ * so partitions run each window independently.
+ *
+ * Every event due past the window, including the chunks handed over, is held until the window barrier,
+ * and then scheduled in the order the sequential simulation would have scheduled it:
+ * by time, then by the order of the events scheduling them, traced back through their ancestors
+ * down to the events scheduled in an earlier window or before the run.
+ * Hence the events are invoked in the exact sequential order, and the results are identical.
+ * Express scheduling isn't supported, as its relayed arrivals can't be held.
+ *
+ * While the ParallelSimulator is alive, links of the topology schedule their events
+ * on the event queue of their partition, so chunks can be sent with Topology::send() as usual.
+ * The callback of a chunk is invoked by the worker owning the chunk's destination device,
+ * therefore callbacks of different partitions may run concurrently.
+ * For the same reason, the topology is in its concurrent mode meanwhile (see Topology::set_concurrent()).
+ */
+    class ParallelSimulator {
+    public:
+        /**
+   * Constructor.
+   * Partitions the devices of the topology and binds its links to the partitions.
+   *
+   * @param topology topology to simulate
+   * @param partitions_count number of partitions, i.e., worker threads
+   */
+        ParallelSimulator(std::shared_ptr<Topology> topology, int partitions_count) noexcept;
+
+        /**
+   * Destructor.
+   * Binds the links of the topology back to the event queue of the topology.
+   */
+        ~ParallelSimulator() noexcept;
+
+        ParallelSimulator(const ParallelSimulator&) = delete;
+
+        ParallelSimulator& operator=(const ParallelSimulator&) = delete;
+
+        /**
+   * Get the number of partitions.
+   *
+   * @return number of partitions
+   */
+        [[nodiscard]] int get_partitions_count() const noexcept;
+
+        /**
+   * Get the partition owning a device.
+   *
+   * @param device id of the device
+   * @return partition of the device
+   */
+        [[nodiscard]] int get_partition(DeviceId device) const noexcept;
+
+        /**
+   * Get the event queue of the partition owning a device.
+   * Chunk callbacks of chunks destined to the device should read the time from this queue.
+   *
+   * @param device id of the device
+   * @return event queue of the device's partition
+   */
+        [[nodiscard]] EventQueue* get_event_queue(DeviceId device) const noexcept;
+
+        /**
+   * Get the lookahead, i.e., the size of a synchronization window.
+   *
+   * @return lookahead in ns
+   */
+        [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+        /**
+   * Get the time of the latest event invoked among all partitions.
+   *
+   * @return current time of the simulation
+   */
+        [[nodiscard]] EventTime get_current_time() const noexcept;
+
+        /**
+   * Run the simulation until every partition runs out of events.
+   *
+   * @return summary of the execution, accumulated over all partitions
+   */
+        RunSummary run() noexcept;
+
+    private:
+        /// index of the invocation when no event is in progress
+        static constexpr uint64_t no_invocation = std::numeric_limits<uint64_t>::max();
+
+        /**
+   * Origin of an event, to order the events of the same time as the sequential simulation.
+   */
+        struct EventOrigin {
+            /// true if the event is scheduled by an event invoked in the current window
+            bool in_window;
+
+            /// index of the scheduling event among the invocations of its partition if in_window,
+            /// the rank of the event in the sequential order otherwise
+            uint64_t index;
+        };
+
+        /**
+   * Event invoked in the current window.
+   */
+        struct Invocation {
+            /// time of the event
+            EventTime time;
+
+            /// origin of the event
+            EventOrigin origin;
+        };
+
+        /**
+   * Event held until the window barrier.
+   */
+        struct HeldEvent {
+            /// time of the event
+            EventTime time;
+
+            /// origin of the event
+            EventOrigin origin;
+
+            /// partition to invoke the event
+            int partition;
+
+            /// callback function pointer
+            Callback callback;
+
+            /// argument of the callback function
+            CallbackArg callback_arg;
+        };
+
+        struct Partition;
+
+        /**
+   * Event scheduled on a partition, carrying its origin until it's invoked.
+   */
+        struct TrackedEvent {
+            /// partition of the event
+            Partition* partition;
+
+            /// origin of the event
+            EventOrigin origin;
+
+            /// callback function pointer
+            Callback callback;
+
+            /// argument of the callback function
+            CallbackArg callback_arg;
+        };
+
+        /**
+   * State of a partition, touched only by its worker within a window.
+   */
+        struct Partition {
+            /// simulator of the partition
+            ParallelSimulator* simulator = nullptr;
+
+            /// id of the partition
+            int id = 0;
+
+            /// event queue of the partition
+            std::unique_ptr<EventQueue> event_queue;
+
+            /// end of the current window (inclusive)
+            EventTime window_end = 0;
+
+            /// events invoked in the current window, in order
+            std::vector<Invocation> invocations;
+
+            /// index of the invocation in progress, no_invocation if none
+            uint64_t invocation = no_invocation;
+
+            /// events scheduled by this partition past the window, in the order scheduled
+            std::vector<HeldEvent> held_events;
+
+            /// chunks handed over by the links crossing from this partition within the window, in the order sent
+            ChunkMailbox outbox;
+
+            /// tracked events, with stable addresses
+            std::deque<TrackedEvent> tracked_events;
+
+            /// tracked events free to reuse
+            std::vector<TrackedEvent*> free_tracked_events;
+
+            /// held events to schedule on this partition, in the order to schedule them
+            std::vector<HeldEvent> deliveries;
+        };
+
+        /// simulated topology
+        std::shared_ptr<Topology> topology;
+
+        /// number of partitions
+        int partitions_count;
+
+        /// partition_of_device[device id] -> partition
+        std::vector<int> partition_of_device;
+
+        /// state per partition
+        std::vector<std::unique_ptr<Partition>> partitions;
+
+        /// outbox of every link crossing partitions while not running, in the order sent
+        ChunkMailbox idle_outbox;
+
+        /// true while run() is in progress
+        bool running;
+
+        /// rank of the next event in the sequential order, among the events held so far
+        uint64_t next_rank;
+
+        /// lookahead of the simulation
+        EventTime lookahead;
+
+        /**
+   * Bind the links crossing partitions to the outboxes of the current mode (running or not).
+   */
+        void bind_outboxes() noexcept;
+
+        /**
+   * Intercept an event scheduled on a partition: track it if it's due within the window, hold it otherwise.
+   * See ScheduleHook.
+   *
+   * @param partition_ptr partition the event is scheduled on
+   * @param event_time time of the event
+   * @param callback callback function pointer, replaced if the event is tracked
+   * @param callback_arg argument of the callback function, replaced if the event is tracked
+   * @return true if the event is held, false otherwise
+   */
+        static bool intercept_event(void* partition_ptr,
+                                    EventTime event_time,
+                                    Callback& callback,
+                                    CallbackArg& callback_arg) noexcept;
+
+        /**
+   * Invoke a tracked event, logging its invocation as the origin of the events it schedules.
+   *
+   * @param tracked_event_ptr tracked event
+   */
+        static void invoke_tracked_event(void* tracked_event_ptr) noexcept;
+
+        /**
+   * Track an event, to invoke it by invoke_tracked_event().
+   *
+   * @param partition partition of the event
+   * @param origin origin of the event
+   * @param callback callback function pointer
+   * @param callback_arg argument of the callback function
+   * @return tracked event
+   */
+        [[nodiscard]] static TrackedEvent* track_event(Partition& partition,
+                                                       EventOrigin origin,
+                                                       Callback callback,
+                                                       CallbackArg callback_arg) noexcept;
+
+        /**
+   * Hold the chunks handed over to the idle outbox, ranked in the order sent.
+   */
+        void hold_idle_handovers() noexcept;
+
+        /**
+   * Hold the chunks handed over to an outbox.
+   *
+   * @param partition partition holding the chunks
+   * @param outbox outbox of the chunks
+   * @param origin origin of the chunks
+   */
+        void hold_handovers(Partition& partition, ChunkMailbox& outbox, EventOrigin origin) const noexcept;
+
+        /**
+   * Compare two held events of the same partition or of different ones in the sequential order.
+   *
+   * @param lhs_partition partition holding the first event
+   * @param lhs first event
+   * @param rhs_partition partition holding the second event
+   * @param rhs second event
+   * @return true if the first event is scheduled before the second one sequentially, false otherwise
+   */
+        [[nodiscard]] bool precedes(int lhs_partition,
+                                    const HeldEvent& lhs,
+                                    int rhs_partition,
+                                    const HeldEvent& rhs) const noexcept;
+
+        /**
+   * Merge the held events of every partition in the sequential order, ranking them
+   * and handing them over to the partitions to invoke them.
+   * The held events of each partition should be sorted by time.
+   */
+        void merge_held_events() noexcept;
+
+        /**
+   * Schedule the held events handed over to a partition at the barrier.
+   *
+   * @param partition partition to schedule the events
+   */
+        static void deliver_held_events(Partition& partition) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
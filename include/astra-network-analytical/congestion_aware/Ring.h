@@ -41,12 +41,12 @@ namespace NetworkAnalyticalCongestionAware {
    */
         Ring(int npus_count, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
+    private:
         /**
-   * Implementation of route function in Topology.
+   * Implementation of compute_route function in Topology.
    */
-        [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
 
-    private:
         /// true if the ring is bidirectional, false otherwise
         bool bidirectional;
     };
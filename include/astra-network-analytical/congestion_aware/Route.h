@@ -0,0 +1,167 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Route is a sequence of devices that a chunk traverses,
+ * including the src and dest devices themselves.
+ *
+ * A route is stored as its src device and the LinkId of each hop,
+ * resolved through the link table of the topology.
+ * Therefore, forwarding a chunk looks up its next link directly,
+ * and traversing a route neither allocates nor touches reference counts.
+ * Routes up to inline_capacity hops are kept inline, longer ones in a single heap buffer.
+ * A route may instead reference an interned link sequence (e.g., of a RouteCache),
+ * in which case copying the route copies no hops at all.
+ * The route keeps a cursor to the current device: devices before the cursor are already traversed.
+ */
+    class Route {
+    public:
+        /// number of hops stored without a heap allocation
+        static constexpr size_t inline_capacity = 8;
+
+        /**
+   * Constructor.
+   *
+   * @param topology topology the route belongs to
+   */
+        explicit Route(const Topology& topology) noexcept;
+
+        /**
+   * Constructor of a route referencing an interned link sequence.
+   * The interned sequence must outlive the route, and can't be appended through the route.
+   *
+   * @param topology topology the route belongs to
+   * @param src src device id of the route
+   * @param interned_links interned link ids of the route
+   */
+        Route(const Topology& topology, DeviceId src, const std::vector<LinkId>& interned_links) noexcept;
+
+        /**
+   * Constructor of a route referencing an interned array of link ids (e.g., of a CompiledTopology).
+   * The interned array must outlive the route.
+   *
+   * @param topology topology the route belongs to
+   * @param src src device id of the route
+   * @param interned_links interned link ids of the route
+   * @param links_count number of hops of the route
+   */
+        Route(const Topology& topology, DeviceId src, const LinkId* interned_links, size_t links_count) noexcept;
+
+        /**
+   * Append a device at the end of the route.
+   * The device must be connected to the last device of the route.
+   *
+   * @param device id of the device
+   */
+        void push_back(DeviceId device) noexcept;
+
+        /**
+   * Check if no device is left in the route.
+   *
+   * @return true if the route is empty, false otherwise
+   */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+   * Get the number of devices left in the route, including the current device.
+   *
+   * @return number of devices left
+   */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+   * Get the id of a device left in the route.
+   *
+   * @param index index of the device from the current device (0 for the current device)
+   * @return id of the device
+   */
+        [[nodiscard]] DeviceId at(size_t index) const noexcept;
+
+        /**
+   * Get a device left in the route.
+   *
+   * @param index index of the device from the current device (0 for the current device)
+   * @return pointer to the device
+   */
+        [[nodiscard]] Device* device(size_t index) const noexcept;
+
+        /**
+   * Get the id of a link left in the route.
+   *
+   * @param index index of the link from the current device (0 for the link to the next device)
+   * @return id of the link
+   */
+        [[nodiscard]] LinkId link_id(size_t index) const noexcept;
+
+        /**
+   * Get a link left in the route.
+   *
+   * @param index index of the link from the current device (0 for the link to the next device)
+   * @return pointer to the link
+   */
+        [[nodiscard]] Link* link(size_t index) const noexcept;
+
+        /**
+   * Drop the current device from the route,
+   * i.e., the next device becomes the current device.
+   */
+        void pop_front() noexcept;
+
+        /**
+   * Get a route referencing the devices left in this route, without copying its hops.
+   * This route must outlive the shared route, and must not be appended meanwhile.
+   *
+   * @return route starting at the current device of this route
+   */
+        [[nodiscard]] Route share() const noexcept;
+
+    private:
+        /// topology the route belongs to
+        const Topology* topology;
+
+        /// src device of the route, -1 if the route has no device
+        DeviceId src;
+
+        /// last device of the route, to resolve the link of the next hop
+        DeviceId last_device;
+
+        /// number of hops in the route, including the traversed ones
+        uint32_t links_count;
+
+        /// number of devices dropped from the route
+        uint32_t cursor;
+
+        /// hops of the route, if the route is interned
+        const LinkId* interned_links;
+
+        /// hops of the route, if links_count <= inline_capacity
+        std::array<LinkId, inline_capacity> inline_links;
+
+        /// hops of the route, if links_count > inline_capacity
+        std::vector<LinkId> heap_links;
+
+        /**
+   * Get the id of a hop, counted from the src.
+   *
+   * @param position index of the hop from the src
+   * @return id of the link
+   */
+        [[nodiscard]] LinkId link_id_at(size_t position) const noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,126 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * RouteCache interns the routes of a topology, keyed by (src, dest).
+ *
+ * Each route is stored once as a sequence of LinkIds,
+ * and Routes handed to chunks reference the interned sequence.
+ * Interned routes are never evicted, as chunks in flight may reference them:
+ * once the memory cap is reached, new routes are simply not cached anymore.
+ */
+    class RouteCache {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param devices_count number of devices of the topology
+   * @param memory_cap maximum memory (in bytes) the cache may use
+   */
+        RouteCache(int devices_count, size_t memory_cap) noexcept;
+
+        /**
+   * Look up the interned route from src to dest.
+   * Counts a hit or a miss.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @return interned route, nullptr if not cached
+   */
+        [[nodiscard]] const std::vector<LinkId>* find(DeviceId src, DeviceId dest) noexcept;
+
+        /**
+   * Intern the route from src to dest.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @param route route from src to dest
+   * @return interned route, nullptr if the memory cap doesn't allow it
+   */
+        const std::vector<LinkId>* insert(DeviceId src, DeviceId dest, const Route& route) noexcept;
+
+        /**
+   * Get the number of interned routes.
+   *
+   * @return number of interned routes
+   */
+        [[nodiscard]] size_t get_routes_count() const noexcept;
+
+        /**
+   * Get the number of lookups that found an interned route.
+   *
+   * @return number of cache hits
+   */
+        [[nodiscard]] uint64_t get_hits_count() const noexcept;
+
+        /**
+   * Get the number of lookups that didn't find an interned route.
+   *
+   * @return number of cache misses
+   */
+        [[nodiscard]] uint64_t get_misses_count() const noexcept;
+
+        /**
+   * Get the memory used by the interned routes.
+   *
+   * @return memory usage in bytes
+   */
+        [[nodiscard]] size_t get_memory_usage() const noexcept;
+
+        /**
+   * Get the memory cap of the cache.
+   *
+   * @return memory cap in bytes
+   */
+        [[nodiscard]] size_t get_memory_cap() const noexcept;
+
+    private:
+        /// estimated bookkeeping memory per interned route (hash node and vector header)
+        static constexpr size_t entry_overhead = sizeof(std::pair<const int64_t, std::vector<LinkId>>) + 2 * sizeof(void*);
+
+        /// number of devices of the topology
+        int devices_count;
+
+        /// maximum memory the cache may use
+        size_t memory_cap;
+
+        /// memory used by the interned routes
+        size_t memory_usage;
+
+        /// interned routes, keyed by (src * devices_count + dest)
+        /// unordered_map never moves its elements, so interned routes stay valid
+        std::unordered_map<int64_t, std::vector<LinkId>> routes;
+
+        /// number of cache hits
+        uint64_t hits_count;
+
+        /// number of cache misses
+        uint64_t misses_count;
+
+        /**
+   * Compute the key of (src, dest).
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @return key of the route
+   */
+        [[nodiscard]] int64_t key(DeviceId src, DeviceId dest) const noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
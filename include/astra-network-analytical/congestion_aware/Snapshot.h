@@ -0,0 +1,175 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include "congestion_aware/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Snapshot is a checkpoint of a congestion-aware simulation:
+ * the current time, the pending events of the event queue,
+ * the busy-until time and the pending chunks of every link, and the chunks in flight with their routes.
+ *
+ * As callbacks and their arguments are raw pointers, they're stored as handles:
+ * the user maps them to handles on capture, and back to (possibly different) callbacks on restore.
+ * This applies to the chunk callbacks and to the events scheduled by the user.
+ *
+ * A snapshot can be saved to a compact binary file, and restored into any number of topologies
+ * built from the same network configuration, so what-if branches can resume from a shared prefix.
+ * Telemetry counters are not part of the snapshot.
+ * Capturing while chunks are in flight over express reservations or as cut-through packets,
+ * or while a ParallelSimulator is alive, is not supported.
+ */
+    class Snapshot {
+    public:
+        /**
+   * Capture the state of a topology and its event queue.
+   * The event queue shouldn't be proceeding, e.g., capture between run_until() calls.
+   *
+   * @param topology topology to capture
+   * @param encoder maps chunk callbacks and user events to handles
+   * @return captured snapshot
+   */
+        [[nodiscard]] static Snapshot capture(const Topology& topology, const CallbackEncoder& encoder) noexcept;
+
+        /**
+   * Load a snapshot from a binary file.
+   *
+   * @param path path of the snapshot file
+   * @return loaded snapshot
+   */
+        [[nodiscard]] static Snapshot load(const std::string& path) noexcept;
+
+        /**
+   * Save the snapshot to a binary file.
+   *
+   * @param path path of the snapshot file
+   */
+        void save(const std::string& path) const noexcept;
+
+        /**
+   * Restore the snapshot into a topology, which should be built from the same network configuration,
+   * bound to an empty event queue, and have no chunks in it.
+   *
+   * @param topology topology to restore into
+   * @param decoder maps handles back to chunk callbacks and user events
+   */
+        void restore(Topology& topology, const CallbackDecoder& decoder) const noexcept;
+
+        /**
+   * Get the simulation time of the snapshot.
+   *
+   * @return time the snapshot is captured at
+   */
+        [[nodiscard]] EventTime get_time() const noexcept;
+
+        /**
+   * Get the number of pending events in the snapshot.
+   *
+   * @return number of pending events
+   */
+        [[nodiscard]] size_t get_events_count() const noexcept;
+
+        /**
+   * Get the number of chunks in the snapshot, either in flight or pending in a link.
+   *
+   * @return number of chunks
+   */
+        [[nodiscard]] size_t get_chunks_count() const noexcept;
+
+    private:
+        /// state of a chunk
+        struct ChunkState {
+            /// size of the chunk
+            ChunkSize chunk_size;
+
+            /// handle of the callback
+            CallbackHandle callback;
+
+            /// rest of the route, starting from the current device
+            std::vector<DeviceId> route;
+        };
+
+        /// state of a link
+        struct LinkState {
+            /// time the link becomes free
+            EventTime busy_until;
+
+            /// pending chunks, in order
+            std::vector<ChunkState> pending_chunks;
+        };
+
+        /// kinds of pending events
+        enum class EventKind : uint32_t { ChunkArrival, LinkFree, UserEvent };
+
+        /// state of a pending event
+        struct EventState {
+            /// time of the event
+            EventTime time;
+
+            /// kind of the event
+            EventKind kind;
+
+            /// link becoming free, if kind is LinkFree
+            LinkId link;
+
+            /// handle of the callback, if kind is UserEvent
+            CallbackHandle callback;
+
+            /// arriving chunk, if kind is ChunkArrival
+            ChunkState chunk;
+        };
+
+        /// current time
+        EventTime time;
+
+        /// number of devices of the topology
+        int devices_count;
+
+        /// state of every link, indexed by LinkId
+        std::vector<LinkState> links;
+
+        /// pending events, in the order they would be invoked
+        std::vector<EventState> events;
+
+        /**
+   * Constructor.
+   */
+        Snapshot() noexcept;
+
+        /**
+   * Capture the state of a chunk.
+   *
+   * @param chunk chunk to capture
+   * @param encoder maps the chunk callback to a handle
+   * @return state of the chunk
+   */
+        [[nodiscard]] static ChunkState capture_chunk(const Chunk& chunk, const CallbackEncoder& encoder) noexcept;
+
+        /**
+   * Recreate a chunk from its state, allocated from the chunk pool of the topology.
+   *
+   * @param topology topology to create the chunk in
+   * @param chunk state of the chunk
+   * @param decoder maps the handle back to the chunk callback
+   * @return recreated chunk
+   */
+        [[nodiscard]] static std::unique_ptr<Chunk> restore_chunk(Topology& topology,
+                                                                  const ChunkState& chunk,
+                                                                  const CallbackDecoder& decoder) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
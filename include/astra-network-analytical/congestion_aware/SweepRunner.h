@@ -0,0 +1,86 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /// SweepWorkload initiates the chunk transmissions of a sweep configuration on the given topology
+    using SweepWorkload = std::function<void(Topology& topology)>;
+
+    /**
+ * SweepRunner runs independent simulations of multiple configurations
+ * in parallel on a pool of worker threads.
+ *
+ * Each configuration is a network input file and a workload.
+ * Every simulation constructs its own topology bound to its own event queue,
+ * so the simulations don't share any state.
+ * A workload may be invoked by any worker thread.
+ */
+    class SweepRunner {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param threads_count number of worker threads
+   */
+        explicit SweepRunner(int threads_count) noexcept;
+
+        /**
+   * Add a configuration to the sweep.
+   *
+   * @param network_config_path path of the network input file
+   * @param workload workload to run on the network
+   */
+        void add_config(const std::string& network_config_path, SweepWorkload workload) noexcept;
+
+        /**
+   * Get the number of configurations in the sweep.
+   *
+   * @return number of configurations
+   */
+        [[nodiscard]] int get_configs_count() const noexcept;
+
+        /**
+   * Simulate every configuration until its event queue is drained.
+   *
+   * @return finish time per configuration, in the order added
+   */
+        [[nodiscard]] std::vector<EventTime> run() const noexcept;
+
+    private:
+        /// configuration of a single simulation
+        struct SweepConfig {
+            /// path of the network input file
+            std::string network_config_path;
+
+            /// workload to run on the network
+            SweepWorkload workload;
+        };
+
+        /// number of worker threads
+        int threads_count;
+
+        /// configurations to simulate
+        std::vector<SweepConfig> configs;
+
+        /**
+   * Simulate a single configuration.
+   *
+   * @param config configuration to simulate
+   * @return finish time of the simulation
+   */
+        [[nodiscard]] static EventTime run_config(const SweepConfig& config) noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
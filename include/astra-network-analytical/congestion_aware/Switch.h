@@ -39,12 +39,12 @@ namespace NetworkAnalyticalCongestionAware {
    */
         Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
+    private:
         /**
-   * Implementation of route function in Topology.
+   * Implementation of compute_route function in Topology.
    */
-        [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
 
-    private:
         /// node_id of the switch node
         DeviceId switch_id;
     };
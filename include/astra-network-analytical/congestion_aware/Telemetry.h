@@ -0,0 +1,238 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Telemetry records per-link counters of a topology:
+ * bytes sent, busy time, pending chunks depth, and queuing delay of the chunks waiting for the link.
+ *
+ * Counters are stored as a struct of arrays indexed by LinkId,
+ * so that the links only touch the arrays they update.
+ * The links record their counters only if the backend is compiled with ANALYTICAL_TELEMETRY
+ * (CMake option NETWORK_BACKEND_TELEMETRY), otherwise the instrumentation is compiled out.
+ */
+    class Telemetry {
+    public:
+        /**
+   * Constructor.
+   */
+        Telemetry() noexcept;
+
+        /**
+   * Register a link, growing the counter arrays if needed.
+   *
+   * @param id id of the link
+   * @param src id of the device the link starts from
+   * @param dest id of the device the link ends at
+   */
+        void register_link(LinkId id, DeviceId src, DeviceId dest) noexcept;
+
+        /**
+   * Grow the counter arrays to hold a number of links upfront,
+   * so that links are registered later without reallocating the arrays, e.g., while other threads record theirs.
+   *
+   * @param links_count number of links
+   */
+        void reserve_links(int links_count) noexcept;
+
+        /**
+   * Get the number of registered links.
+   *
+   * @return number of links
+   */
+        [[nodiscard]] int get_links_count() const noexcept;
+
+        /**
+   * Record a chunk transmitted over a link.
+   *
+   * @param id id of the link
+   * @param chunk_size size of the chunk
+   * @param busy_time time the link is occupied by the chunk
+   */
+        void record_transmission(LinkId id, ChunkSize chunk_size, EventTime busy_time) noexcept;
+
+        /**
+   * Cancel a recorded transmission, e.g., of a rolled back express reservation.
+   *
+   * @param id id of the link
+   * @param chunk_size size of the chunk
+   * @param busy_time time the link would have been occupied by the chunk
+   */
+        void cancel_transmission(LinkId id, ChunkSize chunk_size, EventTime busy_time) noexcept;
+
+        /**
+   * Record a change of the number of pending chunks of a link.
+   *
+   * @param id id of the link
+   * @param current_time time of the change
+   * @param depth number of pending chunks after the change
+   */
+        void record_pending_depth(LinkId id, EventTime current_time, size_t depth) noexcept;
+
+        /**
+   * Record the time a chunk waited in the pending chunks of a link.
+   *
+   * @param id id of the link
+   * @param queuing_delay time the chunk waited
+   */
+        void record_queuing_delay(LinkId id, EventTime queuing_delay) noexcept;
+
+        /**
+   * Get the number of bytes sent over a link.
+   *
+   * @param id id of the link
+   * @return bytes sent
+   */
+        [[nodiscard]] ChunkSize get_bytes_sent(LinkId id) const noexcept;
+
+        /**
+   * Get the number of chunks sent over a link.
+   *
+   * @param id id of the link
+   * @return chunks sent
+   */
+        [[nodiscard]] uint64_t get_chunks_sent(LinkId id) const noexcept;
+
+        /**
+   * Get the cumulative time a link has been busy.
+   *
+   * @param id id of the link
+   * @return busy time in ns
+   */
+        [[nodiscard]] EventTime get_busy_time(LinkId id) const noexcept;
+
+        /**
+   * Get the maximum number of pending chunks of a link.
+   *
+   * @param id id of the link
+   * @return maximum pending chunks depth
+   */
+        [[nodiscard]] size_t get_max_pending_depth(LinkId id) const noexcept;
+
+        /**
+   * Get the time-weighted average number of pending chunks of a link.
+   *
+   * @param id id of the link
+   * @param end_time time the average is taken until, usually the finish time of the simulation
+   * @return average pending chunks depth
+   */
+        [[nodiscard]] double get_average_pending_depth(LinkId id, EventTime end_time) const noexcept;
+
+        /**
+   * Get the number of chunks that waited for a link.
+   *
+   * @param id id of the link
+   * @return number of queued chunks
+   */
+        [[nodiscard]] uint64_t get_queued_chunks(LinkId id) const noexcept;
+
+        /**
+   * Get the average queuing delay of the chunks that waited for a link.
+   *
+   * @param id id of the link
+   * @return average queuing delay in ns, 0 if no chunk waited
+   */
+        [[nodiscard]] double get_average_queuing_delay(LinkId id) const noexcept;
+
+        /**
+   * Get the maximum queuing delay of the chunks that waited for a link.
+   *
+   * @param id id of the link
+   * @return maximum queuing delay in ns
+   */
+        [[nodiscard]] EventTime get_max_queuing_delay(LinkId id) const noexcept;
+
+        /**
+   * Write the counters as CSV, a row per link.
+   *
+   * @param out stream to write to
+   * @param end_time finish time of the simulation
+   */
+        void write_csv(std::ostream& out, EventTime end_time) const noexcept;
+
+        /**
+   * Write the counters as JSON, an array of objects per link.
+   *
+   * @param out stream to write to
+   * @param end_time finish time of the simulation
+   */
+        void write_json(std::ostream& out, EventTime end_time) const noexcept;
+
+        /**
+   * Merge the counters of another table into this one, e.g., of another rank of a distributed simulation.
+   * Counts and sums are added, and maxima are kept. The merge is exact if every link
+   * is recorded by a single table, as each rank records the links starting from its devices.
+   *
+   * @param other table to merge
+   */
+        void merge(const Telemetry& other) noexcept;
+
+        /**
+   * Append the counters to a byte buffer, to be sent to another process.
+   *
+   * @param buffer buffer to append to
+   */
+        void serialize(std::vector<char>& buffer) const noexcept;
+
+        /**
+   * Read the counters appended by serialize().
+   *
+   * @param data serialized counters
+   * @param size size of the serialized counters in bytes
+   * @return table of the counters
+   */
+        [[nodiscard]] static Telemetry deserialize(const char* data, size_t size) noexcept;
+
+    private:
+        /// src device of each link
+        std::vector<DeviceId> src;
+
+        /// dest device of each link
+        std::vector<DeviceId> dest;
+
+        /// bytes sent over each link
+        std::vector<ChunkSize> bytes_sent;
+
+        /// chunks sent over each link
+        std::vector<uint64_t> chunks_sent;
+
+        /// cumulative busy time of each link
+        std::vector<EventTime> busy_time;
+
+        /// current number of pending chunks of each link
+        std::vector<size_t> pending_depth;
+
+        /// maximum number of pending chunks of each link
+        std::vector<size_t> max_pending_depth;
+
+        /// integral of the pending chunks depth over time of each link
+        std::vector<double> pending_depth_integral;
+
+        /// time of the last pending chunks depth change of each link
+        std::vector<EventTime> pending_depth_changed_time;
+
+        /// number of chunks that waited for each link
+        std::vector<uint64_t> queued_chunks;
+
+        /// sum of the queuing delays of each link
+        std::vector<EventTime> queuing_delay_sum;
+
+        /// maximum queuing delay of each link
+        std::vector<EventTime> max_queuing_delay;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -6,9 +6,20 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/EventQueue.h"
+#include "congestion_aware/CallbackBatcher.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkPool.h"
 #include "congestion_aware/Device.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkStateTable.h"
+#include "congestion_aware/RouteCache.h"
+#include "congestion_aware/Telemetry.h"
+#include "congestion_aware/Tracer.h"
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -20,21 +31,39 @@ namespace NetworkAnalyticalCongestionAware {
  */
     class Topology {
     public:
+        /**
+   * Constructor.
+   */
+        Topology() noexcept;
+
         /**
    * Set the event queue to be used by the topology.
+   * Every link of the topology schedules its events on this event queue,
+   * so topologies bound to different event queues can be simulated independently.
    *
    * @param event_queue pointer to the event queue
    */
-        static void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
+        void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
 
         /**
-   * Constructor.
+   * Bind the links of the topology to event queues of their own, e.g., of the partitions of a parallel run,
+   * instead of the event queue of the topology.
+   * The resolver is applied to every link, including the lazy links created later.
+   *
+   * @param resolver maps a link to its event queue, empty to bind every link back to the event queue of the topology
    */
-        Topology() noexcept;
+        void set_link_event_queues(LinkEventQueueResolver resolver) noexcept;
+
+        /**
+   * Get the event queue used by the topology.
+   *
+   * @return pointer to the event queue, nullptr if not set yet
+   */
+        [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
 
         /**
    * Construct the route from src to dest.
-   * Route is a list of devices (pointers) that the chunk should traverse,
+   * Route is a sequence of devices that the chunk should traverse,
    * including the src and dest devices themselves.
    *
    * e.g., route(0, 3) = [0, 5, 7, 2, 3]
@@ -42,9 +71,92 @@ namespace NetworkAnalyticalCongestionAware {
    * @param src src NPU id
    * @param dest dest NPU id
    *
+   * If the route cache is enabled, the returned route references the interned route.
+   *
    * @return route from src NPU to dest NPU
    */
-        [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest) const noexcept = 0;
+        [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept;
+
+        /**
+   * Enable or disable coalescing of pending chunks on every link of the topology.
+   * See Link::set_coalescing().
+   *
+   * @param coalescing true to enable coalescing, false to disable it
+   */
+        void set_link_coalescing(bool coalescing) noexcept;
+
+        /**
+   * Enable or disable the cut-through mode on every link of the topology.
+   * See Link::cut_through().
+   *
+   * @param packet_size size of the packets, 0 to fall back to store-and-forward
+   */
+        void set_cut_through(ChunkSize packet_size) noexcept;
+
+        /**
+   * Enable or disable express scheduling on every link of the topology.
+   * See Link::set_express().
+   *
+   * @param express true to enable express scheduling, false to disable it
+   */
+        void set_express_scheduling(bool express) noexcept;
+
+        /**
+   * Check if express scheduling is enabled on the links of the topology.
+   *
+   * @return true if express scheduling is enabled, false otherwise
+   */
+        [[nodiscard]] bool get_express_scheduling() const noexcept;
+
+        /**
+   * Record the chunk transmissions and arrivals on every link of the topology to a tracer.
+   * See Tracer.
+   *
+   * @param tracer tracer to record to, nullptr to disable tracing
+   */
+        void set_tracer(Tracer* tracer) noexcept;
+
+        /**
+   * Hand the chunks arriving over the links of the topology to mailboxes, e.g., of the ranks of a distributed run.
+   * The resolver is applied to every link, including the lazy links created later. See Link::set_outbox().
+   *
+   * @param resolver maps a link to its outbox, empty to schedule every arrival directly
+   */
+        void set_link_outboxes(LinkOutboxResolver resolver) noexcept;
+
+        /**
+   * Deliver the chunks with a callback in batches:
+   * the chunks arriving at their destinations at the same event time are delivered
+   * by a single invocation of batch_callback, with their callback arguments.
+   * The event queue should be set first. See CallbackBatcher.
+   *
+   * @param callback callback of the chunks to batch
+   * @param batch_callback callback invoked with the arguments of the chunks arrived at the same time
+   */
+        void set_callback_batching(Callback callback, BatchCallback batch_callback) noexcept;
+
+        /**
+   * Get the callback batcher of the topology.
+   *
+   * @return pointer to the callback batcher, nullptr if no callback is batched
+   */
+        [[nodiscard]] const CallbackBatcher* get_callback_batcher() const noexcept;
+
+        /**
+   * Enable the route cache, which interns every route the topology constructs.
+   * The cache is guarded by a lock only in the concurrent mode, see set_concurrent().
+   *
+   * @param memory_cap maximum memory (in bytes) the cache may use
+   * @param precompute true to intern the routes of every NPU pair now, false to intern them on first use
+   */
+        void enable_route_cache(size_t memory_cap, bool precompute = false) noexcept;
+
+        /**
+   * Get the route cache of the topology.
+   *
+   * @return pointer to the route cache, nullptr if the route cache is not enabled
+   */
+        [[nodiscard]] const RouteCache* get_route_cache() const noexcept;
 
         /**
    * Initiate a transmission of a chunk.
@@ -53,6 +165,58 @@ namespace NetworkAnalyticalCongestionAware {
    */
         void send(std::unique_ptr<Chunk> chunk) noexcept;
 
+        /**
+   * Initiate the transmissions of multiple chunks at once.
+   * Routes are resolved and chunks are allocated from the chunk pool in a single pass,
+   * then the chunks are grouped by their first link and sent group by group:
+   * each link transmits its first chunk and queues the rest in the order requested.
+   *
+   * @param requests chunk transmissions to initiate, src and dest should differ
+   */
+        void send_batch(const std::vector<SendRequest>& requests) noexcept;
+
+        /**
+   * Create a chunk from src to dest, allocated from the chunk pool of the topology.
+   * The route is constructed by route(), hence interned if the route cache is enabled.
+   *
+   * @param chunk_size size of the chunk
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @param callback callback to be invoked when the chunk arrives dest
+   * @param callback_arg argument of the callback
+   * @return the created chunk
+   */
+        [[nodiscard]] std::unique_ptr<Chunk> make_chunk(ChunkSize chunk_size, DeviceId src, DeviceId dest,
+                                                        Callback callback, CallbackArg callback_arg) noexcept;
+
+        /**
+   * Get the chunk pool of the topology.
+   *
+   * @return chunk pool of the topology
+   */
+        [[nodiscard]] ChunkPool& get_chunk_pool() noexcept;
+
+        /**
+   * Enable or disable the concurrent mode, in which multiple threads send chunks over the topology at once
+   * (e.g., the partitions of a ParallelSimulator): the chunk pool, the lazy links, and the route cache
+   * are guarded by a lock meanwhile.
+   * Lazy links created in the concurrent mode hold their own link state,
+   * as the shared link state table can't grow while the other threads read it.
+   *
+   * @param concurrent true to enable the concurrent mode, false to disable it
+   */
+        void set_concurrent(bool concurrent) noexcept;
+
+#ifdef ANALYTICAL_TELEMETRY
+        /**
+   * Get the telemetry counters of the links of the topology.
+   * Available only if the backend is compiled with ANALYTICAL_TELEMETRY.
+   *
+   * @return telemetry table, indexed by LinkId
+   */
+        [[nodiscard]] const Telemetry& get_telemetry() const noexcept;
+#endif
+
         /**
    * Get the number of NPUs in the topology.
    * NPU excludes non-NPU devices such as switches.
@@ -69,6 +233,70 @@ namespace NetworkAnalyticalCongestionAware {
    */
         [[nodiscard]] int get_devices_count() const noexcept;
 
+        /**
+   * Get a device of the topology.
+   *
+   * @param id id of the device
+   * @return pointer to the device
+   */
+        [[nodiscard]] Device* get_device(DeviceId id) const noexcept;
+
+        /**
+   * Get the number of links in the topology.
+   * If the links are lazy, idle links not created yet are counted as well.
+   *
+   * @return number of links in the topology
+   */
+        [[nodiscard]] int get_links_count() const noexcept;
+
+        /**
+   * Get a link of the topology.
+   * If the links are lazy, the link is created on first use.
+   *
+   * @param id id of the link
+   * @return pointer to the link
+   */
+        [[nodiscard]] Link* get_link(LinkId id) const noexcept;
+
+        /**
+   * Get the id of the link from src to dest.
+   * src and dest should be connected.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @return id of the link
+   */
+        [[nodiscard]] LinkId get_link_id(DeviceId src, DeviceId dest) const noexcept;
+
+        /**
+   * Check if the links of the topology are created on first use.
+   *
+   * @return true if the links are lazy, false otherwise
+   */
+        [[nodiscard]] bool has_lazy_links() const noexcept;
+
+        /**
+   * Get the number of link instances created so far.
+   * Equals get_links_count() unless the links are lazy.
+   *
+   * @return number of created links
+   */
+        [[nodiscard]] size_t get_instantiated_links_count() const noexcept;
+
+        /**
+   * Get the smallest latency of the links, without creating lazy links.
+   *
+   * @return smallest link latency in ns, 0 if the topology has no link
+   */
+        [[nodiscard]] Latency get_min_link_latency() const noexcept;
+
+        /**
+   * Get the state table of the links of the topology.
+   *
+   * @return state table of the links
+   */
+        [[nodiscard]] const LinkStateTable& get_link_states() const noexcept;
+
         /**
    * Get the number of network dimensions.
    *
@@ -108,9 +336,92 @@ namespace NetworkAnalyticalCongestionAware {
         /// holds the entire device instances in the topology
         std::vector<std::shared_ptr<Device>> devices;
 
+        /// pool of the chunks created by make_chunk(), and of the packets split at the links
+        /// declared before links, so that it outlives the chunks pending in the links
+        /// lazy links take it on first use, from const get_link()
+        mutable ChunkPool chunk_pool;
+
+        /// state of every link touched per hop, as struct-of-arrays
+        /// declared before links, so that it outlives them
+        /// lazy links register to it on first use, from const get_link()
+        mutable LinkStateTable link_states;
+
+        /// holds the entire link instances in the topology, indexed by LinkId
+        std::vector<std::unique_ptr<Link>> links;
+
         /// bandwidth per each network dimension
         std::vector<Bandwidth> bandwidth_per_dim;
 
+        /// event queue the links of the topology schedule their events on
+        std::shared_ptr<EventQueue> event_queue;
+
+#ifdef ANALYTICAL_TELEMETRY
+        /// telemetry counters of the links
+        /// lazy links register to it on first use, from const get_link()
+        mutable Telemetry telemetry;
+#endif
+
+        /// route cache, nullptr if not enabled
+        /// route() is const, but populates the cache
+        mutable std::unique_ptr<RouteCache> route_cache;
+
+        /// true if the links are created on first use, see enable_lazy_links()
+        bool lazy_links;
+
+        /// number of links, if the links are lazy
+        int lazy_links_count;
+
+        /// bandwidth of every link, if the links are lazy
+        Bandwidth lazy_link_bandwidth;
+
+        /// latency of every link, if the links are lazy
+        Latency lazy_link_latency;
+
+        /// links created so far, keyed by LinkId, if the links are lazy
+        /// get_link() is const, but creates the link on first use
+        mutable std::unordered_map<LinkId, std::unique_ptr<Link>> lazy_link_table;
+
+        /// coalescing of every link, applied to lazy links as they're created
+        bool link_coalescing;
+
+        /// cut-through packet size of every link, applied to lazy links as they're created
+        ChunkSize link_packet_size;
+
+        /// express scheduling of every link, applied to lazy links as they're created
+        bool link_express;
+
+        /// tracer of every link, applied to lazy links as they're created
+        Tracer* link_tracer;
+
+        /// outbox of every link, applied to lazy links as they're created, empty if none
+        LinkOutboxResolver link_outbox_resolver;
+
+        /// event queue of every link, applied to lazy links as they're created, empty to use event_queue
+        LinkEventQueueResolver link_event_queue_resolver;
+
+        /// true if the lazy links and the route cache are guarded by mutex, see set_concurrent()
+        bool concurrent;
+
+        /// lock of the lazy link table in the concurrent mode
+        mutable std::mutex lazy_links_mutex;
+
+        /// lock of the route cache in the concurrent mode
+        /// separate from lazy_links_mutex, as constructing a route may create lazy links
+        mutable std::mutex route_cache_mutex;
+
+        /// batcher of the destination callbacks, nullptr if no callback is batched
+        std::unique_ptr<CallbackBatcher> callback_batcher;
+
+        /**
+   * Construct the route from src to dest from scratch.
+   * Each topology implements its own routing algorithm here.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @return route from src NPU to dest NPU
+   */
+        [[nodiscard]] virtual Route compute_route(DeviceId src, DeviceId dest) const noexcept = 0;
+
         /**
    * Instantiate Device objects in the topology.
    */
@@ -130,6 +441,119 @@ namespace NetworkAnalyticalCongestionAware {
    */
         void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency,
                      bool bidirectional = true) noexcept;
+
+        /**
+   * Create a src -> dest link without registering it to the src device,
+   * so that multiple links may connect the same device pair, or a device to itself.
+   * Such a link can't be resolved by get_link_id(): it's only reachable through interned routes.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @param bandwidth bandwidth of link
+   * @param latency latency of link
+   * @return id of the link
+   */
+        LinkId add_detached_link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+        /**
+   * Switch the topology to lazy links:
+   * instead of connecting every device pair upfront, the link state of a pair is created on first use,
+   * so idle links cost no memory.
+   * Every link shares the same bandwidth and latency,
+   * and the topology maps each connected pair to a LinkId by compute_lazy_link_id().
+   *
+   * @param links_count number of links, i.e., of connected device pairs
+   * @param bandwidth bandwidth of every link
+   * @param latency latency of every link
+   */
+        void enable_lazy_links(int links_count, Bandwidth bandwidth, Latency latency) noexcept;
+
+        /**
+   * Compute the LinkId of the src -> dest link, if the links are lazy.
+   * Topologies enabling lazy links implement it.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @return id of the link
+   */
+        [[nodiscard]] virtual LinkId compute_lazy_link_id(DeviceId src, DeviceId dest) const noexcept;
+
+        /**
+   * Compute the (src, dest) devices of a link, if the links are lazy.
+   * Inverse of compute_lazy_link_id().
+   *
+   * @param id id of the link
+   * @return (src, dest) device ids of the link
+   */
+        [[nodiscard]] virtual std::pair<DeviceId, DeviceId> compute_lazy_link_devices(LinkId id) const noexcept;
+
+    private:
+        /**
+   * Get the lazy link of the given id, creating it on first use.
+   *
+   * @param id id of the link
+   * @return pointer to the link
+   */
+        [[nodiscard]] Link* get_lazy_link(LinkId id) const noexcept;
+
+        /**
+   * Find the event queue a link schedules its events on.
+   *
+   * @param link the link
+   * @return event queue of the link, nullptr if not set yet
+   */
+        [[nodiscard]] EventQueue* resolve_event_queue(const Link& link) const noexcept;
+
+        /**
+   * Construct the route from src to dest, interning it if the route cache is enabled.
+   * Not guarded by the lock of the concurrent mode.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @return route from src NPU to dest NPU
+   */
+        [[nodiscard]] Route cached_route(DeviceId src, DeviceId dest) const noexcept;
+
+        /**
+   * Bind a newly created link to the event queue, the telemetry, and the link settings of the topology.
+   *
+   * @param id id of the link
+   * @param link the link
+   */
+        void setup_link(LinkId id, Link& link) const noexcept;
+
+        /**
+   * Implementation of send_batch() for lazy links, grouping the chunks by sorting instead of counting.
+   *
+   * @param requests chunk transmissions to initiate, src and dest should differ
+   */
+        void send_batch_sorted(const std::vector<SendRequest>& requests) noexcept;
+
+        /**
+   * Invoke a function on every created link.
+   *
+   * @tparam F type of the function
+   * @param function function to invoke with each Link&
+   */
+        template <typename F>
+        void for_each_link(F&& function) const noexcept {
+            for (const auto& link : links) {
+                function(*link);
+            }
+            for (const auto& [id, link] : lazy_link_table) {
+                function(*link);
+            }
+        }
+
+        /**
+   * Create a src -> dest link, and register it to the link table.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @param bandwidth bandwidth of link
+   * @param latency latency of link
+   */
+        void add_link(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
     };
 
 }  // namespace NetworkAnalyticalCongestionAware
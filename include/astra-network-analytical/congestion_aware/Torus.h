@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /**
+ * Implements a Torus topology of any number of sides, or a Mesh if without the wraparound links.
+ *
+ * Torus(16, shape={4, 4}) example:
+ * +-  0 -  1 -  2 -  3 -+
+ * |   |    |    |    |  |
+ * +-  4 -  5 -  6 -  7 -+
+ * |   |    |    |    |  |
+ * +-  8 -  9 - 10 - 11 -+
+ * |   |    |    |    |  |
+ * +- 12 - 13 - 14 - 15 -+
+ * (and the columns wrap around as well)
+ *
+ * Side 0 is the fastest-varying: NPU (x, y) has the ID x + 4 * y.
+ * Every link is bidirectional, and a side of 2 has no wraparound link.
+ *
+ * Chunks are routed in dimension order: side 0 first, then side 1, and so on,
+ * taking the shorter way around each side of a Torus.
+ * For example, send(0 -> 15) flows through:
+ * 0 -> 3 -> 15
+ * so takes 2 hops.
+ *
+ * Links are indexed per side and direction, so the link of each hop is computed in O(1),
+ * and created on its first use.
+ */
+    class Torus final : public BasicTopology {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param npus_count number of NPUs, the product of the sides
+   * @param bandwidth bandwidth of each link
+   * @param latency latency of each link
+   * @param shape number of NPUs along each side, {npus_count} if empty
+   * @param wraparound true for a Torus, false for a Mesh
+   */
+        Torus(int npus_count,
+              Bandwidth bandwidth,
+              Latency latency,
+              const std::vector<int>& shape = {},
+              bool wraparound = true) noexcept;
+
+        /**
+   * Get the number of NPUs along each side.
+   *
+   * @return sides of the topology
+   */
+        [[nodiscard]] const std::vector<int>& get_shape() const noexcept;
+
+    private:
+        /**
+   * Implementation of compute_route function in Topology.
+   */
+        [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implementation of compute_lazy_link_id function in Topology.
+   */
+        [[nodiscard]] LinkId compute_lazy_link_id(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implementation of compute_lazy_link_devices function in Topology.
+   */
+        [[nodiscard]] std::pair<DeviceId, DeviceId> compute_lazy_link_devices(LinkId id) const noexcept override;
+
+        /**
+   * Check if a side has wraparound links.
+   *
+   * @param side index of the side
+   * @return true if the side wraps around
+   */
+        [[nodiscard]] bool wraps_around(int side) const noexcept;
+
+        /// number of NPUs along each side
+        std::vector<int> shape;
+
+        /// ID distance between neighbors along each side
+        std::vector<int> strides;
+
+        /// true for a Torus, false for a Mesh
+        bool wraparound;
+
+        /// first LinkId of each (side, direction), indexed 2 * side + (0: forward, 1: backward)
+        std::vector<LinkId> link_offsets;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
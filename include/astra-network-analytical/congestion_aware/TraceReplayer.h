@@ -0,0 +1,167 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /// Send of a workload trace, written to the trace file as is
+    struct TraceSend {
+        /// time the chunk is sent
+        EventTime time;
+
+        /// size of the chunk
+        ChunkSize chunk_size;
+
+        /// src NPU id
+        DeviceId src;
+
+        /// dest NPU id
+        DeviceId dest;
+    };
+
+    /**
+ * TraceReplayer replays a workload trace of sends from a memory-mapped binary file.
+ *
+ * The file holds a header and the sends in time order.
+ * Sends are injected lazily: a single injection event is pending at a time,
+ * which sends every chunk due at the current time through Topology::send(), then schedules itself at the next send.
+ * Only a window of the mapping ahead of the current send is prefetched, and the sends behind are dropped
+ * from memory, so the memory stays bounded however long the trace is.
+ */
+    class TraceReplayer {
+    public:
+        /// version of the trace format
+        static constexpr uint32_t format_version = 1;
+
+        /**
+   * Write a workload trace file.
+   *
+   * @param path path of the trace file
+   * @param sends sends of the trace, in time order
+   */
+        static void write(const std::string& path, const std::vector<TraceSend>& sends) noexcept;
+
+        /**
+   * Open a workload trace file to replay on a topology.
+   * The topology should be bound to its event queue.
+   *
+   * @param path path of the trace file
+   * @param topology topology to send the chunks to
+   * @param window_sends_count number of sends prefetched ahead of the current send
+   * @return replayer of the trace, nullptr if the file is missing or malformed
+   */
+        [[nodiscard]] static std::unique_ptr<TraceReplayer> open(const std::string& path,
+                                                                 Topology& topology,
+                                                                 size_t window_sends_count = 65'536) noexcept;
+
+        /**
+   * Destructor.
+   * Unmaps the trace file.
+   */
+        ~TraceReplayer() noexcept;
+
+        TraceReplayer(const TraceReplayer&) = delete;
+        TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+        /**
+   * Start the replay, by scheduling the injection of the first send.
+   * The first send shouldn't be earlier than the current time of the event queue.
+   */
+        void start() noexcept;
+
+        /**
+   * Get the number of sends of the trace.
+   *
+   * @return number of sends
+   */
+        [[nodiscard]] uint64_t get_sends_count() const noexcept;
+
+        /**
+   * Get the number of sends injected so far.
+   *
+   * @return number of injected sends
+   */
+        [[nodiscard]] uint64_t get_injected_count() const noexcept;
+
+        /**
+   * Get the number of sends arrived at their destinations so far.
+   *
+   * @return number of finished sends
+   */
+        [[nodiscard]] uint64_t get_finished_count() const noexcept;
+
+    private:
+        /**
+   * Constructor.
+   *
+   * @param mapping mapped trace file
+   * @param mapping_size size of the mapping in bytes
+   * @param topology topology to send the chunks to
+   * @param window_sends_count number of sends prefetched ahead of the current send
+   */
+        TraceReplayer(void* mapping, size_t mapping_size, Topology& topology, size_t window_sends_count) noexcept;
+
+        /**
+   * Send every chunk due at the current time, then schedule the injection of the next send.
+   *
+   * @param replayer replayer to inject the sends of
+   */
+        static void inject(TraceReplayer* replayer) noexcept;
+
+        /**
+   * Count a send arrived at its destination.
+   *
+   * @param replayer replayer the send belongs to
+   */
+        static void send_finished(void* replayer) noexcept;
+
+        /**
+   * Prefetch the next window of the sends, and drop the sends behind the current one from memory.
+   */
+        void advance_window() noexcept;
+
+        /// mapped trace file
+        void* mapping;
+
+        /// size of the mapping in bytes
+        size_t mapping_size;
+
+        /// sends of the trace, within the mapping
+        const TraceSend* sends;
+
+        /// number of sends of the trace
+        uint64_t sends_count;
+
+        /// topology the chunks are sent to
+        Topology* topology;
+
+        /// number of sends per prefetched window
+        size_t window_sends_count;
+
+        /// index of the next send to inject
+        uint64_t cursor;
+
+        /// index of the send past the prefetched window
+        uint64_t window_end;
+
+        /// offset of the mapping up to which the pages are dropped from memory
+        size_t dropped_end;
+
+        /// number of sends arrived at their destinations
+        uint64_t finished_count;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
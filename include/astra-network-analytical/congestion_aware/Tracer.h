@@ -0,0 +1,196 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+    /// Kinds of trace records
+    ///   - Transmission: a link serializes a chunk from begin to end
+    ///   - Arrival: a chunk arrives at the dest device at begin (= end)
+    ///   - Rollback: an express reservation of the link, recorded earlier, is rolled back at begin (= end)
+    enum class TraceRecordType : uint32_t { Transmission, Arrival, Rollback };
+
+    /// Trace record, written to the trace file as is
+    struct TraceRecord {
+        /// begin time of the record
+        EventTime begin;
+
+        /// end time of the record
+        EventTime end;
+
+        /// size of the chunk
+        ChunkSize chunk_size;
+
+        /// src device
+        DeviceId src;
+
+        /// dest device
+        DeviceId dest;
+
+        /// kind of the record
+        TraceRecordType type;
+
+        /// index of the thread that recorded it
+        uint32_t thread;
+    };
+
+    /**
+ * Tracer streams a timeline of chunk transmissions and arrivals to a compact binary file.
+ *
+ * Each recording thread appends to its own buffer, so simulations on multiple threads
+ * (e.g., ParallelSimulator) trace without contention.
+ * When a buffer fills up, it's handed to a background writer thread, which appends it to the file.
+ * Only a few buffers are held in memory: recording threads wait if the writer falls behind.
+ *
+ * The binary file can be converted into the Chrome trace (JSON) format,
+ * which chrome://tracing and Perfetto (ui.perfetto.dev) open:
+ * each device is a process, and each of its links is a thread of it.
+ */
+    class Tracer {
+    public:
+        /**
+   * Constructor.
+   * Creates the trace file and starts the writer thread.
+   *
+   * @param path path of the binary trace file
+   * @param buffer_capacity number of records per thread buffer
+   */
+        explicit Tracer(const std::string& path, size_t buffer_capacity = 65'536) noexcept;
+
+        /**
+   * Destructor.
+   * Flushes every buffer and closes the trace file.
+   * No thread should be recording anymore.
+   */
+        ~Tracer() noexcept;
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        /**
+   * Record an entry into the buffer of the calling thread.
+   *
+   * @param type kind of the record
+   * @param begin begin time of the record
+   * @param end end time of the record
+   * @param src src device
+   * @param dest dest device
+   * @param chunk_size size of the chunk
+   */
+        void record(TraceRecordType type,
+                    EventTime begin,
+                    EventTime end,
+                    DeviceId src,
+                    DeviceId dest,
+                    ChunkSize chunk_size) noexcept;
+
+        /**
+   * Write every buffered record to the trace file.
+   * No thread should be recording meanwhile, e.g., call after the simulation finishes.
+   */
+        void flush() noexcept;
+
+        /**
+   * Get the number of records so far.
+   *
+   * @return number of records
+   */
+        [[nodiscard]] uint64_t get_records_count() const noexcept;
+
+        /**
+   * Convert a binary trace file into the Chrome trace (JSON) format.
+   *
+   * @param trace_path path of the binary trace file
+   * @param json_path path of the JSON file to write
+   */
+        static void convert_to_chrome_json(const std::string& trace_path, const std::string& json_path) noexcept;
+
+    private:
+        /// buffer of a recording thread
+        struct ThreadBuffer {
+            /// index of the thread
+            uint32_t thread;
+
+            /// the thread owning the buffer
+            std::thread::id owner;
+
+            /// records not written yet
+            std::vector<TraceRecord> records;
+        };
+
+        /// maximum number of full buffers waiting for the writer
+        static constexpr size_t max_queued_buffers = 4;
+
+        /// identifies the tracer in the thread-local buffer cache, unique over the process lifetime
+        uint64_t serial;
+
+        /// number of records per thread buffer
+        size_t buffer_capacity;
+
+        /// trace file
+        std::ofstream file;
+
+        /// buffers of the recording threads
+        std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers;
+
+        /// full buffers waiting for the writer
+        std::deque<std::vector<TraceRecord>> queued_buffers;
+
+        /// number of records so far
+        uint64_t records_count;
+
+        /// true if the writer thread should stop once the queue is empty
+        bool stopping;
+
+        /// true while the writer thread is writing a buffer
+        bool writing;
+
+        /// guards thread_buffers, queued_buffers, records_count, stopping, and writing
+        mutable std::mutex mutex;
+
+        /// signals the writer that a buffer is queued, or the recorders that a buffer is written
+        std::condition_variable condition;
+
+        /// background writer thread
+        std::thread writer;
+
+        /**
+   * Get the buffer of the calling thread, registering one if it's the first record of the thread.
+   *
+   * @return buffer of the calling thread
+   */
+        [[nodiscard]] ThreadBuffer* thread_buffer() noexcept;
+
+        /**
+   * Hand the records of a buffer to the writer, waiting if too many buffers are queued.
+   * The mutex should be held.
+   *
+   * @param lock lock holding the mutex
+   * @param buffer buffer to hand over
+   */
+        void enqueue(std::unique_lock<std::mutex>& lock, ThreadBuffer& buffer) noexcept;
+
+        /**
+   * Body of the writer thread: write the queued buffers until stopped.
+   */
+        void write_queued_buffers() noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionAware
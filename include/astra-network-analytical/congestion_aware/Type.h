@@ -5,8 +5,19 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include <list>
+#include "common/Type.h"
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+    /// Forward declaration of the event queue
+    class EventQueue;
+
+}  // namespace NetworkAnalytical
 
 namespace NetworkAnalyticalCongestionAware {
 
@@ -14,8 +25,59 @@ namespace NetworkAnalyticalCongestionAware {
     class Chunk;
     class Link;
     class Device;
+    class Topology;
+
+    /// LinkId is the index of a link in the link table of its topology
+    using LinkId = int;
+
+    /// Request of a chunk transmission, used to send chunks in bulk
+    struct SendRequest {
+        /// src NPU id
+        NetworkAnalytical::DeviceId src;
+
+        /// dest NPU id
+        NetworkAnalytical::DeviceId dest;
+
+        /// size of the chunk
+        NetworkAnalytical::ChunkSize chunk_size;
+
+        /// callback to be invoked when the chunk arrives dest
+        NetworkAnalytical::Callback callback;
+
+        /// argument of the callback
+        NetworkAnalytical::CallbackArg callback_arg;
+    };
+
+    /// Chunk arrival handed over to a partition of a parallel simulation
+    struct ChunkDelivery {
+        /// time the chunk arrives the next device
+        NetworkAnalytical::EventTime arrival_time;
+
+        /// time the chunk started its transmission
+        NetworkAnalytical::EventTime send_time;
+
+        /// chunk in flight
+        Chunk* chunk;
+    };
+
+    /// Chunk arrivals handed over to a partition of a parallel simulation, in the order sent
+    using ChunkMailbox = std::vector<ChunkDelivery>;
+
+    /// Maps a link to the mailbox its arriving chunks are handed over to, nullptr to schedule them directly
+    using LinkOutboxResolver = std::function<ChunkMailbox*(const Link& link)>;
+
+    /// Maps a link to the event queue it schedules its events on
+    using LinkEventQueueResolver = std::function<NetworkAnalytical::EventQueue*(const Link& link)>;
+
+    /// Serializable handle of a callback and its argument, assigned by the user
+    using CallbackHandle = uint64_t;
+
+    /// Maps a callback and its argument to a handle, e.g., when capturing a snapshot
+    using CallbackEncoder = std::function<CallbackHandle(NetworkAnalytical::Callback callback,
+                                                         NetworkAnalytical::CallbackArg callback_arg)>;
 
-    /// Route is a list of devices
-    using Route = std::list<std::shared_ptr<Device>>;
+    /// Maps a handle back to a callback and its argument, e.g., when restoring a snapshot
+    using CallbackDecoder =
+        std::function<std::pair<NetworkAnalytical::Callback, NetworkAnalytical::CallbackArg>(CallbackHandle handle)>;
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -7,15 +7,27 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_unaware/Topology.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionUnaware {
 
+    /// Layouts of the link delay lookup table of a BasicTopology
+    ///   - None: no table, hops are computed per query
+    ///   - Dense: delay per (src, dest) pair
+    ///   - DistanceClass: delay per (dest - src) mod npus_count,
+    ///     for topologies whose hops only depend on the distance, e.g., Ring
+    enum class LookupTableMode { None, Dense, DistanceClass };
+
     /**
  * BasicTopology defines 1D topology
  * such as Ring, FullyConnected, and Switch topology,
  * which can be used to construct multi-dimensional topology.
+ * Building blocks derive from BasicTopologyImpl, which implements send().
  */
     class BasicTopology : public Topology {
     public:
@@ -34,9 +46,15 @@ namespace NetworkAnalyticalCongestionUnaware {
         virtual ~BasicTopology() noexcept;
 
         /**
-   * Implement the send method of Topology.
+   * Implement the send_batch method of Topology.
+   * Hops counts are computed a block at a time by the building block,
+   * and the delays by a branch-free loop the compiler can vectorize.
    */
-        [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
+        void send_batch(const DeviceId* srcs,
+                        const DeviceId* dests,
+                        const ChunkSize* chunk_sizes,
+                        EventTime* comms_delays,
+                        size_t count) const noexcept override;
 
         /**
    * Return the type of the basic topology
@@ -46,6 +64,39 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         [[nodiscard]] TopologyBuildingBlock get_basic_topology_type() const noexcept;
 
+        /**
+   * Implement the build_lookup_tables method of Topology.
+   * A dense table is built if it fits the memory budget,
+   * otherwise a distance class table if the topology supports one.
+   */
+        void build_lookup_tables(size_t memory_budget) noexcept override;
+
+        /**
+   * Get the layout of the link delay lookup table.
+   *
+   * @return layout of the lookup table
+   */
+        [[nodiscard]] LookupTableMode get_lookup_table_mode() const noexcept;
+
+        /**
+   * Compute the link delay between src and dest, i.e., hops_count * latency,
+   * from the lookup table if built.
+   *
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @return link delay between src and dest in ps
+   */
+        [[nodiscard]] PicoTime compute_link_delay(DeviceId src, DeviceId dest) const noexcept;
+
+        /**
+   * Implement the estimate_collective method of Topology.
+   * Takes O(1) time, except for HalvingDoubling AllToAll on building blocks
+   * whose hops count isn't constant (e.g., Ring), which takes O(npus_count^2).
+   */
+        [[nodiscard]] EventTime estimate_collective(CollectiveType type,
+                                                    CollectiveAlgorithm algorithm,
+                                                    ChunkSize size) const noexcept override;
+
     protected:
         /**
    * Compute the number of hops between src and dest.
@@ -56,10 +107,57 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         [[nodiscard]] virtual int compute_hops_count(DeviceId src, DeviceId dest) const noexcept = 0;
 
+        /**
+   * Compute the numbers of hops of a block of src and dest pairs.
+   * The default implementation invokes compute_hops_count() per pair.
+   *
+   * @param srcs src NPU IDs
+   * @param dests dest NPU IDs
+   * @param hops_counts output array of the numbers of hops
+   * @param count number of pairs
+   */
+        virtual void compute_hops_counts(const DeviceId* srcs,
+                                         const DeviceId* dests,
+                                         int* hops_counts,
+                                         size_t count) const noexcept;
+
+        /**
+   * Check if the number of hops only depends on the distance (dest - src) mod npus_count.
+   * The default implementation returns false.
+   *
+   * @return true if the hops count is invariant under rotating the NPU IDs
+   */
+        [[nodiscard]] virtual bool is_rotation_invariant() const noexcept;
+
+        /**
+   * Compute the maximum number of hops between any two NPUs.
+   * The default implementation scans every pair (or distance, if rotation invariant).
+   *
+   * @return maximum number of hops
+   */
+        [[nodiscard]] virtual int compute_max_hops_count() const noexcept;
+
+        /**
+   * Compute the hops of the shifted pairwise steps, i.e.,
+   * the sum over 0 < i < npus_count of the maximum hops between any npu and (npu + i) mod npus_count.
+   * The default implementation scans every step.
+   *
+   * @return number of hops summed over the steps
+   */
+        [[nodiscard]] virtual int64_t compute_shift_hops_count_sum() const noexcept;
+
+        /**
+   * Compute the hops of the XOR pairwise steps, i.e.,
+   * the sum over 0 < i < npus_count of the maximum hops between any npu and (npu XOR i).
+   * npus_count should be a power of 2. The default implementation scans every step and NPU.
+   *
+   * @return number of hops summed over the steps
+   */
+        [[nodiscard]] virtual int64_t compute_xor_hops_count_sum() const noexcept;
+
         /// type of the basic topology
         TopologyBuildingBlock basic_topology_type;
 
-    private:
         /**
    * Analytically compute the communication delay.
    *
@@ -69,14 +167,101 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         [[nodiscard]] EventTime compute_communication_delay(int hops_count, ChunkSize chunk_size) const noexcept;
 
+        /**
+   * Compute the communication delay given the precomputed link delay.
+   *
+   * @param link_delay link delay between src and dest in ps, i.e., hops_count * latency
+   * @param chunk_size size of the chunk
+   * @return communication delay to send a chunk between src and dest
+   */
+        [[nodiscard]] EventTime compute_communication_delay(PicoTime link_delay, ChunkSize chunk_size) const noexcept;
+
+        /**
+   * Look up the link delay between src and dest.
+   * A lookup table should exist.
+   *
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @return link delay between src and dest in ps
+   */
+        [[nodiscard]] PicoTime lookup_link_delay(DeviceId src, DeviceId dest) const noexcept;
+
+    private:
+        /**
+   * Compute the maximum hops between any npu and (npu + distance) mod npus_count.
+   *
+   * @param distance distance of the peers
+   * @return maximum number of hops
+   */
+        [[nodiscard]] int compute_shift_hops_count(int distance) const noexcept;
+
+        /**
+   * Compute the maximum hops between any npu and (npu XOR distance).
+   *
+   * @param distance XOR distance of the peers
+   * @return maximum number of hops
+   */
+        [[nodiscard]] int compute_xor_hops_count(int distance) const noexcept;
+
+        /// number of queries a batch is processed at a time
+        static constexpr size_t batch_block_size = 256;
+
         /// bandwidth of each link in GB/s
         Bandwidth bandwidth;
 
-        /// bandwidth of each link in B/ns, used for actual computation
-        Bandwidth bandwidth_Bpns;
+        /// reciprocal bandwidth of each link in ps/B, used for actual computation
+        ReciprocalBandwidth reciprocal_bandwidth;
 
         /// latency of each link in ns
         Latency latency;
+
+        /// latency of each link in ps, used for actual computation
+        PicoTime latency_ps;
+
+        /// layout of the link delay lookup table
+        LookupTableMode lookup_table_mode;
+
+        /// precomputed link delays in ps, laid out by lookup_table_mode
+        std::vector<PicoTime> link_delay_table;
+    };
+
+    /**
+ * BasicTopologyImpl implements the send method of BasicTopology for a building block Derived,
+ * i.e., class Ring final : public BasicTopologyImpl<Ring>.
+ *
+ * The hops count is computed by a direct call to Derived::compute_hops_count,
+ * and as Derived is final, send() invoked on a Derived is statically dispatched as well,
+ * so a query to a known building block takes no virtual call.
+ *
+ * @tparam Derived the building block, which should befriend BasicTopologyImpl<Derived>
+ */
+    template <typename Derived>
+    class BasicTopologyImpl : public BasicTopology {
+    public:
+        using BasicTopology::BasicTopology;
+
+        /**
+   * Implement the send method of Topology.
+   */
+        [[nodiscard]] EventTime send(const DeviceId src,
+                                     const DeviceId dest,
+                                     const ChunkSize chunk_size) const noexcept final {
+            assert(0 <= src && src < npus_count);
+            assert(0 <= dest && dest < npus_count);
+            assert(src != dest);
+            assert(chunk_size > 0);
+
+            // look up the link delay
+            if (get_lookup_table_mode() != LookupTableMode::None) {
+                return compute_communication_delay(lookup_link_delay(src, dest), chunk_size);
+            }
+
+            // get hops count, without a virtual call
+            const auto hops_count = static_cast<const Derived*>(this)->Derived::compute_hops_count(src, dest);
+
+            // return communication delay
+            return compute_communication_delay(hops_count, chunk_size);
+        }
     };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,85 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+    /**
+ * Implements a k-ary n-level FatTree topology of k^n NPUs,
+ * where each leaf switch connects k NPUs and each level-l switch serves a subtree of k^l NPUs.
+ *
+ * FatTree(4, radix=2) example:
+ *   [t0]  [t1]      level 2 (top)
+ *    | \  / |
+ *    |  \/  |
+ *    |  /\  |
+ *   [l0]  [l1]      level 1 (leaf)
+ *   | |   | |
+ *   0 1   2 3
+ *
+ * A chunk goes up to the lowest level L whose subtree holds both src and dest, then down,
+ * so takes 2L hops: e.g., send(0 -> 1) takes 2 hops, and send(0 -> 2) takes 4 hops.
+ * The hops count is computed from the NPU IDs in O(levels).
+ *
+ * As the topology is congestion-unaware,
+ * neither the number of parallel switches nor the oversubscription of the leaf switches changes the delay.
+ */
+    class FatTree final : public BasicTopologyImpl<FatTree> {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param npus_count number of NPUs, which should be a power of radix
+   * @param bandwidth bandwidth of each link
+   * @param latency latency of each link
+   * @param radix number of down ports of each switch
+   */
+        FatTree(int npus_count, Bandwidth bandwidth, Latency latency, int radix) noexcept;
+
+        /**
+   * Get the number of switch levels.
+   *
+   * @return number of levels
+   */
+        [[nodiscard]] int get_levels_count() const noexcept;
+
+    private:
+        /// send() calls compute_hops_count directly
+        friend class BasicTopologyImpl<FatTree>;
+
+        /**
+   * Implements the compute_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implements the compute_max_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_max_hops_count() const noexcept override;
+
+        /**
+   * Implements the compute_shift_hops_count_sum method of BasicTopology.
+   */
+        [[nodiscard]] int64_t compute_shift_hops_count_sum() const noexcept override;
+
+        /**
+   * Implements the compute_xor_hops_count_sum method of BasicTopology.
+   */
+        [[nodiscard]] int64_t compute_xor_hops_count_sum() const noexcept override;
+
+        /// number of down ports of each switch
+        int radix;
+
+        /// number of switch levels
+        int levels_count;
+    };
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -5,9 +5,13 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
+#include "common/Type.h"
 #include "congestion_unaware/Topology.h"
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -17,8 +21,45 @@ namespace NetworkAnalyticalCongestionUnaware {
  * Construct a topology from a NetworkParser.
  *
  * @param network_parser NetworkParser to parse the network input file
- * @return pointer to the constructed topology
+ * @return pointer to the constructed topology, nullptr if the config isn't supported by the backend
  */
     [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
 
+    /**
+ * Construct a topology from an in-memory NetworkConfig.
+ *
+ * @param network_config network configuration
+ * @return pointer to the constructed topology, nullptr if the config is invalid (see NetworkConfig::validate())
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config) noexcept;
+
+    /**
+ * Construct a topology from an in-memory NetworkConfig, returning the error message if it fails.
+ *
+ * @param network_config network configuration
+ * @param error set to the error message if the config is invalid or not supported, empty otherwise
+ * @return pointer to the constructed topology, nullptr if the config is invalid or not supported
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config,
+                                                               std::string& error) noexcept;
+
+    /**
+ * Construct a topology from the shape of each network dimension.
+ *
+ * @param topologies_per_dim building block of each dimension
+ * @param npus_counts_per_dim number of NPUs of each dimension
+ * @param bandwidths_per_dim link bandwidth (GB/s) of each dimension
+ * @param latencies_per_dim link latency (ns) of each dimension
+ * @param radixes_per_dim switch radix of each dimension, only required for FatTree dimensions
+ * @param shapes_per_dim sides of each dimension, only used by Torus and Mesh dimensions
+ * @return pointer to the constructed topology, nullptr if the dimensions are invalid (see NetworkConfig::validate())
+ */
+    [[nodiscard]] std::shared_ptr<Topology>
+    construct_topology(const std::vector<TopologyBuildingBlock>& topologies_per_dim,
+                       const std::vector<int>& npus_counts_per_dim,
+                       const std::vector<Bandwidth>& bandwidths_per_dim,
+                       const std::vector<Latency>& latencies_per_dim,
+                       const std::vector<int>& radixes_per_dim = {},
+                       const std::vector<std::vector<int>>& shapes_per_dim = {}) noexcept;
+
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -7,13 +7,25 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_unaware/BasicTopology.h"
+#include "congestion_unaware/FatTree.h"
+#include "congestion_unaware/FullyConnected.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/Switch.h"
 #include "congestion_unaware/Topology.h"
+#include "congestion_unaware/Torus.h"
 #include <memory>
+#include <variant>
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionUnaware {
 
+    /// Routing of a chunk between NPUs whose addresses differ in multiple dimensions
+    ///   - FirstDim: only the lowest differing dimension is traversed, as if the NPUs differ only there
+    ///   - DimOrder: every differing dimension is traversed in order,
+    ///     summing the link delays of the dimensions, and serializing at the bottleneck bandwidth
+    enum class MultiDimRouting { FirstDim, DimOrder };
+
     /**
  * MultiDimTopology implements multi-dimensional network topologies
  * which can be constructed by stacking up multiple BasicTopology instances.
@@ -30,6 +42,26 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
 
+        /**
+   * Set the routing of chunks crossing multiple dimensions.
+   * Defaults to MultiDimRouting::FirstDim.
+   *
+   * @param routing routing of chunks
+   */
+        void set_routing(MultiDimRouting routing) noexcept;
+
+        /**
+   * Implement the send_batch method of Topology.
+   * Chunks are grouped by the dimension they're transferred in,
+   * and each group is sent as a batch of the BasicTopology of that dimension.
+   * With DimOrder routing, each chunk is sent on its own.
+   */
+        void send_batch(const DeviceId* srcs,
+                        const DeviceId* dests,
+                        const ChunkSize* chunk_sizes,
+                        EventTime* comms_delays,
+                        size_t count) const noexcept override;
+
         /**
    * Add a dimension to the multi-dimensional topology.
    *
@@ -37,34 +69,104 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         void append_dimension(std::unique_ptr<BasicTopology> basic_topology) noexcept;
 
+        /**
+   * Implement the build_lookup_tables method of Topology.
+   * Each dimension builds its own table, splitting the memory budget evenly.
+   */
+        void build_lookup_tables(size_t memory_budget) noexcept override;
+
+        /**
+   * Implement the estimate_collective method of Topology, hierarchically in O(dims):
+   *   - ReduceScatter: dim 1 first, each dim scatters the shard left by the previous dims
+   *   - AllGather: the reverse, the last dim gathers first
+   *   - AllReduce: ReduceScatter followed by AllGather
+   *   - AllToAll: each dim exchanges the whole buffer in turn
+   * Each dim runs the given algorithm on its BasicTopology.
+   */
+        [[nodiscard]] EventTime estimate_collective(CollectiveType type,
+                                                    CollectiveAlgorithm algorithm,
+                                                    ChunkSize size) const noexcept override;
+
+        /**
+   * Get the BasicTopology of a dimension.
+   *
+   * @param dim dimension
+   * @return BasicTopology of the dimension
+   */
+        [[nodiscard]] const BasicTopology& get_topology_of_dim(int dim) const noexcept;
+
     private:
-        /// Each NPU ID can be broken down into multiple dimensions.
-        /// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
-        /// then the NPU ID can be broken down into [1, 7, 1].
-        using MultiDimAddress = std::vector<DeviceId>;
+        /// dimension where a transfer happens, and the src and dest addresses in that dimension
+        /// for example, if the topology size is [2, 8, 4], NPU 47 has the address [1, 7, 2]
+        /// and NPU 45 has the address [1, 6, 2], so 47 -> 45 is a transfer 7 -> 6 in dim 1.
+        struct DimTransfer {
+            /// dimension to transfer in
+            int dim;
+
+            /// src address in the dimension
+            DeviceId src_local_id;
+
+            /// dest address in the dimension
+            DeviceId dest_local_id;
+        };
+
+        /// BasicTopology of a dimension, resolved to its building block
+        /// so that sending to a known building block is statically dispatched.
+        /// Other building blocks fall back to the virtual send of BasicTopology.
+        using DimTopology = std::variant<const Ring*,
+                                         const FullyConnected*,
+                                         const Switch*,
+                                         const FatTree*,
+                                         const Torus*,
+                                         const BasicTopology*>;
 
         /// BasicTopology instances per dimension.
         std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
 
+        /// BasicTopology instances per dimension, resolved to their building blocks.
+        std::vector<DimTopology> dim_topology_per_dim;
+
+        /// reciprocal link bandwidth (ps/B) per dimension
+        std::vector<ReciprocalBandwidth> reciprocal_bandwidth_per_dim;
+
+        /// routing of chunks crossing multiple dimensions
+        MultiDimRouting routing;
+
+        /**
+   * Send a chunk over every dimension where src and dest differ.
+   *
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @param chunk_size size of the chunk
+   * @return communication delay
+   */
+        [[nodiscard]] EventTime send_dim_order(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept;
+
+        /// distance between the IDs of neighboring NPUs per dimension,
+        /// i.e., the product of the NPUs count of the lower dimensions.
+        std::vector<int> stride_per_dim;
+
         /**
-   * Translate the NPU ID into a multi-dimensional address.
+   * Find the dimension where the transfer should happen,
+   * i.e., the lowest dimension where the src and dest addresses differ,
+   * without materializing the full multi-dimensional addresses.
    *
-   * @param npu_id id of the NPU
-   * @return the same NPU in multi-dimensional address representation
+   * @tparam DimsCount number of dimensions if known at compile time, 0 otherwise
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @return the dimension to transfer in, and the src and dest addresses in it
    */
-        [[nodiscard]] MultiDimAddress translate_address(DeviceId npu_id) const noexcept;
+        template <int DimsCount>
+        [[nodiscard]] DimTransfer get_dim_to_transfer(DeviceId src, DeviceId dest) const noexcept;
 
         /**
-   * Given src and dest address in multi-dimensional form,
-   * return the dimension where the transfer should happen.
-   * i.e., the dimension where the src and dest addresses differ.
+   * Get the dimension to transfer of a chunk, dispatching on the dims count.
    *
-   * @param src_address src NPU ID in multi-dimensional form
-   * @param dest_address dest NPU ID in multi-dimensional form
-   * @return the dimension where the transfer should happen
+   * @param src src NPU ID
+   * @param dest dest NPU ID
+   * @return the dimension to transfer in, and the src and dest addresses in it
    */
-        [[nodiscard]] int get_dim_to_transfer(const MultiDimAddress& src_address,
-                                              const MultiDimAddress& dest_address) const noexcept;
+        [[nodiscard]] DimTransfer find_dim_to_transfer(DeviceId src, DeviceId dest) const noexcept;
     };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
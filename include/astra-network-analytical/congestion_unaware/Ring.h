@@ -27,7 +27,7 @@ namespace NetworkAnalyticalCongestionUnaware {
  * 0 -> 1 -> 2 -> 3 -> 4 -> 5 -> 6 -> 7 -> 0
  * 0 <- 1 <- 2 <- 3 <- 4 <- 5 <- 6 <- 7 <- 0
  */
-    class Ring final : public BasicTopology {
+    class Ring final : public BasicTopologyImpl<Ring> {
     public:
         /**
    * Constructor
@@ -40,11 +40,37 @@ namespace NetworkAnalyticalCongestionUnaware {
         Ring(int npus_count, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
     private:
+        /// send() calls compute_hops_count directly
+        friend class BasicTopologyImpl<Ring>;
+
         /**
    * Implements the compute_hops_count method of BasicTopology.
    */
         [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
 
+        /**
+   * Implements the compute_hops_counts method of BasicTopology.
+   */
+        void compute_hops_counts(const DeviceId* srcs,
+                                 const DeviceId* dests,
+                                 int* hops_counts,
+                                 size_t count) const noexcept override;
+
+        /**
+   * Implements the is_rotation_invariant method of BasicTopology.
+   */
+        [[nodiscard]] bool is_rotation_invariant() const noexcept override;
+
+        /**
+   * Implements the compute_max_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_max_hops_count() const noexcept override;
+
+        /**
+   * Implements the compute_shift_hops_count_sum method of BasicTopology.
+   */
+        [[nodiscard]] int64_t compute_shift_hops_count_sum() const noexcept override;
+
         /// true if the ring is bidirectional, false otherwise
         bool bidirectional;
     };
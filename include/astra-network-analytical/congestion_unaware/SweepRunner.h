@@ -0,0 +1,173 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/Topology.h"
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+    /// SweepMetric evaluates a message size on the topology of a sweep configuration,
+    /// e.g., a send between two NPUs or a collective estimate.
+    /// It may be invoked by any worker thread, concurrently on the same topology.
+    using SweepMetric = std::function<EventTime(const Topology& topology, ChunkSize size)>;
+
+    /**
+ * SweepResults holds the results of a sweep in columns, a row per (configuration, message size):
+ * the shape of the configuration per dimension, the message size, and the value of each metric.
+ */
+    struct SweepResults {
+        /// number of NPUs of each row, per dimension
+        std::vector<std::vector<int>> npus_counts_per_dim;
+
+        /// link bandwidth (GB/s) of each row, per dimension
+        std::vector<std::vector<Bandwidth>> bandwidths_per_dim;
+
+        /// link latency (ns) of each row, per dimension
+        std::vector<std::vector<Latency>> latencies_per_dim;
+
+        /// message size of each row
+        std::vector<ChunkSize> sizes;
+
+        /// names of the metrics
+        std::vector<std::string> metric_names;
+
+        /// value of each row, per metric
+        std::vector<std::vector<EventTime>> metric_values;
+
+        /**
+   * Get the number of rows.
+   *
+   * @return number of rows
+   */
+        [[nodiscard]] size_t get_rows_count() const noexcept;
+
+        /**
+   * Write the results as CSV, a column per field.
+   *
+   * @param out stream to write to
+   */
+        void write_csv(std::ostream& out) const noexcept;
+    };
+
+    /**
+ * SweepRunner evaluates a grid of network configurations and message sizes
+ * in parallel on a pool of worker threads.
+ *
+ * Each dimension is given candidate NPU counts, bandwidths, and latencies,
+ * and the grid is every combination of the candidates of every dimension.
+ * The topology of each configuration is constructed once,
+ * then shared read-only by the workers evaluating its message sizes.
+ */
+    class SweepRunner {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param threads_count number of worker threads
+   */
+        explicit SweepRunner(int threads_count) noexcept;
+
+        /**
+   * Append a dimension to the configurations of the sweep.
+   *
+   * @param topology building block of the dimension
+   * @param npus_counts candidate numbers of NPUs
+   * @param bandwidths candidate link bandwidths (GB/s)
+   * @param latencies candidate link latencies (ns)
+   */
+        void add_dimension(TopologyBuildingBlock topology,
+                           std::vector<int> npus_counts,
+                           std::vector<Bandwidth> bandwidths,
+                           std::vector<Latency> latencies) noexcept;
+
+        /**
+   * Add a message size to evaluate on every configuration.
+   *
+   * @param size message size
+   */
+        void add_message_size(ChunkSize size) noexcept;
+
+        /**
+   * Add a metric to evaluate per configuration and message size.
+   *
+   * @param name name of the metric, used as the column name
+   * @param metric metric to evaluate
+   */
+        void add_metric(const std::string& name, SweepMetric metric) noexcept;
+
+        /**
+   * Get the number of configurations in the grid.
+   *
+   * @return number of configurations
+   */
+        [[nodiscard]] size_t get_configs_count() const noexcept;
+
+        /**
+   * Evaluate every metric on every configuration and message size.
+   * Rows are ordered by configuration, then by message size in the order added.
+   * Configurations are enumerated with the candidates of the last dimension varying the fastest.
+   * The metrics of a configuration that doesn't describe a valid topology (see NetworkConfig::validate()) are 0.
+   *
+   * @return results of the sweep
+   */
+        [[nodiscard]] SweepResults run() const noexcept;
+
+    private:
+        /// candidate shapes of a dimension
+        struct SweepDimension {
+            /// building block of the dimension
+            TopologyBuildingBlock topology;
+
+            /// candidate numbers of NPUs
+            std::vector<int> npus_counts;
+
+            /// candidate link bandwidths
+            std::vector<Bandwidth> bandwidths;
+
+            /// candidate link latencies
+            std::vector<Latency> latencies;
+
+            /**
+   * Get the number of candidate shapes of the dimension.
+   *
+   * @return number of candidate shapes
+   */
+            [[nodiscard]] size_t get_candidates_count() const noexcept;
+        };
+
+        /// number of worker threads
+        int threads_count;
+
+        /// candidate shapes per dimension
+        std::vector<SweepDimension> dimensions;
+
+        /// message sizes to evaluate
+        std::vector<ChunkSize> sizes;
+
+        /// names of the metrics
+        std::vector<std::string> metric_names;
+
+        /// metrics to evaluate
+        std::vector<SweepMetric> metrics;
+
+        /**
+   * Run a job per index on the worker threads.
+   *
+   * @param jobs_count number of jobs
+   * @param job job to run, given its index
+   */
+        void run_parallel(size_t jobs_count, const std::function<void(size_t index)>& job) const noexcept;
+    };
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -24,7 +24,7 @@ namespace NetworkAnalyticalCongestionUnaware {
  * 0 -> switch -> 2
  * so takes 2 hops.
  */
-    class Switch final : public BasicTopology {
+    class Switch final : public BasicTopologyImpl<Switch> {
     public:
         /**
    * Constructor.
@@ -36,10 +36,41 @@ namespace NetworkAnalyticalCongestionUnaware {
         Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
     private:
+        /// send() calls compute_hops_count directly
+        friend class BasicTopologyImpl<Switch>;
+
         /**
    * Implements the compute_hops_count method of BasicTopology.
    */
         [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implements the compute_hops_counts method of BasicTopology.
+   */
+        void compute_hops_counts(const DeviceId* srcs,
+                                 const DeviceId* dests,
+                                 int* hops_counts,
+                                 size_t count) const noexcept override;
+
+        /**
+   * Implements the is_rotation_invariant method of BasicTopology.
+   */
+        [[nodiscard]] bool is_rotation_invariant() const noexcept override;
+
+        /**
+   * Implements the compute_max_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_max_hops_count() const noexcept override;
+
+        /**
+   * Implements the compute_shift_hops_count_sum method of BasicTopology.
+   */
+        [[nodiscard]] int64_t compute_shift_hops_count_sum() const noexcept override;
+
+        /**
+   * Implements the compute_xor_hops_count_sum method of BasicTopology.
+   */
+        [[nodiscard]] int64_t compute_xor_hops_count_sum() const noexcept override;
     };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -14,6 +16,10 @@ namespace NetworkAnalyticalCongestionUnaware {
 
     /**
  * Abstracts a network topology.
+ *
+ * A topology is immutable once constructed (and its lookup tables built):
+ * every const method only reads the topology, so a single topology can be queried
+ * by multiple threads concurrently, e.g., through a SharedTopology.
  */
     class Topology {
     public:
@@ -33,6 +39,54 @@ namespace NetworkAnalyticalCongestionUnaware {
    */
         [[nodiscard]] virtual EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept = 0;
 
+        /**
+   * Estimate the communication delays of a batch of chunks,
+   * i.e., comms_delays[i] = send(srcs[i], dests[i], chunk_sizes[i]) for every i < count.
+   * The default implementation invokes send() per chunk.
+   *
+   * @param srcs src NPU IDs
+   * @param dests dest NPU IDs
+   * @param chunk_sizes sizes of the chunks to send
+   * @param comms_delays output array of the communication delays
+   * @param count number of chunks in the batch
+   */
+        virtual void send_batch(const DeviceId* srcs,
+                                const DeviceId* dests,
+                                const ChunkSize* chunk_sizes,
+                                EventTime* comms_delays,
+                                size_t count) const noexcept;
+
+        /**
+   * Precompute the link delays between NPUs into lookup tables,
+   * so that send() becomes a lookup plus the serialization delay.
+   * The table layout is selected to fit the memory budget, and the delays are unchanged.
+   *
+   * @param memory_budget maximum size of the tables in bytes, 0 to drop the tables
+   */
+        virtual void build_lookup_tables(size_t memory_budget) noexcept = 0;
+
+        /**
+   * Estimate the time of a collective over every NPU in closed form,
+   * without simulating its steps.
+   * The collective buffer of each NPU is split into shards, and expanded into steps
+   * as the congestion-aware Collective does:
+   *   - Ring: N-1 steps, each NPU sends a shard to its ring neighbor per step
+   *   - Direct: a single step, each NPU sends a shard to every other NPU at once
+   *   - HalvingDoubling: log2(N) steps, exchanging with the NPU whose id differs by a single bit
+   *     (N-1 pairwise steps for AllToAll), requiring a power-of-2 number of NPUs
+   *   - AllReduce is a ReduceScatter followed by an AllGather
+   * Each step takes the link delay of its farthest peer plus the serialization delay of its chunk,
+   * as links are assumed to be free of congestion.
+   *
+   * @param type collective communication pattern
+   * @param algorithm collective algorithm
+   * @param size collective buffer size of each NPU
+   * @return estimated time of the collective
+   */
+        [[nodiscard]] virtual EventTime estimate_collective(CollectiveType type,
+                                                            CollectiveAlgorithm algorithm,
+                                                            ChunkSize size) const noexcept = 0;
+
         /**
    * Get the number of NPUs in the topology.
    *
@@ -75,4 +129,7 @@ namespace NetworkAnalyticalCongestionUnaware {
         std::vector<Bandwidth> bandwidth_per_dim;
     };
 
+    /// Immutable topology, safe to share and query across threads
+    using SharedTopology = std::shared_ptr<const Topology>;
+
 }  // namespace NetworkAnalyticalCongestionUnaware
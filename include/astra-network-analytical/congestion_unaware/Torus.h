@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+    /**
+ * Implements a Torus topology of any number of sides, or a Mesh if without the wraparound links.
+ *
+ * Torus(16, shape={4, 4}) example:
+ * +-  0 -  1 -  2 -  3 -+
+ * |   |    |    |    |  |
+ * +-  4 -  5 -  6 -  7 -+
+ * |   |    |    |    |  |
+ * +-  8 -  9 - 10 - 11 -+
+ * |   |    |    |    |  |
+ * +- 12 - 13 - 14 - 15 -+
+ * (and the columns wrap around as well)
+ *
+ * Side 0 is the fastest-varying: NPU (x, y) has the ID x + 4 * y.
+ *
+ * Chunks are routed in dimension order, taking the shorter way around each side of a Torus,
+ * so the hops count is the sum of the distances along the sides.
+ * For example, send(0 -> 15) flows through:
+ * 0 -> 3 -> 15
+ * so takes 2 hops, while it takes 6 hops on a Mesh.
+ */
+    class Torus final : public BasicTopologyImpl<Torus> {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param npus_count number of NPUs, the product of the sides
+   * @param bandwidth bandwidth of each link
+   * @param latency latency of each link
+   * @param shape number of NPUs along each side, {npus_count} if empty
+   * @param wraparound true for a Torus, false for a Mesh
+   */
+        Torus(int npus_count,
+              Bandwidth bandwidth,
+              Latency latency,
+              const std::vector<int>& shape = {},
+              bool wraparound = true) noexcept;
+
+        /**
+   * Get the number of NPUs along each side.
+   *
+   * @return sides of the topology
+   */
+        [[nodiscard]] const std::vector<int>& get_shape() const noexcept;
+
+    private:
+        /// send() calls compute_hops_count directly
+        friend class BasicTopologyImpl<Torus>;
+
+        /**
+   * Implements the compute_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+        /**
+   * Implements the is_rotation_invariant method of BasicTopology.
+   */
+        [[nodiscard]] bool is_rotation_invariant() const noexcept override;
+
+        /**
+   * Implements the compute_max_hops_count method of BasicTopology.
+   */
+        [[nodiscard]] int compute_max_hops_count() const noexcept override;
+
+        /// number of NPUs along each side
+        std::vector<int> shape;
+
+        /// ID distance between neighbors along each side
+        std::vector<int> strides;
+
+        /// true for a Torus, false for a Mesh
+        bool wraparound;
+    };
+
+}  // namespace NetworkAnalyticalCongestionUnaware
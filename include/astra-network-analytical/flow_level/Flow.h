@@ -0,0 +1,101 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "flow_level/Type.h"
+#include <cstddef>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalFlowLevel {
+
+    /**
+ * Flow class represents a transfer modeled as a fluid flow.
+ * A flow occupies every link of its route at once,
+ * draining at the max-min fair rate the Topology assigns to it.
+ */
+    class Flow {
+    public:
+        /**
+   * Callback to be invoked when a flow arrives at its destination.
+   * The callback of the flow is invoked, then the flow is destroyed.
+   *
+   * The event queue holds the ownership of the flow while it's in flight.
+   *
+   * @param flow_ptr: pointer to the flow that's arrived at its destination
+   */
+        static void flow_arrived_dest(Flow* flow_ptr) noexcept;
+
+        /**
+   * Constructor.
+   *
+   * @param flow_size: size of the flow
+   * @param route: route of the flow from its source to destination
+   * @param callback: callback to be invoked when the flow arrives destination
+   * @param callback_arg: argument of the callback
+   */
+        Flow(ChunkSize flow_size, Route route, Callback callback, CallbackArg callback_arg) noexcept;
+
+        /**
+   * Get the size of the flow.
+   *
+   * @return size of the flow
+   */
+        [[nodiscard]] ChunkSize get_size() const noexcept;
+
+        /**
+   * Get the route of the flow.
+   *
+   * @return route of the flow
+   */
+        [[nodiscard]] const Route& get_route() const noexcept;
+
+        /**
+   * Get the current transmission rate of the flow.
+   *
+   * @return rate of the flow in B/ns, 0 if the flow is not in flight
+   */
+        [[nodiscard]] Bandwidth get_rate() const noexcept;
+
+        /**
+   * Invoke the callback.
+   */
+        void invoke_callback() noexcept;
+
+    private:
+        /// Topology updates the transmission state of the flow
+        friend class Topology;
+
+        /// size of the flow
+        ChunkSize flow_size;
+
+        /// route of the flow
+        Route route;
+
+        /// callback to be invoked when the flow arrives destination
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+
+        /// bytes not yet transmitted
+        double remaining_bytes;
+
+        /// max-min fair rate in B/ns
+        Bandwidth rate;
+
+        /// time the remaining bytes drain at the current rate
+        double drain_time;
+
+        /// sum of the latencies of the route
+        Latency route_latency;
+
+        /// index of the flow within the active flows of the Topology
+        size_t active_index;
+    };
+
+}  // namespace NetworkAnalyticalFlowLevel
@@ -0,0 +1,44 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "flow_level/BasicTopology.h"
+
+namespace NetworkAnalyticalFlowLevel {
+
+    /**
+ * Implements a FullyConnected topology.
+ *
+ * FullyConnected(4) example:
+ *    0
+ *  / | \
+ * 3 -|- 1
+ *  \ | /
+ *   2
+ *
+ * Therefore, the number of NPUs and devices are both 4.
+ *
+ * Arbitrary send between two pair of NPUs will take 1 hop.
+ */
+    class FullyConnected final : public BasicTopology {
+    public:
+        /**
+   * Constructor.
+   *
+   * @param npus_count number of npus in the FullyConnected topology
+   * @param bandwidth bandwidth of each link
+   * @param latency latency of each link
+   */
+        FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
+
+        /**
+   * Implementation of route function in Topology.
+   */
+        [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    };
+
+}  // namespace NetworkAnalyticalFlowLevel
@@ -0,0 +1,46 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkConfig.h"
+#include "common/NetworkParser.h"
+#include "flow_level/Topology.h"
+#include <memory>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalFlowLevel {
+
+    /**
+ * Construct a topology from a NetworkParser.
+ *
+ * @param network_parser NetworkParser to parse the network input file
+ * @return pointer to the constructed topology, nullptr if the config isn't supported by the backend
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
+
+    /**
+ * Construct a topology from an in-memory NetworkConfig.
+ *
+ * @param network_config network configuration
+ * @return pointer to the constructed topology,
+ *     nullptr if the config is invalid (see NetworkConfig::validate()) or not supported by the backend
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config) noexcept;
+
+    /**
+ * Construct a topology from an in-memory NetworkConfig, returning the error message if it fails.
+ * The flow_level backend supports 1-dimensional Ring, Switch, and FullyConnected topologies only.
+ *
+ * @param network_config network configuration
+ * @param error set to the error message if the config is invalid or not supported, empty otherwise
+ * @return pointer to the constructed topology, nullptr if the config is invalid or not supported
+ */
+    [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config,
+                                                               std::string& error) noexcept;
+
+}  // namespace NetworkAnalyticalFlowLevel
@@ -0,0 +1,260 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "flow_level/Flow.h"
+#include "flow_level/Type.h"
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalFlowLevel {
+
+    /**
+ * Topology abstracts a network topology simulated at the flow level.
+ *
+ * Every in-flight flow occupies all links of its route simultaneously,
+ * and the link bandwidths are shared among the flows by max-min fairness.
+ * The fair rates are recomputed (by progressive filling) only when a flow starts or drains,
+ * so the number of events doesn't depend on the flow sizes nor on the number of hops.
+ *
+ * A flow arrives its destination the route latency after its last byte is drained.
+ */
+    class Topology {
+    public:
+        /**
+   * Callback to be invoked when the earliest in-flight flow is expected to drain.
+   *
+   * @param topology_ptr: pointer to the topology
+   */
+        static void flows_drained(Topology* topology_ptr) noexcept;
+
+        /**
+   * Constructor.
+   */
+        Topology() noexcept;
+
+        /**
+   * Destructor.
+   */
+        virtual ~Topology() noexcept;
+
+        /**
+   * Set the event queue to be used by the topology.
+   *
+   * @param event_queue pointer to the event queue
+   */
+        void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
+
+        /**
+   * Get the event queue used by the topology.
+   *
+   * @return pointer to the event queue, nullptr if not set yet
+   */
+        [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+        /**
+   * Construct the route from src to dest.
+   * Route is a sequence of links that the flow should traverse.
+   *
+   * @param src src NPU id
+   * @param dest dest NPU id
+   * @return route from src NPU to dest NPU
+   */
+        [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest) const noexcept = 0;
+
+        /**
+   * Initiate a transmission of a flow.
+   * The fair rates of every in-flight flow are recomputed.
+   *
+   * @param flow flow to be transmitted
+   */
+        void send(std::unique_ptr<Flow> flow) noexcept;
+
+        /**
+   * Get the number of in-flight flows, whose bytes are not fully drained yet.
+   *
+   * @return number of in-flight flows
+   */
+        [[nodiscard]] size_t get_active_flows_count() const noexcept;
+
+        /**
+   * Get the number of times the fair rates were recomputed.
+   *
+   * @return number of fair rate recomputations
+   */
+        [[nodiscard]] size_t get_rate_updates_count() const noexcept;
+
+        /**
+   * Get the number of NPUs in the topology.
+   * NPU excludes non-NPU devices such as switches.
+   *
+   * @return number of NPUs in the topology
+   */
+        [[nodiscard]] int get_npus_count() const noexcept;
+
+        /**
+   * Get the number of devices in the topology.
+   * Device includes non-NPU devices such as switches.
+   *
+   * @return number of devices in the topology
+   */
+        [[nodiscard]] int get_devices_count() const noexcept;
+
+        /**
+   * Get the number of links in the topology.
+   *
+   * @return number of links in the topology
+   */
+        [[nodiscard]] int get_links_count() const noexcept;
+
+        /**
+   * Get the number of network dimensions.
+   *
+   * @return number of network dimensions
+   */
+        [[nodiscard]] int get_dims_count() const noexcept;
+
+        /**
+   * Get the number of NPUs per each dimension.
+   *
+   * @return number of NPUs per each dimension
+   */
+        [[nodiscard]] std::vector<int> get_npus_count_per_dim() const noexcept;
+
+        /**
+   * Get the bandwidth per each network dimension.
+   *
+   * @return bandwidth per each dimension
+   */
+        [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
+
+    protected:
+        /// number of total devices in the topology
+        /// device includes non-NPU devices such as switches
+        int devices_count;
+
+        /// number of NPUs in the topology
+        /// NPU excludes non-NPU devices such as switches
+        int npus_count;
+
+        /// number of network dimensions
+        int dims_count;
+
+        /// number of NPUs per each dimension
+        std::vector<int> npus_count_per_dim;
+
+        /// bandwidth per each network dimension
+        std::vector<Bandwidth> bandwidth_per_dim;
+
+        /**
+   * Instantiate the link tables of the devices in the topology.
+   */
+        void instantiate_devices() noexcept;
+
+        /**
+   * Connect src -> dest with the given bandwidth and latency.
+   *
+   * if bidirectional=true, dest -> src connection is also established.
+   *
+   * @param src src device id
+   * @param dest dest device id
+   * @param bandwidth bandwidth of link
+   * @param latency latency of link
+   * @param bidirectional true if connection is bidirectional, false otherwise
+   */
+        void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency,
+                     bool bidirectional = true) noexcept;
+
+        /**
+   * Append the src -> dest link to the route.
+   * src and dest should be connected.
+   *
+   * @param route route to append the link to
+   * @param src src device id
+   * @param dest dest device id
+   */
+        void append_link(Route& route, DeviceId src, DeviceId dest) const noexcept;
+
+    private:
+        /**
+   * Link is a src -> dest connection, whose bandwidth is shared by the flows.
+   */
+        struct Link {
+            /// src device id
+            DeviceId src;
+
+            /// dest device id
+            DeviceId dest;
+
+            /// bandwidth in B/ns
+            Bandwidth bandwidth_Bpns;
+
+            /// latency in ns
+            Latency latency;
+        };
+
+        /// holds the entire links in the topology, indexed by LinkId
+        std::vector<Link> links;
+
+        /// (dest, link id) pairs of the outgoing links per each device, sorted by dest
+        std::vector<std::vector<std::pair<DeviceId, LinkId>>> device_links;
+
+        /// in-flight flows, owned by the topology until drained
+        std::vector<std::unique_ptr<Flow>> active_flows;
+
+        /// event queue the topology schedules its events on
+        std::shared_ptr<EventQueue> event_queue;
+
+        /// time the remaining bytes of the active flows were last updated
+        EventTime last_update_time;
+
+        /// handle of the pending drain event, moved whenever the fair rates change
+        EventHandle drain_event;
+
+        /// time of the pending drain event, valid while it's pending
+        EventTime next_drain_time;
+
+        /// number of fair rate recomputations
+        size_t rate_updates_count;
+
+        /// per-link scratch space of the progressive filling: unallocated bandwidth
+        std::vector<Bandwidth> residual_bandwidth;
+
+        /// per-link scratch space of the progressive filling: number of unfrozen flows
+        std::vector<int> unfrozen_flows_count;
+
+        /**
+   * Subtract the bytes transmitted since the last update from every active flow.
+   *
+   * @param current_time current time
+   */
+        void advance_flows(EventTime current_time) noexcept;
+
+        /**
+   * Recompute the max-min fair rates of the active flows by progressive filling,
+   * and the time their remaining bytes drain at.
+   */
+        void update_rates() noexcept;
+
+        /**
+   * Schedule a drain event at the earliest drain time of the active flows, if not already scheduled.
+   */
+        void schedule_drain() noexcept;
+
+        /**
+   * Retire the active flows drained by the current time,
+   * and schedule their arrivals at the destinations.
+   */
+        void process_drained_flows() noexcept;
+    };
+
+}  // namespace NetworkAnalyticalFlowLevel
@@ -0,0 +1,25 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalFlowLevel {
+
+    class Flow;
+
+    class Topology;
+
+    /// Link ID which indexes the link table of a Topology
+    using LinkId = int;
+
+    /// Route of a flow: sequence of links from its src to dest
+    using Route = std::vector<LinkId>;
+
+}  // namespace NetworkAnalyticalFlowLevel
@@ -3,12 +3,40 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/EventProfiler.h"
 #include "common/EventQueue.h"
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
+#include "common/RingBuffer.h"
 #include "common/Type.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkGenerator.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/CollectiveCache.h"
+#include "congestion_aware/CompiledTopology.h"
+#ifdef ANALYTICAL_MPI
+#include "congestion_aware/DistributedSimulator.h"
+#endif
+#include "congestion_aware/FatTree.h"
+#include "congestion_aware/FullyConnected.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/ParallelSimulator.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/Snapshot.h"
+#include "congestion_aware/SweepRunner.h"
+#include "congestion_aware/Switch.h"
+#include "congestion_aware/Torus.h"
+#include "congestion_aware/TraceReplayer.h"
+#include "congestion_aware/Tracer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
@@ -16,9 +44,8 @@ using namespace NetworkAnalyticalCongestionAware;
 class TestNetworkAnalyticalCongestionAware : public ::testing::Test {
 protected:
     void SetUp() override {
-        // set event queue
+        // create event queue
         event_queue = std::make_shared<EventQueue>();
-        Topology::set_event_queue(event_queue);
 
         // set chunk size
         chunk_size = 1'048'576;  // 1 MB
@@ -35,6 +62,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Ring) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Ring.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -57,6 +85,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnected) {
     /// setup
     const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -79,6 +108,7 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Switch) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Switch.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
 
     /// message settings
     auto route = topology->route(1, 4);
@@ -97,10 +127,50 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Switch) {
     EXPECT_EQ(simulation_time, 40'062);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionAware, Ring_FullyConnected_Switch) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    // 64 NPUs, and a switch per each of the 16 dim-3 instances
+    EXPECT_EQ(topology->get_npus_count(), 64);
+    EXPECT_EQ(topology->get_devices_count(), 80);
+    EXPECT_EQ(topology->get_dims_count(), 3);
+
+    // send a chunk, and return its communication delay
+    const auto send = [&](const DeviceId src, const DeviceId dest) {
+        const auto start_time = event_queue->get_current_time();
+        topology->send(std::make_unique<Chunk>(chunk_size, topology->route(src, dest), callback, nullptr));
+        event_queue->run_to_completion();
+        return event_queue->get_current_time() - start_time;
+    };
+
+    /// test
+    // run on dim 1: [0, 0, 0] -> [1, 0, 0]
+    EXPECT_EQ(send(0, 1), 4'932);
+
+    // run on dim 2: [1, 2, 2] -> [1, 4, 2]
+    EXPECT_EQ(send(37, 41), 10'265);
+
+    // run on dim 3: [0, 5, 1] -> [0, 5, 2], through the switch
+    EXPECT_EQ(send(26, 42), 43'062);
+
+    // run on every dim in order: [0, 0, 0] -> [1, 0, 0] -> [1, 7, 0] -> switch -> [1, 7, 3]
+    const auto route = topology->route(0, 63);
+    const auto expected_route = std::vector<DeviceId>{0, 1, 15, 64 + 15, 63};
+    ASSERT_EQ(route.size(), expected_route.size());
+    for (auto i = size_t(0); i < expected_route.size(); i++) {
+        EXPECT_EQ(route.at(i), expected_route[i]);
+    }
+    EXPECT_EQ(send(0, 63), 4'932 + 10'265 + 43'062);
+}
+
 TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     /// setup
     const auto network_parser = NetworkParser("../../input/Ring.yml");
     const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
     const auto npus_count = topology->get_npus_count();
 
     /// message settings
@@ -132,3 +202,1876 @@ TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     const auto simulation_time = event_queue->get_current_time();
     EXPECT_EQ(simulation_time, 704'116);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRingListBackend) {
+    /// setup
+    event_queue = std::make_shared<EventQueue>(EventQueueBackend::List);
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            // create and send a chunk
+            auto route = topology->route(i, j);
+            auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+    }
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 704'116);
+}
+
+/// records the invocation order of scheduled events
+struct EventRecord {
+    EventQueue* event_queue;
+    std::vector<std::pair<EventTime, int>>* invoked;
+    int id;
+    int rescheduled;
+};
+
+static void record_event(void* const arg) {
+    auto* const record = static_cast<EventRecord*>(arg);
+    const auto current_time = record->event_queue->get_current_time();
+    record->invoked->emplace_back(current_time, record->id);
+
+    // reschedule each event a few times, sometimes at the current time
+    if (record->rescheduled < 3) {
+        record->rescheduled++;
+        const auto delay = static_cast<EventTime>((record->id * 7919 + record->rescheduled * 104'729) % 5'000);
+        record->event_queue->schedule_event(current_time + delay, record_event, arg);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueueBackendsMatch) {
+    auto invoked_per_backend = std::vector<std::vector<std::pair<EventTime, int>>>();
+
+    for (const auto backend : {EventQueueBackend::List, EventQueueBackend::Calendar}) {
+        auto queue = EventQueue(backend);
+        auto invoked = std::vector<std::pair<EventTime, int>>();
+        auto records = std::vector<EventRecord>();
+        records.reserve(2'000);
+
+        // schedule events at scattered, partially colliding times
+        for (auto i = 0; i < 2'000; i++) {
+            records.push_back({&queue, &invoked, i, 0});
+            const auto event_time = static_cast<EventTime>(1 + (i * 2'654'435'761U) % 50'000);
+            queue.schedule_event(event_time, record_event, &records.back());
+        }
+
+        // run simulation
+        while (!queue.finished()) {
+            queue.proceed();
+        }
+
+        invoked_per_backend.push_back(std::move(invoked));
+    }
+
+    /// test
+    EXPECT_EQ(invoked_per_backend[0].size(), 8'000);
+    EXPECT_EQ(invoked_per_backend[0], invoked_per_backend[1]);
+}
+
+/// schedules itself again until the given number of hops
+struct ChainedEvent {
+    EventQueue* event_queue;
+    int remaining_hops;
+};
+
+static void chained_event(void* const arg) {
+    auto* const chained = static_cast<ChainedEvent*>(arg);
+    if (chained->remaining_hops > 0) {
+        chained->remaining_hops--;
+        const auto next_time = chained->event_queue->get_current_time() + 10;
+        chained->event_queue->schedule_event(next_time, chained_event, arg);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventListPoolRecycled) {
+    for (const auto backend : {EventQueueBackend::List, EventQueueBackend::Calendar}) {
+        auto queue = EventQueue(backend);
+        auto chained = ChainedEvent {&queue, 1'000};
+        queue.schedule_event(10, chained_event, &chained);
+
+        // run simulation
+        while (!queue.finished()) {
+            queue.proceed();
+        }
+
+        /// test
+        // the event list being invoked and the next one are the only ones in use
+        EXPECT_EQ(queue.get_current_time(), 10'010);
+        EXPECT_EQ(queue.get_peak_pool_usage(), 2);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RunUntil) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// message settings
+    auto route = topology->route(1, 4);
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+    topology->send(std::move(chunk));
+
+    /// Run simulation in two steps
+    const auto first_summary = event_queue->run_until(30'000);
+    EXPECT_FALSE(event_queue->finished());
+    EXPECT_LE(event_queue->get_current_time(), 30'000);
+
+    const auto second_summary = event_queue->run_to_completion();
+    EXPECT_TRUE(event_queue->finished());
+
+    /// test
+    // 3 hops, each of which invokes a chunk arrival event
+    // the links are never contended, so no link free event is scheduled
+    EXPECT_EQ(event_queue->get_current_time(), 60'093);
+    EXPECT_EQ(first_summary.events_count + second_summary.events_count, 3);
+    EXPECT_EQ(first_summary.event_times_count + second_summary.event_times_count, 3);
+}
+
+static void increment_counter(int* const counter) noexcept {
+    (*counter)++;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TypedEvent) {
+    auto counter = 0;
+
+    // typed events are interleaved with ordinary callbacks in time order
+    event_queue->schedule_event<int, increment_counter>(10, &counter);
+    event_queue->schedule_event<int, increment_counter>(20, &counter);
+    event_queue->schedule_event(20, callback, nullptr);
+    event_queue->run_until(10);
+
+    /// test
+    EXPECT_EQ(counter, 1);
+    const auto summary = event_queue->run_to_completion();
+    EXPECT_EQ(counter, 2);
+    EXPECT_EQ(summary.events_count, 2);
+}
+
+/// records the arrival time of a chunk
+struct ChunkArrival {
+    EventQueue* event_queue;
+    EventTime arrival_time;
+};
+
+static void record_arrival(void* const arg) {
+    auto* const arrival = static_cast<ChunkArrival*>(arg);
+    arrival->arrival_time = arrival->event_queue->get_current_time();
+}
+
+/// run an all-to-all sent at once, sequentially if partitions_count is 0, and return the chunk arrival times
+static std::vector<EventTime> run_all_to_all(const std::shared_ptr<Topology>& topology,
+                                             const int partitions_count,
+                                             const ChunkSize chunk_size) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    auto simulator = std::unique_ptr<ParallelSimulator>();
+    if (partitions_count > 0) {
+        simulator = std::make_unique<ParallelSimulator>(topology, partitions_count);
+    }
+
+    auto arrivals = std::vector<ChunkArrival>(npus_count * npus_count);
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            auto* const arrival = &arrivals[i * npus_count + j];
+            arrival->event_queue = (simulator != nullptr) ? simulator->get_event_queue(j) : event_queue.get();
+            topology->send(topology->make_chunk(chunk_size, i, j, record_arrival, arrival));
+        }
+    }
+
+    if (simulator != nullptr) {
+        simulator->run();
+    } else {
+        event_queue->run_to_completion();
+    }
+
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto& arrival : arrivals) {
+        arrival_times.push_back(arrival.arrival_time);
+    }
+    return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelMatchesSequential) {
+    const auto paths = {"../../input/Ring.yml", "../../input/Switch.yml", "../../input/FullyConnected.yml"};
+    for (const auto* const path : paths) {
+        const auto network_parser = NetworkParser(path);
+        const auto sequential = run_all_to_all(construct_topology(network_parser), 0, 1'048'576);
+
+        for (const auto partitions_count : {2, 3, 4}) {
+            const auto parallel = run_all_to_all(construct_topology(network_parser), partitions_count, 1'048'576);
+            EXPECT_EQ(sequential, parallel) << path << " with " << partitions_count << " partitions";
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelMatchesSequentialMixedLatencies) {
+    /// setup
+    // chunks sent at once over dimensions of different latencies arrive at the same times
+    // from different partitions, and contend for the same links
+    const auto network_config = NetworkConfig()
+                                        .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 10)
+                                        .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 200);
+    const auto sequential = run_all_to_all(construct_topology(network_config), 0, 1'024);
+
+    /// test
+    for (const auto partitions_count : {2, 3, 4}) {
+        const auto parallel = run_all_to_all(construct_topology(network_config), partitions_count, 1'024);
+        EXPECT_EQ(sequential, parallel) << "with " << partitions_count << " partitions";
+    }
+}
+
+/// token hopping over 4 links of growing strides, each sent from the callback of the previous hop
+struct LazyLinksToken {
+    Topology* topology;
+    EventQueue* event_queue;
+    ParallelSimulator* simulator;
+    DeviceId device;
+    int hops_count;
+    EventTime arrival_time;
+};
+
+static void send_token(LazyLinksToken* const token) {
+    const auto src = token->device;
+    token->hops_count++;
+    token->device = (src + token->hops_count) % token->topology->get_npus_count();
+    token->topology->send(token->topology->make_chunk(1'048'576, src, token->device, [](void* const arg) {
+        auto* const token = static_cast<LazyLinksToken*>(arg);
+        if (token->hops_count < 4) {
+            send_token(token);
+            return;
+        }
+        const auto* const event_queue =
+            (token->simulator != nullptr) ? token->simulator->get_event_queue(token->device) : token->event_queue;
+        token->arrival_time = event_queue->get_current_time();
+    }, token));
+}
+
+/// forward a token from every NPU of a lazy FullyConnected topology, sequentially if partitions_count is 0
+static std::vector<EventTime> run_lazy_tokens(const int partitions_count, size_t& instantiated_links_count) {
+    const auto npus_count = 64;
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = std::make_shared<FullyConnected>(npus_count, 50, 500, true);
+    topology->set_event_queue(event_queue);
+    topology->enable_route_cache(1 << 20);
+
+    // binding the partitions creates no link
+    auto simulator = std::unique_ptr<ParallelSimulator>();
+    if (partitions_count > 0) {
+        simulator = std::make_unique<ParallelSimulator>(topology, partitions_count);
+    }
+    EXPECT_EQ(topology->get_instantiated_links_count(), 0);
+
+    // the following links and routes are created by the partitions concurrently
+    auto tokens = std::vector<LazyLinksToken>(npus_count);
+    for (auto i = 0; i < npus_count; i++) {
+        tokens[i] = {topology.get(), event_queue.get(), simulator.get(), i, 0, 0};
+        send_token(&tokens[i]);
+    }
+    if (simulator != nullptr) {
+        simulator->run();
+    } else {
+        event_queue->run_to_completion();
+    }
+
+    instantiated_links_count = topology->get_instantiated_links_count();
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto& token : tokens) {
+        arrival_times.push_back(token.arrival_time);
+    }
+    return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelLazyLinks) {
+    /// Run sequentially and in parallel
+    auto instantiated_links_count = size_t(0);
+    const auto arrival_times = run_lazy_tokens(0, instantiated_links_count);
+    auto parallel_instantiated_links_count = size_t(0);
+    const auto parallel_arrival_times = run_lazy_tokens(4, parallel_instantiated_links_count);
+
+    /// test: identical results, with only the used links created (a distinct link per token and hop)
+    EXPECT_EQ(parallel_arrival_times, arrival_times);
+    EXPECT_EQ(instantiated_links_count, 64 * 4);
+    EXPECT_EQ(parallel_instantiated_links_count, 64 * 4);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, IndependentSimulations) {
+    /// setup
+    // two topologies bound to their own event queues
+    const auto ring_event_queue = std::make_shared<EventQueue>();
+    const auto ring = construct_topology(NetworkParser("../../input/Ring.yml"));
+    ring->set_event_queue(ring_event_queue);
+
+    const auto switch_event_queue = std::make_shared<EventQueue>();
+    const auto switch_topology = construct_topology(NetworkParser("../../input/Switch.yml"));
+    switch_topology->set_event_queue(switch_event_queue);
+
+    /// message settings
+    ring->send(std::make_unique<Chunk>(chunk_size, ring->route(1, 4), callback, nullptr));
+    switch_topology->send(std::make_unique<Chunk>(chunk_size, switch_topology->route(1, 4), callback, nullptr));
+
+    /// Run simulations interleaved
+    while (!ring_event_queue->finished() || !switch_event_queue->finished()) {
+        if (!ring_event_queue->finished()) {
+            ring_event_queue->proceed();
+        }
+        if (!switch_event_queue->finished()) {
+            switch_event_queue->proceed();
+        }
+    }
+
+    /// test
+    EXPECT_EQ(ring_event_queue->get_current_time(), 60'093);
+    EXPECT_EQ(switch_event_queue->get_current_time(), 40'062);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SweepRunner) {
+    /// setup
+    const auto send_chunk = [this](Topology& topology) {
+        topology.send(std::make_unique<Chunk>(chunk_size, topology.route(1, 4), callback, nullptr));
+    };
+    const auto all_gather = [this](Topology& topology) {
+        const auto npus_count = topology.get_npus_count();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology.send(std::make_unique<Chunk>(chunk_size, topology.route(i, j), callback, nullptr));
+                }
+            }
+        }
+    };
+
+    auto sweep_runner = SweepRunner(3);
+    sweep_runner.add_config("../../input/Ring.yml", send_chunk);
+    sweep_runner.add_config("../../input/FullyConnected.yml", send_chunk);
+    sweep_runner.add_config("../../input/Switch.yml", send_chunk);
+    sweep_runner.add_config("../../input/Ring.yml", all_gather);
+    sweep_runner.add_config("../../input/Ring.yml", all_gather);
+
+    /// Run sweep
+    const auto finish_times = sweep_runner.run();
+
+    /// test
+    const auto expected_finish_times = std::vector<EventTime>({60'093, 20'031, 40'062, 704'116, 704'116});
+    EXPECT_EQ(sweep_runner.get_configs_count(), 5);
+    EXPECT_EQ(finish_times, expected_finish_times);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteTraversal) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+
+    // route of 9 devices, which exceeds the inline storage
+    auto route = topology->route(0, 8);
+    EXPECT_GT(route.size(), Route::inline_capacity);
+
+    /// test
+    // traverse the ring clockwise
+    for (auto device = 0; device <= 8; device++) {
+        EXPECT_EQ(route.size(), 9 - device);
+        EXPECT_EQ(route.at(0), device);
+        EXPECT_EQ(route.device(0)->get_id(), device);
+        if (device < 8) {
+            // the route holds the link of each hop
+            EXPECT_EQ(route.link(0)->get_src(), device);
+            EXPECT_EQ(route.link(0)->get_dest(), device + 1);
+        }
+        route.pop_front();
+    }
+    EXPECT_TRUE(route.empty());
+
+    // short route is kept inline
+    const auto short_route = topology->route(1, 4);
+    EXPECT_EQ(short_route.size(), 4);
+    EXPECT_EQ(short_route.at(3), 4);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteCache) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->enable_route_cache(1 << 20);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather twice
+    for (int iteration = 0; iteration < 2; iteration++) {
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology->send(std::make_unique<Chunk>(chunk_size, topology->route(i, j), callback, nullptr));
+                }
+            }
+        }
+        event_queue->run_to_completion();
+    }
+
+    /// test
+    // the first all-gather interns every route, the second one reuses them
+    const auto* const route_cache = topology->get_route_cache();
+    EXPECT_EQ(event_queue->get_current_time(), 2 * 704'116);
+    EXPECT_EQ(route_cache->get_routes_count(), 240);
+    EXPECT_EQ(route_cache->get_misses_count(), 240);
+    EXPECT_EQ(route_cache->get_hits_count(), 240);
+    EXPECT_LE(route_cache->get_memory_usage(), route_cache->get_memory_cap());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteCacheMemoryCap) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->enable_route_cache(1'024, true);
+
+    /// test
+    // only a part of the routes fits within the cap, the others are constructed on demand
+    const auto* const route_cache = topology->get_route_cache();
+    EXPECT_GT(route_cache->get_routes_count(), 0);
+    EXPECT_LT(route_cache->get_routes_count(), 240);
+    EXPECT_LE(route_cache->get_memory_usage(), 1'024);
+
+    const auto route = topology->route(15, 8);
+    EXPECT_EQ(route.size(), 8);
+    EXPECT_EQ(route.at(7), 8);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPoolRecycled) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather twice
+    for (int iteration = 0; iteration < 2; iteration++) {
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology->send(topology->make_chunk(chunk_size, i, j, callback, nullptr));
+                }
+            }
+        }
+        event_queue->run_to_completion();
+    }
+
+    /// test
+    // every chunk returned to the pool, and the second all-gather reused the slots
+    const auto& chunk_pool = topology->get_chunk_pool();
+    EXPECT_EQ(event_queue->get_current_time(), 2 * 704'116);
+    EXPECT_EQ(chunk_pool.get_in_use_count(), 0);
+    EXPECT_EQ(chunk_pool.get_peak_usage(), 240);
+    EXPECT_EQ(chunk_pool.get_capacity(), 256);
+}
+
+/// run an all-to-all of unit chunks on a switch, and return the chunk arrival times
+static std::vector<EventTime> run_switch_all_to_all(const bool coalescing, const bool express, RunSummary& summary) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->set_link_coalescing(coalescing);
+    topology->set_express_scheduling(express);
+    const auto npus_count = topology->get_npus_count();
+
+    auto arrivals = std::vector<ChunkArrival>(npus_count * npus_count, {event_queue.get(), 0});
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                auto* const arrival = &arrivals[i * npus_count + j];
+                topology->send(topology->make_chunk(1'048'576, i, j, record_arrival, arrival));
+            }
+        }
+    }
+    summary = event_queue->run_to_completion();
+
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto& arrival : arrivals) {
+        arrival_times.push_back(arrival.arrival_time);
+    }
+    return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkCoalescing) {
+    /// Run all-to-all with and without coalescing
+    auto summary = RunSummary();
+    const auto arrival_times = run_switch_all_to_all(false, false, summary);
+    auto coalesced_summary = RunSummary();
+    const auto coalesced_arrival_times = run_switch_all_to_all(true, false, coalesced_summary);
+
+    /// test
+    // every chunk arrives at the same time, with far fewer link free events
+    EXPECT_EQ(arrival_times, coalesced_arrival_times);
+    EXPECT_LT(coalesced_summary.events_count, summary.events_count * 2 / 3);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SendBatch) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run all-to-all in a single batch
+    auto arrivals = std::vector<ChunkArrival>(npus_count * npus_count, {event_queue.get(), 0});
+    auto requests = std::vector<SendRequest>();
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                requests.push_back({i, j, 1'048'576, record_arrival, &arrivals[i * npus_count + j]});
+            }
+        }
+    }
+    topology->send_batch(requests);
+    const auto batch_summary = event_queue->run_to_completion();
+
+    auto batch_arrival_times = std::vector<EventTime>();
+    for (const auto& arrival : arrivals) {
+        batch_arrival_times.push_back(arrival.arrival_time);
+    }
+
+    /// test: same as sending the chunks one by one
+    auto summary = RunSummary();
+    EXPECT_EQ(batch_arrival_times, run_switch_all_to_all(false, false, summary));
+    EXPECT_EQ(batch_summary.events_count, summary.events_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ExpressScheduling) {
+    /// Run all-to-all with and without express scheduling
+    auto summary = RunSummary();
+    const auto arrival_times = run_switch_all_to_all(false, false, summary);
+    auto express_summary = RunSummary();
+    const auto express_arrival_times = run_switch_all_to_all(false, true, express_summary);
+
+    /// test
+    // every chunk arrives at the same time, skipping the idle switch hops
+    EXPECT_EQ(arrival_times, express_arrival_times);
+    EXPECT_LT(express_summary.events_count, summary.events_count);
+}
+
+/// send a chunk 1 -> 4 on a ring, and another chunk 3 -> 4 while the first one is in flight
+static EventTime run_ring_overtaken(const bool express) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->set_express_scheduling(express);
+
+    auto arrival = ChunkArrival{event_queue.get(), 0};
+    topology->send(topology->make_chunk(1'048'576, 1, 4, record_arrival, &arrival));
+    event_queue->schedule_event(
+        30'000,
+        [](void* const arg) {
+            auto* const topology = static_cast<Topology*>(arg);
+            topology->send(topology->make_chunk(1'048'576, 3, 4, [](void* const) {}, nullptr));
+        },
+        topology.get());
+    event_queue->run_to_completion();
+
+    return arrival.arrival_time;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ExpressSchedulingRollback) {
+    /// Run with and without express scheduling
+    const auto arrival_time = run_ring_overtaken(false);
+    const auto express_arrival_time = run_ring_overtaken(true);
+
+    /// test
+    // the reservation of link 3 -> 4 is rolled back, and the chunk waits for it as it does hop by hop
+    EXPECT_GT(arrival_time, 60'093);
+    EXPECT_EQ(express_arrival_time, arrival_time);
+}
+
+/// run an all-to-all of small chunks sent at once on a 2D ring with mixed latencies, and return the arrival times
+static std::vector<EventTime> run_contended_all_to_all(const bool express, RunSummary& summary) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = construct_topology(NetworkConfig()
+                                                 .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 10)
+                                                 .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 200));
+    topology->set_event_queue(event_queue);
+    topology->set_express_scheduling(express);
+    const auto npus_count = topology->get_npus_count();
+
+    auto arrivals = std::vector<ChunkArrival>(npus_count * npus_count, ChunkArrival{event_queue.get(), 0});
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                topology->send(topology->make_chunk(1'024, i, j, record_arrival, &arrivals[i * npus_count + j]));
+            }
+        }
+    }
+    summary = event_queue->run_to_completion();
+
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto& arrival : arrivals) {
+        arrival_times.push_back(arrival.arrival_time);
+    }
+    return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ExpressSchedulingContended) {
+    /// Run with and without express scheduling
+    auto summary = RunSummary();
+    const auto arrival_times = run_contended_all_to_all(false, summary);
+    auto express_summary = RunSummary();
+    const auto express_arrival_times = run_contended_all_to_all(true, express_summary);
+
+    /// test
+    // chunks requesting a link at the same time are served in the same order as hop by hop,
+    // even when they're relayed through express hops of different lengths
+    EXPECT_EQ(arrival_times, express_arrival_times);
+    EXPECT_LT(express_summary.events_count, summary.events_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkFreeEventsOnlyWhenContended) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// 3 chunks from NPU 0 to NPU 1: the last two wait for the uplink and downlink of the switch
+    for (auto i = 0; i < 3; i++) {
+        topology->send(topology->make_chunk(chunk_size, 0, 1, callback, nullptr));
+    }
+    const auto summary = event_queue->run_to_completion();
+
+    /// test
+    // 2 arrivals per chunk, and a link free event per waiting chunk on the uplink
+    // the downlink is free by the time every chunk arrives at the switch
+    EXPECT_EQ(summary.events_count, 3 * 2 + 2);
+}
+
+/// run a collective on the topology, and return its finish time
+static EventTime run_collective(const std::string& path,
+                                const CollectiveType type,
+                                const CollectiveAlgorithm algorithm,
+                                const ChunkSize size) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser(path);
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    auto finish = ChunkArrival{event_queue.get(), 0};
+    auto collective = Collective(topology.get(), type, algorithm, size, record_arrival, &finish);
+    collective.start();
+    event_queue->run_to_completion();
+
+    EXPECT_TRUE(collective.finished());
+    return finish.arrival_time;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Collective) {
+    const auto ring = std::string("../../input/Ring.yml");
+    const auto shards_size = 16 * chunk_size;
+
+    /// test
+    // direct all-gather is the same as sending every chunk at once
+    EXPECT_EQ(run_collective(ring, CollectiveType::AllGather, CollectiveAlgorithm::Direct, shards_size), 704'116);
+
+    // ring all-gather forwards a shard over a single hop per step
+    EXPECT_EQ(run_collective(ring, CollectiveType::AllGather, CollectiveAlgorithm::Ring, shards_size), 15 * 20'031);
+    EXPECT_EQ(run_collective(ring, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, shards_size),
+              2 * 15 * 20'031);
+
+    // halving-doubling all-gather and reduce-scatter mirror each other
+    const auto all_gather =
+        run_collective(ring, CollectiveType::AllGather, CollectiveAlgorithm::HalvingDoubling, shards_size);
+    const auto reduce_scatter =
+        run_collective(ring, CollectiveType::ReduceScatter, CollectiveAlgorithm::HalvingDoubling, shards_size);
+    EXPECT_EQ(all_gather, reduce_scatter);
+    EXPECT_EQ(run_collective(ring, CollectiveType::AllReduce, CollectiveAlgorithm::HalvingDoubling, shards_size),
+              all_gather + reduce_scatter);
+
+    // every all-to-all algorithm sends the same shards
+    EXPECT_GT(run_collective(ring, CollectiveType::AllToAll, CollectiveAlgorithm::Ring, shards_size), 0);
+    EXPECT_GT(run_collective(ring, CollectiveType::AllToAll, CollectiveAlgorithm::HalvingDoubling, shards_size), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectiveChunksCount) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// test
+    auto ring = Collective(topology.get(), CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size, callback,
+                           nullptr);
+    EXPECT_EQ(ring.get_steps_count(), 2 * (npus_count - 1));
+    EXPECT_EQ(ring.get_chunks_count(), 2 * npus_count * (npus_count - 1));
+
+    auto direct = Collective(topology.get(), CollectiveType::AllToAll, CollectiveAlgorithm::Direct, chunk_size,
+                             callback, nullptr);
+    EXPECT_EQ(direct.get_steps_count(), 1);
+    EXPECT_EQ(direct.get_chunks_count(), npus_count * (npus_count - 1));
+}
+
+#ifdef ANALYTICAL_TELEMETRY
+TEST_F(TestNetworkAnalyticalCongestionAware, Telemetry) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// 3 chunks from NPU 0 to NPU 1, the last two wait for the uplink of NPU 0
+    for (auto i = 0; i < 3; i++) {
+        topology->send(topology->make_chunk(chunk_size, 0, 1, callback, nullptr));
+    }
+    event_queue->run_to_completion();
+
+    /// test
+    const auto& telemetry = topology->get_telemetry();
+    const auto uplink = topology->get_device(0)->get_link_id(topology->route(0, 1).at(1));
+    EXPECT_EQ(telemetry.get_links_count(), topology->get_links_count());
+    EXPECT_EQ(telemetry.get_bytes_sent(uplink), 3 * chunk_size);
+    EXPECT_EQ(telemetry.get_chunks_sent(uplink), 3);
+    EXPECT_EQ(telemetry.get_max_pending_depth(uplink), 2);
+    EXPECT_EQ(telemetry.get_queued_chunks(uplink), 2);
+
+    // the chunks wait for 1 and 2 serialization delays
+    const auto serialization_delay = telemetry.get_busy_time(uplink) / 3;
+    EXPECT_EQ(telemetry.get_max_queuing_delay(uplink), 2 * serialization_delay);
+    EXPECT_DOUBLE_EQ(telemetry.get_average_queuing_delay(uplink), 1.5 * serialization_delay);
+
+    // a row per link and a header
+    auto csv = std::stringstream();
+    telemetry.write_csv(csv, event_queue->get_current_time());
+    EXPECT_EQ(std::count(std::istreambuf_iterator<char>(csv), {}, '\n'), topology->get_links_count() + 1);
+}
+#endif
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Tracer) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather with tiny buffers, so that the writer thread flushes them along the way
+    auto records_count = uint64_t(0);
+    {
+        auto tracer = Tracer("trace.bin", 16);
+        topology->set_tracer(&tracer);
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology->send(topology->make_chunk(chunk_size, i, j, callback, nullptr));
+                }
+            }
+        }
+        event_queue->run_to_completion();
+        tracer.flush();
+        records_count = tracer.get_records_count();
+        topology->set_tracer(nullptr);
+    }
+    Tracer::convert_to_chrome_json("trace.bin", "trace.json");
+
+    /// test
+    // every hop is a transmission and an arrival
+    auto hops_count = uint64_t(0);
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                hops_count += topology->route(i, j).size() - 1;
+            }
+        }
+    }
+    EXPECT_EQ(records_count, 2 * hops_count);
+
+    // the trace file holds every record, and the JSON file a slice per transmission
+    auto trace = std::ifstream("trace.bin", std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<uint64_t>(trace.tellg()), 8 + (records_count * sizeof(TraceRecord)));
+
+    auto json = std::ifstream("trace.json");
+    const auto content = std::string(std::istreambuf_iterator<char>(json), {});
+    auto slices_count = uint64_t(0);
+    for (auto position = content.find("\"ph\": \"X\""); position != std::string::npos;
+         position = content.find("\"ph\": \"X\"", position + 1)) {
+        slices_count++;
+    }
+    EXPECT_EQ(slices_count, hops_count);
+}
+
+/// arrival records of an all-to-all on a switch, and a marker event at the end
+struct SnapshotRun {
+    std::shared_ptr<EventQueue> event_queue;
+    std::shared_ptr<Topology> topology;
+    std::vector<ChunkArrival> arrivals;
+};
+
+static SnapshotRun make_snapshot_run() {
+    auto run = SnapshotRun();
+    run.event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    run.topology = construct_topology(network_parser);
+    run.topology->set_event_queue(run.event_queue);
+    const auto npus_count = run.topology->get_npus_count();
+    run.arrivals = std::vector<ChunkArrival>((npus_count * npus_count) + 1, {run.event_queue.get(), 0});
+    return run;
+}
+
+static std::vector<EventTime> arrival_times_of(const SnapshotRun& run) {
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto& arrival : run.arrivals) {
+        arrival_times.push_back(arrival.arrival_time);
+    }
+    return arrival_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Snapshot) {
+    /// setup
+    auto run = make_snapshot_run();
+    const auto npus_count = run.topology->get_npus_count();
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                auto* const arrival = &run.arrivals[i * npus_count + j];
+                run.topology->send(run.topology->make_chunk(1'048'576, i, j, record_arrival, arrival));
+            }
+        }
+    }
+    run.event_queue->schedule_event(500'000, record_arrival, &run.arrivals.back());
+
+    /// Run the shared prefix, then capture it
+    // every callback argument is an arrival record, encoded by its index
+    run.event_queue->run_until(200'000);
+    const auto snapshot = Snapshot::capture(*run.topology, [&](const Callback callback, const CallbackArg arg) {
+        EXPECT_EQ(callback, record_arrival);
+        return static_cast<CallbackHandle>(static_cast<ChunkArrival*>(arg) - run.arrivals.data());
+    });
+    snapshot.save("snapshot.bin");
+
+    /// Fork the snapshot, once in memory and once through the file
+    auto fork = make_snapshot_run();
+    auto loaded_fork = make_snapshot_run();
+    for (auto* const branch : {&fork, &loaded_fork}) {
+        const auto decoder = [branch](const CallbackHandle handle) {
+            return std::make_pair(Callback(record_arrival), CallbackArg(&branch->arrivals[handle]));
+        };
+        if (branch == &fork) {
+            snapshot.restore(*branch->topology, decoder);
+        } else {
+            Snapshot::load("snapshot.bin").restore(*branch->topology, decoder);
+        }
+        EXPECT_EQ(branch->event_queue->get_current_time(), snapshot.get_time());
+    }
+
+    // every branch resumes from the prefix
+    run.event_queue->run_to_completion();
+    fork.event_queue->run_to_completion();
+    loaded_fork.event_queue->run_to_completion();
+
+    /// test
+    // the snapshot caught chunks both in flight and pending in the links
+    EXPECT_GT(snapshot.get_chunks_count(), 0);
+    EXPECT_LT(snapshot.get_chunks_count(), npus_count * (npus_count - 1));
+    EXPECT_GT(snapshot.get_events_count(), 1);
+
+    // the branches finish exactly as the original simulation, chunks that arrived in the prefix aside
+    const auto arrival_times = arrival_times_of(run);
+    auto fork_arrival_times = arrival_times_of(fork);
+    auto loaded_fork_arrival_times = arrival_times_of(loaded_fork);
+    EXPECT_EQ(fork_arrival_times, loaded_fork_arrival_times);
+    EXPECT_EQ(fork.event_queue->get_current_time(), run.event_queue->get_current_time());
+    EXPECT_EQ(fork_arrival_times.back(), 500'000);
+    for (auto i = size_t(0); i < arrival_times.size(); i++) {
+        if (arrival_times[i] > snapshot.get_time()) {
+            EXPECT_EQ(fork_arrival_times[i], arrival_times[i]);
+        } else {
+            EXPECT_EQ(fork_arrival_times[i], 0);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CutThrough) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    // send a chunk over idle links, and return its arrival time
+    const auto send = [&](const ChunkSize packet_size, RunSummary& summary) {
+        topology->set_cut_through(packet_size);
+        const auto start_time = event_queue->get_current_time();
+        topology->send(std::make_unique<Chunk>(chunk_size, topology->route(1, 4), callback, nullptr));
+        summary = event_queue->run_to_completion();
+        return event_queue->get_current_time() - start_time;
+    };
+
+    /// test
+    // a single packet per chunk is store-and-forward: same as the hop-by-hop simulation
+    auto summary = RunSummary();
+    EXPECT_EQ(send(chunk_size, summary), 60'093);
+
+    // 64 KB packets are pipelined over the 3 hops, with a single arrival event
+    EXPECT_EQ(send(65'536, summary), 23'472);
+    EXPECT_EQ(summary.events_count, 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CutThroughSubNanosecondLatency) {
+    /// setup
+    // 0.4 ns of latency per hop, 19'531.25 ns of serialization delay
+    const auto topology = construct_topology(NetworkConfig().add_dimension(TopologyBuildingBlock::Ring, 8, 50, 0.4));
+    topology->set_event_queue(event_queue);
+
+    // send a chunk over 4 idle hops, and return its arrival time
+    const auto send = [&](const ChunkSize packet_size) {
+        topology->set_cut_through(packet_size);
+        const auto start_time = event_queue->get_current_time();
+        topology->send(std::make_unique<Chunk>(chunk_size, topology->route(0, 4), callback, nullptr));
+        event_queue->run_to_completion();
+        return event_queue->get_current_time() - start_time;
+    };
+
+    /// test
+    // store-and-forward truncates every hop to ns
+    EXPECT_EQ(send(0), 4 * 19'531);
+
+    // a single packet per chunk crosses the same hops, summed in ps and truncated once
+    EXPECT_EQ(send(chunk_size), 78'126);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CutThroughPackets) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->set_cut_through(65'536);
+
+    /// message settings
+    // the second hop of the latter chunk is busy, so it's split into 16 packets
+    topology->send(std::make_unique<Chunk>(chunk_size, topology->route(2, 3), callback, nullptr));
+    topology->send(std::make_unique<Chunk>(chunk_size, topology->route(1, 4), callback, nullptr));
+    event_queue->run_to_completion();
+
+    /// test
+    // the packets wait for the link to be free (19'531 ns), are serialized over it (16 * 1'220 ns),
+    // then the last one takes the last hop: 19'531 + 16 * 1'220 + 500 + 1'220 + 500
+    // store-and-forward would take 60'093 ns
+    EXPECT_EQ(event_queue->get_current_time(), 41'271);
+
+    // the packets are taken from the chunk pool of the topology, and all returned to it
+    EXPECT_EQ(topology->get_chunk_pool().get_peak_usage(), 16);
+    EXPECT_EQ(topology->get_chunk_pool().get_in_use_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CutThroughContended) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    topology->set_cut_through(65'536);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather: contended chunks are split into packets
+    auto arrivals_count = 0;
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                topology->send(std::make_unique<Chunk>(
+                    chunk_size, topology->route(i, j), [](void* const arg) { (*static_cast<int*>(arg))++; },
+                    &arrivals_count));
+            }
+        }
+    }
+    event_queue->run_to_completion();
+
+    /// test: every chunk arrives, not earlier than the busiest link (36 MB) allows
+    EXPECT_EQ(arrivals_count, npus_count * (npus_count - 1));
+    EXPECT_GE(event_queue->get_current_time(), 703'125);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RingBuffer) {
+    auto ring_buffer = RingBuffer<int>();
+
+    // push and pop across the wrap-around point while growing
+    auto next_push = 0;
+    auto next_pop = 0;
+    for (auto round = 0; round < 10; round++) {
+        for (auto i = 0; i < 3 + round; i++) {
+            ring_buffer.push_back(next_push++);
+        }
+        for (auto i = 0; i < 2; i++) {
+            EXPECT_EQ(ring_buffer.pop_front(), next_pop++);
+        }
+    }
+
+    /// test
+    EXPECT_EQ(ring_buffer.size(), next_push - next_pop);
+    EXPECT_EQ(ring_buffer.capacity() & (ring_buffer.capacity() - 1), 0);
+    while (!ring_buffer.empty()) {
+        EXPECT_EQ(ring_buffer.pop_front(), next_pop++);
+    }
+    EXPECT_EQ(next_pop, next_push);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CompiledTopology) {
+    /// setup: the first run compiles the topology, the next one loads it
+    const auto network_config_path = std::string("../../input/Ring_FullyConnected_Switch.yml");
+    std::remove("compiled_topology.bin");
+    const auto topology = construct_topology(network_config_path, "compiled_topology.bin");
+    const auto compiled_topology = construct_topology(network_config_path, "compiled_topology.bin");
+    EXPECT_EQ(dynamic_cast<const CompiledTopology*>(topology.get()), nullptr);
+    ASSERT_NE(dynamic_cast<const CompiledTopology*>(compiled_topology.get()), nullptr);
+
+    /// test: the link table and every route are preserved
+    const auto npus_count = topology->get_npus_count();
+    EXPECT_EQ(compiled_topology->get_npus_count(), npus_count);
+    EXPECT_EQ(compiled_topology->get_devices_count(), topology->get_devices_count());
+    EXPECT_EQ(compiled_topology->get_npus_count_per_dim(), topology->get_npus_count_per_dim());
+    EXPECT_EQ(compiled_topology->get_bandwidth_per_dim(), topology->get_bandwidth_per_dim());
+    ASSERT_EQ(compiled_topology->get_links_count(), topology->get_links_count());
+    for (auto id = 0; id < topology->get_links_count(); id++) {
+        EXPECT_EQ(compiled_topology->get_link(id)->get_src(), topology->get_link(id)->get_src());
+        EXPECT_EQ(compiled_topology->get_link(id)->get_dest(), topology->get_link(id)->get_dest());
+    }
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            const auto route = topology->route(i, j);
+            const auto compiled_route = compiled_topology->route(i, j);
+            ASSERT_EQ(compiled_route.size(), route.size());
+            for (auto hop = size_t(0); hop < route.size(); hop++) {
+                EXPECT_EQ(compiled_route.at(hop), route.at(hop));
+            }
+        }
+    }
+
+    // both simulate an all-to-all identically
+    auto finish_times = std::vector<EventTime>();
+    for (const auto& simulated_topology : {topology, compiled_topology}) {
+        const auto simulation_event_queue = std::make_shared<EventQueue>();
+        simulated_topology->set_event_queue(simulation_event_queue);
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    simulated_topology->send(simulated_topology->make_chunk(chunk_size, i, j, callback, nullptr));
+                }
+            }
+        }
+        simulation_event_queue->run_to_completion();
+        finish_times.push_back(simulation_event_queue->get_current_time());
+    }
+    EXPECT_EQ(finish_times[0], finish_times[1]);
+
+    // a compiled topology of another configuration is stale
+    const auto config_hash = CompiledTopology::hash_network_config(network_config_path);
+    EXPECT_NE(CompiledTopology::load("compiled_topology.bin", config_hash), nullptr);
+    EXPECT_EQ(CompiledTopology::load("compiled_topology.bin", config_hash + 1), nullptr);
+    EXPECT_NE(CompiledTopology::hash_network_config("../../input/Ring.yml"), config_hash);
+
+    // an invalid configuration is reported, and never compiled
+    std::ofstream("invalid_network.yml") << "topology: [ FatTree ]\nnpus_count: [ 16 ]\n"
+                                            "bandwidth: [ 50 ]\nlatency: [ 500 ]\n";
+    std::remove("compiled_invalid_topology.bin");
+    EXPECT_EQ(construct_topology("invalid_network.yml", "compiled_invalid_topology.bin"), nullptr);
+    EXPECT_FALSE(std::ifstream("compiled_invalid_topology.bin").is_open());
+    std::remove("invalid_network.yml");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LazyLinks) {
+    /// setup: the same FullyConnected topology, with links created upfront and on first use
+    const auto npus_count = 256;
+    const auto eager_topology = std::make_shared<FullyConnected>(npus_count, 50, 500);
+    const auto lazy_topology = std::make_shared<FullyConnected>(npus_count, 50, 500, true);
+    EXPECT_FALSE(eager_topology->has_lazy_links());
+    EXPECT_TRUE(lazy_topology->has_lazy_links());
+    EXPECT_EQ(lazy_topology->get_links_count(), eager_topology->get_links_count());
+    EXPECT_EQ(lazy_topology->get_instantiated_links_count(), 0);
+
+    // link ids match the eager topology
+    for (auto src = 0; src < npus_count; src += 37) {
+        for (auto dest = 0; dest < npus_count; dest += 11) {
+            if (src != dest) {
+                EXPECT_EQ(lazy_topology->get_link_id(src, dest), eager_topology->get_link_id(src, dest));
+            }
+        }
+    }
+
+    /// run a ring-neighbor exchange and a fan-in on both, settings applied before the links exist
+    auto finish_times = std::vector<EventTime>();
+    for (const auto& topology : {eager_topology, lazy_topology}) {
+        const auto simulation_event_queue = std::make_shared<EventQueue>();
+        topology->set_event_queue(simulation_event_queue);
+        topology->set_link_coalescing(true);
+
+        auto requests = std::vector<SendRequest>();
+        for (auto i = 0; i < npus_count; i++) {
+            requests.push_back({i, (i + 1) % npus_count, chunk_size, callback, nullptr});
+            requests.push_back({i, (i + 1) % npus_count, chunk_size, callback, nullptr});
+            if (i != 0) {
+                requests.push_back({i, 0, chunk_size, callback, nullptr});
+            }
+        }
+        topology->send_batch(requests);
+        simulation_event_queue->run_to_completion();
+        finish_times.push_back(simulation_event_queue->get_current_time());
+    }
+
+    /// test: identical results, with only the used links created
+    EXPECT_EQ(finish_times[0], finish_times[1]);
+    EXPECT_EQ(lazy_topology->get_instantiated_links_count(), (2 * npus_count) - 2);
+    EXPECT_EQ(eager_topology->get_instantiated_links_count(), npus_count * (npus_count - 1));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkStateTable) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto& link_states = topology->get_link_states();
+    ASSERT_EQ(link_states.size(), topology->get_links_count());
+
+    // send a chunk from every NPU to its clockwise neighbor, and two from NPU 0
+    const auto npus_count = topology->get_npus_count();
+    for (int i = 0; i < npus_count; i++) {
+        topology->send(topology->make_chunk(chunk_size, i, (i + 1) % npus_count, callback, nullptr));
+    }
+    topology->send(topology->make_chunk(chunk_size, 0, 1, callback, nullptr));
+
+    /// test: the links read their state from the table
+    const auto first_link = topology->get_link_id(0, 1);
+    EXPECT_EQ(link_states.get_busy_until(first_link), topology->get_link(first_link)->get_busy_until());
+    EXPECT_EQ(link_states.get_latency(first_link), topology->get_link(first_link)->get_latency());
+    EXPECT_EQ(link_states.count_busy_links(event_queue->get_current_time()), npus_count);
+
+    // the second chunk of NPU 0 keeps its link busy the longest
+    event_queue->run_until(link_states.get_busy_until(topology->get_link_id(1, 2)));
+    EXPECT_EQ(link_states.count_busy_links(event_queue->get_current_time()), 1);
+    event_queue->run_to_completion();
+    EXPECT_EQ(link_states.count_busy_links(event_queue->get_current_time()), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventProfiler) {
+    /// a profiler counts invocations per callback and events per event time
+    auto profiler = EventProfiler();
+    profiler.record_callback(callback, 10);
+    profiler.record_callback(callback, 30);
+    profiler.record_batch(1);
+    profiler.record_batch(5);
+    EXPECT_EQ(profiler.get_callback_profiles().at(callback).invocations_count, 2);
+    EXPECT_EQ(profiler.get_callback_profiles().at(callback).ticks, 40);
+    EXPECT_EQ(profiler.get_batch_sizes_histogram(), (std::vector<uint64_t>{1, 0, 1}));
+    EXPECT_EQ(profiler.get_max_batch_size(), 5);
+
+    // merged profilers add their counters
+    auto merged = EventProfiler();
+    merged.record_batch(2);
+    merged.merge(profiler);
+    EXPECT_EQ(merged.get_callback_profiles().at(callback).invocations_count, 2);
+    EXPECT_EQ(merged.get_batch_sizes_histogram(), (std::vector<uint64_t>{1, 1, 1}));
+    EXPECT_EQ(merged.get_batches_count(), 3);
+
+#ifdef ANALYTICAL_PROFILING
+    /// the event loop records into the profiler of the thread
+    auto& thread_profiler = EventProfiler::get_thread_profiler();
+    auto thread_profile = EventProfiler();
+    thread_profile.merge(thread_profiler);
+    thread_profiler.reset();
+
+    auto counter = 0;
+    event_queue->schedule_event<int, increment_counter>(10, &counter);
+    event_queue->schedule_event<int, increment_counter>(20, &counter);
+    event_queue->schedule_event<int, increment_counter>(20, &counter);
+    event_queue->schedule_event(20, callback, nullptr);
+    event_queue->run_to_completion();
+
+    /// test
+    const auto& callback_profiles = thread_profiler.get_callback_profiles();
+    EXPECT_EQ(callback_profiles.size(), 2);
+    EXPECT_EQ(callback_profiles.at(invoke_typed_event<int, increment_counter>).invocations_count, 3);
+    EXPECT_EQ(callback_profiles.at(callback).invocations_count, 1);
+    EXPECT_EQ(thread_profiler.get_batch_sizes_histogram(), (std::vector<uint64_t>{1, 1}));
+
+    // keep the profile of the other tests, to be printed at exit
+    thread_profiler.merge(thread_profile);
+#endif
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FatTree) {
+    /// setup: 4-ary 3-level FatTree of 64 NPUs, non-blocking and 2:1 oversubscribed at the leaves
+    const auto fat_tree = std::make_shared<FatTree>(64, 50, 500, 4);
+    const auto oversubscribed_fat_tree = std::make_shared<FatTree>(64, 50, 500, 4, 2);
+    EXPECT_EQ(fat_tree->get_levels_count(), 3);
+
+    // 16 switches per level, and links up and down between the levels
+    EXPECT_EQ(fat_tree->get_devices_count(), 64 + 16 + 16 + 16);
+    EXPECT_EQ(fat_tree->get_links_count(), 2 * (64 + (16 * 4) + (16 * 4)));
+
+    // half the up ports at the leaves: 16 leaves, 8 switches of the upper levels
+    EXPECT_EQ(oversubscribed_fat_tree->get_devices_count(), 64 + 16 + 8 + 8);
+    EXPECT_EQ(oversubscribed_fat_tree->get_links_count(), 2 * (64 + (16 * 2) + (8 * 4)));
+
+    /// test: routes go up to the lowest common level and down through connected links
+    for (const auto& topology : {fat_tree, oversubscribed_fat_tree}) {
+        EXPECT_EQ(topology->route(0, 1).size(), 3);
+        EXPECT_EQ(topology->route(0, 5).size(), 5);
+        EXPECT_EQ(topology->route(0, 63).size(), 7);
+
+        for (auto src = 0; src < 64; src += 3) {
+            for (auto dest = 0; dest < 64; dest += 5) {
+                if (src == dest) {
+                    continue;
+                }
+                auto route = topology->route(src, dest);
+                EXPECT_EQ(route.at(0), src);
+                EXPECT_EQ(route.at(route.size() - 1), dest);
+                while (route.size() > 1) {
+                    EXPECT_EQ(route.link(0)->get_src(), route.at(0));
+                    EXPECT_EQ(route.link(0)->get_dest(), route.at(1));
+                    route.pop_front();
+                }
+            }
+        }
+    }
+
+    // each flow keeps its path, and the flows spread over the top switches
+    EXPECT_EQ(fat_tree->route(0, 63).at(3), fat_tree->route(0, 63).at(3));
+    auto top_switches = std::set<DeviceId>();
+    for (auto src = 0; src < 16; src++) {
+        top_switches.insert(fat_tree->route(src, 63 - src).at(3));
+    }
+    EXPECT_GT(top_switches.size(), 1);
+
+    // a chunk takes 6 hops of store-and-forward, as on a Ring of 6 hops
+    fat_tree->set_event_queue(event_queue);
+    fat_tree->send(std::make_unique<Chunk>(chunk_size, fat_tree->route(0, 63), callback, nullptr));
+    event_queue->run_to_completion();
+    const auto ring_event_queue = std::make_shared<EventQueue>();
+    const auto ring = std::make_shared<Ring>(12, 50, 500, false);
+    ring->set_event_queue(ring_event_queue);
+    ring->send(std::make_unique<Chunk>(chunk_size, ring->route(0, 6), callback, nullptr));
+    ring_event_queue->run_to_completion();
+    EXPECT_EQ(event_queue->get_current_time(), ring_event_queue->get_current_time());
+
+    /// large FatTree of 32K NPUs, routed arithmetically
+    const auto large_fat_tree = construct_topology(NetworkConfig()
+                                                       .add_dimension(TopologyBuildingBlock::FatTree, 32'768, 50, 500)
+                                                       .set_fat_tree(0, 8, 2));
+    EXPECT_EQ(large_fat_tree->get_npus_count(), 32'768);
+    EXPECT_EQ(large_fat_tree->route(0, 32'767).size(), 11);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TorusAndMesh) {
+    /// setup: 4x4 Torus and Mesh, and a 4x2x3 Torus whose side of 2 has no wraparound
+    const auto torus = std::make_shared<Torus>(16, 50, 500, std::vector<int>{4, 4});
+    const auto mesh = std::make_shared<Torus>(16, 50, 500, std::vector<int>{4, 4}, false);
+    const auto torus_3d = std::make_shared<Torus>(24, 50, 500, std::vector<int>{4, 2, 3});
+    EXPECT_EQ(torus->get_links_count(), 2 * 2 * 16);
+    EXPECT_EQ(mesh->get_links_count(), 2 * 2 * 12);
+    EXPECT_EQ(torus_3d->get_links_count(), (2 * 24) + (2 * 12) + (2 * 24));
+
+    /// test: dimension-order routes, the shorter way around a Torus
+    auto route = torus->route(0, 15);
+    EXPECT_EQ(route.size(), 3);
+    EXPECT_EQ(route.at(1), 3);
+    EXPECT_EQ(mesh->route(0, 15).size(), 7);
+    EXPECT_EQ(mesh->route(0, 15).at(3), 3);
+    EXPECT_EQ(torus_3d->route(0, 23).size(), 4);
+
+    // every hop resolves to the link between the neighbors, and link ids round-trip
+    for (const auto& topology : std::vector<std::shared_ptr<Torus>>{torus, mesh, torus_3d}) {
+        const auto npus_count = topology->get_npus_count();
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+                auto pair_route = topology->route(src, dest);
+                while (pair_route.size() > 1) {
+                    EXPECT_EQ(pair_route.link(0)->get_src(), pair_route.at(0));
+                    EXPECT_EQ(pair_route.link(0)->get_dest(), pair_route.at(1));
+                    pair_route.pop_front();
+                }
+            }
+        }
+        for (auto link_id = 0; link_id < topology->get_links_count(); link_id++) {
+            const auto* const link = topology->get_link(link_id);
+            EXPECT_EQ(topology->get_link_id(link->get_src(), link->get_dest()), link_id);
+        }
+    }
+
+    // a chunk over the wraparound takes 2 hops, as on a Ring
+    torus->set_event_queue(event_queue);
+    torus->send(std::make_unique<Chunk>(chunk_size, torus->route(0, 15), callback, nullptr));
+    event_queue->run_to_completion();
+    const auto ring_event_queue = std::make_shared<EventQueue>();
+    const auto ring = std::make_shared<Ring>(8, 50, 500, false);
+    ring->set_event_queue(ring_event_queue);
+    ring->send(std::make_unique<Chunk>(chunk_size, ring->route(0, 2), callback, nullptr));
+    ring_event_queue->run_to_completion();
+    EXPECT_EQ(event_queue->get_current_time(), ring_event_queue->get_current_time());
+
+    /// a 4x4x4 Torus parsed from a string
+    auto error = std::string();
+    const auto network_config = NetworkConfig::parse_yaml("topology: [ Torus ]\nnpus_count: [ 64 ]\n"
+                                                          "bandwidth: [ 50 ]\nlatency: [ 500 ]\n"
+                                                          "shape: [ [ 4, 4, 4 ] ]\n",
+                                                          error);
+    ASSERT_TRUE(network_config.has_value());
+    EXPECT_EQ(construct_topology(*network_config)->route(0, 63).size(), 4);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InvalidConfigNotConstructed) {
+    /// setup: a FatTree dimension without its radix, and a Torus of the wrong shape
+    auto fat_tree_config = NetworkConfig()
+                                   .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 500)
+                                   .add_dimension(TopologyBuildingBlock::FatTree, 16, 50, 500);
+    auto torus_config = NetworkConfig().add_dimension(TopologyBuildingBlock::Torus, 16, 50, 500);
+    torus_config.set_shape(0, {4, 3});
+
+    /// test: the errors are returned instead of exiting
+    auto error = std::string();
+    EXPECT_EQ(construct_topology(fat_tree_config, error), nullptr);
+    EXPECT_EQ(error, "radix (0) of FatTree dimension 1 should be larger than 1");
+    EXPECT_EQ(construct_topology(torus_config, error), nullptr);
+    EXPECT_EQ(error, "sides of dimension 0 multiply to 12, not npus_count (16)");
+
+    // fixed configs are constructed
+    fat_tree_config.set_fat_tree(1, 4);
+    EXPECT_NE(construct_topology(fat_tree_config, error), nullptr);
+    EXPECT_EQ(error, "");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HybridFidelity) {
+    /// setup: a Ring of 4 NPUs simulated analytically, stacked with an aware Switch of 4 NPUs
+    const auto network_parser = NetworkParser("../../input/Hybrid.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    // every NPU pair of each Ring instance is a single analytical link, and the Switch instances are kept as is
+    EXPECT_EQ(topology->get_links_count(), (4 * 12) + (4 * 8));
+    EXPECT_EQ(topology->get_devices_count(), 16 + 4);
+    const auto route = topology->route(0, 2);
+    ASSERT_EQ(route.size(), 2);
+    EXPECT_TRUE(route.link(0)->is_analytical());
+    EXPECT_EQ(route.link(0)->get_latency(), 2 * 500);
+    EXPECT_FALSE(topology->route(0, 4).link(0)->is_analytical());
+    EXPECT_EQ(topology->route(0, 6).size(), 4);
+
+    /// test: chunks cross the unaware dimension side by side, in closed form
+    auto arrivals = std::vector<ChunkArrival>(4, {event_queue.get(), 0});
+    topology->send(topology->make_chunk(chunk_size, 0, 2, record_arrival, &arrivals[0]));
+    topology->send(topology->make_chunk(chunk_size, 0, 2, record_arrival, &arrivals[1]));
+    topology->send(topology->make_chunk(chunk_size, 0, 4, record_arrival, &arrivals[2]));
+    topology->send(topology->make_chunk(chunk_size, 0, 4, record_arrival, &arrivals[3]));
+    event_queue->run_to_completion();
+
+    // a single uncontended hop takes latency + serialization delay
+    const auto hop_event_queue = std::make_shared<EventQueue>();
+    const auto hop = std::make_shared<FullyConnected>(2, 50, 500);
+    hop->set_event_queue(hop_event_queue);
+    hop->send(hop->make_chunk(chunk_size, 0, 1, callback, nullptr));
+    hop_event_queue->run_to_completion();
+    const auto hop_delay = hop_event_queue->get_current_time();
+
+    // which is 2 hops * latency + serialization delay over the Ring, but queued on the Switch
+    EXPECT_EQ(arrivals[0].arrival_time, hop_delay + 500);
+    EXPECT_EQ(arrivals[1].arrival_time, arrivals[0].arrival_time);
+    EXPECT_GT(arrivals[3].arrival_time, arrivals[2].arrival_time);
+
+    /// the analytical links survive the compilation
+    std::remove("compiled_hybrid_topology.bin");
+    const auto config_hash = CompiledTopology::hash_network_config("../../input/Hybrid.yml");
+    CompiledTopology::compile(*topology, config_hash, "compiled_hybrid_topology.bin");
+    const auto compiled_topology = CompiledTopology::load("compiled_hybrid_topology.bin", config_hash);
+    ASSERT_NE(compiled_topology, nullptr);
+    for (auto id = 0; id < topology->get_links_count(); id++) {
+        EXPECT_EQ(compiled_topology->get_link(id)->is_analytical(), topology->get_link(id)->is_analytical());
+    }
+
+    /// invalid fidelities are reported
+    auto error = std::string();
+    EXPECT_FALSE(NetworkConfig::parse_yaml("topology: [ Ring ]\nnpus_count: [ 4 ]\nbandwidth: [ 50 ]\n"
+                                           "latency: [ 500 ]\nfidelity: [ fast ]\n",
+                                           error)
+                     .has_value());
+    EXPECT_EQ(error, "Fidelity name fast not supported");
+}
+
+/// arrival of a chunk whose callback may be batched
+struct BatchedArrival {
+    EventQueue* event_queue;
+    EventTime arrival_time;
+    size_t batch_size;
+};
+
+static void record_batched_arrival(void* const arg) {
+    auto* const arrival = static_cast<BatchedArrival*>(arg);
+    arrival->arrival_time = arrival->event_queue->get_current_time();
+    arrival->batch_size = 1;
+}
+
+static void record_batched_arrivals(const CallbackArg* const args, const size_t count) {
+    for (auto i = size_t(0); i < count; i++) {
+        auto* const arrival = static_cast<BatchedArrival*>(args[i]);
+        arrival->arrival_time = arrival->event_queue->get_current_time();
+        arrival->batch_size = count;
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CallbackBatching) {
+    /// setup: chunks around a FullyConnected of 4 NPUs, arriving at the same time
+    const auto topology = std::make_shared<FullyConnected>(4, 50, 500);
+    topology->set_event_queue(event_queue);
+    topology->set_callback_batching(record_batched_arrival, record_batched_arrivals);
+
+    auto arrivals = std::vector<BatchedArrival>(5, {event_queue.get(), 0, 0});
+    for (auto npu = 0; npu < 4; npu++) {
+        topology->send(topology->make_chunk(chunk_size, npu, (npu + 1) % 4, record_batched_arrival, &arrivals[npu]));
+    }
+    topology->send(topology->make_chunk(2 * chunk_size, 0, 2, record_batched_arrival, &arrivals[4]));
+
+    // a chunk with another callback is delivered alone
+    auto unbatched_arrival = ChunkArrival{event_queue.get(), 0};
+    topology->send(topology->make_chunk(chunk_size, 1, 3, record_arrival, &unbatched_arrival));
+    event_queue->run_to_completion();
+
+    /// test: the arrivals of the same time are delivered at once, at the time they arrived
+    for (auto npu = 0; npu < 4; npu++) {
+        EXPECT_EQ(arrivals[npu].batch_size, 4);
+        EXPECT_EQ(arrivals[npu].arrival_time, unbatched_arrival.arrival_time);
+    }
+    EXPECT_EQ(arrivals[4].batch_size, 1);
+    EXPECT_GT(arrivals[4].arrival_time, arrivals[0].arrival_time);
+
+    const auto* const callback_batcher = topology->get_callback_batcher();
+    ASSERT_NE(callback_batcher, nullptr);
+    EXPECT_EQ(callback_batcher->get_batches_count(), 2);
+    EXPECT_EQ(callback_batcher->get_deferred_count(), 5);
+}
+
+/// run an all-to-all of various chunk sizes on a switch with the given time quantum, and return the finish time
+static EventTime run_quantized_all_to_all(const EventTime time_quantum, RunSummary& summary) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    event_queue->set_time_quantum(time_quantum);
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    auto arrival = ChunkArrival{event_queue.get(), 0};
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                topology->send(topology->make_chunk(1'000 * (1 + i + j), i, j, record_arrival, &arrival));
+            }
+        }
+    }
+    summary = event_queue->run_to_completion();
+    return event_queue->get_current_time();
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TimeQuantum) {
+    /// setup: an event is rounded up to the quantum, and the events it schedules inherit the error
+    event_queue->set_time_quantum(100);
+    auto arrival = ChunkArrival{event_queue.get(), 0};
+    event_queue->schedule_event(150, record_arrival, &arrival);
+    event_queue->run_to_completion();
+    EXPECT_EQ(arrival.arrival_time, 200);
+    EXPECT_EQ(event_queue->get_time_error_bound(), 50);
+    event_queue->schedule_event(230, record_arrival, &arrival);
+    const auto summary = event_queue->run_to_completion();
+    EXPECT_EQ(arrival.arrival_time, 300);
+    EXPECT_EQ(summary.time_error_bound, 50 + 70);
+
+    /// test: a quantized all-to-all visits far fewer event times, and finishes within the error bound
+    auto exact_summary = RunSummary();
+    const auto exact_time = run_quantized_all_to_all(0, exact_summary);
+    auto quantized_summary = RunSummary();
+    const auto quantized_time = run_quantized_all_to_all(100, quantized_summary);
+    EXPECT_EQ(exact_summary.time_error_bound, 0);
+    EXPECT_LT(quantized_summary.event_times_count * 4, exact_summary.event_times_count);
+    EXPECT_GE(quantized_time, exact_time);
+    EXPECT_LE(quantized_time, exact_time + quantized_summary.time_error_bound);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AdvanceTo) {
+    /// setup: events at 100, 200, and 300
+    auto arrivals = std::vector<ChunkArrival>(4, {event_queue.get(), 0});
+    for (auto i = 0; i < 3; i++) {
+        event_queue->schedule_event(100 * (i + 1), record_arrival, &arrivals[i]);
+    }
+
+    /// test: advance up to the bound, without overshooting
+    EXPECT_EQ(event_queue->advance_to(250).events_count, 2);
+    EXPECT_EQ(event_queue->get_current_time(), 250);
+    EXPECT_EQ(arrivals[1].arrival_time, 200);
+    EXPECT_EQ(arrivals[2].arrival_time, 0);
+    EXPECT_EQ(event_queue->peek_next_event_time(), 300);
+
+    // a co-simulator may schedule at the bound
+    event_queue->schedule_event(250, record_arrival, &arrivals[3]);
+    EXPECT_EQ(event_queue->peek_next_event_time(), 250);
+    EXPECT_EQ(event_queue->advance_to(250).events_count, 1);
+    EXPECT_EQ(arrivals[3].arrival_time, 250);
+
+    // advancing past every event drains the queue
+    EXPECT_EQ(event_queue->advance_to(1'000).events_count, 1);
+    EXPECT_EQ(arrivals[2].arrival_time, 300);
+    EXPECT_EQ(event_queue->get_current_time(), 1'000);
+    EXPECT_TRUE(event_queue->finished());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TraceReplayer) {
+    /// setup: an all-to-all on a switch, sent at once and replayed from a trace
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    auto sends = std::vector<TraceSend>();
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                topology->send(topology->make_chunk(chunk_size, i, j, callback, nullptr));
+                sends.push_back({0, chunk_size, i, j});
+            }
+        }
+    }
+    event_queue->run_to_completion();
+    TraceReplayer::write("trace_replayer.bin", sends);
+
+    /// test: the replay, prefetching a few sends at a time, simulates identically
+    const auto replay_event_queue = std::make_shared<EventQueue>();
+    const auto replay_topology = construct_topology(network_parser);
+    replay_topology->set_event_queue(replay_event_queue);
+    auto replayer = TraceReplayer::open("trace_replayer.bin", *replay_topology, 5);
+    ASSERT_NE(replayer, nullptr);
+    EXPECT_EQ(replayer->get_sends_count(), sends.size());
+    replayer->start();
+    replay_event_queue->run_to_completion();
+    EXPECT_EQ(replay_event_queue->get_current_time(), event_queue->get_current_time());
+    EXPECT_EQ(replayer->get_injected_count(), sends.size());
+    EXPECT_EQ(replayer->get_finished_count(), sends.size());
+
+    // sends are injected at their time, and not ahead
+    sends = {{100, chunk_size, 0, 1}, {100, chunk_size, 1, 2}, {5'000, chunk_size, 2, 3}, {9'000, chunk_size, 3, 3}};
+    TraceReplayer::write("trace_replayer.bin", sends);
+    const auto staggered_event_queue = std::make_shared<EventQueue>();
+    const auto staggered_topology = construct_topology(network_parser);
+    staggered_topology->set_event_queue(staggered_event_queue);
+    replayer = TraceReplayer::open("trace_replayer.bin", *staggered_topology);
+    ASSERT_NE(replayer, nullptr);
+    replayer->start();
+    staggered_event_queue->advance_to(99);
+    EXPECT_EQ(replayer->get_injected_count(), 0);
+    staggered_event_queue->advance_to(4'999);
+    EXPECT_EQ(replayer->get_injected_count(), 2);
+    staggered_event_queue->run_to_completion();
+    EXPECT_EQ(replayer->get_injected_count(), 4);
+    EXPECT_EQ(replayer->get_finished_count(), 4);
+
+    /// a missing or malformed trace isn't opened
+    EXPECT_EQ(TraceReplayer::open("missing_trace.bin", *topology), nullptr);
+    EXPECT_EQ(TraceReplayer::open("../../input/Switch.yml", *topology), nullptr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkGenerator) {
+    /// setup: an all-to-all on a switch, injected up front and generated with a window of 2 chunks per NPU
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i != j) {
+                topology->send(topology->make_chunk(chunk_size, i, j, callback, nullptr));
+            }
+        }
+    }
+    event_queue->run_to_completion();
+
+    const auto generated_event_queue = std::make_shared<EventQueue>();
+    const auto generated_topology = construct_topology(network_parser);
+    generated_topology->set_event_queue(generated_event_queue);
+    auto generator = AllToAllGenerator(generated_topology.get(), chunk_size, 2);
+    generator.start();
+    generated_event_queue->run_to_completion();
+
+    /// test: every chunk arrives, with only a window of chunks per NPU ever allocated
+    const auto chunks_count = static_cast<uint64_t>(npus_count * (npus_count - 1));
+    EXPECT_EQ(generator.get_sent_count(), chunks_count);
+    EXPECT_EQ(generator.get_arrived_count(), chunks_count);
+    EXPECT_LE(generator.get_peak_in_flight_count(), 2 * npus_count);
+    // (an arrived chunk is freed once its callback pulled the next one)
+    EXPECT_LE(generated_topology->get_chunk_pool().get_peak_usage(), (2 * npus_count) + 1);
+    EXPECT_EQ(topology->get_chunk_pool().get_peak_usage(), chunks_count);
+
+    // no later than injected up front, as the staggered dests don't contend at the switch
+    EXPECT_LE(generated_event_queue->get_current_time(), event_queue->get_current_time());
+}
+
+/// run a collective on a fresh topology, and return the finish time of every NPU
+template <typename TopologyFactory>
+static std::vector<EventTime> run_npu_finish_times(TopologyFactory make_topology,
+                                                   const CollectiveType type,
+                                                   const CollectiveAlgorithm algorithm,
+                                                   const ChunkSize size,
+                                                   const bool symmetry_reduction) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = make_topology();
+    topology->set_event_queue(event_queue);
+
+    auto finish = ChunkArrival{event_queue.get(), 0};
+    auto collective = Collective(topology.get(), type, algorithm, size, record_arrival, &finish);
+    collective.set_symmetry_reduction(symmetry_reduction);
+    collective.start();
+    event_queue->run_to_completion();
+
+    EXPECT_TRUE(collective.finished());
+    const auto reducible = (algorithm != CollectiveAlgorithm::HalvingDoubling);
+    EXPECT_EQ(collective.is_symmetry_reduced(), symmetry_reduction && reducible);
+    auto finish_times = std::vector<EventTime>();
+    for (auto npu = 0; npu < topology->get_npus_count(); npu++) {
+        finish_times.push_back(collective.get_npu_finish_time(npu));
+    }
+    EXPECT_EQ(*std::max_element(finish_times.begin(), finish_times.end()), finish.arrival_time);
+    return finish_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SymmetryReduction) {
+    /// setup
+    const auto npus_count = 8;
+    const auto size = npus_count * chunk_size;
+    const auto ring = [=] { return std::make_shared<Ring>(npus_count, 50, 500, true); };
+    const auto star = [=] { return std::make_shared<Switch>(npus_count, 50, 500); };
+    const auto fully_connected = [=] { return std::make_shared<FullyConnected>(npus_count, 50, 500); };
+
+    /// test
+    // a quotient link stands for a rotation orbit of the links
+    EXPECT_EQ(OrbitTopology(*ring()).get_links_count(), 2);
+    EXPECT_EQ(OrbitTopology(*star()).get_links_count(), 2);
+    EXPECT_EQ(OrbitTopology(*fully_connected()).get_links_count(), npus_count - 1);
+
+    // every NPU of the reduced collective finishes when NPU 0 does, so do the NPUs of the full collective
+    const auto check = [&](const auto& make_topology, const CollectiveType type, const CollectiveAlgorithm algorithm) {
+        const auto full = run_npu_finish_times(make_topology, type, algorithm, size, false);
+        const auto reduced = run_npu_finish_times(make_topology, type, algorithm, size, true);
+        EXPECT_EQ(reduced, full);
+    };
+    for (const auto algorithm : {CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct}) {
+        for (const auto type : {CollectiveType::AllReduce, CollectiveType::AllToAll}) {
+            check(ring, type, algorithm);
+            check(star, type, algorithm);
+            check(fully_connected, type, algorithm);
+        }
+    }
+
+    // halving-doubling isn't rotation-invariant, so falls back to the full collective
+    check(ring, CollectiveType::AllGather, CollectiveAlgorithm::HalvingDoubling);
+}
+
+/// run an all-reduce on Switch.yml through the cache, and return its per-NPU finish times
+static std::vector<EventTime> run_cached_collective(CollectiveCache& cache,
+                                                    const uint64_t config_hash,
+                                                    const ChunkSize size,
+                                                    bool& cached) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = construct_topology(NetworkParser("../../input/Switch.yml"));
+    topology->set_event_queue(event_queue);
+
+    auto finish = ChunkArrival{event_queue.get(), 0};
+    auto collective = Collective(topology.get(), CollectiveType::AllReduce, CollectiveAlgorithm::Ring, size,
+                                 record_arrival, &finish);
+    collective.set_result_cache(&cache, config_hash);
+    collective.start();
+    event_queue->run_to_completion();
+
+    EXPECT_TRUE(collective.finished());
+    cached = collective.is_result_cached();
+    auto finish_times = std::vector<EventTime>{finish.arrival_time};
+    for (auto npu = 0; npu < topology->get_npus_count(); npu++) {
+        finish_times.push_back(collective.get_npu_finish_time(npu));
+    }
+    return finish_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectiveCache) {
+    /// setup
+    const auto config_hash = NetworkParser("../../input/Switch.yml").get_network_config().hash();
+    const auto size = 16 * chunk_size;
+    const auto directory = std::string("collective_cache");
+
+    // start from an empty store
+    for (const auto cached_size : {size, 2 * size}) {
+        const auto key = CollectiveCache::hash_key(config_hash, CollectiveType::AllReduce, CollectiveAlgorithm::Ring,
+                                                   cached_size);
+        auto path = std::ostringstream();
+        path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".collective";
+        std::remove(path.str().c_str());
+    }
+
+    /// test
+    // the hash is canonical: the same network built by hand hashes the same
+    EXPECT_EQ(NetworkConfig().add_dimension(TopologyBuildingBlock::Switch, 16, 50, 500).hash(), config_hash);
+    EXPECT_NE(NetworkConfig().add_dimension(TopologyBuildingBlock::Switch, 16, 50, 501).hash(), config_hash);
+
+    // the first run simulates, the rerun replays the same result from memory
+    auto cache = CollectiveCache(4, directory);
+    auto cached = true;
+    const auto simulated = run_cached_collective(cache, config_hash, size, cached);
+    EXPECT_FALSE(cached);
+    EXPECT_EQ(run_cached_collective(cache, config_hash, size, cached), simulated);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(cache.get_memory_hits_count(), 1);
+
+    // another process shares the store on disk
+    auto other_cache = CollectiveCache(4, directory);
+    EXPECT_EQ(run_cached_collective(other_cache, config_hash, size, cached), simulated);
+    EXPECT_TRUE(cached);
+    EXPECT_EQ(other_cache.get_disk_hits_count(), 1);
+
+    // another traffic descriptor misses
+    EXPECT_NE(run_cached_collective(cache, config_hash, 2 * size, cached), simulated);
+    EXPECT_FALSE(cached);
+    EXPECT_EQ(cache.get_misses_count(), 2);
+    EXPECT_DOUBLE_EQ(cache.get_hit_rate(), 1.0 / 3);
+
+    // the least recently used result is evicted from memory
+    auto small_cache = CollectiveCache(1);
+    small_cache.insert(1, {10, {10}});
+    small_cache.insert(2, {20, {20}});
+    EXPECT_EQ(small_cache.get_entries_count(), 1);
+    EXPECT_FALSE(small_cache.find(1).has_value());
+    EXPECT_EQ(small_cache.find(2)->duration, 20);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventHandles) {
+    for (const auto backend : {EventQueueBackend::Calendar, EventQueueBackend::List}) {
+        /// setup: events at 100, 200, and 300
+        auto queue = std::make_shared<EventQueue>(backend);
+        auto arrivals = std::vector<ChunkArrival>(3, {queue.get(), 0});
+        auto handles = std::vector<EventHandle>();
+        for (auto i = 0; i < 3; i++) {
+            handles.push_back(queue->schedule_event(100 * (i + 1), record_arrival, &arrivals[i]));
+        }
+
+        /// test: a cancelled event is never invoked, and its time is dropped
+        EXPECT_TRUE(queue->cancel(handles[0]));
+        EXPECT_FALSE(queue->is_pending(handles[0]));
+        EXPECT_FALSE(queue->cancel(handles[0]));
+        EXPECT_EQ(queue->peek_next_event_time(), 200);
+
+        // a rescheduled event is invoked at its new time only
+        const auto moved = queue->reschedule(handles[2], 150);
+        EXPECT_FALSE(queue->is_pending(handles[2]));
+        EXPECT_TRUE(queue->is_pending(moved));
+        queue->proceed();
+        EXPECT_EQ(arrivals[2].arrival_time, 150);
+        EXPECT_FALSE(queue->is_pending(moved));
+
+        // the handle of an invoked event is stale
+        queue->proceed();
+        EXPECT_EQ(arrivals[1].arrival_time, 200);
+        EXPECT_FALSE(queue->cancel(handles[1]));
+        EXPECT_FALSE(queue->is_pending(queue->reschedule(handles[1], 400)));
+        EXPECT_EQ(arrivals[0].arrival_time, 0);
+        EXPECT_TRUE(queue->finished());
+
+        // cancelling every event finishes the queue, even if the list is recycled
+        const auto handle = queue->schedule_event(500, record_arrival, &arrivals[0]);
+        EXPECT_TRUE(queue->cancel(handle));
+        EXPECT_TRUE(queue->finished());
+        const auto recycled = queue->schedule_event(500, record_arrival, &arrivals[0]);
+        EXPECT_FALSE(queue->is_pending(handle));
+        EXPECT_TRUE(queue->is_pending(recycled));
+    }
+}
+
+#ifdef ANALYTICAL_MPI
+/// run a collective, distributed over MPI_COMM_WORLD if distributed, and return the finish time of each NPU
+static std::vector<EventTime> run_distributed_collective(const std::string& path,
+                                                         const CollectiveType type,
+                                                         const CollectiveAlgorithm algorithm,
+                                                         const ChunkSize size,
+                                                         const bool distributed) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto network_parser = NetworkParser(path);
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    auto finish = ChunkArrival{event_queue.get(), 0};
+    auto collective = Collective(topology.get(), type, algorithm, size, record_arrival, &finish);
+    auto finish_times = std::vector<EventTime>(npus_count, 0);
+    if (!distributed) {
+        collective.start();
+        event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+        for (auto npu = 0; npu < npus_count; npu++) {
+            finish_times[npu] = collective.get_npu_finish_time(npu);
+        }
+        return finish_times;
+    }
+
+    // every rank simulates its own NPUs
+    const auto encoder = [&](const Callback callback, const CallbackArg callback_arg) {
+        return collective.encode_callback(callback, callback_arg);
+    };
+    const auto decoder = [&](const CallbackHandle handle) { return collective.decode_callback(handle); };
+    auto simulator = DistributedSimulator(topology, MPI_COMM_WORLD, encoder, decoder);
+    const auto [begin, end] = simulator.get_local_npus();
+    collective.set_local_npus(begin, end);
+    collective.start();
+    simulator.run();
+    EXPECT_TRUE(collective.finished());
+
+    // gather the finish times of every rank
+    auto local_finish_times = std::vector<EventTime>(npus_count, 0);
+    for (auto npu = begin; npu < end; npu++) {
+        local_finish_times[npu] = collective.get_npu_finish_time(npu);
+    }
+    MPI_Allreduce(local_finish_times.data(), finish_times.data(), npus_count, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    EXPECT_EQ(simulator.get_current_time(), *std::max_element(finish_times.begin(), finish_times.end()));
+    return finish_times;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DistributedMatchesSequential) {
+    // a single rank, unless launched by mpirun
+    auto initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        MPI_Init(nullptr, nullptr);
+        std::atexit([] { MPI_Finalize(); });
+    }
+
+    /// test
+    // the Torus creates its links lazily, only for the devices of each rank
+    const auto cases = std::vector<std::pair<std::string, CollectiveAlgorithm>>{
+        {"../../input/Ring.yml", CollectiveAlgorithm::Ring},
+        {"../../input/Ring.yml", CollectiveAlgorithm::Direct},
+        {"../../input/Switch.yml", CollectiveAlgorithm::Ring},
+        {"../../input/Switch.yml", CollectiveAlgorithm::Direct},
+        {"../../input/FullyConnected.yml", CollectiveAlgorithm::Direct},
+        {"../../input/Torus.yml", CollectiveAlgorithm::Ring},
+    };
+    for (const auto& [path, algorithm] : cases) {
+        const auto type = CollectiveType::AllReduce;
+        const auto sequential = run_distributed_collective(path, type, algorithm, 16 * chunk_size, false);
+        const auto distributed = run_distributed_collective(path, type, algorithm, 16 * chunk_size, true);
+        EXPECT_EQ(sequential, distributed) << path;
+    }
+}
+#endif
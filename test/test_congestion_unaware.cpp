@@ -3,10 +3,24 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
 #include "common/Type.h"
+#include "congestion_unaware/FatTree.h"
+#include "congestion_unaware/FullyConnected.h"
 #include "congestion_unaware/Helper.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/SweepRunner.h"
+#include "congestion_unaware/Switch.h"
+#include "congestion_unaware/Torus.h"
+#include <algorithm>
+#include <functional>
 #include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
@@ -68,3 +82,510 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring_FullyConnected_Switch) {
     const auto comm_delay_dim3 = topology->send(26, 42, chunk_size);
     EXPECT_EQ(comm_delay_dim3, 23'531);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, MultiDimTopologyManyDims) {
+    // create a 5D network, beyond the dims counts with an unrolled address translation
+    auto topology = MultiDimTopology();
+    topology.append_dimension(std::make_unique<Ring>(2, 50, 500));
+    topology.append_dimension(std::make_unique<FullyConnected>(3, 100, 400));
+    topology.append_dimension(std::make_unique<Switch>(4, 200, 300));
+    topology.append_dimension(std::make_unique<Ring>(5, 400, 200));
+    topology.append_dimension(std::make_unique<Switch>(2, 800, 100));
+    EXPECT_EQ(topology.get_npus_count(), 240);
+
+    // each transfer happens in the lowest dim the src and dest addresses differ,
+    // e.g., NPU 1 = [1, 0, 0, 0, 0] and NPU 239 = [1, 2, 3, 4, 1] differ in dim 1
+    EXPECT_EQ(topology.send(1, 239, chunk_size), FullyConnected(3, 100, 400).send(0, 2, chunk_size));
+    EXPECT_EQ(topology.send(12, 36, chunk_size), Ring(5, 400, 200).send(0, 1, chunk_size));
+    EXPECT_EQ(topology.send(0, 120, chunk_size), Switch(2, 800, 100).send(0, 1, chunk_size));
+    EXPECT_EQ(topology.send(239, 238, chunk_size), Ring(2, 50, 500).send(1, 0, chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendBatch) {
+    // create networks
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topologies = std::vector<std::shared_ptr<Topology>>{construct_topology(network_parser),
+                                                                   std::make_shared<Ring>(7, 50, 500),
+                                                                   std::make_shared<Ring>(7, 50, 500, false),
+                                                                   std::make_shared<FullyConnected>(5, 100, 400),
+                                                                   std::make_shared<Switch>(9, 200, 300)};
+
+    for (const auto& topology : topologies) {
+        // random queries, more than a block of the batch
+        const auto npus_count = topology->get_npus_count();
+        auto generator = std::mt19937(42);
+        auto npu_distribution = std::uniform_int_distribution<DeviceId>(0, npus_count - 1);
+        auto size_distribution = std::uniform_int_distribution<ChunkSize>(1, 4 * chunk_size);
+
+        const auto queries_count = size_t(1'000);
+        auto srcs = std::vector<DeviceId>();
+        auto dests = std::vector<DeviceId>();
+        auto chunk_sizes = std::vector<ChunkSize>();
+        while (srcs.size() < queries_count) {
+            const auto src = npu_distribution(generator);
+            const auto dest = npu_distribution(generator);
+            if (src != dest) {
+                srcs.push_back(src);
+                dests.push_back(dest);
+                chunk_sizes.push_back(size_distribution(generator));
+            }
+        }
+
+        // the batch matches the scalar path
+        auto comms_delays = std::vector<EventTime>(queries_count);
+        topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), comms_delays.data(), queries_count);
+        for (auto i = size_t(0); i < queries_count; i++) {
+            EXPECT_EQ(comms_delays[i], topology->send(srcs[i], dests[i], chunk_sizes[i]));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, LookupTables) {
+    // create networks
+    auto ring = Ring(16, 50, 500);
+    const auto reference_ring = Ring(16, 50, 500);
+
+    // the table layout follows the memory budget
+    const auto modes = std::vector<std::pair<size_t, LookupTableMode>>{
+        {16 * 16 * sizeof(Latency), LookupTableMode::Dense},
+        {16 * sizeof(Latency), LookupTableMode::DistanceClass},
+        {16 * sizeof(Latency) - 1, LookupTableMode::None},
+    };
+    for (const auto& [memory_budget, mode] : modes) {
+        ring.build_lookup_tables(memory_budget);
+        EXPECT_EQ(ring.get_lookup_table_mode(), mode);
+
+        // every delay is unchanged
+        for (auto src = 0; src < 16; src++) {
+            for (auto dest = 0; dest < 16; dest++) {
+                if (src != dest) {
+                    EXPECT_EQ(ring.send(src, dest, chunk_size), reference_ring.send(src, dest, chunk_size));
+                }
+            }
+        }
+    }
+
+    // multi-dim topology splits the budget across the dims: 128 B each for the [2, 8, 4] dims
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->build_lookup_tables(3 * 16 * sizeof(Latency));
+    const auto& multi_dim_topology = dynamic_cast<const MultiDimTopology&>(*topology);
+    EXPECT_EQ(multi_dim_topology.get_topology_of_dim(0).get_lookup_table_mode(), LookupTableMode::Dense);
+    EXPECT_EQ(multi_dim_topology.get_topology_of_dim(1).get_lookup_table_mode(), LookupTableMode::DistanceClass);
+    EXPECT_EQ(multi_dim_topology.get_topology_of_dim(2).get_lookup_table_mode(), LookupTableMode::Dense);
+
+    EXPECT_EQ(topology->send(0, 1, chunk_size), 4'932);
+    EXPECT_EQ(topology->send(37, 41, chunk_size), 10'265);
+    EXPECT_EQ(topology->send(26, 42, chunk_size), 23'531);
+}
+
+/// estimate a collective by sending the chunks of every step, and summing the slowest send per step
+static EventTime estimate_collective_by_steps(const Topology& topology,
+                                              const CollectiveType type,
+                                              const CollectiveAlgorithm algorithm,
+                                              const ChunkSize size) {
+    const auto npus_count = topology.get_npus_count();
+    const auto shard_size = size / npus_count;
+
+    // time of a step sending chunk_size to peer(npu) (or every other NPU, if peer is null)
+    const auto step_time = [&](const ChunkSize chunk_size, const std::function<DeviceId(DeviceId)>& peer) {
+        auto time = EventTime(0);
+        for (auto npu = 0; npu < npus_count; npu++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (dest != npu && (peer == nullptr || dest == peer(npu))) {
+                    time = std::max(time, topology.send(npu, dest, chunk_size));
+                }
+            }
+        }
+        return time;
+    };
+
+    auto time = EventTime(0);
+    if (algorithm == CollectiveAlgorithm::Direct) {
+        time = step_time(shard_size, nullptr);
+    } else if (type == CollectiveType::AllToAll) {
+        for (auto i = 1; i < npus_count; i++) {
+            if (algorithm == CollectiveAlgorithm::Ring) {
+                time += step_time(shard_size, [&](const DeviceId npu) { return (npu + i) % npus_count; });
+            } else {
+                time += step_time(shard_size, [&](const DeviceId npu) { return npu ^ i; });
+            }
+        }
+    } else if (algorithm == CollectiveAlgorithm::Ring) {
+        const auto next_step_time = step_time(shard_size, [&](const DeviceId npu) { return (npu + 1) % npus_count; });
+        time = (npus_count - 1) * next_step_time;
+    } else {
+        for (auto distance = 1; distance < npus_count; distance *= 2) {
+            time += step_time(shard_size * distance, [&](const DeviceId npu) { return npu ^ distance; });
+        }
+    }
+    return time;
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, EstimateCollective) {
+    // create networks
+    const auto topologies = std::vector<std::shared_ptr<Topology>>{std::make_shared<Ring>(8, 50, 500),
+                                                                   std::make_shared<Ring>(8, 50, 500, false),
+                                                                   std::make_shared<FullyConnected>(8, 100, 400),
+                                                                   std::make_shared<Switch>(8, 200, 300)};
+    const auto types = {CollectiveType::AllGather, CollectiveType::ReduceScatter, CollectiveType::AllToAll};
+    const auto algorithms = {CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct,
+                             CollectiveAlgorithm::HalvingDoubling};
+    const auto size = 8 * chunk_size;
+
+    // the closed form matches the step-by-step estimate, up to rounding each step to ns
+    for (const auto& topology : topologies) {
+        for (const auto type : types) {
+            for (const auto algorithm : algorithms) {
+                const auto time = topology->estimate_collective(type, algorithm, size);
+                const auto steps_time = estimate_collective_by_steps(*topology, type, algorithm, size);
+                EXPECT_GE(time, steps_time);
+                EXPECT_LE(time, steps_time + topology->get_npus_count());
+            }
+
+            // all-reduce is a reduce-scatter followed by an all-gather
+            EXPECT_EQ(topology->estimate_collective(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, size),
+                      topology->estimate_collective(CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, size) +
+                          topology->estimate_collective(CollectiveType::AllGather, CollectiveAlgorithm::Ring, size));
+        }
+    }
+
+    // multi-dim topology: each dim scatters the shard left by the previous dims
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto& multi_dim_topology = dynamic_cast<const MultiDimTopology&>(*topology);
+    const auto ring_time = multi_dim_topology.get_topology_of_dim(0).estimate_collective(
+        CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, size);
+    const auto fully_connected_time = multi_dim_topology.get_topology_of_dim(1).estimate_collective(
+        CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, size / 2);
+    const auto switch_time = multi_dim_topology.get_topology_of_dim(2).estimate_collective(
+        CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, size / 16);
+    EXPECT_EQ(topology->estimate_collective(CollectiveType::ReduceScatter, CollectiveAlgorithm::Ring, size),
+              ring_time + fully_connected_time + switch_time);
+    EXPECT_EQ(topology->estimate_collective(CollectiveType::AllGather, CollectiveAlgorithm::Ring, size),
+              ring_time + fully_connected_time + switch_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, ConcurrentQueries) {
+    // share a single immutable topology across threads
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = SharedTopology(construct_topology(network_parser));
+    const auto npus_count = topology->get_npus_count();
+
+    // every (src, dest) pair, sequentially
+    auto expected_delays = std::vector<EventTime>();
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            expected_delays.push_back((src == dest) ? 0 : topology->send(src, dest, chunk_size));
+        }
+    }
+
+    // every thread queries every pair concurrently
+    const auto threads_count = 8;
+    auto delays_per_thread = std::vector<std::vector<EventTime>>(threads_count);
+    auto threads = std::vector<std::thread>();
+    for (auto i = 0; i < threads_count; i++) {
+        threads.emplace_back([&, i] {
+            for (auto src = 0; src < npus_count; src++) {
+                for (auto dest = 0; dest < npus_count; dest++) {
+                    delays_per_thread[i].push_back((src == dest) ? 0 : topology->send(src, dest, chunk_size));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    /// test
+    for (const auto& delays : delays_per_thread) {
+        EXPECT_EQ(delays, expected_delays);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SweepRunner) {
+    /// setup
+    // 2 x 2 candidates of the first dim, 2 of the second: 8 configurations
+    auto sweep_runner = SweepRunner(4);
+    sweep_runner.add_dimension(TopologyBuildingBlock::Ring, {2, 4}, {50, 100}, {500});
+    sweep_runner.add_dimension(TopologyBuildingBlock::Switch, {4}, {100}, {100, 200});
+    sweep_runner.add_message_size(chunk_size);
+    sweep_runner.add_message_size(4 * chunk_size);
+    sweep_runner.add_metric("send", [](const Topology& topology, const ChunkSize size) {
+        return topology.send(0, topology.get_npus_count() - 1, size);
+    });
+    sweep_runner.add_metric("all_reduce", [](const Topology& topology, const ChunkSize size) {
+        return topology.estimate_collective(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, size);
+    });
+    EXPECT_EQ(sweep_runner.get_configs_count(), 8);
+
+    /// Run the sweep
+    const auto results = sweep_runner.run();
+
+    /// test
+    // every row matches a topology constructed on its own
+    EXPECT_EQ(results.get_rows_count(), 16);
+    for (auto row = size_t(0); row < results.get_rows_count(); row++) {
+        const auto topology = construct_topology(
+            {TopologyBuildingBlock::Ring, TopologyBuildingBlock::Switch},
+            {results.npus_counts_per_dim[0][row], results.npus_counts_per_dim[1][row]},
+            {results.bandwidths_per_dim[0][row], results.bandwidths_per_dim[1][row]},
+            {results.latencies_per_dim[0][row], results.latencies_per_dim[1][row]});
+        const auto size = results.sizes[row];
+        EXPECT_EQ(results.metric_values[0][row], topology->send(0, topology->get_npus_count() - 1, size));
+        EXPECT_EQ(results.metric_values[1][row],
+                  topology->estimate_collective(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, size));
+    }
+
+    // the last dim varies the fastest, and the sizes within a configuration
+    EXPECT_EQ(results.latencies_per_dim[1][0], 100);
+    EXPECT_EQ(results.sizes[1], 4 * chunk_size);
+    EXPECT_EQ(results.latencies_per_dim[1][2], 200);
+    EXPECT_EQ(results.npus_counts_per_dim[0][15], 4);
+
+    // a header and a line per row
+    auto csv = std::stringstream();
+    results.write_csv(csv);
+    auto lines_count = 0;
+    for (auto line = std::string(); std::getline(csv, line);) {
+        lines_count++;
+    }
+    EXPECT_EQ(lines_count, 17);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DimOrderRouting) {
+    // create network
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    auto& multi_dim_topology = dynamic_cast<MultiDimTopology&>(*topology);
+
+    // NPU 0 = [0, 0, 0], and NPU 63 = [1, 7, 3]
+    const auto first_dim_delay = topology->send(0, 63, chunk_size);
+    multi_dim_topology.set_routing(MultiDimRouting::DimOrder);
+    const auto dim_order_delay = topology->send(0, 63, chunk_size);
+
+    /// test
+    // the first dim alone is the ring of dim 1
+    EXPECT_EQ(first_dim_delay, 4'932);
+
+    // every dim: 50 + 500 + (2 x 2000) ns link delays, serialized at dim 3 bandwidth (50 GB/s)
+    EXPECT_EQ(dim_order_delay, 24'081);
+
+    // single-dim sends are unchanged
+    EXPECT_EQ(topology->send(0, 1, chunk_size), 4'932);
+    EXPECT_EQ(topology->send(37, 41, chunk_size), 10'265);
+    EXPECT_EQ(topology->send(26, 42, chunk_size), 23'531);
+
+    // batches route every dim as well
+    const auto srcs = std::vector<DeviceId>{0, 26};
+    const auto dests = std::vector<DeviceId>{63, 42};
+    const auto chunk_sizes = std::vector<ChunkSize>{chunk_size, chunk_size};
+    auto comms_delays = std::vector<EventTime>(2);
+    topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), comms_delays.data(), 2);
+    EXPECT_EQ(comms_delays, (std::vector<EventTime>{24'081, 23'531}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, NetworkConfig) {
+    /// a config built in memory matches the one parsed from a file
+    auto network_config = NetworkConfig()
+                              .add_dimension(TopologyBuildingBlock::Ring, 2, 200, 50)
+                              .add_dimension(TopologyBuildingBlock::FullyConnected, 8, 100, 500)
+                              .add_dimension(TopologyBuildingBlock::Switch, 4, 50, 2'000);
+    EXPECT_EQ(network_config.validate(), "");
+    const auto topology = construct_topology(network_config);
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->send(0, 1, chunk_size), 4'932);
+    EXPECT_EQ(topology->send(37, 41, chunk_size), 10'265);
+    EXPECT_EQ(topology->send(26, 42, chunk_size), 23'531);
+
+    // vary a single value without any file
+    network_config.set_bandwidth(2, 100);
+    EXPECT_LT(construct_topology(network_config)->send(26, 42, chunk_size), 23'531);
+
+    /// a config parsed from a string
+    auto error = std::string();
+    const auto parsed_config = NetworkConfig::parse_yaml(
+        "topology: [ Ring ]\nnpus_count: [ 8 ]\nbandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n", error);
+    ASSERT_TRUE(parsed_config.has_value());
+    EXPECT_EQ(construct_topology(*parsed_config)->send(1, 4, chunk_size), 21'031);
+
+    /// errors are returned to the caller
+    EXPECT_FALSE(NetworkConfig::parse_yaml("topology: [ Ring\n", error).has_value());
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(
+        NetworkConfig::parse_yaml("topology: [ Star ]\nnpus_count: [ 8 ]\nbandwidth: [ 50 ]\nlatency: [ 5 ]", error)
+            .has_value());
+    EXPECT_EQ(error, "Topology name Star not supported");
+    EXPECT_FALSE(
+        NetworkConfig::parse_yaml("topology: [ Ring ]\nnpus_count: [ 8, 2 ]\nbandwidth: [ 50 ]\nlatency: [ 5 ]", error)
+            .has_value());
+    EXPECT_FALSE(NetworkConfig::load_yaml_file("missing.yml", error).has_value());
+
+    // an invalid config isn't constructed
+    network_config.set_npus_count(1, 1);
+    EXPECT_EQ(network_config.validate(), "npus_count (1) should be larger than 1");
+    EXPECT_EQ(construct_topology(network_config), nullptr);
+    EXPECT_EQ(construct_topology(NetworkConfig()), nullptr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, FatTree) {
+    /// setup: 4-ary 3-level FatTree of 64 NPUs
+    const auto fat_tree = std::make_shared<FatTree>(64, 50, 500, 4);
+    const auto ring = std::make_shared<Ring>(64, 50, 500, false);
+    EXPECT_EQ(fat_tree->get_levels_count(), 3);
+
+    /// test: a chunk takes 2L hops, L being the lowest level holding both NPUs
+    EXPECT_EQ(fat_tree->send(0, 1, chunk_size), ring->send(0, 2, chunk_size));
+    EXPECT_EQ(fat_tree->send(0, 5, chunk_size), ring->send(0, 4, chunk_size));
+    EXPECT_EQ(fat_tree->send(63, 0, chunk_size), ring->send(0, 6, chunk_size));
+    EXPECT_EQ(fat_tree->send(17, 18, chunk_size), fat_tree->send(18, 17, chunk_size));
+
+    // the closed forms of the collectives match the step-by-step estimates
+    const auto size = 64 * chunk_size;
+    for (const auto type : {CollectiveType::AllGather, CollectiveType::ReduceScatter, CollectiveType::AllToAll}) {
+        for (const auto algorithm :
+             {CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct, CollectiveAlgorithm::HalvingDoubling}) {
+            const auto time = fat_tree->estimate_collective(type, algorithm, size);
+            const auto steps_time = estimate_collective_by_steps(*fat_tree, type, algorithm, size);
+            EXPECT_GE(time, steps_time);
+            EXPECT_LE(time, steps_time + fat_tree->get_npus_count());
+        }
+    }
+
+    /// a FatTree dimension parsed from a string, stacked on a Ring
+    auto error = std::string();
+    const auto parsed_config = NetworkConfig::parse_yaml("topology: [ Ring, FatTree ]\nnpus_count: [ 2, 16 ]\n"
+                                                         "bandwidth: [ 50, 50 ]\nlatency: [ 500, 500 ]\n"
+                                                         "radix: [ 0, 4 ]\noversubscription: [ 1, 2 ]\n",
+                                                         error);
+    ASSERT_TRUE(parsed_config.has_value());
+    EXPECT_EQ(parsed_config->get_radixes_per_dim(), (std::vector<int>{0, 4}));
+    EXPECT_EQ(parsed_config->get_oversubscriptions_per_dim(), (std::vector<int>{1, 2}));
+    const auto multi_dim_topology = construct_topology(*parsed_config);
+    EXPECT_EQ(multi_dim_topology->send(0, 2, chunk_size), ring->send(0, 2, chunk_size));
+    EXPECT_EQ(multi_dim_topology->send(0, 30, chunk_size), ring->send(0, 4, chunk_size));
+
+    /// FatTree dimensions should be shaped by a valid radix
+    auto network_config = NetworkConfig().add_dimension(TopologyBuildingBlock::FatTree, 64, 50, 500);
+    EXPECT_EQ(network_config.validate(), "radix (0) of FatTree dimension 0 should be larger than 1");
+    network_config.set_fat_tree(0, 8);
+    EXPECT_EQ(network_config.validate(), "");
+    network_config.set_fat_tree(0, 8, 3);
+    EXPECT_EQ(network_config.validate(), "oversubscription (3) of FatTree dimension 0 should divide radix (8)");
+    network_config.set_fat_tree(0, 16);
+    EXPECT_EQ(network_config.validate(), "npus_count (64) of FatTree dimension 0 should be a power of radix (16)");
+    EXPECT_EQ(construct_topology(network_config), nullptr);
+    EXPECT_FALSE(NetworkConfig::parse_yaml("topology: [ FatTree ]\nnpus_count: [ 16 ]\nbandwidth: [ 50 ]\n"
+                                           "latency: [ 500 ]\nradix: [ 4, 4 ]\n",
+                                           error)
+                     .has_value());
+    EXPECT_EQ(error, "length of radix (2) doesn't match with dims_count (1)");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, InvalidConfigNotConstructed) {
+    /// setup: a FatTree dimension without its radix
+    const auto network_config = NetworkConfig()
+                                    .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 500)
+                                    .add_dimension(TopologyBuildingBlock::FatTree, 16, 50, 500);
+
+    /// test: the error is returned instead of exiting
+    auto error = std::string();
+    EXPECT_EQ(construct_topology(network_config, error), nullptr);
+    EXPECT_EQ(error, "radix (0) of FatTree dimension 1 should be larger than 1");
+
+    // the same for the dimensions given one by one
+    EXPECT_EQ(construct_topology(network_config.get_topologies_per_dim(), network_config.get_npus_counts_per_dim(),
+                                 network_config.get_bandwidths_per_dim(), network_config.get_latencies_per_dim()),
+              nullptr);
+    EXPECT_NE(construct_topology(network_config.get_topologies_per_dim(), network_config.get_npus_counts_per_dim(),
+                                 network_config.get_bandwidths_per_dim(), network_config.get_latencies_per_dim(),
+                                 {0, 4}),
+              nullptr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, TorusAndMesh) {
+    /// setup: 4x4 Torus and Mesh
+    const auto torus = std::make_shared<Torus>(16, 50, 500, std::vector<int>{4, 4});
+    const auto mesh = std::make_shared<Torus>(16, 50, 500, std::vector<int>{4, 4}, false);
+    const auto ring = std::make_shared<Ring>(16, 50, 500, false);
+
+    /// test: the hops count sums the distances along the sides
+    EXPECT_EQ(torus->send(0, 15, chunk_size), ring->send(0, 2, chunk_size));
+    EXPECT_EQ(mesh->send(0, 15, chunk_size), ring->send(0, 6, chunk_size));
+    EXPECT_EQ(torus->send(5, 10, chunk_size), ring->send(0, 2, chunk_size));
+    EXPECT_EQ(mesh->send(6, 5, chunk_size), ring->send(0, 1, chunk_size));
+
+    // a one-sided Torus is a bidirectional Ring
+    const auto ring_torus = std::make_shared<Torus>(16, 50, 500);
+    const auto bidirectional_ring = std::make_shared<Ring>(16, 50, 500);
+    for (auto dest = 1; dest < 16; dest++) {
+        EXPECT_EQ(ring_torus->send(0, dest, chunk_size), bidirectional_ring->send(0, dest, chunk_size));
+    }
+
+    // the closed forms of the collectives match the step-by-step estimates
+    const auto size = 16 * chunk_size;
+    for (const auto& topology : std::vector<std::shared_ptr<Torus>>{torus, mesh}) {
+        for (const auto type : {CollectiveType::AllGather, CollectiveType::ReduceScatter, CollectiveType::AllToAll}) {
+            for (const auto algorithm :
+                 {CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct, CollectiveAlgorithm::HalvingDoubling}) {
+                const auto time = topology->estimate_collective(type, algorithm, size);
+                const auto steps_time = estimate_collective_by_steps(*topology, type, algorithm, size);
+                EXPECT_GE(time, steps_time);
+                EXPECT_LE(time, steps_time + topology->get_npus_count());
+            }
+        }
+    }
+
+    /// a Mesh dimension parsed from a string, stacked on a Switch
+    auto error = std::string();
+    const auto parsed_config = NetworkConfig::parse_yaml("topology: [ Switch, Mesh ]\nnpus_count: [ 2, 12 ]\n"
+                                                         "bandwidth: [ 50, 50 ]\nlatency: [ 500, 500 ]\n"
+                                                         "shape: [ [ ], [ 3, 4 ] ]\n",
+                                                         error);
+    ASSERT_TRUE(parsed_config.has_value());
+    EXPECT_EQ(parsed_config->get_shapes_per_dim()[1], (std::vector<int>{3, 4}));
+    const auto multi_dim_topology = construct_topology(*parsed_config);
+    EXPECT_EQ(multi_dim_topology->send(0, 22, chunk_size), ring->send(0, 5, chunk_size));
+
+    /// sides should multiply to npus_count
+    auto network_config = NetworkConfig().add_dimension(TopologyBuildingBlock::Torus, 16, 50, 500);
+    EXPECT_EQ(network_config.validate(), "");
+    network_config.set_shape(0, {4, 2});
+    EXPECT_EQ(network_config.validate(), "sides of dimension 0 multiply to 8, not npus_count (16)");
+    network_config.set_shape(0, {16, 1});
+    EXPECT_EQ(network_config.validate(), "side (1) of dimension 0 should be larger than 1");
+    EXPECT_EQ(construct_topology(network_config), nullptr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, FixedPointDelays) {
+    /// setup: a unidirectional Ring, so that NPU 0 reaches NPU d in d hops
+    const auto npus_count = 16;
+    const auto latency_ps = 290;  // 0.29 ns
+    auto ring = std::make_shared<Ring>(npus_count, 50, 0.29, false);
+
+    // exact delay in ps scaled by the bandwidth in B/s, as 50 GB/s is 50 * 2^30 B per 10^12 ps
+    const auto bandwidth_Bps = static_cast<unsigned __int128>(50) << 30;
+    const auto ns = bandwidth_Bps * 1'000;
+    const auto exact_delay = [&](const int hops_count, const ChunkSize chunk_size) {
+        return (static_cast<unsigned __int128>(hops_count * latency_ps) * bandwidth_Bps) +
+               (static_cast<unsigned __int128>(chunk_size) * 1'000'000'000'000ULL);
+    };
+
+    /// test: delays are truncated to ns from the exact delay in ps, without accumulating the error of the hops
+    for (const auto lookup_table : {false, true}) {
+        if (lookup_table) {
+            ring->build_lookup_tables(1 << 20);
+        }
+        for (const auto chunk_size : {ChunkSize(1), ChunkSize(1'000), ChunkSize(1 << 20), (ChunkSize(1) << 32) + 7}) {
+            for (auto dest = 1; dest < npus_count; dest++) {
+                // the fixed-point delay is exact up to a ps, so skip delays that close to a ns boundary
+                const auto delay = exact_delay(dest, chunk_size);
+                const auto remainder = delay % ns;
+                if (remainder < bandwidth_Bps || remainder > ns - bandwidth_Bps) {
+                    continue;
+                }
+                EXPECT_EQ(ring->send(0, dest, chunk_size), static_cast<EventTime>(delay / ns));
+            }
+        }
+    }
+}
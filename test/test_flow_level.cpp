@@ -0,0 +1,205 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkConfig.h"
+#include "common/NetworkFunction.h"
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "flow_level/Flow.h"
+#include "flow_level/Helper.h"
+#include "flow_level/Ring.h"
+#include <gtest/gtest.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalFlowLevel;
+
+class TestNetworkAnalyticalFlowLevel : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // create event queue
+        event_queue = std::make_shared<EventQueue>();
+
+        // set flow size
+        flow_size = 1'048'576;  // 1 MB
+    }
+
+    std::shared_ptr<EventQueue> event_queue;
+
+    static void callback(void* const arg) {}
+
+    ChunkSize flow_size;
+};
+
+TEST_F(TestNetworkAnalyticalFlowLevel, Ring) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// message settings
+    auto route = topology->route(1, 4);
+    auto flow = std::make_unique<Flow>(flow_size, route, callback, nullptr);
+
+    // send a flow
+    topology->send(std::move(flow));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test: the flow is pipelined over the 3 hops
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 21'032);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, FullyConnected) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// message settings
+    auto route = topology->route(1, 4);
+    auto flow = std::make_unique<Flow>(flow_size, route, callback, nullptr);
+
+    // send a flow
+    topology->send(std::move(flow));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 20'032);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, Switch) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    /// message settings
+    auto route = topology->route(1, 4);
+    auto flow = std::make_unique<Flow>(flow_size, route, callback, nullptr);
+
+    // send a flow
+    topology->send(std::move(flow));
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 20'532);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, AllGatherOnRing) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+    const auto npus_count = topology->get_npus_count();
+
+    /// message settings
+    for (int i = 0; i < npus_count; i++) {
+        for (int j = 0; j < npus_count; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            auto route = topology->route(i, j);
+            auto flow = std::make_unique<Flow>(flow_size, route, callback, nullptr);
+            topology->send(std::move(flow));
+        }
+    }
+
+    /// Run simulation
+    const auto summary = event_queue->run_to_completion();
+
+    /// test
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 707'126);
+    EXPECT_EQ(topology->get_active_flows_count(), 0);
+
+    // one arrival per flow, and at most one valid drain per flow
+    const auto flows_count = static_cast<size_t>(npus_count * (npus_count - 1));
+    EXPECT_LE(topology->get_rate_updates_count(), 2 * flows_count);
+    EXPECT_GE(summary.events_count, flows_count);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, MaxMinFairness) {
+    /// setup: unidirectional 4-NPU ring
+    const auto bandwidth = Bandwidth(50);
+    const auto topology = std::make_shared<Ring>(4, bandwidth, 500, false);
+    topology->set_event_queue(event_queue);
+
+    // link 1->2 is shared by three flows, and link 0->1 by two of them
+    auto long_flow = std::make_unique<Flow>(flow_size, topology->route(0, 3), callback, nullptr);
+    auto short_flow = std::make_unique<Flow>(flow_size, topology->route(0, 1), callback, nullptr);
+    auto* const long_flow_ptr = long_flow.get();
+    auto* const short_flow_ptr = short_flow.get();
+    topology->send(std::move(long_flow));
+    topology->send(std::move(short_flow));
+    for (int i = 0; i < 2; i++) {
+        topology->send(std::make_unique<Flow>(flow_size, topology->route(1, 2), callback, nullptr));
+    }
+
+    /// test: 1->2 bottlenecks the long flow at 1/3,
+    /// so the short flow takes the remaining 2/3 of 0->1
+    const auto bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    EXPECT_DOUBLE_EQ(long_flow_ptr->get_rate(), bandwidth_Bpns / 3);
+    EXPECT_DOUBLE_EQ(short_flow_ptr->get_rate(), bandwidth_Bpns * 2 / 3);
+
+    event_queue->run_to_completion();
+    EXPECT_EQ(topology->get_active_flows_count(), 0);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, RatesReallocated) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    topology->set_event_queue(event_queue);
+
+    // 0->1 and 0->2 share link 0->1
+    topology->send(std::make_unique<Flow>(flow_size, topology->route(0, 1), callback, nullptr));
+    topology->send(std::make_unique<Flow>(2 * flow_size, topology->route(0, 2), callback, nullptr));
+
+    /// Run simulation
+    event_queue->run_to_completion();
+
+    /// test: the half of 0->2 left after 0->1 drains is sent at the full bandwidth
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 59'594);
+}
+
+TEST_F(TestNetworkAnalyticalFlowLevel, UnsupportedConfigNotConstructed) {
+    /// setup
+    auto error = std::string();
+    auto fat_tree_config = NetworkConfig().add_dimension(TopologyBuildingBlock::FatTree, 16, 50, 500);
+    fat_tree_config.set_fat_tree(0, 4);
+    const auto multi_dim_config = NetworkConfig()
+                                      .add_dimension(TopologyBuildingBlock::Ring, 4, 50, 500)
+                                      .add_dimension(TopologyBuildingBlock::Switch, 4, 50, 500);
+
+    /// test: building blocks and dimensions the backend doesn't support are rejected by the validation
+    EXPECT_EQ(fat_tree_config.validate(), "");
+    EXPECT_EQ(construct_topology(fat_tree_config, error), nullptr);
+    EXPECT_EQ(error, "topology of dimension 0 is not supported by this backend");
+    EXPECT_EQ(construct_topology(multi_dim_config, error), nullptr);
+    EXPECT_EQ(error, "dims_count (2) should be at most 1 for this backend");
+    EXPECT_EQ(construct_topology(NetworkConfig().add_dimension(TopologyBuildingBlock::Torus, 16, 50, 500)), nullptr);
+
+    // a supported config is constructed
+    EXPECT_NE(construct_topology(NetworkConfig().add_dimension(TopologyBuildingBlock::Ring, 4, 50, 500), error),
+              nullptr);
+    EXPECT_EQ(error, "");
+}
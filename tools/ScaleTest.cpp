@@ -0,0 +1,128 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "ScaleTest.h"
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/resource.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalTools;
+
+size_t Traffic::size() const noexcept {
+    assert(srcs.size() == dests.size());
+    assert(srcs.size() == chunk_sizes.size());
+
+    return srcs.size();
+}
+
+void Traffic::add_chunk(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) noexcept {
+    assert(src != dest);
+    assert(chunk_size > 0);
+
+    srcs.push_back(src);
+    dests.push_back(dest);
+    chunk_sizes.push_back(chunk_size);
+}
+
+Traffic NetworkAnalyticalTools::load_traffic(const std::string& path, const int npus_count) noexcept {
+    auto file = std::ifstream(path);
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/tools) "
+                  << "Unable to open traffic file " << path << std::endl;
+        std::exit(-1);
+    }
+
+    auto traffic = Traffic();
+    auto line = std::string();
+    for (auto line_number = 1; std::getline(file, line); line_number++) {
+        // skip empty lines and comments
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        auto fields = std::istringstream(line);
+        auto src = DeviceId();
+        auto dest = DeviceId();
+        auto chunk_size = ChunkSize();
+        if (!(fields >> src >> dest >> chunk_size)) {
+            std::cerr << "[Error] (network/analytical/tools) " << path << ":" << line_number
+                      << ": expected \"src dest chunk_size\"" << std::endl;
+            std::exit(-1);
+        }
+
+        if (src < 0 || src >= npus_count || dest < 0 || dest >= npus_count || src == dest || chunk_size == 0) {
+            std::cerr << "[Error] (network/analytical/tools) " << path << ":" << line_number << ": chunk " << src
+                      << " -> " << dest << " of size " << chunk_size << " is invalid for " << npus_count << " NPUs"
+                      << std::endl;
+            std::exit(-1);
+        }
+
+        traffic.add_chunk(src, dest, chunk_size);
+    }
+
+    return traffic;
+}
+
+void NetworkAnalyticalTools::save_traffic(const Traffic& traffic,
+                                          const std::string& path,
+                                          const std::string& comment) noexcept {
+    auto file = std::ofstream(path);
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/tools) "
+                  << "Unable to write traffic file " << path << std::endl;
+        std::exit(-1);
+    }
+
+    file << "#" << comment << "\n";
+    file << "# src dest chunk_size\n";
+    for (auto i = size_t(0); i < traffic.size(); i++) {
+        file << traffic.srcs[i] << " " << traffic.dests[i] << " " << traffic.chunk_sizes[i] << "\n";
+    }
+
+    if (!file.flush()) {
+        std::cerr << "[Error] (network/analytical/tools) "
+                  << "Unable to write traffic file " << path << std::endl;
+        std::exit(-1);
+    }
+}
+
+double NetworkAnalyticalTools::get_peak_rss_MB() noexcept {
+    auto usage = rusage();
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    // ru_maxrss is in bytes on macOS
+    return static_cast<double>(usage.ru_maxrss) / (1024 * 1024);
+#else
+    // and in KB on Linux
+    return static_cast<double>(usage.ru_maxrss) / 1024;
+#endif
+}
+
+double NetworkAnalyticalTools::get_wall_time() noexcept {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(now).count();
+}
+
+void NetworkAnalyticalTools::print_report(const ScaleReport& report) noexcept {
+    const auto events_per_second =
+        (report.simulation_time > 0) ? static_cast<double>(report.events_count) / report.simulation_time : 0;
+
+    std::cout << "Backend: " << report.backend << std::endl;
+    std::cout << "NPUs count: " << report.npus_count << std::endl;
+    std::cout << "Devices count: " << report.devices_count << std::endl;
+    std::cout << "Chunks count: " << report.chunks_count << std::endl;
+    std::cout << "Construction time: " << report.construction_time << " s" << std::endl;
+    std::cout << "Simulation time: " << report.simulation_time << " s" << std::endl;
+    std::cout << "Finish time: " << report.finish_time << " ns" << std::endl;
+    std::cout << "Events executed: " << report.events_count << " (" << events_per_second << " events/s)"
+              << std::endl;
+    std::cout << "Peak RSS: " << get_peak_rss_MB() << " MB" << std::endl;
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalTools {
+
+    /**
+ * Traffic is a list of chunks to inject at time 0, in struct-of-arrays form:
+ * chunk i is sent from srcs[i] to dests[i] with size chunk_sizes[i].
+ *
+ * A traffic file lists one chunk per line, as "src dest chunk_size".
+ * Empty lines and lines starting with '#' are ignored.
+ */
+    struct Traffic {
+        /// src NPU of each chunk
+        std::vector<DeviceId> srcs;
+
+        /// dest NPU of each chunk
+        std::vector<DeviceId> dests;
+
+        /// size of each chunk in bytes
+        std::vector<ChunkSize> chunk_sizes;
+
+        /**
+   * Get the number of chunks.
+   *
+   * @return number of chunks
+   */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+   * Append a chunk.
+   *
+   * @param src src NPU of the chunk
+   * @param dest dest NPU of the chunk
+   * @param chunk_size size of the chunk
+   */
+        void add_chunk(DeviceId src, DeviceId dest, ChunkSize chunk_size) noexcept;
+    };
+
+    /**
+ * Read a traffic file.
+ * Exits if the file can't be read, or a chunk is out of the [0, npus_count) range.
+ *
+ * @param path path of the traffic file
+ * @param npus_count number of NPUs of the topology the traffic is sent over
+ * @return read traffic
+ */
+    [[nodiscard]] Traffic load_traffic(const std::string& path, int npus_count) noexcept;
+
+    /**
+ * Write a traffic file.
+ * Exits if the file can't be written.
+ *
+ * @param traffic traffic to write
+ * @param path path of the traffic file
+ * @param comment header comment of the file, without the leading '#'
+ */
+    void save_traffic(const Traffic& traffic, const std::string& path, const std::string& comment) noexcept;
+
+    /**
+ * Get the peak resident set size of the process so far.
+ *
+ * @return peak RSS in MB
+ */
+    [[nodiscard]] double get_peak_rss_MB() noexcept;
+
+    /**
+ * Get the current wall-clock time, to measure elapsed times.
+ *
+ * @return monotonic time in seconds
+ */
+    [[nodiscard]] double get_wall_time() noexcept;
+
+    /**
+ * ScaleReport collects the measurements of a scale test run.
+ */
+    struct ScaleReport {
+        /// name of the backend
+        std::string backend;
+
+        /// number of NPUs of the topology
+        int npus_count = 0;
+
+        /// number of devices of the topology, NPUs and switches
+        int devices_count = 0;
+
+        /// number of chunks sent
+        size_t chunks_count = 0;
+
+        /// wall-clock time taken to construct the topology, in seconds
+        double construction_time = 0;
+
+        /// wall-clock time taken to simulate the traffic, in seconds
+        double simulation_time = 0;
+
+        /// simulated time the last chunk arrived, in ns
+        EventTime finish_time = 0;
+
+        /// number of simulated events (chunks estimated, if the backend doesn't run events)
+        uint64_t events_count = 0;
+    };
+
+    /**
+ * Print a scale test report, including the peak RSS of the process, to stdout.
+ *
+ * @param report measurements to print
+ */
+    void print_report(const ScaleReport& report) noexcept;
+
+}  // namespace NetworkAnalyticalTools
@@ -0,0 +1,302 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+/**
+ * TopologyGenerator emits a network configuration and a matching traffic file,
+ * to scale-test the backends beyond the examples of input/.
+ *
+ * Usage:
+ *   TopologyGenerator --topology Ring,Switch --npus-count 64,64 --bandwidth 50,50 --latency 500,500
+ *                     --pattern uniform --chunk-size 1048576 --chunks-count 100000 --output scale/4096
+ * writes scale/4096.yml and scale/4096.traffic, to be run by ScaleRunner<Backend>.
+ *
+ * Traffic patterns:
+ *   - uniform: chunks-count chunks between uniformly random NPU pairs
+ *   - permutation: each NPU sends a single chunk to a distinct NPU, following a random permutation
+ *   - all_to_all: each NPU sends a chunk to every other NPU
+ *   - hotspot: like uniform, but hotspot-fraction of the chunks are sent to NPU 0
+ *   - ring: ring all-gather; each NPU sends npus_count - 1 chunks to its ring neighbor
+ * Every chunk is injected at time 0.
+ */
+
+#include "ScaleTest.h"
+#include "common/NetworkConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalTools;
+
+namespace {
+
+    /// Traffic patterns of the generator
+    enum class TrafficPattern { Uniform, Permutation, AllToAll, Hotspot, Ring };
+
+    [[noreturn]] void exit_with_usage(const std::string& message) noexcept {
+        std::cerr << "[Error] (network/analytical/tools) " << message << std::endl;
+        std::cerr << "Usage: TopologyGenerator --topology <list> --npus-count <list> --bandwidth <list> "
+                  << "--latency <list> --pattern <uniform|permutation|all_to_all|hotspot|ring> --output <prefix> "
+                  << "[--chunk-size <bytes>] [--chunks-count <count>] [--hotspot-fraction <fraction>] [--seed <seed>]"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    /// split a comma-separated list of values
+    template <typename T>
+    [[nodiscard]] std::vector<T> parse_list(const std::string& key, const std::string& value) noexcept {
+        auto values = std::vector<T>();
+        auto fields = std::istringstream(value);
+        auto field = std::string();
+        while (std::getline(fields, field, ',')) {
+            auto element_stream = std::istringstream(field);
+            auto element = T();
+            if (!(element_stream >> element) || !element_stream.eof()) {
+                exit_with_usage("--" + key + ": " + field + " is not a valid value");
+            }
+            values.push_back(element);
+        }
+        return values;
+    }
+
+    /// parse a single value
+    template <typename T>
+    [[nodiscard]] T parse_value(const std::string& key, const std::string& value) noexcept {
+        const auto values = parse_list<T>(key, value);
+        if (values.size() != 1) {
+            exit_with_usage("--" + key + " expects a single value");
+        }
+        return values[0];
+    }
+
+    [[nodiscard]] TrafficPattern parse_pattern(const std::string& pattern) noexcept {
+        if (pattern == "uniform") {
+            return TrafficPattern::Uniform;
+        }
+        if (pattern == "permutation") {
+            return TrafficPattern::Permutation;
+        }
+        if (pattern == "all_to_all") {
+            return TrafficPattern::AllToAll;
+        }
+        if (pattern == "hotspot") {
+            return TrafficPattern::Hotspot;
+        }
+        if (pattern == "ring") {
+            return TrafficPattern::Ring;
+        }
+        exit_with_usage("Traffic pattern " + pattern + " not supported");
+    }
+
+    [[nodiscard]] std::string topology_name(const TopologyBuildingBlock topology) noexcept {
+        switch (topology) {
+            case TopologyBuildingBlock::Ring:
+                return "Ring";
+            case TopologyBuildingBlock::FullyConnected:
+                return "FullyConnected";
+            case TopologyBuildingBlock::Switch:
+                return "Switch";
+            default:
+                return "Undefined";
+        }
+    }
+
+    /// write a network config in the format of input/*.yml
+    template <typename T>
+    void write_yaml_list(std::ofstream& file, const std::string& key, const std::vector<T>& values) noexcept {
+        file << key << ": [ ";
+        for (auto i = size_t(0); i < values.size(); i++) {
+            file << ((i > 0) ? ", " : "") << values[i];
+        }
+        file << " ]\n";
+    }
+
+    void save_network_config(const NetworkConfig& network_config, const std::string& path) noexcept {
+        auto file = std::ofstream(path);
+        if (!file) {
+            std::cerr << "[Error] (network/analytical/tools) "
+                      << "Unable to write network config file " << path << std::endl;
+            std::exit(-1);
+        }
+
+        auto topology_names = std::vector<std::string>();
+        for (const auto topology : network_config.get_topologies_per_dim()) {
+            topology_names.push_back(topology_name(topology));
+        }
+
+        file << "# Network Configuration, generated by TopologyGenerator\n";
+        write_yaml_list(file, "topology", topology_names);
+        write_yaml_list(file, "npus_count", network_config.get_npus_counts_per_dim());
+        write_yaml_list(file, "bandwidth", network_config.get_bandwidths_per_dim());
+        write_yaml_list(file, "latency", network_config.get_latencies_per_dim());
+
+        if (!file.flush()) {
+            std::cerr << "[Error] (network/analytical/tools) "
+                      << "Unable to write network config file " << path << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    [[nodiscard]] Traffic generate_traffic(const TrafficPattern pattern,
+                                           const int npus_count,
+                                           const ChunkSize chunk_size,
+                                           const size_t chunks_count,
+                                           const double hotspot_fraction,
+                                           const uint32_t seed) noexcept {
+        auto generator = std::mt19937(seed);
+        auto npu = std::uniform_int_distribution<DeviceId>(0, npus_count - 1);
+        auto traffic = Traffic();
+
+        // random dest other than src
+        const auto random_peer = [&](const DeviceId src) {
+            auto dest = npu(generator);
+            while (dest == src) {
+                dest = npu(generator);
+            }
+            return dest;
+        };
+
+        switch (pattern) {
+            case TrafficPattern::Uniform:
+                for (auto i = size_t(0); i < chunks_count; i++) {
+                    const auto src = npu(generator);
+                    traffic.add_chunk(src, random_peer(src), chunk_size);
+                }
+                break;
+
+            case TrafficPattern::Permutation: {
+                auto dests = std::vector<DeviceId>(npus_count);
+                std::iota(dests.begin(), dests.end(), 0);
+                std::shuffle(dests.begin(), dests.end(), generator);
+
+                // NPUs mapped to themselves swap their dest with the next NPU
+                for (auto src = 0; src < npus_count; src++) {
+                    if (dests[src] == src) {
+                        std::swap(dests[src], dests[(src + 1) % npus_count]);
+                    }
+                }
+
+                for (auto src = 0; src < npus_count; src++) {
+                    traffic.add_chunk(src, dests[src], chunk_size);
+                }
+                break;
+            }
+
+            case TrafficPattern::AllToAll:
+                for (auto src = 0; src < npus_count; src++) {
+                    for (auto dest = 0; dest < npus_count; dest++) {
+                        if (src != dest) {
+                            traffic.add_chunk(src, dest, chunk_size);
+                        }
+                    }
+                }
+                break;
+
+            case TrafficPattern::Hotspot: {
+                auto hotspot = std::bernoulli_distribution(hotspot_fraction);
+                for (auto i = size_t(0); i < chunks_count; i++) {
+                    if (hotspot(generator)) {
+                        traffic.add_chunk(random_peer(0), 0, chunk_size);
+                    } else {
+                        const auto src = npu(generator);
+                        traffic.add_chunk(src, random_peer(src), chunk_size);
+                    }
+                }
+                break;
+            }
+
+            case TrafficPattern::Ring:
+                for (auto step = 1; step < npus_count; step++) {
+                    for (auto src = 0; src < npus_count; src++) {
+                        traffic.add_chunk(src, (src + 1) % npus_count, chunk_size);
+                    }
+                }
+                break;
+        }
+
+        return traffic;
+    }
+
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+    // parse "--key value" arguments
+    auto arguments = std::map<std::string, std::string>();
+    for (auto i = 1; i < argc; i += 2) {
+        const auto key = std::string(argv[i]);
+        if (key.rfind("--", 0) != 0 || i + 1 >= argc) {
+            exit_with_usage("Invalid argument " + key);
+        }
+        arguments[key.substr(2)] = argv[i + 1];
+    }
+
+    for (const auto* const key : {"topology", "npus-count", "bandwidth", "latency", "pattern", "output"}) {
+        if (arguments.find(key) == arguments.end()) {
+            exit_with_usage(std::string("--") + key + " is required");
+        }
+    }
+
+    // build the network config
+    const auto topology_names = parse_list<std::string>("topology", arguments["topology"]);
+    const auto npus_count_per_dim = parse_list<int>("npus-count", arguments["npus-count"]);
+    const auto bandwidth_per_dim = parse_list<Bandwidth>("bandwidth", arguments["bandwidth"]);
+    const auto latency_per_dim = parse_list<Latency>("latency", arguments["latency"]);
+    const auto dims_count = topology_names.size();
+    if (npus_count_per_dim.size() != dims_count || bandwidth_per_dim.size() != dims_count ||
+        latency_per_dim.size() != dims_count) {
+        exit_with_usage("--topology, --npus-count, --bandwidth, and --latency should have the same length");
+    }
+
+    auto network_config = NetworkConfig();
+    for (auto dim = size_t(0); dim < dims_count; dim++) {
+        network_config.add_dimension(NetworkConfig::parse_topology_name(topology_names[dim]), npus_count_per_dim[dim],
+                                     bandwidth_per_dim[dim], latency_per_dim[dim]);
+    }
+    if (const auto error = network_config.validate(); !error.empty()) {
+        exit_with_usage(error);
+    }
+
+    // count NPUs
+    auto npus_count = 1;
+    for (const auto npus_count_of_dim : npus_count_per_dim) {
+        npus_count *= npus_count_of_dim;
+    }
+
+    // generate the traffic
+    const auto pattern = parse_pattern(arguments["pattern"]);
+    const auto chunk_size =
+        (arguments.count("chunk-size") > 0) ? parse_value<ChunkSize>("chunk-size", arguments["chunk-size"]) : 1'048'576;
+    const auto chunks_count = (arguments.count("chunks-count") > 0)
+                                  ? parse_value<size_t>("chunks-count", arguments["chunks-count"])
+                                  : static_cast<size_t>(npus_count);
+    const auto hotspot_fraction = (arguments.count("hotspot-fraction") > 0)
+                                      ? parse_value<double>("hotspot-fraction", arguments["hotspot-fraction"])
+                                      : 0.5;
+    const auto seed = (arguments.count("seed") > 0) ? parse_value<uint32_t>("seed", arguments["seed"]) : 0;
+    if (chunk_size == 0) {
+        exit_with_usage("--chunk-size should be larger than 0");
+    }
+    if (!(0 <= hotspot_fraction && hotspot_fraction <= 1)) {
+        exit_with_usage("--hotspot-fraction should be in [0, 1]");
+    }
+
+    const auto traffic = generate_traffic(pattern, npus_count, chunk_size, chunks_count, hotspot_fraction, seed);
+
+    // write the network config and the traffic
+    const auto& output = arguments["output"];
+    save_network_config(network_config, output + ".yml");
+    save_traffic(traffic, output + ".traffic",
+                 " pattern: " + arguments["pattern"] + ", npus_count: " + std::to_string(npus_count) +
+                     ", seed: " + std::to_string(seed));
+
+    std::cout << "Generated " << output << ".yml (" << npus_count << " NPUs) and " << output << ".traffic ("
+              << traffic.size() << " chunks)" << std::endl;
+
+    return 0;
+}
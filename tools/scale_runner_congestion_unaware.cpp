@@ -0,0 +1,62 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+/**
+ * ScaleRunnerCongestionUnaware estimates a traffic file over a network config,
+ * and reports the construction time, chunks estimated per second, and peak RSS.
+ * The backend runs no events, so every estimated chunk counts as an event.
+ *
+ * Usage: ScaleRunnerCongestionUnaware <network.yml> <traffic>
+ */
+
+#include "ScaleTest.h"
+#include "common/NetworkConfig.h"
+#include "congestion_unaware/Helper.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+using namespace NetworkAnalyticalTools;
+
+int main(const int argc, const char* const argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: ScaleRunnerCongestionUnaware <network.yml> <traffic>" << std::endl;
+        return -1;
+    }
+
+    auto error = std::string();
+    const auto network_config = NetworkConfig::load_yaml_file(argv[1], error);
+    if (!network_config.has_value()) {
+        std::cerr << "[Error] (network/analytical/tools) " << error << std::endl;
+        return -1;
+    }
+
+    auto report = ScaleReport();
+    report.backend = "congestion_unaware";
+
+    // construct the topology
+    const auto construction_start = get_wall_time();
+    const auto topology = construct_topology(network_config.value());
+    report.construction_time = get_wall_time() - construction_start;
+    report.npus_count = topology->get_npus_count();
+    report.devices_count = report.npus_count;
+
+    const auto traffic = load_traffic(argv[2], report.npus_count);
+    report.chunks_count = traffic.size();
+
+    // estimate every chunk, the last one to arrive finishes the traffic
+    auto comms_delays = std::vector<EventTime>(traffic.size());
+
+    const auto simulation_start = get_wall_time();
+    topology->send_batch(traffic.srcs.data(), traffic.dests.data(), traffic.chunk_sizes.data(), comms_delays.data(),
+                         traffic.size());
+    report.simulation_time = get_wall_time() - simulation_start;
+    report.finish_time = comms_delays.empty() ? 0 : *std::max_element(comms_delays.begin(), comms_delays.end());
+    report.events_count = traffic.size();
+
+    print_report(report);
+    return 0;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+/**
+ * ScaleRunnerFlowLevel simulates a traffic file over a network config,
+ * and reports the construction time, events per second, and peak RSS.
+ * Each chunk of the traffic is sent as a flow.
+ *
+ * Usage: ScaleRunnerFlowLevel <network.yml> <traffic>
+ */
+
+#include "ScaleTest.h"
+#include "common/EventQueue.h"
+#include "common/NetworkConfig.h"
+#include "flow_level/Flow.h"
+#include "flow_level/Helper.h"
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalFlowLevel;
+using namespace NetworkAnalyticalTools;
+
+namespace {
+
+    void flow_arrived(void* const arg) noexcept {}
+
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: ScaleRunnerFlowLevel <network.yml> <traffic>" << std::endl;
+        return -1;
+    }
+
+    auto error = std::string();
+    const auto network_config = NetworkConfig::load_yaml_file(argv[1], error);
+    if (!network_config.has_value()) {
+        std::cerr << "[Error] (network/analytical/tools) " << error << std::endl;
+        return -1;
+    }
+
+    auto report = ScaleReport();
+    report.backend = "flow_level";
+
+    // construct the topology
+    const auto construction_start = get_wall_time();
+    const auto topology = construct_topology(network_config.value(), error);
+    report.construction_time = get_wall_time() - construction_start;
+    if (topology == nullptr) {
+        std::cerr << "[Error] (network/analytical/tools) " << error << std::endl;
+        return -1;
+    }
+    report.npus_count = topology->get_npus_count();
+    report.devices_count = topology->get_devices_count();
+
+    const auto traffic = load_traffic(argv[2], report.npus_count);
+    report.chunks_count = traffic.size();
+
+    // inject every flow at time 0, then simulate
+    const auto event_queue = std::make_shared<EventQueue>();
+    topology->set_event_queue(event_queue);
+
+    const auto simulation_start = get_wall_time();
+    for (auto i = size_t(0); i < traffic.size(); i++) {
+        auto route = topology->route(traffic.srcs[i], traffic.dests[i]);
+        topology->send(std::make_unique<Flow>(traffic.chunk_sizes[i], route, flow_arrived, nullptr));
+    }
+    const auto summary = event_queue->run_to_completion();
+    report.simulation_time = get_wall_time() - simulation_start;
+    report.finish_time = event_queue->get_current_time();
+    report.events_count = summary.events_count;
+
+    print_report(report);
+    return 0;
+}